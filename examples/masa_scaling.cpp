@@ -0,0 +1,126 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_scaling.cpp: strong-scaling benchmark of the threaded batch
+//                   evaluation, from one thread up to N (default: the
+//                   MASA_NUM_THREADS setting)
+//
+//   usage: masa_scaling [max_threads] [points]
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+//
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <masa.h>
+
+using namespace MASA;
+using namespace std;
+
+typedef double Scalar;
+
+// wall clock seconds of the fastest of a few repetitions
+double time_batch(Scalar (*f)(Scalar,Scalar),
+                  const vector<Scalar>& x,const vector<Scalar>& y)
+{
+  vector<Scalar> out;
+  double best = 0;
+
+  for(int rep = 0; rep < 3; rep++)
+    {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      masa_eval_2d_batch<Scalar>(f,x,y,out);
+      double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      if(rep == 0 || elapsed < best)
+        best = elapsed;
+    }
+
+  return best;
+}
+
+void scaling(const char* solution,const char* term,Scalar (*f)(Scalar,Scalar),
+             Scalar x0,Scalar x1,Scalar y0,Scalar y1,int max_threads,int npts)
+{
+  masa_init<Scalar>(solution,solution);
+  masa_init_param<Scalar>();
+
+  // points scattered over the domain (golden ratio sequence)
+  vector<Scalar> x(npts),y(npts);
+  for(int i = 0; i < npts; i++)
+    {
+      Scalar a = Scalar(i)/npts;
+      Scalar b = i * 0.6180339887498949 - int(i * 0.6180339887498949);
+      x[i] = x0 + (x1-x0)*a;
+      y[i] = y0 + (y1-y0)*b;
+    }
+
+  cout << "\n" << solution << " (" << term << ", " << npts << " points)\n";
+  cout << setw(8) << "threads" << setw(14) << "seconds" << setw(10) << "speedup"
+       << setw(12) << "efficiency" << "\n";
+
+  double serial = 0;
+  for(int nt = 1; nt <= max_threads; nt++)
+    {
+      masa_set_num_threads(nt);
+      double t = time_batch(f,x,y);
+      if(nt == 1)
+        serial = t;
+      cout << setw(8) << nt << setw(14) << t << setw(10) << setprecision(3)
+           << serial/t << setw(12) << serial/t/nt << setprecision(6) << "\n";
+    }
+}
+
+int main(int argc,char** argv)
+{
+  int max_threads = argc > 1 ? atoi(argv[1]) : masa_get_num_threads();
+  int npts        = argc > 2 ? atoi(argv[2]) : 200000;
+
+  if(max_threads < 1 || npts < 1)
+    {
+      cout << "usage: masa_scaling [max_threads] [points]\n";
+      return 1;
+    }
+
+  // uniform cost per point
+  scaling("navierstokes_2d_compressible","source rho_e",masa_eval_source_rho_e<Scalar>,
+          0,1,0,1,max_threads,npts);
+
+  // non-uniform cost: root finding in the rarefaction fan only
+  scaling("sod_1d","source rho_u",masa_eval_source_rho_u<Scalar>,
+          -5,5,0.1,2,max_threads,npts/4);
+
+  // expensive, stateful evaluation
+  scaling("fans_sa_steady_wall_bounded","source rho_e",masa_eval_source_rho_e<Scalar>,
+          0.05,1,0.05,1,max_threads,npts/4);
+
+  masa_set_num_threads(0);
+  return 0;
+}
@@ -0,0 +1,134 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_stream.cpp: evaluates 3D manufactured solution fields on a
+//                  uniform grid of the unit cube straight into a
+//                  MASAGRID file, without holding the grid in memory
+//
+//   usage: masa_stream solution file nx ny nz [slab_planes] [field ...]
+//
+//   fields are named after the masa_eval_* routines, e.g. exact_rho or
+//   source_rho_e; by default the exact rho, u, v, w and p are written.
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+//
+#include <iostream>
+#include <cstdlib>
+#include <map>
+#include <masa.h>
+
+using namespace MASA;
+using namespace std;
+
+typedef double Scalar;
+typedef Scalar (*field_fn)(Scalar,Scalar,Scalar);
+
+void build_table(map<string,field_fn>& table)
+{
+  table["exact_t"]       = masa_eval_exact_t<Scalar>;
+  table["exact_u"]       = masa_eval_exact_u<Scalar>;
+  table["exact_v"]       = masa_eval_exact_v<Scalar>;
+  table["exact_w"]       = masa_eval_exact_w<Scalar>;
+  table["exact_p"]       = masa_eval_exact_p<Scalar>;
+  table["exact_rho"]     = masa_eval_exact_rho<Scalar>;
+  table["exact_nu"]      = masa_eval_exact_nu<Scalar>;
+
+  table["source_t"]      = masa_eval_source_t<Scalar>;
+  table["source_u"]      = masa_eval_source_u<Scalar>;
+  table["source_v"]      = masa_eval_source_v<Scalar>;
+  table["source_w"]      = masa_eval_source_w<Scalar>;
+  table["source_e"]      = masa_eval_source_e<Scalar>;
+  table["source_rho"]    = masa_eval_source_rho<Scalar>;
+  table["source_rho_u"]  = masa_eval_source_rho_u<Scalar>;
+  table["source_rho_v"]  = masa_eval_source_rho_v<Scalar>;
+  table["source_rho_w"]  = masa_eval_source_rho_w<Scalar>;
+  table["source_rho_e"]  = masa_eval_source_rho_e<Scalar>;
+  table["source_nu"]     = masa_eval_source_nu<Scalar>;
+}
+
+int usage()
+{
+  cout << "usage: masa_stream solution file nx ny nz [slab_planes] [field ...]\n";
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  if(argc < 6)
+    return usage();
+
+  const string solution = argv[1];
+  const string filename = argv[2];
+  const int nx = atoi(argv[3]);
+  const int ny = atoi(argv[4]);
+  const int nz = atoi(argv[5]);
+  const int slab_planes = argc > 6 ? atoi(argv[6]) : 0;
+
+  if(nx < 1 || ny < 1 || nz < 1 || slab_planes < 0)
+    return usage();
+
+  map<string,field_fn> table;
+  build_table(table);
+
+  vector<string> names;
+  for(int a = 7; a < argc; a++)
+    names.push_back(argv[a]);
+  if(names.empty())
+    {
+      names.push_back("exact_rho");
+      names.push_back("exact_u");
+      names.push_back("exact_v");
+      names.push_back("exact_w");
+      names.push_back("exact_p");
+    }
+
+  vector<field_fn> fields;
+  for(unsigned int f = 0; f != names.size(); f++)
+    {
+      if(table.find(names[f]) == table.end())
+        {
+          cout << "masa_stream: unknown field " << names[f] << "\n";
+          return 1;
+        }
+      fields.push_back(table[names[f]]);
+    }
+
+  masa_init<Scalar>(solution,solution);
+  masa_init_param<Scalar>();
+  if(masa_sanity_check<Scalar>())
+    return 1;
+
+  // uniform nodes on the unit cube
+  vector<Scalar> x(nx),y(ny),z(nz);
+  for(int i = 0; i < nx; i++) x[i] = nx > 1 ? Scalar(i)/(nx-1) : 0;
+  for(int j = 0; j < ny; j++) y[j] = ny > 1 ? Scalar(j)/(ny-1) : 0;
+  for(int k = 0; k < nz; k++) z[k] = nz > 1 ? Scalar(k)/(nz-1) : 0;
+
+  return masa_stream_3d_grid<Scalar>(filename,fields,names,x,y,z,slab_planes);
+}
@@ -57,6 +57,15 @@ echo Optional Features:
      echo '   'Enable python interfaces..... : no
    fi
 
+   echo '   'Scalar types................. : $masa_scalars
+   echo '   'Solutions.................... : $masa_solutions
+
+   if test "x$MASA_CSE_FLAGS" = "x--powers"; then
+     echo '   'Multiply out source powers... : yes
+   else
+     echo '   'Multiply out source powers... : no
+   fi
+
    if test "$FORT_INTERFACES" = "1"; then
      echo '   'Enable fortran interfaces.... : yes
      echo Fortran compiler................   : $FC
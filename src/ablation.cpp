@@ -393,4 +393,6 @@ Scalar MASA::navierstokes_ablation_1d_steady<Scalar>::eval_exact_rho_C3(Scalar x
   return rho_an_C3;
 }
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ablation
 MASA_INSTANTIATE_ALL(MASA::navierstokes_ablation_1d_steady);
+#endif
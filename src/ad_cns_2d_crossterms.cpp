@@ -23,7 +23,7 @@
 //-----------------------------------------------------------------------el-
 
 #include <masa_internal.h>
-#include <ad_masa.h>
+#include <ad_residual.h>
 
 // typedef double RawScalar;
 typedef ShadowNumber<double, long double> RawScalar;
@@ -33,6 +33,27 @@ typedef DualNumber<RawScalar, NumberArray<NDIM, RawScalar> > FirstDerivType;
 typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
 typedef SecondDerivType ADType;
 
+namespace {
+
+// extract the gradient carried by a first (or higher) derivative type
+template <typename Scalar, typename ADScalar>
+void ad_gradient(const ADScalar& f, Scalar* grad)
+{
+  for(unsigned int i = 0; i != NDIM; i++)
+    grad[i] = raw_value(f.derivatives()[i]);
+}
+
+// extract the (row-major) hessian carried by a second derivative type
+template <typename Scalar, typename ADScalar>
+void ad_hessian(const ADScalar& f, Scalar* hess)
+{
+  for(unsigned int i = 0; i != NDIM; i++)
+    for(unsigned int j = 0; j != NDIM; j++)
+      hess[i*NDIM+j] = raw_value(f.derivatives()[i].derivatives()[j]);
+}
+
+}
+
 using namespace MASA;
 
 template <typename Scalar>
@@ -110,9 +131,10 @@ int MASA::ad_cns_2d_crossterms<Scalar>::init_var()
 // Source Terms
 // ----------------------------------------
 
-// public static method, that can be called from eval_q_t
+// continuity, momentum and energy source terms at a point, from one
+// derivative sweep shared by all of them
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1) const
+const Scalar* MASA::ad_cns_2d_crossterms<Scalar>::eval_residual(Scalar x1, Scalar y1) const
 {
   using std::cos;
 
@@ -120,154 +142,179 @@ Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1) const
   typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
   typedef SecondDerivType ADScalar;
 
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+  typedef ad_compressible_ns<Scalar, NDIM> Operator;
+
+  const Scalar point[NDIM] = {x1, y1};
+  const Scalar* cached = fused.find(this->revision,point);
+  if(cached)
+    return cached;
+
+  Scalar Q[4];
+  ad_residual<ADScalar>(Operator(Gamma,R,mu,k),
+    [this](const NumberArray<NDIM, ADScalar>& X, typename Operator::template state<ADScalar>& s)
+    {
+      const ADScalar& x = X[0];
+      const ADScalar& y = X[1];
+
+      // Arbitrary manufactured solution
+      s.U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
+      s.U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
+      s.RHO  = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
+      s.P    = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+    },
+    point,Q);
+
+  return fused.store(this->revision,point,Q);
+}
 
-  // Temperature
-  ADScalar T = P / RHO / R;
+// public static method, that can be called from eval_q_t
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1) const
+{
+  return eval_residual(x1,y1)[1];
+}
 
-  // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
+// public, static method
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_v(Scalar x1, Scalar y1) const
+{
+  return eval_residual(x1,y1)[2];
+}
 
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
+// public, static method
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_e(Scalar x1, Scalar y1) const
+{
+  return eval_residual(x1,y1)[3];
+}
 
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
+// public, static method
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_rho(Scalar x1, Scalar y1) const
+{
+  return eval_residual(x1,y1)[0];
+}
 
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
 
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
 
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  NumberArray<NDIM, Scalar> Q_rho_u = 
-    raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
+// ----------------------------------------
+// Analytical Terms
+// ----------------------------------------
 
-  return Q_rho_u[0];
+// example of a public method called from eval_exact_t
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_u(Scalar x, Scalar y)
+{
+  using std::cos;
 
+  Scalar exact_u;
+  exact_u = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
+  return exact_u;
 }
 
-// public, static method
+// public method
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_v(Scalar x1, Scalar y1) const
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_v(Scalar x, Scalar y)
 {
   using std::cos;
 
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
-
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
+  Scalar exact_v;
+  exact_v = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
+  return exact_v;
+}
 
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
+// public method
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_p(Scalar x, Scalar y)
+{
+  using std::cos;
 
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+  Scalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+  return P;
+}
 
-  // Temperature
-  ADScalar T = P / RHO / R;
+// public method
+template <typename Scalar>
+Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_rho(Scalar x, Scalar y)
+{
+  using std::cos;
 
-  // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
+  Scalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
+  return RHO;
+}
 
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
 
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
 
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
+// ----------------------------------------
+// Full Gradient and Hessian of Analytical Terms
+// ----------------------------------------
 
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
+template <typename Scalar>
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_grad_u(Scalar x1, Scalar y1, Scalar* grad)
+{
+  using std::cos;
 
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  NumberArray<NDIM, Scalar> Q_rho_u = 
-    raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef FirstDerivType ADScalar;
 
-  return Q_rho_u[1];
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
+  ADScalar U = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
+  ad_gradient(U,grad);
+  return 0;
 }
 
-// public, static method
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_e(Scalar x1, Scalar y1) const
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_grad_v(Scalar x1, Scalar y1, Scalar* grad)
 {
   using std::cos;
 
   typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
+  typedef FirstDerivType ADScalar;
 
   const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
   const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
-
-  // Temperature
-  ADScalar T = P / RHO / R;
+  ADScalar V = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
+  ad_gradient(V,grad);
+  return 0;
+}
 
-  // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
+template <typename Scalar>
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_grad_p(Scalar x1, Scalar y1, Scalar* grad)
+{
+  using std::cos;
 
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef FirstDerivType ADScalar;
 
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
+  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+  ad_gradient(P,grad);
+  return 0;
+}
 
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
+template <typename Scalar>
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_grad_rho(Scalar x1, Scalar y1, Scalar* grad)
+{
+  using std::cos;
 
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  // NumberArray<NDIM, Scalar> Q_rho_u = 
-  //   raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef FirstDerivType ADScalar;
 
-  // energy equation
-  Scalar Q_rho_e = raw_value(divergence((RHO*ET+P)*U + q - Tau.dot(U)));
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
-  return Q_rho_e;
+  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
+  ad_gradient(RHO,grad);
+  return 0;
 }
 
-// public, static method
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_rho(Scalar x1, Scalar y1) const
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_hess_u(Scalar x1, Scalar y1, Scalar* hess)
 {
   using std::cos;
 
@@ -278,74 +325,70 @@ Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_q_rho(Scalar x1, Scalar y1) cons
   const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
   const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
-
-  Scalar Q_rho = raw_value(divergence(RHO*U));
-
-  return Q_rho;
+  ADScalar U = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
+  ad_hessian(U,hess);
+  return 0;
 }
 
-
-
-// ----------------------------------------
-// Analytical Terms
-// ----------------------------------------
-
-// example of a public method called from eval_exact_t
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_u(Scalar x, Scalar y)
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_hess_v(Scalar x1, Scalar y1, Scalar* hess)
 {
   using std::cos;
 
-  Scalar exact_u;
-  exact_u = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L);
-  return exact_u;
-}
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
+  typedef SecondDerivType ADScalar;
 
-// public method
-template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_v(Scalar x, Scalar y)
-{
-  using std::cos;
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
 
-  Scalar exact_v;
-  exact_v = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
-  return exact_v;
+  ADScalar V = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L);
+  ad_hessian(V,hess);
+  return 0;
 }
 
-// public method
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_p(Scalar x, Scalar y)
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_hess_p(Scalar x1, Scalar y1, Scalar* hess)
 {
   using std::cos;
 
-  Scalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
-  return P;
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
+  typedef SecondDerivType ADScalar;
+
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
+
+  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L);
+  ad_hessian(P,hess);
+  return 0;
 }
 
-// public method
 template <typename Scalar>
-Scalar MASA::ad_cns_2d_crossterms<Scalar>::eval_exact_rho(Scalar x, Scalar y)
+int MASA::ad_cns_2d_crossterms<Scalar>::eval_hess_rho(Scalar x1, Scalar y1, Scalar* hess)
 {
   using std::cos;
 
-  Scalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
-  return RHO;
-}
+  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
+  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
+  typedef SecondDerivType ADScalar;
 
+  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
+  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
+
+  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L);
+  ad_hessian(RHO,hess);
+  return 0;
+}
 
 
 // ----------------------------------------
 // Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::ad_cns_2d_crossterms);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ad_cns_2d_crossterms
+MASA_INSTANTIATE_SCALARS(MASA::ad_cns_2d_crossterms);
+#endif
 
 
 
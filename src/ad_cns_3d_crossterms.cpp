@@ -24,7 +24,7 @@
 
 #include <masa_internal.h>
 
-#include <ad_masa.h>
+#include <ad_residual.h>
 
 typedef ShadowNumber<double, long double> RawScalar;
 const unsigned int NDIM = 3;
@@ -139,9 +139,10 @@ int MASA::ad_cns_3d_crossterms<Scalar>::init_var()
 // Source Terms
 // ----------------------------------------
 
-// public static method, that can be called from eval_q_t
+// continuity, momentum and energy source terms at a point, from one
+// derivative sweep shared by all of them
 template <typename Scalar>
-Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1, Scalar z1) const
+const Scalar* MASA::ad_cns_3d_crossterms<Scalar>::eval_residual(Scalar x1, Scalar y1, Scalar z1) const
 {
   using std::cos;
 
@@ -149,237 +150,66 @@ Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1, Scalar
   typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
   typedef SecondDerivType ADScalar;
 
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  const ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
-  U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
-
-  // Temperature
-  ADScalar T = P / RHO / R;
-
-  // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
-
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
-
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
-
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
-
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
-
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  NumberArray<NDIM, Scalar> Q_rho_u = 
-    raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
+  typedef ad_compressible_ns<Scalar, NDIM> Operator;
+
+  const Scalar point[NDIM] = {x1, y1, z1};
+  const Scalar* cached = fused.find(this->revision,point);
+  if(cached)
+    return cached;
+
+  Scalar Q[5];
+  ad_residual<ADScalar>(Operator(Gamma,R,mu,k),
+    [this](const NumberArray<NDIM, ADScalar>& X, typename Operator::template state<ADScalar>& s)
+    {
+      const ADScalar& x = X[0];
+      const ADScalar& y = X[1];
+      const ADScalar& z = X[2];
+
+      // Arbitrary manufactured solution
+      s.U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
+      s.U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
+      s.U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
+      s.RHO  = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
+      s.P    = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
+    },
+    point,Q);
+
+  return fused.store(this->revision,point,Q);
+}
 
-  return Q_rho_u[0];
+// public static method, that can be called from eval_q_t
+template <typename Scalar>
+Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_u(Scalar x1, Scalar y1, Scalar z1) const
+{
+  return eval_residual(x1,y1,z1)[1];
 }
 
 // public, static method
 template <typename Scalar>
 Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_v(Scalar x1, Scalar y1, Scalar z1) const
 {
-  using std::cos;
-
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
-
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  const ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
-  U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
-
-  // Temperature
-  ADScalar T = P / RHO / R;
-
- // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
-
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
-
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
-
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
-
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
-
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  NumberArray<NDIM, Scalar> Q_rho_u = 
-    raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
-
-  return Q_rho_u[1];
-
+  return eval_residual(x1,y1,z1)[2];
 }
 
 // public, static method
 template <typename Scalar>
 Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_w(Scalar x1, Scalar y1, Scalar z1) const
 {
-  using std::cos;
-
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
-
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  const ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
-  U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
-
-  // Temperature
-  ADScalar T = P / RHO / R;
-
- // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
-
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
-
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
-
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
-
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
-
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  NumberArray<NDIM, Scalar> Q_rho_u = 
-    raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
-
-  return Q_rho_u[2];
-
+  return eval_residual(x1,y1,z1)[3];
 }
 
 // public, static method
 template <typename Scalar>
 Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_e(Scalar x1, Scalar y1, Scalar z1) const
 {
-  using std::cos;
-
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  const ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
-  U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
-
-  // Temperature
-  ADScalar T = P / RHO / R;
-
-  // Perfect gas energies
-  ADScalar E = 1./(Gamma-1.)*P/RHO;
-  ADScalar ET = E + .5 * U.dot(U);
-
-  // The shear strain tensor
-  NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
-
-  // The identity tensor I
-  NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity = 
-    NumberArray<NDIM, Scalar>::identity();
-
-  // The shear stress tensor
-  NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
-
-  // Temperature flux
-  NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
-
-  // Euler equation residuals
-  // Scalar Q_rho = raw_value(divergence(RHO*U));
-  // NumberArray<NDIM, Scalar> Q_rho_u = 
-  //   raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
-
-  // energy equation
-  Scalar Q_rho_e = raw_value(divergence((RHO*ET+P)*U + q - Tau.dot(U)));
-
-  return Q_rho_e;
+  return eval_residual(x1,y1,z1)[4];
 }
 
-
 // public, static method
 template <typename Scalar>
 Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_q_rho(Scalar x1, Scalar y1, Scalar z1) const
 {
-  using std::cos;
-
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef SecondDerivType ADScalar;
-
-  const ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  const ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  const ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  // Arbitrary manufactured solution
-  U[0] = u_0 + u_x * cos(a_ux * PI * x / L) * u_y * cos(a_uy * PI * y / L) * cos(a_uy * PI * z / L);
-  U[1] = v_0 + v_x * cos(a_vx * PI * x / L) * v_y * cos(a_vy * PI * y / L) * cos(a_vy * PI * z / L);
-  U[2] = w_0 + w_x * cos(a_wx * PI * x / L) * w_y * cos(a_wy * PI * y / L) * cos(a_wy * PI * z / L);
-  ADScalar RHO = rho_0 + rho_x * cos(a_rhox * PI * x / L) * rho_y * cos(a_rhoy * PI * y / L) * cos(a_rhoz * PI * z / L);
-  ADScalar P = p_0 + p_x * cos(a_px * PI * x / L) * p_y * cos(a_py * PI * y / L) * cos(a_pz * PI * z / L);
-
-  Scalar Q_rho = raw_value(divergence(RHO*U));
-
-  return Q_rho;
+  return eval_residual(x1,y1,z1)[0];
 }
 
 
@@ -446,7 +276,9 @@ Scalar MASA::ad_cns_3d_crossterms<Scalar>::eval_exact_rho(Scalar x, Scalar y, Sc
 // Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::ad_cns_3d_crossterms);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ad_cns_3d_crossterms
+MASA_INSTANTIATE_SCALARS(MASA::ad_cns_3d_crossterms);
+#endif
 
 
 
@@ -0,0 +1,191 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// ad_residual.h: source terms by automatic differentiation, shared by
+//                the solutions that only write down their primitive
+//                fields and leave the derivatives of the equations to
+//                DualNumber
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#ifndef __ad_residual_h__
+#define __ad_residual_h__
+
+#include "ad_masa.h"
+
+namespace MASA
+{
+
+  // The coordinates of a point as the independent variables of
+  // ADScalar: each carries the unit vector of its direction as its
+  // gradient, and zero higher derivatives
+  template <typename ADScalar, unsigned int NDIM, typename Scalar>
+  inline NumberArray<NDIM, ADScalar> ad_seed(const Scalar* point)
+  {
+    NumberArray<NDIM, ADScalar> X;
+    for(unsigned int i = 0; i != NDIM; i++)
+      {
+        NumberArray<NDIM, Scalar> e = 0;
+        e[i] = 1;
+        X[i] = ADScalar(point[i],e);
+      }
+    return X;
+  }
+
+  // Every source term of Operator at a point. fields(X,state) fills
+  // in the primitive fields of the solution as functions of the seeded
+  // coordinates X, and the operator turns them into its residuals,
+  // Operator::components of them, in Q. ADScalar must carry as many
+  // derivatives as the fields take of themselves plus the order of
+  // the operator.
+  template <typename ADScalar, typename Operator, typename Fields, typename Scalar>
+  inline void ad_residual(const Operator& op, const Fields& fields, const Scalar* point, Scalar* Q)
+  {
+    typename Operator::template state<ADScalar> s;
+    fields(ad_seed<ADScalar, Operator::dim>(point), s);
+    op(s,Q);
+  }
+
+  // Steady compressible Navier-Stokes equations of a perfect gas with
+  // constant viscosity mu and conductivity k (the Euler equations
+  // when both are zero). Q holds the continuity, NDIM momentum and
+  // energy residuals, in that order.
+  template <typename Scalar, unsigned int NDIM>
+  struct ad_compressible_ns
+  {
+    static const unsigned int dim        = NDIM;
+    static const unsigned int components = NDIM + 2;
+
+    template <typename ADScalar>
+    struct state
+    {
+      NumberArray<NDIM, ADScalar> U;     // velocity
+      ADScalar RHO;                      // density
+      ADScalar P;                        // pressure
+    };
+
+    ad_compressible_ns(Scalar Gamma_, Scalar R_, Scalar mu_, Scalar k_)
+      : Gamma(Gamma_), R(R_), mu(mu_), k(k_) {}
+
+    template <typename ADScalar>
+    void operator()(state<ADScalar>& s, Scalar* Q) const
+    {
+      NumberArray<NDIM, ADScalar>& U = s.U;
+      const ADScalar& RHO = s.RHO;
+      const ADScalar& P = s.P;
+
+      // Temperature
+      ADScalar T = P / RHO / R;
+
+      // Perfect gas energies
+      ADScalar E = 1./(Gamma-1.)*P/RHO;
+      ADScalar ET = E + .5 * U.dot(U);
+
+      // The shear strain tensor
+      NumberArray<NDIM, typename ADScalar::derivatives_type> GradU = gradient(U);
+
+      // The identity tensor I
+      NumberArray<NDIM, NumberArray<NDIM, Scalar> > Identity =
+        NumberArray<NDIM, Scalar>::identity();
+
+      // The shear stress tensor
+      NumberArray<NDIM, NumberArray<NDIM, ADScalar> > Tau = mu * (GradU + transpose(GradU) - 2./3.*divergence(U)*Identity);
+
+      // Temperature flux
+      NumberArray<NDIM, ADScalar> q = -k * T.derivatives();
+
+      // Euler equation residuals
+      Q[0] = raw_value(divergence(RHO*U));
+
+      NumberArray<NDIM, Scalar> Q_rho_u =
+        raw_value(divergence(RHO*U.outerproduct(U) - Tau) + P.derivatives());
+      for(unsigned int i = 0; i != NDIM; i++)
+        Q[1+i] = Q_rho_u[i];
+
+      // energy equation
+      Q[NDIM+1] = raw_value(divergence((RHO*ET+P)*U + q - Tau.dot(U)));
+    }
+
+    Scalar Gamma;
+    Scalar R;
+    Scalar mu;
+    Scalar k;
+  };
+
+  // Steady incompressible Navier-Stokes equations with kinematic
+  // viscosity nu. Q holds the NDIM momentum source terms, the
+  // negated residuals of
+  //   convection * div(U U) - grad(P) + nu * div(grad(U))
+  // where the sign of the convective term is left to the solution.
+  template <typename Scalar, unsigned int NDIM>
+  struct ad_incompressible_ns
+  {
+    static const unsigned int dim        = NDIM;
+    static const unsigned int components = NDIM;
+
+    template <typename ADScalar>
+    struct state
+    {
+      NumberArray<NDIM, ADScalar> U;     // velocity
+      ADScalar P;                        // pressure
+    };
+
+    ad_incompressible_ns(Scalar nu_, Scalar convection_ = 1)
+      : nu(nu_), convection(convection_) {}
+
+    template <typename ADScalar>
+    void operator()(state<ADScalar>& s, Scalar* Q) const
+    {
+      NumberArray<NDIM, ADScalar>& U = s.U;
+      const ADScalar& P = s.P;
+
+      // NS equation residuals
+      NumberArray<NDIM, Scalar> Q_u =
+        raw_value(
+
+                  // convective term
+                  convection * divergence(U.outerproduct(U))
+
+                  // pressure
+                  - P.derivatives()
+
+                  // dissipation
+                  + nu * divergence(gradient(U)));
+
+      for(unsigned int i = 0; i != NDIM; i++)
+        Q[i] = -Q_u[i];
+    }
+
+    Scalar nu;
+    Scalar convection;
+  };
+
+} // end namespace MASA
+
+#endif // __ad_residual_h__
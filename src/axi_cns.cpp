@@ -201,4 +201,6 @@ Scalar MASA::axi_cns<Scalar>::eval_exact_rho(Scalar r,Scalar z)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns
 MASA_INSTANTIATE_ALL(MASA::axi_cns);
+#endif
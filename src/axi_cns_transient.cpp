@@ -33,6 +33,7 @@ MASA::axi_cns_transient<Scalar>::axi_cns_transient()
 {
   this->mmsname = "axi_cns_transient";
   this->dimension = 2;
+  this->transient = true;
 
   this->register_var("rho_0",&rho_0);
   this->register_var("rho_r",&rho_r);
@@ -255,7 +256,9 @@ Scalar MASA::axi_cns_transient<Scalar>::eval_exact_w(Scalar r, Scalar z, Scalar
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns_transient
 MASA_INSTANTIATE_ALL(MASA::axi_cns_transient);
+#endif
 
 
 
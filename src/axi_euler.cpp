@@ -220,4 +220,6 @@ Scalar MASA::axi_euler<Scalar>::eval_exact_rho(Scalar r,Scalar z)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler
 MASA_INSTANTIATE_ALL(MASA::axi_euler);
+#endif
@@ -33,6 +33,7 @@ MASA::axi_euler_transient<Scalar>::axi_euler_transient()
 {
   this->mmsname = "axi_euler_transient";
   this->dimension = 2;
+  this->transient = true;
 
   this->register_var("rho_0",&rho_0);
   this->register_var("rho_r",&rho_r);
@@ -240,7 +241,9 @@ Scalar MASA::axi_euler_transient<Scalar>::eval_exact_w(Scalar r, Scalar z, Scala
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler_transient
 MASA_INSTANTIATE_ALL(MASA::axi_euler_transient);
+#endif
 
 
 
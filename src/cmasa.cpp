@@ -32,6 +32,8 @@
 //
 
 #include <masa.h>
+#include <masa_internal.h> // thread pool sizing
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -82,6 +84,16 @@ extern "C" int masa_init(const char* specificname,const char* functionname)
   return 0;
 }
 
+extern "C" int masa_init_expr(const char* specificname,const char* equations,const char* definitions)
+{
+  return masa_init_expr<double>(specificname,equations,definitions);
+}
+
+extern "C" int masa_jit_compile(const char* cache_dir)
+{
+  return masa_jit_compile<double>(cache_dir);
+}
+
 extern "C" int masa_select_mms(const char* function_user_wants)
 {
   std::string fuw(function_user_wants);
@@ -285,3 +297,590 @@ extern "C" double masa_eval_4d_grad_v   (double x,double y,double z,double t,int
 extern "C" double masa_eval_4d_grad_w   (double x,double y,double z,double t,int i){return(masa_eval_grad_w  <double>(x,y,z,t,i));}
 extern "C" double masa_eval_4d_grad_p   (double x,double y,double z,double t,int i){return(masa_eval_grad_p  <double>(x,y,z,t,i));}
 extern "C" double masa_eval_4d_grad_rho (double x,double y,double z,double t,int i){return(masa_eval_grad_rho<double>(x,y,z,t,i));}
+
+// --------------------------------
+// full gradient and hessian of analytical term(s) -- 2D, 3D and 4D
+// --------------------------------
+
+extern "C" int masa_eval_2d_gradient_t  (double x,double y,double* grad)                  {return(masa_eval_gradient_t  <double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_t  (double x,double y,double z,double* grad)         {return(masa_eval_gradient_t  <double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_t  (double x,double y,double z,double t,double* grad){return(masa_eval_gradient_t  <double>(x,y,z,t,grad));}
+extern "C" int masa_eval_2d_gradient_u  (double x,double y,double* grad)                  {return(masa_eval_gradient_u  <double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_u  (double x,double y,double z,double* grad)         {return(masa_eval_gradient_u  <double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_u  (double x,double y,double z,double t,double* grad){return(masa_eval_gradient_u  <double>(x,y,z,t,grad));}
+extern "C" int masa_eval_2d_gradient_v  (double x,double y,double* grad)                  {return(masa_eval_gradient_v  <double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_v  (double x,double y,double z,double* grad)         {return(masa_eval_gradient_v  <double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_v  (double x,double y,double z,double t,double* grad){return(masa_eval_gradient_v  <double>(x,y,z,t,grad));}
+extern "C" int masa_eval_2d_gradient_w  (double x,double y,double* grad)                  {return(masa_eval_gradient_w  <double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_w  (double x,double y,double z,double* grad)         {return(masa_eval_gradient_w  <double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_w  (double x,double y,double z,double t,double* grad){return(masa_eval_gradient_w  <double>(x,y,z,t,grad));}
+extern "C" int masa_eval_2d_gradient_p  (double x,double y,double* grad)                  {return(masa_eval_gradient_p  <double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_p  (double x,double y,double z,double* grad)         {return(masa_eval_gradient_p  <double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_p  (double x,double y,double z,double t,double* grad){return(masa_eval_gradient_p  <double>(x,y,z,t,grad));}
+extern "C" int masa_eval_2d_gradient_rho(double x,double y,double* grad)                  {return(masa_eval_gradient_rho<double>(x,y,grad));}
+extern "C" int masa_eval_3d_gradient_rho(double x,double y,double z,double* grad)         {return(masa_eval_gradient_rho<double>(x,y,z,grad));}
+extern "C" int masa_eval_4d_gradient_rho(double x,double y,double z,double t,double* grad){return(masa_eval_gradient_rho<double>(x,y,z,t,grad));}
+
+extern "C" int masa_eval_2d_hessian_t  (double x,double y,double* hess)                  {return(masa_eval_hessian_t  <double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_t  (double x,double y,double z,double* hess)         {return(masa_eval_hessian_t  <double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_t  (double x,double y,double z,double t,double* hess){return(masa_eval_hessian_t  <double>(x,y,z,t,hess));}
+extern "C" int masa_eval_2d_hessian_u  (double x,double y,double* hess)                  {return(masa_eval_hessian_u  <double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_u  (double x,double y,double z,double* hess)         {return(masa_eval_hessian_u  <double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_u  (double x,double y,double z,double t,double* hess){return(masa_eval_hessian_u  <double>(x,y,z,t,hess));}
+extern "C" int masa_eval_2d_hessian_v  (double x,double y,double* hess)                  {return(masa_eval_hessian_v  <double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_v  (double x,double y,double z,double* hess)         {return(masa_eval_hessian_v  <double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_v  (double x,double y,double z,double t,double* hess){return(masa_eval_hessian_v  <double>(x,y,z,t,hess));}
+extern "C" int masa_eval_2d_hessian_w  (double x,double y,double* hess)                  {return(masa_eval_hessian_w  <double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_w  (double x,double y,double z,double* hess)         {return(masa_eval_hessian_w  <double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_w  (double x,double y,double z,double t,double* hess){return(masa_eval_hessian_w  <double>(x,y,z,t,hess));}
+extern "C" int masa_eval_2d_hessian_p  (double x,double y,double* hess)                  {return(masa_eval_hessian_p  <double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_p  (double x,double y,double z,double* hess)         {return(masa_eval_hessian_p  <double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_p  (double x,double y,double z,double t,double* hess){return(masa_eval_hessian_p  <double>(x,y,z,t,hess));}
+extern "C" int masa_eval_2d_hessian_rho(double x,double y,double* hess)                  {return(masa_eval_hessian_rho<double>(x,y,hess));}
+extern "C" int masa_eval_3d_hessian_rho(double x,double y,double z,double* hess)         {return(masa_eval_hessian_rho<double>(x,y,z,hess));}
+extern "C" int masa_eval_4d_hessian_rho(double x,double y,double z,double t,double* hess){return(masa_eval_hessian_rho<double>(x,y,z,t,hess));}
+
+// --------------------------------
+// integrated and cell-averaged source term(s) -- 3D
+// --------------------------------
+
+extern "C" int masa_gauss_legendre(int order,double* abscissae,double* weights)
+{
+  std::vector<double> x,w;
+  int err = masa_gauss_legendre<double>(order,x,w);
+  for(int i = 0; i < (int)x.size(); i++)
+    {
+      abscissae[i] = x[i];
+      weights[i]   = w[i];
+    }
+  return err;
+}
+
+extern "C" double masa_integrate_3d_box(double (*source)(double,double,double),
+                                        double x0,double x1,double y0,double y1,
+                                        double z0,double z1,int order,
+                                        double (*weight)(double,double,double))
+{
+  return masa_integrate_box<double>(source,x0,x1,y0,y1,z0,z1,order,weight);
+}
+
+extern "C" double masa_average_3d_box(double (*source)(double,double,double),
+                                      double x0,double x1,double y0,double y1,
+                                      double z0,double z1,int order)
+{
+  return masa_average_box<double>(source,x0,x1,y0,y1,z0,z1,order);
+}
+
+extern "C" int masa_average_3d_grid(double (*source)(double,double,double),
+                                    int nx,int ny,int nz,
+                                    const double* xnodes,const double* ynodes,
+                                    const double* znodes,int order,double* averages)
+{
+  std::vector<double> xn(xnodes,xnodes+nx+1);
+  std::vector<double> yn(ynodes,ynodes+ny+1);
+  std::vector<double> zn(znodes,znodes+nz+1);
+  std::vector<double> avg;
+
+  int err = masa_average_grid<double>(source,xn,yn,zn,order,avg);
+  std::copy(avg.begin(),avg.end(),averages);
+  return err;
+}
+
+extern "C" double masa_integrate_3d_tet(double (*source)(double,double,double),
+                                        const double v0[3],const double v1[3],
+                                        const double v2[3],const double v3[3],
+                                        int order,double (*weight)(double,double,double))
+{
+  return masa_integrate_tet<double>(source,v0,v1,v2,v3,order,weight);
+}
+
+extern "C" int masa_set_num_threads(int nthreads)
+{
+  return masa_pool_set_threads(nthreads);
+}
+
+extern "C" int masa_get_num_threads()
+{
+  return masa_pool_threads();
+}
+
+extern "C" int masa_eval_1d_batch(double (*func)(double),int n,
+                                  const double* x,double* out)
+{
+  return masa_eval_1d_batch<double>(func,n,x,out);
+}
+
+extern "C" int masa_eval_2d_batch(double (*func)(double,double),int n,
+                                  const double* x,const double* y,double* out)
+{
+  return masa_eval_2d_batch<double>(func,n,x,y,out);
+}
+
+extern "C" int masa_eval_3d_batch(double (*func)(double,double,double),int n,
+                                  const double* x,const double* y,const double* z,
+                                  double* out)
+{
+  return masa_eval_3d_batch<double>(func,n,x,y,z,out);
+}
+
+extern "C" int masa_eval_4d_batch(double (*func)(double,double,double,double),int n,
+                                  const double* x,const double* y,const double* z,
+                                  const double* t,double* out)
+{
+  return masa_eval_4d_batch<double>(func,n,x,y,z,t,out);
+}
+
+extern "C" int masa_eval_2d_grid(double (*func)(double,double),int nx,int ny,
+                                 const double* x,const double* y,double* out)
+{
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+
+  return masa_eval_2d_grid<double>(func,xv,yv,out);
+}
+
+extern "C" int masa_eval_3d_grid(double (*func)(double,double,double),
+                                 int nx,int ny,int nz,
+                                 const double* x,const double* y,const double* z,
+                                 double* out)
+{
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+  std::vector<double> zv(z,z+nz);
+
+  return masa_eval_3d_grid<double>(func,xv,yv,zv,out);
+}
+
+extern "C" int masa_static_partition(int nplanes,int plane_size,int nslabs,int* partition)
+{
+  std::vector<std::size_t> part;
+
+  int err = masa_static_partition(nplanes,plane_size,nslabs,part);
+  std::copy(part.begin(),part.end(),partition);
+  return err;
+}
+
+extern "C" double* masa_alloc_field(int n,int nslabs,const int* partition)
+{
+  std::vector<std::size_t> part;
+  if(nslabs > 0 && partition)
+    part.assign(partition,partition+nslabs+1);
+
+  return masa_alloc_field<double>(n,part);
+}
+
+extern "C" void masa_free_field(double* field)
+{
+  masa_free_field<double>(field);
+}
+
+extern "C" int masa_eval_3d_batch_partitioned(double (*func)(double,double,double),int n,
+                                              const double* x,const double* y,const double* z,
+                                              int nslabs,const int* partition,double* out)
+{
+  std::vector<std::size_t> part(partition,partition+nslabs+1);
+
+  return masa_eval_3d_batch<double>(func,n,x,y,z,out,part);
+}
+
+extern "C" int masa_eval_2d_grid_partitioned(double (*func)(double,double),int nx,int ny,
+                                             const double* x,const double* y,
+                                             int nslabs,const int* partition,double* out)
+{
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+  std::vector<std::size_t> part(partition,partition+nslabs+1);
+
+  return masa_eval_2d_grid<double>(func,xv,yv,out,part);
+}
+
+extern "C" int masa_eval_3d_grid_partitioned(double (*func)(double,double,double),
+                                             int nx,int ny,int nz,
+                                             const double* x,const double* y,const double* z,
+                                             int nslabs,const int* partition,double* out)
+{
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+  std::vector<double> zv(z,z+nz);
+  std::vector<std::size_t> part(partition,partition+nslabs+1);
+
+  return masa_eval_3d_grid<double>(func,xv,yv,zv,out,part);
+}
+
+extern "C" int masa_stream_3d_grid(const char* filename,int nfields,
+                                   double (**fields)(double,double,double),
+                                   const char** names,int nx,int ny,int nz,
+                                   const double* x,const double* y,const double* z,
+                                   int slab_planes)
+{
+  std::vector<double (*)(double,double,double)> funcs(fields,fields+nfields);
+  std::vector<std::string> fnames(names,names+nfields);
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+  std::vector<double> zv(z,z+nz);
+
+  return masa_stream_3d_grid<double>(filename,funcs,fnames,xv,yv,zv,slab_planes);
+}
+
+extern "C" int masa_enable_cache(const char* dir,size_t max_bytes)
+{
+  if(dir == 0 || *dir == '\0')
+    {
+      std::cout << "MASA ERROR:: masa_enable_cache needs a directory" << std::endl;
+      return 1;
+    }
+
+  return masa_cache_configure(dir,max_bytes);
+}
+
+extern "C" int masa_disable_cache()
+{
+  return masa_cache_configure("",0);
+}
+
+extern "C" int masa_release_view(const void* view)
+{
+  return masa_cache_release(view);
+}
+
+extern "C" const double* masa_eval_3d_batch_cached(double (*func)(double,double,double),int n,
+                                                   const double* x,const double* y,const double* z)
+{
+  std::vector<double> xv(x,x+n);
+  std::vector<double> yv(y,y+n);
+  std::vector<double> zv(z,z+n);
+
+  return masa_eval_3d_batch_cached<double>(func,xv,yv,zv);
+}
+
+extern "C" const double* masa_eval_3d_grid_cached(double (*func)(double,double,double),
+                                                  int nx,int ny,int nz,
+                                                  const double* x,const double* y,const double* z)
+{
+  std::vector<double> xv(x,x+nx);
+  std::vector<double> yv(y,y+ny);
+  std::vector<double> zv(z,z+nz);
+
+  return masa_eval_3d_grid_cached<double>(func,xv,yv,zv);
+}
+
+extern "C" int masa_register_grid(const double* x,const double* y,const double* z,int n)
+{
+  if(n < 0)
+    {
+      std::cout << "MASA ERROR:: masa_register_grid needs a non-negative number of points" << std::endl;
+      return -1;
+    }
+
+  return masa_register_grid<double>(x,y,z,n);
+}
+
+extern "C" const double* masa_grid_field(int handle,const char* field)
+{
+  return masa_grid_field<double>(handle,field);
+}
+
+extern "C" int masa_evict_field(int handle,const char* field)
+{
+  return masa_evict_field<double>(handle,field);
+}
+
+extern "C" int masa_release_grid(int handle)
+{
+  return masa_release_grid<double>(handle);
+}
+
+extern "C" int masa_enable_memo(int entries)
+{
+  if(entries < 0)
+    {
+      std::cout << "MASA ERROR:: masa_enable_memo needs a non-negative number of entries" << std::endl;
+      return 1;
+    }
+
+  return masa_enable_memo<double>(entries);
+}
+
+extern "C" int masa_memo_stats(unsigned long* hits,unsigned long* misses)
+{
+  return masa_memo_stats<double>(*hits,*misses);
+}
+
+extern "C" int masa_param_count()
+{
+  return masa_param_count<double>();
+}
+
+extern "C" int masa_save_params(double* values)
+{
+  std::vector<double> snapshot;
+
+  masa_save_params<double>(snapshot);
+  std::copy(snapshot.begin(),snapshot.end(),values);
+  return 0;
+}
+
+extern "C" int masa_load_params(const double* values)
+{
+  return masa_load_params<double>(std::vector<double>(values,values + masa_param_count<double>()));
+}
+
+extern "C" int masa_write_params(const char* filename)
+{
+  std::string bytes;
+  masa_serialize_params<double>(bytes);
+
+  FILE* file = fopen(filename,"wb");
+  if(file == NULL)
+    {
+      std::cout << "MASA ERROR:: masa_write_params cannot open " << filename << std::endl;
+      return 1;
+    }
+
+  const bool written = fwrite(bytes.data(),1,bytes.size(),file) == bytes.size();
+  if(fclose(file) != 0 || !written)
+    {
+      std::cout << "MASA ERROR:: masa_write_params cannot write " << filename << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+extern "C" int masa_read_params(const char* filename)
+{
+  FILE* file = fopen(filename,"rb");
+  if(file == NULL)
+    {
+      std::cout << "MASA ERROR:: masa_read_params cannot open " << filename << std::endl;
+      return 1;
+    }
+
+  std::string bytes;
+  char buffer[4096];
+  std::size_t n;
+  while((n = fread(buffer,1,sizeof(buffer),file)) > 0)
+    bytes.append(buffer,n);
+  fclose(file);
+
+  return masa_deserialize_params<double>(bytes);
+}
+
+extern "C" int masa_eval_1d_lanes(const char* field,int n,const double* x,double* out)
+{
+  const double* c[] = {x};
+
+  return masa_simd_eval("masa_eval_1d_lanes",field,1,std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_2d_lanes(const char* field,int n,const double* x,const double* y,
+                                  double* out)
+{
+  const double* c[] = {x, y};
+
+  return masa_simd_eval("masa_eval_2d_lanes",field,2,std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_3d_lanes(const char* field,int n,const double* x,const double* y,
+                                  const double* z,double* out)
+{
+  const double* c[] = {x, y, z};
+
+  return masa_simd_eval("masa_eval_3d_lanes",field,3,std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_4d_lanes(const char* field,int n,const double* x,const double* y,
+                                  const double* z,const double* t,double* out)
+{
+  const double* c[] = {x, y, z, t};
+
+  return masa_simd_eval("masa_eval_4d_lanes",field,4,std::max(n,0),c,out);
+}
+
+extern "C" int masa_get_lane_isa(char* isa,int length)
+{
+  std::string name;
+
+  masa_get_lane_isa(&name);
+  if(length <= int(name.size()))
+    {
+      std::cout << "MASA ERROR:: masa_get_lane_isa needs room for " << name.size()+1
+                << " characters" << std::endl;
+      return 1;
+    }
+  strcpy(isa,name.c_str());
+  return 0;
+}
+
+extern "C" int masa_eval_1d_float(const char* field,int n,const float* x,float* out)
+{
+  const float* c[] = {x};
+
+  return masa_float_eval("masa_eval_1d_float",field,1,std::max(n,0),c,out,false);
+}
+
+extern "C" int masa_eval_2d_float(const char* field,int n,const float* x,const float* y,
+                                  float* out)
+{
+  const float* c[] = {x, y};
+
+  return masa_float_eval("masa_eval_2d_float",field,2,std::max(n,0),c,out,false);
+}
+
+extern "C" int masa_eval_3d_float(const char* field,int n,const float* x,const float* y,
+                                  const float* z,float* out)
+{
+  const float* c[] = {x, y, z};
+
+  return masa_float_eval("masa_eval_3d_float",field,3,std::max(n,0),c,out,false);
+}
+
+extern "C" int masa_eval_4d_float(const char* field,int n,const float* x,const float* y,
+                                  const float* z,const float* t,float* out)
+{
+  const float* c[] = {x, y, z, t};
+
+  return masa_float_eval("masa_eval_4d_float",field,4,std::max(n,0),c,out,false);
+}
+
+extern "C" int masa_eval_1d_mixed(const char* field,int n,const float* x,float* out)
+{
+  const float* c[] = {x};
+
+  return masa_float_eval("masa_eval_1d_mixed",field,1,std::max(n,0),c,out,true);
+}
+
+extern "C" int masa_eval_2d_mixed(const char* field,int n,const float* x,const float* y,
+                                  float* out)
+{
+  const float* c[] = {x, y};
+
+  return masa_float_eval("masa_eval_2d_mixed",field,2,std::max(n,0),c,out,true);
+}
+
+extern "C" int masa_eval_3d_mixed(const char* field,int n,const float* x,const float* y,
+                                  const float* z,float* out)
+{
+  const float* c[] = {x, y, z};
+
+  return masa_float_eval("masa_eval_3d_mixed",field,3,std::max(n,0),c,out,true);
+}
+
+extern "C" int masa_eval_4d_mixed(const char* field,int n,const float* x,const float* y,
+                                  const float* z,const float* t,float* out)
+{
+  const float* c[] = {x, y, z, t};
+
+  return masa_float_eval("masa_eval_4d_mixed",field,4,std::max(n,0),c,out,true);
+}
+
+extern "C" int masa_eval_1d_dd(const char* field,int n,const double* x,
+                               double* hi,double* lo)
+{
+  const double* c[] = {x};
+
+  return masa_dd_eval("masa_eval_1d_dd",field,1,std::max(n,0),c,hi,lo);
+}
+
+extern "C" int masa_eval_2d_dd(const char* field,int n,const double* x,const double* y,
+                               double* hi,double* lo)
+{
+  const double* c[] = {x, y};
+
+  return masa_dd_eval("masa_eval_2d_dd",field,2,std::max(n,0),c,hi,lo);
+}
+
+extern "C" int masa_eval_3d_dd(const char* field,int n,const double* x,const double* y,
+                               const double* z,double* hi,double* lo)
+{
+  const double* c[] = {x, y, z};
+
+  return masa_dd_eval("masa_eval_3d_dd",field,3,std::max(n,0),c,hi,lo);
+}
+
+extern "C" int masa_eval_4d_dd(const char* field,int n,const double* x,const double* y,
+                               const double* z,const double* t,double* hi,double* lo)
+{
+  const double* c[] = {x, y, z, t};
+
+  return masa_dd_eval("masa_eval_4d_dd",field,4,std::max(n,0),c,hi,lo);
+}
+
+extern "C" int masa_audit_1d(const char* field,const char* shadow,int n,const double* x,
+                             double* max_rel)
+{
+  const double* c[] = {x};
+
+  return masa_audit_eval("masa_audit_1d",field,shadow,1,std::max(n,0),c,*max_rel);
+}
+
+extern "C" int masa_audit_2d(const char* field,const char* shadow,int n,const double* x,
+                             const double* y,double* max_rel)
+{
+  const double* c[] = {x, y};
+
+  return masa_audit_eval("masa_audit_2d",field,shadow,2,std::max(n,0),c,*max_rel);
+}
+
+extern "C" int masa_audit_3d(const char* field,const char* shadow,int n,const double* x,
+                             const double* y,const double* z,double* max_rel)
+{
+  const double* c[] = {x, y, z};
+
+  return masa_audit_eval("masa_audit_3d",field,shadow,3,std::max(n,0),c,*max_rel);
+}
+
+extern "C" int masa_audit_4d(const char* field,const char* shadow,int n,const double* x,
+                             const double* y,const double* z,const double* t,double* max_rel)
+{
+  const double* c[] = {x, y, z, t};
+
+  return masa_audit_eval("masa_audit_4d",field,shadow,4,std::max(n,0),c,*max_rel);
+}
+
+extern "C" int masa_eval_1d_ensemble(const char* field,int members,const double* params,
+                                     int n,const double* x,double* out)
+{
+  const double* c[] = {x};
+
+  return masa_ensemble_eval("masa_eval_1d_ensemble",field,1,std::max(members,0),params,
+                            std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_2d_ensemble(const char* field,int members,const double* params,
+                                     int n,const double* x,const double* y,double* out)
+{
+  const double* c[] = {x, y};
+
+  return masa_ensemble_eval("masa_eval_2d_ensemble",field,2,std::max(members,0),params,
+                            std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_3d_ensemble(const char* field,int members,const double* params,
+                                     int n,const double* x,const double* y,const double* z,
+                                     double* out)
+{
+  const double* c[] = {x, y, z};
+
+  return masa_ensemble_eval("masa_eval_3d_ensemble",field,3,std::max(members,0),params,
+                            std::max(n,0),c,out);
+}
+
+extern "C" int masa_eval_4d_ensemble(const char* field,int members,const double* params,
+                                     int n,const double* x,const double* y,const double* z,
+                                     const double* t,double* out)
+{
+  const double* c[] = {x, y, z, t};
+
+  return masa_ensemble_eval("masa_eval_4d_ensemble",field,4,std::max(members,0),params,
+                            std::max(n,0),c,out);
+}
+
+extern "C" int masa_get_capabilities(int* caps)
+{
+  return masa_get_capabilities<double>(caps);
+}
+
+extern "C" int masa_get_field_capabilities(const char* field,int* dims)
+{
+  return masa_get_field_capabilities<double>(field,dims);
+}
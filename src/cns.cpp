@@ -310,6 +310,146 @@ Scalar MASA::navierstokes_2d_compressible<Scalar>::eval_g_rho(Scalar x,Scalar y,
 
 }
 
+// ----------------------------------------
+//   Full Gradient and Hessian of Analytical Solutions
+// ----------------------------------------
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_grad_u(Scalar x,Scalar y,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_ux * pi / L;
+  const Scalar ky = a_uy * pi / L;
+
+  grad[0] =  u_x * cos(kx * x) * kx;
+  grad[1] = -u_y * sin(ky * y) * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_hess_u(Scalar x,Scalar y,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_ux * pi / L;
+  const Scalar ky = a_uy * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 4; i++)
+    hess[i] = 0;
+
+  hess[0] = -u_x * sin(kx * x) * kx * kx;
+  hess[3] = -u_y * cos(ky * y) * ky * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_grad_v(Scalar x,Scalar y,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_vx * pi / L;
+  const Scalar ky = a_vy * pi / L;
+
+  grad[0] = -v_x * sin(kx * x) * kx;
+  grad[1] =  v_y * cos(ky * y) * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_hess_v(Scalar x,Scalar y,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_vx * pi / L;
+  const Scalar ky = a_vy * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 4; i++)
+    hess[i] = 0;
+
+  hess[0] = -v_x * cos(kx * x) * kx * kx;
+  hess[3] = -v_y * sin(ky * y) * ky * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_grad_p(Scalar x,Scalar y,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_px * pi / L;
+  const Scalar ky = a_py * pi / L;
+
+  grad[0] = -p_x * sin(kx * x) * kx;
+  grad[1] =  p_y * cos(ky * y) * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_hess_p(Scalar x,Scalar y,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_px * pi / L;
+  const Scalar ky = a_py * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 4; i++)
+    hess[i] = 0;
+
+  hess[0] = -p_x * cos(kx * x) * kx * kx;
+  hess[3] = -p_y * sin(ky * y) * ky * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_grad_rho(Scalar x,Scalar y,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_rhox * pi / L;
+  const Scalar ky = a_rhoy * pi / L;
+
+  grad[0] =  rho_x * cos(kx * x) * kx;
+  grad[1] = -rho_y * sin(ky * y) * ky;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_2d_compressible<Scalar>::eval_hess_rho(Scalar x,Scalar y,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_rhox * pi / L;
+  const Scalar ky = a_rhoy * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 4; i++)
+    hess[i] = 0;
+
+  hess[0] = -rho_x * sin(kx * x) * kx * kx;
+  hess[3] = -rho_y * cos(ky * y) * ky * ky;
+
+  return 0;
+}
+
 // ----------------------------------------
 //   Analytical Solutions
 // ----------------------------------------
@@ -691,6 +831,200 @@ Scalar MASA::navierstokes_3d_compressible<Scalar>::eval_g_rho(Scalar x,Scalar y,
 
 }
 
+// ----------------------------------------
+//   Full Gradient and Hessian of Analytical Solutions
+// ----------------------------------------
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_grad_u(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_ux * pi / L;
+  const Scalar ky = a_uy * pi / L;
+  const Scalar kz = a_uz * pi / L;
+
+  grad[0] =  u_x * cos(kx * x) * kx;
+  grad[1] = -u_y * sin(ky * y) * ky;
+  grad[2] = -u_z * sin(kz * z) * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_hess_u(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_ux * pi / L;
+  const Scalar ky = a_uy * pi / L;
+  const Scalar kz = a_uz * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 9; i++)
+    hess[i] = 0;
+
+  hess[0] = -u_x * sin(kx * x) * kx * kx;
+  hess[4] = -u_y * cos(ky * y) * ky * ky;
+  hess[8] = -u_z * cos(kz * z) * kz * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_grad_v(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_vx * pi / L;
+  const Scalar ky = a_vy * pi / L;
+  const Scalar kz = a_vz * pi / L;
+
+  grad[0] = -v_x * sin(kx * x) * kx;
+  grad[1] =  v_y * cos(ky * y) * ky;
+  grad[2] =  v_z * cos(kz * z) * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_hess_v(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_vx * pi / L;
+  const Scalar ky = a_vy * pi / L;
+  const Scalar kz = a_vz * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 9; i++)
+    hess[i] = 0;
+
+  hess[0] = -v_x * cos(kx * x) * kx * kx;
+  hess[4] = -v_y * sin(ky * y) * ky * ky;
+  hess[8] = -v_z * sin(kz * z) * kz * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_grad_w(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_wx * pi / L;
+  const Scalar ky = a_wy * pi / L;
+  const Scalar kz = a_wz * pi / L;
+
+  grad[0] =  w_x * cos(kx * x) * kx;
+  grad[1] =  w_y * cos(ky * y) * ky;
+  grad[2] = -w_z * sin(kz * z) * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_hess_w(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_wx * pi / L;
+  const Scalar ky = a_wy * pi / L;
+  const Scalar kz = a_wz * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 9; i++)
+    hess[i] = 0;
+
+  hess[0] = -w_x * sin(kx * x) * kx * kx;
+  hess[4] = -w_y * sin(ky * y) * ky * ky;
+  hess[8] = -w_z * cos(kz * z) * kz * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_grad_p(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_px * pi / L;
+  const Scalar ky = a_py * pi / L;
+  const Scalar kz = a_pz * pi / L;
+
+  grad[0] = -p_x * sin(kx * x) * kx;
+  grad[1] =  p_y * cos(ky * y) * ky;
+  grad[2] = -p_z * sin(kz * z) * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_hess_p(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_px * pi / L;
+  const Scalar ky = a_py * pi / L;
+  const Scalar kz = a_pz * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 9; i++)
+    hess[i] = 0;
+
+  hess[0] = -p_x * cos(kx * x) * kx * kx;
+  hess[4] = -p_y * sin(ky * y) * ky * ky;
+  hess[8] = -p_z * cos(kz * z) * kz * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_grad_rho(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_rhox * pi / L;
+  const Scalar ky = a_rhoy * pi / L;
+  const Scalar kz = a_rhoz * pi / L;
+
+  grad[0] =  rho_x * cos(kx * x) * kx;
+  grad[1] = -rho_y * sin(ky * y) * ky;
+  grad[2] =  rho_z * cos(kz * z) * kz;
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_3d_compressible<Scalar>::eval_hess_rho(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  using std::sin;
+  using std::cos;
+
+  const Scalar kx = a_rhox * pi / L;
+  const Scalar ky = a_rhoy * pi / L;
+  const Scalar kz = a_rhoz * pi / L;
+
+  // the solution is a sum of one-dimensional terms: no cross derivatives
+  for(int i = 0; i < 9; i++)
+    hess[i] = 0;
+
+  hess[0] = -rho_x * sin(kx * x) * kx * kx;
+  hess[4] = -rho_y * cos(ky * y) * ky * ky;
+  hess[8] = -rho_z * sin(kz * z) * kz * kz;
+
+  return 0;
+}
+
 // ----------------------------------------
 //   Source Terms
 // ----------------------------------------
@@ -817,5 +1151,7 @@ Scalar MASA::navierstokes_3d_compressible<Scalar>::eval_exact_rho(Scalar x,Scala
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cns
 MASA_INSTANTIATE_ALL(MASA::navierstokes_2d_compressible);
 MASA_INSTANTIATE_ALL(MASA::navierstokes_3d_compressible);
+#endif
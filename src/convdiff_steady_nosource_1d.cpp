@@ -106,7 +106,9 @@ Scalar MASA::convdiff_steady_nosource_1d<Scalar>::eval_exact_u(Scalar x)
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_convdiff_steady_nosource_1d
 MASA_INSTANTIATE_ALL(MASA::convdiff_steady_nosource_1d);
+#endif
 
 
 
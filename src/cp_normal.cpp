@@ -225,4 +225,6 @@ Scalar MASA::cp_normal<Scalar>::eval_post_var()
 //   Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::cp_normal);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cp_normal
+MASA_INSTANTIATE_SCALARS(MASA::cp_normal);
+#endif
@@ -0,0 +1,678 @@
+#!/usr/bin/env perl
+# --------------------------------------------------------------------
+# Common subexpression elimination for the Maple generated source
+# terms of the MASA solutions.
+#
+# The eval_q_* functions were pasted from Maple as single expressions
+# that recompute the same sin/cos factors and products many times and
+# square values with pow(). This script reads each function, builds
+# the expression DAG of its straight line statements, and writes it
+# back with every repeated subexpression held in a const temporary.
+# The operations keep their original order and grouping, so the
+# results are bit for bit those of the Maple expressions. A sin and a
+# cos of the same point dependent angle are computed together by
+# masa_sincos(), which shares the range reduction between them and
+# returns the same values as the two calls.
+#
+# Subexpressions of the parameters alone (a_ux * pi, Gamma - 1,
+# pow(L, -2), ...) are folded out of the per point work into the
+# solution's derived constants: the rewritten constructor sizes their
+# block and hands the solution the function that computes them, which
+# runs again whenever set_var, copy_var, ... change the parameters, so
+# the rewritten terms only read them. Only members the solution
+# registers with register_var count as parameters, as those are what
+# set_var changes. A parameter factor applied after a point dependent
+# one (the "* pi / L" of sin(a_ux * pi * x / L) * a_ux * pi / L) stays
+# in the per point work: folding it would regroup the products and
+# change the rounding.
+#
+# With --powers, pow() with a small integer exponent is expanded to
+# products as well. The libm pow() is not correctly rounded, so this
+# changes the last bits of some results (by about an ulp of the
+# terms summed up).
+#
+# Functions that are not plain assignments of +,-,*,/ and calls to
+# the <cmath> functions (loops, branches, AD types) are left alone.
+#
+# Usage: masa_cse.pl [-S dir] [--powers] SOURCE-FILES...
+#        writes NAME_cse.cpp to the current directory for every
+#        NAME.cpp, touching it only when the contents change
+#
+#        masa_cse.pl --check [-S dir] [--powers] SOURCE-FILES...
+#        prints a header holding the original and rewritten form of
+#        every converted function, for tests/cse.cpp
+#
+#        with MASA_CSE_VERBOSE set in the environment, the reason each
+#        function was left alone goes to stderr
+# --------------------------------------------------------------------
+
+use strict;
+use File::Basename;
+use File::Compare;
+use Getopt::Long;
+
+my @opt_S;
+my $opt_check = 0;
+my $opt_powers = 0;
+my $max_power = 8;
+
+GetOptions("S=s" => \@opt_S, "check" => \$opt_check, "powers" => \$opt_powers) || die "Error using GetOptions";
+
+if (@ARGV < 1) {
+    print "\nUsage: masa_cse.pl [OPTION] SOURCE-FILES...\n\n";
+    print "OPTIONS:\n";
+    print "  -S dir               use dir as location of source-files\n";
+    print "  --check              print the original/rewritten pairs for the tests\n";
+    print "  --powers             multiply out integer powers\n";
+    print "\n";
+    exit 0;
+}
+
+# the pure functions a source term may call
+my %math = map { $_ => 1 } qw(sin cos tan asin acos atan atan2 sinh cosh tanh
+                              exp log log10 sqrt pow fabs abs erf);
+
+my %keywords = map { $_ => 1 } qw(Scalar std using return const);
+
+# ------------------------------------------------------------------
+# expression DAG: nodes are hash consed, so structurally equal
+# subexpressions share one node
+# ------------------------------------------------------------------
+
+my (@kind, @text, @kids, %lookup);
+my (%params, %uniform);
+
+sub node {
+    my ($k, $t, @c) = @_;
+    my $key = join("\0", $k, $t, @c);
+    return $lookup{$key} if exists $lookup{$key};
+    push(@kind, $k);
+    push(@text, $t);
+    push(@kids, [@c]);
+    return $lookup{$key} = $#kind;
+}
+
+sub reset_dag {
+    @kind = (); @text = (); @kids = (); %lookup = (); %uniform = ();
+}
+
+# value of an integer constant node (Scalar(2), 0.2e1, -Scalar(2), ...)
+sub integer_value {
+    my ($n) = @_;
+    if ($kind[$n] eq 'num') {
+        my $v = $text[$n];
+        $v =~ s/[fFlL]$//;
+        return undef unless $v =~ /^(\d+\.?\d*|\.\d+)([eE][-+]?\d+)?$/;
+        $v = $v + 0;
+        return (($v == int($v)) ? int($v) : undef);
+    }
+    if ($kind[$n] eq 'cast') {
+        return integer_value($kids[$n][0]);
+    }
+    if ($kind[$n] eq 'neg') {
+        my $v = integer_value($kids[$n][0]);
+        return (defined($v) ? -$v : undef);
+    }
+    return undef;
+}
+
+# subexpressions of the parameters alone: members registered as
+# parameters, by class, pi and numbers
+sub parameters_only {
+    my ($n, $class) = @_;
+    return $uniform{$n} if exists $uniform{$n};
+    my $u = 1;
+    if ($kind[$n] eq 'id') {
+        $u = ($text[$n] eq 'pi' || $text[$n] eq 'PI' || $params{$class}{$text[$n]}) ? 1 : 0;
+    }
+    foreach my $c (@{$kids[$n]}) {
+        $u = 0 unless parameters_only($c, $class);
+    }
+    return $uniform{$n} = $u;
+}
+
+sub constant_only {
+    my ($n) = @_;
+    return 1 if $kind[$n] eq 'num';
+    return 0 if $kind[$n] eq 'id' || $kind[$n] eq 'call';
+    foreach my $c (@{$kids[$n]}) {
+        return 0 unless constant_only($c);
+    }
+    return 1;
+}
+
+# b^n as products, squaring the halves: b*b, b*b*b, (b*b)*(b*b), ...
+sub power {
+    my ($b, $n) = @_;
+    return $b if $n == 1;
+    if ($n % 2 == 0) {
+        my $h = power($b, $n / 2);
+        return node('bin', '*', $h, $h);
+    }
+    return node('bin', '*', power($b, $n - 1), $b);
+}
+
+sub make_call {
+    my ($f, @args) = @_;
+    (my $name = $f) =~ s/^std:://;
+    if ($opt_powers && $name eq 'pow' && @args == 2) {
+        my $n = integer_value($args[1]);
+        if (defined($n) && abs($n) <= $max_power) {
+            return node('cast', 'Scalar', node('num', '1')) if $n == 0;
+            return power($args[0], $n) if $n > 0;
+            return node('bin', '/', node('cast', 'Scalar', node('num', '1')), power($args[0], -$n));
+        }
+    }
+    return node('call', $f, @args);
+}
+
+# ------------------------------------------------------------------
+# parser for the statements of a function body
+# ------------------------------------------------------------------
+
+my (@tok, $pos, %local, %used_ids);
+
+sub peek { return $pos < @tok ? $tok[$pos] : ''; }
+
+sub expect {
+    my ($t) = @_;
+    die "expected '$t'\n" unless peek() eq $t;
+    $pos++;
+}
+
+sub parse_expr {
+    my $n = parse_term();
+    while (peek() eq '+' || peek() eq '-') {
+        my $op = $tok[$pos++];
+        $n = node('bin', $op, $n, parse_term());
+    }
+    return $n;
+}
+
+sub parse_term {
+    my $n = parse_unary();
+    while (peek() eq '*' || peek() eq '/') {
+        my $op = $tok[$pos++];
+        $n = node('bin', $op, $n, parse_unary());
+    }
+    return $n;
+}
+
+sub parse_unary {
+    if (peek() eq '-') {
+        $pos++;
+        return node('neg', '-', parse_unary());
+    }
+    if (peek() eq '+') {
+        $pos++;
+        return parse_unary();
+    }
+    return parse_primary();
+}
+
+sub parse_primary {
+    my $t = peek();
+    $pos++;
+
+    if ($t eq '(') {
+        my $n = parse_expr();
+        expect(')');
+        return $n;
+    }
+    if ($t =~ /^(\d|\.\d)/) {
+        return node('num', $t);
+    }
+    if ($t eq 'Scalar') {
+        expect('(');
+        my $n = parse_expr();
+        expect(')');
+        # a cast of a Scalar valued expression is a copy
+        return constant_only($n) ? node('cast', 'Scalar', $n) : $n;
+    }
+    if ($t =~ /^(std::)?[A-Za-z_]\w*$/) {
+        if (peek() eq '(') {
+            (my $name = $t) =~ s/^std:://;
+            die "call to $t\n" unless $math{$name};
+            $pos++;
+            my @args = (parse_expr());
+            while (peek() eq ',') {
+                $pos++;
+                push(@args, parse_expr());
+            }
+            expect(')');
+            return make_call($t, @args);
+        }
+        die "unexpected $t\n" if $t =~ /::/ || $keywords{$t};
+        if (exists $local{$t}) {
+            die "$t used before it is set\n" unless defined $local{$t};
+            return $local{$t};
+        }
+        $used_ids{$t} = 1;
+        return node('id', $t);
+    }
+    die "unexpected '$t'\n";
+}
+
+sub tokenize {
+    my ($s) = @_;
+    my @t;
+    while ($s =~ /\G\s*(std::\w+|[A-Za-z_]\w*|(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?[fFlL]?|[-+*\/]=|\S)/gc) {
+        push(@t, $1);
+    }
+    return @t;
+}
+
+# Parse the body into a DAG; returns (root, [using lines]) or dies
+sub parse_body {
+    my ($body, @args) = @_;
+
+    $body =~ s{/\*.*?\*/}{}gs;
+    $body =~ s{//[^\n]*}{}g;
+
+    %local = ();
+    %used_ids = ();
+    my %is_arg = map { $_ => 1 } @args;
+    my @using;
+    my $root;
+
+    foreach my $stmt (split(/;/, $body)) {
+        next if $stmt =~ /^\s*$/;
+        die "statement after return\n" if defined $root;
+        die "control flow\n" if $stmt =~ /[{}]/;
+
+        @tok = tokenize($stmt);
+        $pos = 0;
+
+        if ($tok[0] eq 'using') {
+            die "using $tok[1]\n" unless @tok == 2 && $tok[1] =~ /^std::(\w+)$/ && $math{$1};
+            push(@using, $tok[1]);
+            next;
+        }
+        if ($tok[0] eq 'return') {
+            $pos = 1;
+            $root = parse_expr();
+            die "trailing tokens\n" if $pos < @tok;
+            next;
+        }
+
+        my $declare = 0;
+        if ($tok[0] eq 'const') {
+            $pos++;
+            die "const without Scalar\n" unless peek() eq 'Scalar';
+        }
+        if (peek() eq 'Scalar' && $pos + 1 < @tok && $tok[$pos + 1] =~ /^[A-Za-z_]\w*$/) {
+            $declare = 1;
+            $pos++;
+        }
+
+        while (1) {
+            my $name = peek();
+            die "bad statement\n" unless $name =~ /^[A-Za-z_]\w*$/ && !$keywords{$name} && !$is_arg{$name};
+            die "assignment to $name\n" unless $declare || exists $local{$name};
+            $pos++;
+            if (peek() eq '=') {
+                $pos++;
+                my $value = parse_expr();
+                $local{$name} = $value;
+            } elsif (peek() =~ /^([-+*\/])=$/) {
+                die "$name used before it is set\n" unless defined $local{$name};
+                my $op = $1;
+                $pos++;
+                $local{$name} = node('bin', $op, $local{$name}, parse_expr());
+            } else {
+                die "$name redeclared\n" if exists $local{$name};
+                $local{$name} = undef;
+            }
+            last if $pos >= @tok;
+            die "bad statement\n" unless $declare && peek() eq ',';
+            $pos++;
+        }
+    }
+
+    die "no return\n" unless defined $root;
+    return ($root, \@using);
+}
+
+# ------------------------------------------------------------------
+# code generation
+# ------------------------------------------------------------------
+
+my %prec = ('+' => 1, '-' => 1, '*' => 2, '/' => 2);
+
+my (%temp, %folded);
+my $member = "";   # prefix of the identifiers, "s." in the constructor code
+
+sub precedence {
+    my ($n) = @_;
+    return 4 if exists $temp{$n};
+    return $prec{$text[$n]} if $kind[$n] eq 'bin';
+    return 3 if $kind[$n] eq 'neg';
+    return 4;
+}
+
+sub emit {
+    my ($n, $top) = @_;
+    return $temp{$n} if exists $temp{$n} && !$top;
+
+    my $k = $kind[$n];
+    return $text[$n] if $k eq 'num';
+    return "$member$text[$n]" if $k eq 'id';
+
+    my @c = @{$kids[$n]};
+    if ($k eq 'cast') {
+        return "Scalar(" . emit($c[0]) . ")";
+    }
+    if ($k eq 'call') {
+        return "$text[$n](" . join(", ", map { emit($_) } @c) . ")";
+    }
+    if ($k eq 'neg') {
+        my $s = emit($c[0]);
+        return "-" . (precedence($c[0]) <= 3 ? "($s)" : $s);
+    }
+
+    # binary operators group left to right, so the right operand
+    # needs parentheses at equal precedence
+    my $p = $prec{$text[$n]};
+    my $l = emit($c[0]);
+    my $r = emit($c[1]);
+    $l = "($l)" if precedence($c[0]) < $p;
+    $r = "($r)" if precedence($c[1]) <= $p;
+    return "$l $text[$n] $r";
+}
+
+# The same expression with every term counted positive (divisors
+# are taken as they are): the scale of the rounding error of the
+# expression, which the tests measure the rewrite against
+sub emit_magnitude {
+    my ($n, $top) = @_;
+    return "std::fabs($folded{$n})" if exists $folded{$n} && !$top;
+    return "abs_$temp{$n}" if exists $temp{$n} && !$top;
+
+    my $k = $kind[$n];
+    my @c = @{$kids[$n]};
+    return $text[$n] if $k eq 'num';
+    return "std::fabs(" . emit($n, $top) . ")" if $k eq 'id' || $k eq 'cast' || $k eq 'call';
+    return emit_magnitude($c[0]) if $k eq 'neg';
+
+    my $l = emit_magnitude($c[0]);
+    return "($l / std::fabs(" . emit($c[1]) . "))" if $text[$n] eq '/';
+    my $op = $text[$n] eq '*' ? '*' : '+';
+    return "($l $op " . emit_magnitude($c[1]) . ")";
+}
+
+my @temp_order;
+
+# Rewritten body for a parsed DAG, the number of derived constants it
+# reads from offset on, and the code computing them: for the
+# constructor (parameters read from the instance s) and for the checks
+sub generate {
+    my ($root, $using, $class, $offset, @reserved) = @_;
+
+    my %refs;
+    my @order;
+    my %seen;
+
+    # post order walk: operands before their users
+    my $walk;
+    $walk = sub {
+        my ($n) = @_;
+        $refs{$n}++;
+        return if $seen{$n}++;
+        $walk->($_) foreach @{$kids[$n]};
+        push(@order, $n);
+    };
+    $walk->($root);
+
+    my %taken = map { $_ => 1 } @reserved;
+    my $count = 0;
+    %temp = ();
+    %folded = ();
+    @temp_order = ();
+
+    my $out = "";
+    $out .= "  using $_;\n" foreach @$using;
+    $out .= "\n" if @$using;
+
+    # the largest subexpressions of the parameters alone, those read by
+    # a point dependent one, are derived constants
+    my %feeds;
+    foreach my $n (@order) {
+        next if parameters_only($n, $class);
+        $feeds{$_} = 1 foreach @{$kids[$n]};
+    }
+    my @derived = grep { ($feeds{$_} || $_ == $root) && parameters_only($_, $class) &&
+                         $kind[$_] ne 'num' && $kind[$_] ne 'id' && !constant_only($_) } @order;
+    my ($fill, $check_fill) = ("", "");
+    if (@derived) {
+        my $block = "derived";
+        $block .= "_" while $taken{$block};
+        $out .= "  const Scalar* const $block = this->derived_constants($offset);\n\n";
+
+        my @lines;
+        foreach my $prefix ("s.", "") {
+            $member = $prefix;
+            my %saved = %temp;
+            for (my $i = 0; $i != @derived; $i++) {
+                push(@{$lines[$i]}, emit($derived[$i], 1));
+                $temp{$derived[$i]} = "$block\[$i\]";
+            }
+            %temp = %saved;
+        }
+        $member = "";
+
+        my $uses = join("", map { "        using $_;\n" } @$using);
+        $fill = "      {\n$uses        Scalar* const $block = constants + $offset;\n";
+        $check_fill = "    {\n" . join("", map { "      using $_;\n" } @$using) . "      Scalar* const $block = &derived_block[0];\n";
+        for (my $i = 0; $i != @derived; $i++) {
+            $fill .= "        $block\[$i\] = $lines[$i][0];\n";
+            $check_fill .= "      $block\[$i\] = $lines[$i][1];\n";
+            $temp{$derived[$i]} = $folded{$derived[$i]} = "$block\[$i\]";
+        }
+        $fill .= "      }\n";
+        $check_fill .= "    }\n";
+    }
+
+    # sin and cos of the same point dependent angle come from one
+    # masa_sincos, sharing the range reduction
+    my (%sine, %cosine, %pair);
+    foreach my $n (@order) {
+        next if $kind[$n] ne 'call' || $n == $root || parameters_only($n, $class);
+        (my $f = $text[$n]) =~ s/^std:://;
+        $sine{$kids[$n][0]} = $n if $f eq 'sin';
+        $cosine{$kids[$n][0]} = $n if $f eq 'cos';
+    }
+    foreach my $a (keys %sine) {
+        $pair{$sine{$a}} = $pair{$cosine{$a}} = $a if exists $cosine{$a};
+    }
+
+    foreach my $n (@order) {
+        if (exists $pair{$n}) {
+            my $a = $pair{$n};
+            next if exists $temp{$n};
+            my ($s, $c);
+            do { $s = "cse" . ++$count; } while $taken{$s};
+            do { $c = "cse" . ++$count; } while $taken{$c};
+            $out .= "  Scalar $s, $c;\n";
+            $out .= "  masa_sincos(" . emit($a) . ", $s, $c);\n";
+            $temp{$sine{$a}} = $s;
+            $temp{$cosine{$a}} = $c;
+            push(@temp_order, $sine{$a}, $cosine{$a});
+            next;
+        }
+        next if $n == $root || $refs{$n} < 2;
+        next if $kind[$n] eq 'num' || $kind[$n] eq 'id' || constant_only($n);
+        next if parameters_only($n, $class);
+        my $name;
+        do { $name = "cse" . ++$count; } while $taken{$name};
+        $out .= "  const Scalar $name = " . emit($n, 1) . ";\n";
+        $temp{$n} = $name;
+        push(@temp_order, $n);
+    }
+
+    $out .= "  return " . (exists $folded{$root} ? $folded{$root} : emit($root, 1)) . ";";
+    return ($out, scalar(@derived), $fill, $check_fill);
+}
+
+# Constructor code sizing the derived constants of class and naming
+# the function computing them, which set_var and the other parameter
+# setters call again
+sub derive_call {
+    my ($class, $count, $fill) = @_;
+    my $out = "\n\n  // constants the source terms derive from the parameters alone\n";
+    $out .= "  this->use_derived_constants($count, [](MASA::manufactured_solution<Scalar>& ms)\n    {\n";
+    $out .= "      MASA::$class<Scalar>& s = static_cast<MASA::$class<Scalar>&>(ms);\n";
+    $out .= "      Scalar* const constants = &s.derived_block[0];\n";
+    $out .= $fill;
+    $out .= "    });";
+    return $out;
+}
+
+# ------------------------------------------------------------------
+# source files
+# ------------------------------------------------------------------
+
+my @checks;
+my ($converted, $total, $folds) = (0, 0, 0);
+my (%offsets, %fills);   # derived constants taken and the code computing them, by class
+
+foreach my $file (@ARGV) {
+    my $infile = @opt_S ? "$opt_S[0]/$file" : $file;
+    open(my $IN, "<$infile") || die "Cannot open $infile\n";
+    my $src = do { local $/; <$IN> };
+    close($IN);
+
+    # the parameters each constructor registers
+    while ($src =~ /MASA::(\w+)<Scalar>::\1\(\)\s*\{(.*?)\n\}/gs) {
+        my ($class, $body) = ($1, $2);
+        $params{$class}{$1} = 1 while $body =~ /register_var\(\s*"[^"]*"\s*,\s*&(\w+)\s*\)/g;
+    }
+    pos($src) = 0;
+
+    my $out = "";
+    while ($src =~ /(template\s*<typename Scalar>\s*\n)Scalar MASA::(\w+)<Scalar>::(eval_q_\w+)\(([^)]*)\)[ \t]*\n\{\n(.*?)\n\}\n/gs) {
+        my ($class, $fn, $arglist, $body) = ($2, $3, $4, $5);
+        my $start = $-[5];
+        my $end = $+[5];
+        my @args = map { /(\w+)\s*$/ ? $1 : () } split(/,/, $arglist);
+        $total++;
+
+        reset_dag();
+        my ($root, $using) = eval { parse_body($body, @args) };
+        print STDERR "${class}::$fn: $@" if $ENV{MASA_CSE_VERBOSE} && !defined $root;
+        next unless defined $root;
+
+        my @reserved = (keys %used_ids, keys %local, @args);
+        my $offset = $offsets{$class} || 0;
+        my ($rewritten, $derived, $fill, $check_fill) = generate($root, $using, $class, $offset, @reserved);
+        $converted++;
+        if ($derived) {
+            $offsets{$class} = $offset + $derived;
+            $fills{$class} .= $fill;
+            $folds++;
+        }
+
+        my $magnitude = "";
+        foreach my $n (@temp_order) {
+            $magnitude .= "  const Scalar abs_$temp{$n} = " . emit_magnitude($n, 1) . ";\n";
+        }
+        $magnitude .= "  return " . emit_magnitude($root, 1) . ";";
+        (my $cse_temps = $rewritten) =~ s/\n  return [^\n]*$/\n/;
+
+        $out .= substr($src, 0, $start) . $rewritten;
+        $src = substr($src, $end);
+        pos($src) = 0;
+
+        push(@checks, { class => $class, fn => $fn, args => [@args],
+                        ids => [sort grep { my $i = $_; !grep { $_ eq $i } @args } keys %used_ids],
+                        original => $body, cse => $rewritten, derive => $check_fill, count => $derived,
+                        magnitude => $cse_temps . $magnitude });
+    }
+    $out .= $src;
+
+    # the constructors hand their solution the code computing its
+    # derived constants
+    $out =~ s{(MASA::(\w+)<Scalar>::\2\(\)\s*\{.*?)(\n\})}{
+        my ($ctor, $class, $close) = ($1, $2, $3);
+        $ctor =~ s/\s*$// if exists $fills{$class};
+        $ctor . (exists $fills{$class} ? derive_call($class, $offsets{$class}, $fills{$class}) : "") . $close;
+    }gse;
+
+    next if $opt_check;
+
+    my $base = basename($file, ".cpp");
+    my $outfile = "${base}_cse.cpp";
+    my $text = "// generated from $base.cpp by cse_utils/masa_cse.pl -- do not edit\n"
+             . $out;
+
+    # keep the timestamp of unchanged files, so make does not
+    # recompile them
+    my $tmp = "$outfile.tmp";
+    open(my $OUT, ">$tmp") || die "Cannot create $tmp\n";
+    print $OUT $text;
+    close($OUT);
+    if (-e $outfile && compare($tmp, $outfile) == 0) {
+        unlink($tmp);
+    } else {
+        rename($tmp, $outfile) || die "Cannot create $outfile\n";
+    }
+}
+
+if (!$opt_check) {
+    print "masa_cse.pl: rewrote $converted of $total source terms, $folds with derived constants\n";
+    exit 0;
+}
+
+print "// generated by cse_utils/masa_cse.pl -- do not edit\n";
+print "//\n";
+print "// Every source term masa_cse.pl rewrites, as its original Maple\n";
+print "// expression (maple) and as compiled into libmasa (cse), with the\n";
+print "// members it reads as plain Scalar fields. magnitude() is the\n";
+print "// expression with all its terms added up positive.\n\n";
+print "#include <masa_math.h>\n\n";
+print "namespace masa_cse_check {\n\n";
+
+# without --powers the rewritten terms are exact
+print "const bool exact = " . ($opt_powers ? "false" : "true") . ";\n\n";
+
+# the library sees the <cmath> overloads and masa_sincos (masa_internal.h)
+print "using std::$_;\n" foreach sort keys %math;
+print "using MASA::masa_sincos;\n";
+print "\n";
+
+my @names;
+foreach my $c (@checks) {
+    my $name = "$c->{class}_$c->{fn}";
+    my $params = join(",", map { "Scalar $_" } @{$c->{args}});
+    my $dims = scalar(@{$c->{args}});
+    push(@names, $name);
+
+    print "template <typename Scalar>\n";
+    print "struct $name\n{\n";
+    print "  static const char* name() { return \"$c->{class}::$c->{fn}\"; }\n";
+    print "  static const unsigned int dims = $dims;\n\n";
+    print "  Scalar $_;\n" foreach @{$c->{ids}};
+    if ($c->{derive}) {
+        print "\n  // derived constants, computed on every call\n";
+        print "  std::vector<Scalar> derived_block;\n";
+        print "  const Scalar* derived_constants(std::size_t)\n  {\n";
+        print "    derived_block.resize($c->{count});\n$c->{derive}";
+        print "    return &derived_block[0];\n  }\n";
+    }
+    print "\n  void members(std::vector<Scalar*>& m)\n  {\n";
+    print "    m.push_back(&$_);\n" foreach @{$c->{ids}};
+    print "  }\n\n";
+    print "  Scalar maple($params)\n  {\n$c->{original}\n  }\n\n";
+    print "  Scalar cse($params)\n  {\n$c->{cse}\n  }\n\n";
+    print "  Scalar magnitude($params)\n  {\n$c->{magnitude}\n  }\n";
+    my $call = join(",", map { "p[$_]" } (0 .. $dims - 1));
+    print "\n  Scalar maple(const Scalar* p) { return maple($call); }\n";
+    print "  Scalar cse(const Scalar* p) { return cse($call); }\n";
+    print "  Scalar magnitude(const Scalar* p) { return magnitude($call); }\n";
+    print "};\n\n";
+}
+
+print "template <typename Scalar, typename Tester>\n";
+print "void check_all(Tester& t)\n{\n";
+print "  { $_<Scalar> c; t(c); }\n" foreach @names;
+print "}\n\n";
+print "} // end namespace masa_cse_check\n";
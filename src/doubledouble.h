@@ -0,0 +1,932 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// doubledouble.h: an unevaluated sum of two doubles, carrying about
+//                 106 bits of significand with hardware double arithmetic
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#ifndef __doubledouble_h__
+#define __doubledouble_h__
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+// The generated source terms repeat their subexpressions dozens of
+// times (sin(a_ux * pi * x / L), ...), and rely on the compiler to
+// merge them as it does for the builtin types.  That takes arithmetic
+// inlined however large the expression; the elementary functions the
+// compiler cannot merge: these are out of line, and take and return
+// their pairs in registers (see packed below), so each repeat costs a
+// call and a full evaluation.
+#ifdef __GNUC__
+#define DOUBLEDOUBLE_INLINE   inline __attribute__((always_inline))
+#define DOUBLEDOUBLE_FUNCTION __attribute__((noinline))
+#else
+#define DOUBLEDOUBLE_INLINE   inline
+#define DOUBLEDOUBLE_FUNCTION
+#endif
+
+// A value hi + lo with |lo| <= ulp(hi)/2, after the algorithms of
+// Dekker, Knuth and the QD library of Hida, Li and Bailey.  It is a
+// drop in Scalar for the solution templates (masa_init<DoubleDouble>,
+// ...), for a reference precision of about 32 digits where long double
+// is only marginally wider than double.  It is a precision option, not
+// a fast path: every operation costs several double operations, and
+// every elementary function a full evaluation.
+//
+// Every operation rounds to within a few units of 2^-104 relative;
+// the range and the handling of overflow are those of double.
+
+class DoubleDouble
+{
+public:
+  DoubleDouble() : _hi(0), _lo(0) {}
+
+  DoubleDouble(double hi) : _hi(hi), _lo(0) {}
+
+  DoubleDouble(float hi) : _hi(hi), _lo(0) {}
+
+  DoubleDouble(int hi) : _hi(hi), _lo(0) {}
+
+  DoubleDouble(unsigned int hi) : _hi(hi), _lo(0) {}
+
+  DoubleDouble(long hi) : _hi(static_cast<double>(hi)),
+                          _lo(static_cast<double>(hi - static_cast<long>(_hi))) {}
+
+  DoubleDouble(unsigned long hi) : _hi(static_cast<double>(hi)),
+                                   _lo(static_cast<double>(static_cast<long>(hi - static_cast<unsigned long>(_hi)))) {}
+
+  DoubleDouble(long double a) : _hi(static_cast<double>(a)),
+                                _lo(static_cast<double>(a - static_cast<long double>(_hi))) {}
+
+  // no normalization: hi and lo must already be a valid pair
+  DoubleDouble(double hi, double lo) : _hi(hi), _lo(lo) {}
+
+  double hi() const { return _hi; }
+
+  double lo() const { return _lo; }
+
+  explicit operator double() const { return _hi; }
+
+  explicit operator float() const { return static_cast<float>(_hi); }
+
+  explicit operator long double() const
+    { return static_cast<long double>(_hi) + static_cast<long double>(_lo); }
+
+  // truncated toward zero, like the builtin conversions
+  explicit operator int() const
+    {
+      double t = std::trunc(_hi);
+      if(t == _hi)
+        {
+          if(_hi > 0.0 && _lo < 0.0)
+            t -= 1.0;
+          else if(_hi < 0.0 && _lo > 0.0)
+            t += 1.0;
+        }
+      return static_cast<int>(t);
+    }
+
+  DoubleDouble operator- () const { return DoubleDouble(-_hi, -_lo); }
+
+  DoubleDouble& operator+= (const DoubleDouble& a);
+  DoubleDouble& operator+= (double a);
+  DoubleDouble& operator-= (const DoubleDouble& a) { return *this += -a; }
+  DoubleDouble& operator-= (double a) { return *this += -a; }
+  DoubleDouble& operator*= (const DoubleDouble& a);
+  DoubleDouble& operator*= (double a);
+  DoubleDouble& operator/= (const DoubleDouble& a);
+  DoubleDouble& operator/= (double a);
+
+  //
+  // error free transformations of doubles
+  //
+
+  // s + e == a + b exactly
+  static DOUBLEDOUBLE_INLINE double two_sum(double a, double b, double& e)
+    {
+      double s = a + b;
+      double bb = s - a;
+      e = (a - (s - bb)) + (b - bb);
+      return s;
+    }
+
+  // the same when |a| >= |b|
+  static DOUBLEDOUBLE_INLINE double quick_two_sum(double a, double b, double& e)
+    {
+      double s = a + b;
+      e = b - (s - a);
+      return s;
+    }
+
+  // p + e == a * b exactly
+  static DOUBLEDOUBLE_INLINE double two_prod(double a, double b, double& e)
+    {
+      double p = a * b;
+#ifdef FP_FAST_FMA
+      e = std::fma(a, b, -p);
+#else
+      double ah, al, bh, bl;
+      split(a, ah, al);
+      split(b, bh, bl);
+      e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+      return p;
+    }
+
+  // (hi, lo) - a * q, for the division
+  static DOUBLEDOUBLE_INLINE double remainder(double hi, double lo, const DoubleDouble& a, double q, double& e)
+    {
+      double p2;
+      double p1 = two_prod(a._hi, q, p2);
+      p2 += a._lo * q;
+      p1 = quick_two_sum(p1, p2, p2);
+
+      double s2, t2;
+      double s1 = two_sum(hi, -p1, s2);
+      double t1 = two_sum(lo, -p2, t2);
+      s2 += t1;
+      s1 = quick_two_sum(s1, s2, s2);
+      s2 += t2;
+      return quick_two_sum(s1, s2, e);
+    }
+
+  // hi + lo == a, with 26 significant bits in each
+  static DOUBLEDOUBLE_INLINE void split(double a, double& hi, double& lo)
+    {
+      const double splitter = 134217729.0;   // 2^27 + 1
+      double t = splitter * a;
+      hi = t - (t - a);
+      lo = a - hi;
+    }
+
+private:
+  double _hi;
+  double _lo;
+};
+
+
+
+//
+// arithmetic
+//
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator+= (const DoubleDouble& a)
+{
+  double s2, t2;
+  double s1 = two_sum(_hi, a._hi, s2);
+  double t1 = two_sum(_lo, a._lo, t2);
+  s2 += t1;
+  s1 = quick_two_sum(s1, s2, s2);
+  s2 += t2;
+  _hi = quick_two_sum(s1, s2, _lo);
+  return *this;
+}
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator+= (double a)
+{
+  double s2;
+  double s1 = two_sum(_hi, a, s2);
+  s2 += _lo;
+  _hi = quick_two_sum(s1, s2, _lo);
+  return *this;
+}
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator*= (const DoubleDouble& a)
+{
+  double p2;
+  double p1 = two_prod(_hi, a._hi, p2);
+  p2 += (_hi * a._lo + _lo * a._hi);
+  _hi = quick_two_sum(p1, p2, _lo);
+  return *this;
+}
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator*= (double a)
+{
+  double p2;
+  double p1 = two_prod(_hi, a, p2);
+  p2 += _lo * a;
+  _hi = quick_two_sum(p1, p2, _lo);
+  return *this;
+}
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator/= (const DoubleDouble& a)
+{
+  // three quotient digits, each correcting the remainder of the last;
+  // kept in plain doubles so that repeated quotients merge early
+  double r_lo;
+  double q1 = _hi / a._hi;
+  double r_hi = remainder(_hi, _lo, a, q1, r_lo);
+  double q2 = r_hi / a._hi;
+  r_hi = remainder(r_hi, r_lo, a, q2, r_lo);
+  double q3 = r_hi / a._hi;
+
+  _hi = quick_two_sum(q1, q2, _lo);
+  return *this += q3;
+}
+
+DOUBLEDOUBLE_INLINE
+DoubleDouble& DoubleDouble::operator/= (double a)
+{
+  double q1 = _hi / a;
+  double p2;
+  double p1 = two_prod(q1, a, p2);
+  double s2;
+  double s1 = two_sum(_hi, -p1, s2);
+  s2 -= p2;
+  s2 += _lo;
+  double q2 = (s1 + s2) / a;
+  _hi = quick_two_sum(q1, q2, _lo);
+  return *this;
+}
+
+#define DoubleDouble_op(opname, compound) \
+DOUBLEDOUBLE_INLINE DoubleDouble operator opname (const DoubleDouble& a, const DoubleDouble& b) \
+  { DoubleDouble r(a); return r compound b; } \
+DOUBLEDOUBLE_INLINE DoubleDouble operator opname (const DoubleDouble& a, double b) \
+  { DoubleDouble r(a); return r compound b; } \
+DOUBLEDOUBLE_INLINE DoubleDouble operator opname (double a, const DoubleDouble& b) \
+  { DoubleDouble r(a); return r compound b; }
+
+DoubleDouble_op(+, +=)
+DoubleDouble_op(-, -=)
+DoubleDouble_op(*, *=)
+DoubleDouble_op(/, /=)
+
+#undef DoubleDouble_op
+
+#define DoubleDouble_compare(opname) \
+inline bool operator opname (const DoubleDouble& a, const DoubleDouble& b) \
+  { return a.hi() == b.hi() ? a.lo() opname b.lo() : a.hi() opname b.hi(); } \
+inline bool operator opname (const DoubleDouble& a, double b) \
+  { return a.hi() == b ? a.lo() opname 0. : a.hi() opname b; } \
+inline bool operator opname (double a, const DoubleDouble& b) \
+  { return a == b.hi() ? 0. opname b.lo() : a opname b.hi(); }
+
+DoubleDouble_compare(<)
+DoubleDouble_compare(<=)
+DoubleDouble_compare(>)
+DoubleDouble_compare(>=)
+
+#undef DoubleDouble_compare
+
+inline bool operator== (const DoubleDouble& a, const DoubleDouble& b)
+  { return a.hi() == b.hi() && a.lo() == b.lo(); }
+inline bool operator== (const DoubleDouble& a, double b)
+  { return a.hi() == b && a.lo() == 0.; }
+inline bool operator== (double a, const DoubleDouble& b)
+  { return b == a; }
+inline bool operator!= (const DoubleDouble& a, const DoubleDouble& b)
+  { return !(a == b); }
+inline bool operator!= (const DoubleDouble& a, double b)
+  { return !(a == b); }
+inline bool operator!= (double a, const DoubleDouble& b)
+  { return !(a == b); }
+
+
+
+//
+// constants and helpers for the elementary functions
+//
+
+namespace DoubleDoubleDetail
+{
+  inline DoubleDouble two_pi()   { return DoubleDouble(6.283185307179586,  2.4492935982947064e-16); }
+  inline DoubleDouble pi()       { return DoubleDouble(3.141592653589793,  1.2246467991473532e-16); }
+  inline DoubleDouble half_pi()  { return DoubleDouble(1.5707963267948966, 6.123233995736766e-17); }
+  inline DoubleDouble log_two()  { return DoubleDouble(0.6931471805599453, 2.3190468138462996e-17); }
+
+  // 2^-104: the spacing of the pairs near one
+  inline double epsilon() { return 4.93038065763132378e-32; }
+
+  // a * 2^e, exactly
+  inline DoubleDouble ldexp(const DoubleDouble& a, int e)
+    { return DoubleDouble(std::ldexp(a.hi(), e), std::ldexp(a.lo(), e)); }
+
+  // a * b for a power of two b, exactly and without a library call
+  inline DoubleDouble mul_pwr2(const DoubleDouble& a, double b)
+    { return DoubleDouble(a.hi() * b, a.lo() * b); }
+
+  // a * a
+  DOUBLEDOUBLE_INLINE DoubleDouble sqr(const DoubleDouble& a)
+    {
+      double p2;
+      double p1 = DoubleDouble::two_prod(a.hi(), a.hi(), p2);
+      p2 += 2.0 * a.hi() * a.lo();
+      p2 += a.lo() * a.lo();
+      double s2;
+      double s1 = DoubleDouble::quick_two_sum(p1, p2, s2);
+      return DoubleDouble(s1, s2);
+    }
+
+  // the nearest integer, halfway cases away from zero
+  inline DoubleDouble nint(const DoubleDouble& a)
+    {
+      double hi = std::floor(a.hi() + 0.5);
+      if(hi == a.hi())
+        {
+          double lo = std::floor(a.lo() + 0.5);
+          double e;
+          hi = DoubleDouble::quick_two_sum(hi, lo, e);
+          return DoubleDouble(hi, e);
+        }
+      // hi was rounded up from an exact half: the sign of lo decides
+      if(std::fabs(hi - a.hi()) == 0.5 && a.lo() < 0.0)
+        hi -= 1.0;
+      return DoubleDouble(hi);
+    }
+
+  // 1/k! for k = 0 .. inverse_factorials-1
+  const unsigned int inverse_factorials = 32;
+
+  inline const DoubleDouble* inverse_factorial()
+    {
+      static const struct table
+      {
+        DoubleDouble f[inverse_factorials];
+        table() { f[0] = 1.0; for(unsigned int k = 1; k != inverse_factorials; k++) f[k] = f[k-1] / double(k); }
+      } t;
+      return t.f;
+    }
+
+  // sin(a) for small |a| by its Taylor series
+  inline DoubleDouble sin_taylor(const DoubleDouble& a)
+    {
+      const DoubleDouble* inv_fact = inverse_factorial();
+      const double thresh = 0.5 * std::fabs(a.hi()) * epsilon();
+      DoubleDouble x = -sqr(a);
+      DoubleDouble r = a;
+      DoubleDouble s = a;
+      for(unsigned int k = 3; k < inverse_factorials; k += 2)
+        {
+          r *= x;
+          DoubleDouble t = r * inv_fact[k];
+          s += t;
+          if(std::fabs(t.hi()) <= thresh)
+            break;
+        }
+      return s;
+    }
+
+  // a - j pi/2 with |result| <= pi/4, and j mod 4
+  inline DoubleDouble reduce_half_pi(const DoubleDouble& a, int& j)
+    {
+      DoubleDouble r = a - two_pi() * nint(a / two_pi());
+      double q = std::floor(r.hi() / half_pi().hi() + 0.5);
+      j = static_cast<int>(q);
+      return r - half_pi() * q;
+    }
+
+  inline DoubleDouble sqrt_value(const DoubleDouble& a);
+
+  // sin(k pi/16) and cos(k pi/16) for k = 0 .. 4, as hi, lo pairs
+  inline const double* sin_sixteenth_pi()
+    {
+      static const double t[10] = {
+        0.0, 0.0,
+        0.19509032201612828, -7.991079068461731e-18,
+        0.3826834323650898, -1.0050772696461588e-17,
+        0.5555702330196022, 4.709410940561677e-17,
+        0.7071067811865476, -4.833646656726457e-17 };
+      return t;
+    }
+
+  inline const double* cos_sixteenth_pi()
+    {
+      static const double t[10] = {
+        1.0, 0.0,
+        0.9807852804032304, 1.8546939997825006e-17,
+        0.9238795325112867, 1.7645047084336677e-17,
+        0.8314696123025452, 1.4073856984728024e-18,
+        0.7071067811865476, -4.833646656726457e-17 };
+      return t;
+    }
+
+  // sin(a) and cos(a) with a single reduction and series: after the
+  // quadrant, a multiple of pi/16 comes off by table, which leaves
+  // |u| <= pi/32 for a short sine series and cos(u) = sqrt(1 - sin^2(u))
+  inline void sincos(const DoubleDouble& a, DoubleDouble& s, DoubleDouble& c)
+    {
+      int j;
+      DoubleDouble t = reduce_half_pi(a, j);
+
+      const DoubleDouble pi_16 = mul_pwr2(pi(), 0.0625);
+      double q = std::floor(t.hi() / pi_16.hi() + 0.5);
+      int k = static_cast<int>(q);
+      DoubleDouble u = t - pi_16 * q;
+
+      DoubleDouble su = sin_taylor(u);
+      DoubleDouble cu = sqrt_value(1.0 - sqr(su));
+
+      int m = k < 0 ? -k : k;
+      DoubleDouble sk(sin_sixteenth_pi()[2*m], sin_sixteenth_pi()[2*m+1]);
+      DoubleDouble ck(cos_sixteenth_pi()[2*m], cos_sixteenth_pi()[2*m+1]);
+      if(k < 0)
+        sk = -sk;
+
+      DoubleDouble st = sk * cu + ck * su;
+      DoubleDouble ct = ck * cu - sk * su;
+      switch(j)
+        {
+        case 0:  s =  st; c =  ct; break;
+        case 1:  s =  ct; c = -st; break;
+        case -1: s = -ct; c =  st; break;
+        default: s = -st; c = -ct; break;
+        }
+    }
+}
+
+
+
+namespace DoubleDoubleDetail
+{
+  // Results cross the out of line functions below as a pair the
+  // compiler treats as a register, rather than through memory
+#ifdef __GNUC__
+  typedef __complex__ double packed;
+
+  inline packed pack(const DoubleDouble& a)
+    {
+      packed p;
+      __real__ p = a.hi();
+      __imag__ p = a.lo();
+      return p;
+    }
+
+  inline DoubleDouble unpack(packed p) { return DoubleDouble(__real__ p, __imag__ p); }
+#else
+  typedef DoubleDouble packed;
+
+  inline packed pack(const DoubleDouble& a) { return a; }
+
+  inline DoubleDouble unpack(packed p) { return p; }
+#endif
+
+  // Templates, to be defined once across translation units without
+  // the inline that would contradict noinline.
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed sqrt_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed exp_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed log_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed sin_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed cos_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION void   sincos_kernel(double hi, double lo, DoubleDouble& s, DoubleDouble& c);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed erf_kernel(double hi, double lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed atan2_kernel(double y_hi, double y_lo, double x_hi, double x_lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed pow_kernel(double a_hi, double a_lo, double b_hi, double b_lo);
+  template <int = 0> DOUBLEDOUBLE_FUNCTION packed powi_kernel(double hi, double lo, int n);
+}
+
+
+
+namespace std {
+
+inline DoubleDouble abs (const DoubleDouble& a) { return a.hi() < 0.0 ? -a : a; }
+
+inline DoubleDouble fabs (const DoubleDouble& a) { return a.hi() < 0.0 ? -a : a; }
+
+inline DoubleDouble floor (const DoubleDouble& a)
+{
+  double hi = std::floor(a.hi());
+  double lo = 0.0;
+  if(hi == a.hi())
+    {
+      lo = std::floor(a.lo());
+      hi = DoubleDouble::quick_two_sum(hi, lo, lo);
+    }
+  return DoubleDouble(hi, lo);
+}
+
+inline DoubleDouble ceil (const DoubleDouble& a) { return -std::floor(-a); }
+
+inline bool isnan (const DoubleDouble& a) { return std::isnan(a.hi()) || std::isnan(a.lo()); }
+
+inline bool isinf (const DoubleDouble& a) { return std::isinf(a.hi()); }
+
+inline bool isfinite (const DoubleDouble& a) { return std::isfinite(a.hi()); }
+
+#define DoubleDouble_std_unary(funcname) \
+DOUBLEDOUBLE_INLINE DoubleDouble funcname (const DoubleDouble& a) \
+{ \
+  return DoubleDoubleDetail::unpack(DoubleDoubleDetail::funcname##_kernel(a.hi(), a.lo())); \
+}
+
+DoubleDouble_std_unary(sqrt)
+DoubleDouble_std_unary(exp)
+DoubleDouble_std_unary(log)
+DoubleDouble_std_unary(sin)
+DoubleDouble_std_unary(cos)
+DoubleDouble_std_unary(erf)
+
+#undef DoubleDouble_std_unary
+
+DOUBLEDOUBLE_INLINE DoubleDouble atan2 (const DoubleDouble& y, const DoubleDouble& x)
+{
+  return DoubleDoubleDetail::unpack(DoubleDoubleDetail::atan2_kernel(y.hi(), y.lo(), x.hi(), x.lo()));
+}
+
+DOUBLEDOUBLE_INLINE DoubleDouble pow (const DoubleDouble& a, const DoubleDouble& b)
+{
+  return DoubleDoubleDetail::unpack(DoubleDoubleDetail::pow_kernel(a.hi(), a.lo(), b.hi(), b.lo()));
+}
+
+// integer powers by repeated squaring
+DOUBLEDOUBLE_INLINE DoubleDouble pow (const DoubleDouble& a, int n)
+{
+  return DoubleDoubleDetail::unpack(DoubleDoubleDetail::powi_kernel(a.hi(), a.lo(), n));
+}
+
+inline DoubleDouble pow (const DoubleDouble& a, double b) { return std::pow(a, DoubleDouble(b)); }
+
+inline DoubleDouble pow (double a, const DoubleDouble& b) { return std::pow(DoubleDouble(a), b); }
+
+inline DoubleDouble tan (const DoubleDouble& a) { return std::sin(a) / std::cos(a); }
+
+inline DoubleDouble atan (const DoubleDouble& a) { return std::atan2(a, DoubleDouble(1.0)); }
+
+inline DoubleDouble asin (const DoubleDouble& a)
+{
+  return std::atan2(a, std::sqrt((1.0 - a) * (1.0 + a)));
+}
+
+inline DoubleDouble acos (const DoubleDouble& a)
+{
+  return std::atan2(std::sqrt((1.0 - a) * (1.0 + a)), a);
+}
+
+inline DoubleDouble sinh (const DoubleDouble& a)
+{
+  DoubleDouble e = std::exp(a);
+  return DoubleDoubleDetail::mul_pwr2(e - 1.0 / e, 0.5);
+}
+
+inline DoubleDouble cosh (const DoubleDouble& a)
+{
+  DoubleDouble e = std::exp(a);
+  return DoubleDoubleDetail::mul_pwr2(e + 1.0 / e, 0.5);
+}
+
+inline DoubleDouble tanh (const DoubleDouble& a)
+{
+  DoubleDouble e = std::exp(DoubleDoubleDetail::mul_pwr2(a, 2.0));
+  return (e - 1.0) / (e + 1.0);
+}
+
+inline DoubleDouble log10 (const DoubleDouble& a) { return std::log(a) / std::log(DoubleDouble(10.0)); }
+
+inline DoubleDouble max (const DoubleDouble& a, const DoubleDouble& b) { return a < b ? b : a; }
+
+inline DoubleDouble min (const DoubleDouble& a, const DoubleDouble& b) { return b < a ? b : a; }
+
+inline DoubleDouble fmod (const DoubleDouble& a, const DoubleDouble& b)
+{
+  DoubleDouble q = a / b;
+  q = q.hi() < 0.0 ? std::ceil(q) : std::floor(q);
+  return a - q * b;
+}
+
+
+template <>
+class numeric_limits<DoubleDouble>
+{
+public:
+  static const bool is_specialized = true;
+  static DoubleDouble min() throw() { return DoubleDouble(2.0041683600089728e-292); }  // 2^-969
+  static DoubleDouble max() throw() { return DoubleDouble(1.7976931348623157e+308, 9.9792015476735990e+291); }
+  static DoubleDouble lowest() throw() { return -max(); }
+  static const int  digits = 106;
+  static const int  digits10 = 31;
+  static const int  max_digits10 = 33;
+  static const bool is_signed = true;
+  static const bool is_integer = false;
+  static const bool is_exact = false;
+  static const int radix = 2;
+  static DoubleDouble epsilon() throw() { return DoubleDouble(DoubleDoubleDetail::epsilon()); }
+  static DoubleDouble round_error() throw() { return DoubleDouble(0.5); }
+
+  static const int  min_exponent = -968;
+  static const int  min_exponent10 = -291;
+  static const int  max_exponent = numeric_limits<double>::max_exponent;
+  static const int  max_exponent10 = numeric_limits<double>::max_exponent10;
+
+  static const bool has_infinity = true;
+  static const bool has_quiet_NaN = true;
+  static const bool has_signaling_NaN = true;
+  static const float_denorm_style has_denorm = denorm_absent;
+  static const bool has_denorm_loss = false;
+  static DoubleDouble infinity() throw() { return DoubleDouble(numeric_limits<double>::infinity()); }
+  static DoubleDouble quiet_NaN() throw() { return DoubleDouble(numeric_limits<double>::quiet_NaN()); }
+  static DoubleDouble signaling_NaN() throw() { return DoubleDouble(numeric_limits<double>::signaling_NaN()); }
+  static DoubleDouble denorm_min() throw() { return min(); }
+
+  static const bool is_iec559 = false;
+  static const bool is_bounded = true;
+  static const bool is_modulo = false;
+
+  static const bool traps = false;
+  static const bool tinyness_before = false;
+  static const float_round_style round_style = round_to_nearest;
+};
+
+} // namespace std
+
+
+
+namespace DoubleDoubleDetail
+{
+  inline DoubleDouble sqrt_value(const DoubleDouble& a)
+    {
+      if(a.hi() <= 0.0)
+        return DoubleDouble(std::sqrt(a.hi()));
+
+      // one Newton step on 1/sqrt(a) from the double estimate (Karp)
+      double x = 1.0 / std::sqrt(a.hi());
+      double ax = a.hi() * x;
+      double e;
+      double p = DoubleDouble::two_prod(ax, ax, e);
+      return DoubleDouble(ax) + (a - DoubleDouble(p, e)).hi() * (x * 0.5);
+    }
+
+  inline DoubleDouble exp_value(const DoubleDouble& a)
+    {
+      if(a.hi() <= -709.0)
+        return DoubleDouble(std::exp(a.hi()));
+      if(a.hi() >= 709.0)
+        return DoubleDouble(std::exp(a.hi()));
+      if(a.hi() == 0.0)
+        return DoubleDouble(1.0);
+
+      // exp(a) = 2^m exp(r)^512 with |r| <= log(2)/1024; the series is
+      // summed for expm1(r), which keeps the squarings accurate
+      const DoubleDouble* inv_fact = inverse_factorial();
+      double m = std::floor(a.hi() / log_two().hi() + 0.5);
+      DoubleDouble r = mul_pwr2(a - log_two() * m, 1.0/512);
+
+      DoubleDouble p = sqr(r);
+      DoubleDouble s = r + mul_pwr2(p, 0.5);
+      for(unsigned int k = 3; k != 10; k++)
+        {
+          p *= r;
+          s += p * inv_fact[k];
+        }
+
+      for(unsigned int k = 0; k != 9; k++)
+        s = mul_pwr2(s, 2.0) + sqr(s);
+      s += 1.0;
+
+      return ldexp(s, static_cast<int>(m));
+    }
+
+  inline DoubleDouble log_value(const DoubleDouble& a)
+    {
+      if(a.hi() <= 0.0 || a.hi() == std::numeric_limits<double>::infinity())
+        return DoubleDouble(std::log(a.hi()));
+
+      // one Newton step on exp(x) = a from the double estimate
+      DoubleDouble x = std::log(a.hi());
+      return x + a * std::exp(-x) - 1.0;
+    }
+
+  inline DoubleDouble sin_value(const DoubleDouble& a)
+    {
+      if(a.hi() == 0.0)
+        return a;
+
+      DoubleDouble s, c;
+      sincos(a, s, c);
+      return s;
+    }
+
+  inline DoubleDouble cos_value(const DoubleDouble& a)
+    {
+      if(a.hi() == 0.0)
+        return DoubleDouble(1.0);
+
+      DoubleDouble s, c;
+      sincos(a, s, c);
+      return c;
+    }
+
+  inline DoubleDouble atan2_value(const DoubleDouble& y, const DoubleDouble& x)
+    {
+      if(x.hi() == 0.0)
+        {
+          if(y.hi() == 0.0)
+            return DoubleDouble(0.0);
+          return y.hi() > 0.0 ? half_pi() : -half_pi();
+        }
+      if(y.hi() == 0.0)
+        return x.hi() > 0.0 ? DoubleDouble(0.0) : pi();
+
+      // one Newton step on (cos z, sin z) = (x, y)/r from the double
+      // estimate, dividing by whichever of the two is larger
+      DoubleDouble r = std::sqrt(sqr(x) + sqr(y));
+      DoubleDouble xx = x / r;
+      DoubleDouble yy = y / r;
+
+      DoubleDouble z = std::atan2(y.hi(), x.hi());
+      DoubleDouble sin_z = std::sin(z);
+      DoubleDouble cos_z = std::cos(z);
+
+      if(std::fabs(xx.hi()) > std::fabs(yy.hi()))
+        z += (yy - sin_z) / cos_z;
+      else
+        z -= (xx - cos_z) / sin_z;
+      return z;
+    }
+
+  inline DoubleDouble powi_value(const DoubleDouble& a, int n)
+    {
+      if(n == 0)
+        return DoubleDouble(1.0);
+
+      unsigned int m = n < 0 ? -static_cast<unsigned int>(n) : n;
+      DoubleDouble r = a;
+      DoubleDouble s = 1.0;
+      for(;;)
+        {
+          if(m & 1)
+            s *= r;
+          m >>= 1;
+          if(m == 0)
+            break;
+          r = sqr(r);
+        }
+
+      return n < 0 ? 1.0 / s : s;
+    }
+
+  inline DoubleDouble pow_value(const DoubleDouble& a, const DoubleDouble& b)
+    {
+      if(b.lo() == 0.0 && b.hi() == std::floor(b.hi()) && std::fabs(b.hi()) < 1024.0)
+        return std::pow(a, static_cast<int>(b.hi()));
+      return std::exp(b * std::log(a));
+    }
+
+  inline DoubleDouble erf_value(const DoubleDouble& a)
+    {
+      DoubleDouble x = std::fabs(a);
+      DoubleDouble r;
+
+      if(x.hi() < 3.0)
+        {
+          // erf(x) = 2/sqrt(pi) exp(-x^2) sum_k 2^k x^(2k+1) / (1.3.5...(2k+1)),
+          // whose terms are all positive
+          DoubleDouble x2 = mul_pwr2(sqr(x), 2.0);
+          DoubleDouble t = x;
+          DoubleDouble s = x;
+          for(unsigned int k = 1; k != 200; k++)
+            {
+              t = t * x2 / double(2*k+1);
+              s += t;
+              if(t.hi() <= 0.5 * s.hi() * epsilon())
+                break;
+            }
+          r = 2.0 * s * std::exp(-sqr(x)) / std::sqrt(pi());
+        }
+      else if(x.hi() < 27.0)
+        {
+          // erfc(x) = exp(-x^2)/sqrt(pi) / (x + (1/2)/(x + 1/(x + (3/2)/(x + ...)))),
+          // evaluated from the tail
+          DoubleDouble f = x;
+          for(unsigned int k = 120; k != 0; k--)
+            f = x + (0.5 * k) / f;
+          r = 1.0 - std::exp(-sqr(x)) / (f * std::sqrt(pi()));
+        }
+      else
+        r = 1.0;
+
+      return a.hi() < 0.0 ? -r : r;
+    }
+
+  template <int> DOUBLEDOUBLE_FUNCTION packed sqrt_kernel(double hi, double lo) { return pack(sqrt_value(DoubleDouble(hi, lo))); }
+  template <int> DOUBLEDOUBLE_FUNCTION packed exp_kernel(double hi, double lo)  { return pack(exp_value(DoubleDouble(hi, lo))); }
+  template <int> DOUBLEDOUBLE_FUNCTION packed log_kernel(double hi, double lo)  { return pack(log_value(DoubleDouble(hi, lo))); }
+  template <int> DOUBLEDOUBLE_FUNCTION packed sin_kernel(double hi, double lo)  { return pack(sin_value(DoubleDouble(hi, lo))); }
+  template <int> DOUBLEDOUBLE_FUNCTION packed cos_kernel(double hi, double lo)  { return pack(cos_value(DoubleDouble(hi, lo))); }
+
+  template <int> DOUBLEDOUBLE_FUNCTION void sincos_kernel(double hi, double lo, DoubleDouble& s, DoubleDouble& c)
+    {
+      if(hi == 0.0)
+        {
+          s = DoubleDouble(hi, lo);
+          c = DoubleDouble(1.0);
+        }
+      else
+        sincos(DoubleDouble(hi, lo), s, c);
+    }
+  template <int> DOUBLEDOUBLE_FUNCTION packed erf_kernel(double hi, double lo)  { return pack(erf_value(DoubleDouble(hi, lo))); }
+
+  template <int> DOUBLEDOUBLE_FUNCTION packed atan2_kernel(double y_hi, double y_lo, double x_hi, double x_lo)
+    { return pack(atan2_value(DoubleDouble(y_hi, y_lo), DoubleDouble(x_hi, x_lo))); }
+
+  template <int> DOUBLEDOUBLE_FUNCTION packed pow_kernel(double a_hi, double a_lo, double b_hi, double b_lo)
+    { return pack(pow_value(DoubleDouble(a_hi, a_lo), DoubleDouble(b_hi, b_lo))); }
+
+  template <int> DOUBLEDOUBLE_FUNCTION packed powi_kernel(double hi, double lo, int n)
+    { return pack(powi_value(DoubleDouble(hi, lo), n)); }
+}
+
+
+
+// Up to 17 significant digits, and in the fixed and hexadecimal
+// formats, only the leading double is written; hexadecimal writes the
+// exact pair as "hi+lo".  Longer scientific or default formats write
+// the decimal expansion of the sum.
+inline
+std::ostream& operator<< (std::ostream& os, const DoubleDouble& a)
+{
+  const std::ios_base::fmtflags ff = os.flags() & std::ios_base::floatfield;
+
+  if(ff == (std::ios_base::fixed | std::ios_base::scientific))
+    return os << a.hi() << '+' << a.lo();
+
+  const std::streamsize prec = os.precision();
+  if(prec <= 17 || ff == std::ios_base::fixed || !std::isfinite(a.hi()) || a.hi() == 0.0)
+    return os << a.hi();
+
+  const int digits = prec > 33 ? 33 : static_cast<int>(prec);
+
+  DoubleDouble x = std::fabs(a);
+  int e = static_cast<int>(std::floor(std::log10(x.hi())));
+  x /= std::pow(DoubleDouble(10.0), e);
+  if(x >= 10.0) { x /= 10.0; e++; }
+  if(x < 1.0)   { x *= 10.0; e--; }
+
+  // one guard digit, then round to nearest
+  std::string s(digits + 1, '0');
+  for(int i = 0; i <= digits; i++)
+    {
+      int d = static_cast<int>(std::floor(x.hi()));
+      x -= double(d);
+      if(x < 0.0) { x += 1.0; d--; }
+      if(d > 9)   { x += double(d - 9); d = 9; }
+      s[i] = static_cast<char>('0' + d);
+      x *= 10.0;
+    }
+  if(s[digits] >= '5')
+    {
+      int i = digits - 1;
+      while(i >= 0 && s[i] == '9')
+        s[i--] = '0';
+      if(i >= 0)
+        s[i]++;
+      else
+        {
+          s.insert(s.begin(), '1');
+          e++;
+        }
+    }
+  s.resize(digits);
+
+  std::string out;
+  if(a.hi() < 0.0)
+    out += '-';
+  out += s[0];
+  out += '.';
+  out.append(s, 1, std::string::npos);
+  out += 'e';
+  out += (e < 0 ? '-' : '+');
+  int ae = e < 0 ? -e : e;
+  if(ae < 10)
+    out += '0';
+  out += std::to_string(ae);
+
+  return os << out;
+}
+
+#endif // __doubledouble_h__
@@ -266,7 +266,7 @@ DualNumber_std_unary(acos, -1 / std::sqrt(1 - in.value()*in.value()),)
 DualNumber_std_unary(atan, 1 / (1 + in.value()*in.value()),)
 DualNumber_std_unary(sinh, std::cosh(in.value()),)
 DualNumber_std_unary(cosh, std::sinh(in.value()),)
-DualNumber_std_unary(tanh, sech_in * sech_in, T sech_in = 1 / std::cos(in.value()))
+DualNumber_std_unary(tanh, sech_in * sech_in, T sech_in = 1 / std::cosh(in.value()))
 DualNumber_std_unary(abs, (in.value() > 0) - (in.value() < 0),) // std < and > return 0 or 1
 DualNumber_std_unary(ceil, 0,)
 DualNumber_std_unary(floor, 0,)
@@ -345,5 +345,7 @@ Scalar MASA::euler_chem_1d<Scalar>::eval_exact_rho_N2(Scalar x)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_chem
 MASA_INSTANTIATE_ALL(MASA::euler_chem_1d);
+#endif
 
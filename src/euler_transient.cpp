@@ -50,6 +50,7 @@ MASA::euler_transient_1d<Scalar>::euler_transient_1d()
 {
   this->mmsname = "euler_transient_1d";
   this->dimension=1;
+  this->transient=true;
   this->register_var("k",&k);
 
   this->register_var("u_0",&u_0);
@@ -222,7 +223,9 @@ Scalar MASA::euler_transient_1d<Scalar>::eval_exact_rho(Scalar x,Scalar t)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient
 MASA_INSTANTIATE_ALL(MASA::euler_transient_1d);
+#endif
 //MASA_INSTANTIATE_ALL(MASA::euler_transient_2d);
 //MASA_INSTANTIATE_ALL(MASA::euler_transient_3d);
 
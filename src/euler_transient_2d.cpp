@@ -31,6 +31,7 @@ MASA::euler_transient_2d<Scalar>::euler_transient_2d()
 {
   this->mmsname = "euler_transient_2d";
   this->dimension = 2;
+  this->transient = true;
 
   this->register_var("rho_0",&rho_0);
   this->register_var("rho_x",&rho_x);
@@ -234,7 +235,9 @@ Scalar MASA::euler_transient_2d<Scalar>::eval_exact_v(Scalar x,Scalar y,Scalar t
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_2d
 MASA_INSTANTIATE_ALL(MASA::euler_transient_2d);
+#endif
 
 
 
@@ -32,6 +32,7 @@ MASA::euler_transient_3d<Scalar>::euler_transient_3d()
 {
   this->mmsname = "euler_transient_3d";
   this->dimension = 3;
+  this->transient = true;
 
   this->register_var("rho_0",&rho_0);
   this->register_var("rho_x",&rho_x);
@@ -315,7 +316,9 @@ Scalar MASA::euler_transient_3d<Scalar>::eval_exact_w(Scalar x,Scalar y,Scalar z
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_3d
 MASA_INSTANTIATE_ALL(MASA::euler_transient_3d);
+#endif
 
 
 
@@ -48,6 +48,7 @@ MASA::fans_sa_transient_free_shear<Scalar>::fans_sa_transient_free_shear()
 {
   this->mmsname = "fans_sa_transient_free_shear";
   this->dimension=2;
+  this->transient=true;
 
   this->register_var("u_0",&u_0);
   this->register_var("u_x",&u_x);
@@ -725,5 +726,7 @@ Scalar MASA::fans_sa_steady_wall_bounded<Scalar>::update(Scalar x, Scalar y)
 //   Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::fans_sa_steady_wall_bounded);
-MASA_INSTANTIATE_ALL(MASA::fans_sa_transient_free_shear);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_fans_sa
+MASA_INSTANTIATE_SCALARS(MASA::fans_sa_steady_wall_bounded);
+MASA_INSTANTIATE_SCALARS(MASA::fans_sa_transient_free_shear);
+#endif
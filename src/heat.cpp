@@ -207,6 +207,7 @@ MASA::heateq_1d_unsteady_const<Scalar>::heateq_1d_unsteady_const()
 {
   this->mmsname = "heateq_1d_unsteady_const";
   this->dimension=1;
+  this->transient=true;
 
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -251,6 +252,7 @@ MASA::heateq_2d_unsteady_const<Scalar>::heateq_2d_unsteady_const()
 {
   this->mmsname = "heateq_2d_unsteady_const";
   this->dimension=2;
+  this->transient=true;
     
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -308,6 +310,7 @@ MASA::heateq_3d_unsteady_const<Scalar>::heateq_3d_unsteady_const()
 {
   this->mmsname = "heateq_3d_unsteady_const";
   this->dimension=3;
+  this->transient=true;
   
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -368,6 +371,7 @@ MASA::heateq_1d_unsteady_var<Scalar>::heateq_1d_unsteady_var()
 {
   this->mmsname = "heateq_1d_unsteady_var";
   this->dimension=1;
+  this->transient=true;
 
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -422,6 +426,7 @@ MASA::heateq_2d_unsteady_var<Scalar>::heateq_2d_unsteady_var()
 {
   this->mmsname = "heateq_2d_unsteady_var";
   this->dimension=2;
+  this->transient=true;
 
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -479,6 +484,7 @@ MASA::heateq_3d_unsteady_var<Scalar>::heateq_3d_unsteady_var()
 {
   this->mmsname = "heateq_3d_unsteady_var";
   this->dimension=3;
+  this->transient=true;
 
   this->register_var("A_x",&A_x);   
   this->register_var("k_0",&k_0);
@@ -674,6 +680,7 @@ Scalar MASA::heateq_3d_steady_var<Scalar>::eval_q_t(Scalar x,Scalar y,Scalar z)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_heat
 MASA_INSTANTIATE_ALL(MASA::heateq_1d_steady_const);
 MASA_INSTANTIATE_ALL(MASA::heateq_2d_steady_const);
 MASA_INSTANTIATE_ALL(MASA::heateq_3d_steady_const);
@@ -686,3 +693,4 @@ MASA_INSTANTIATE_ALL(MASA::heateq_3d_unsteady_const);
 MASA_INSTANTIATE_ALL(MASA::heateq_1d_unsteady_var);
 MASA_INSTANTIATE_ALL(MASA::heateq_2d_unsteady_var);
 MASA_INSTANTIATE_ALL(MASA::heateq_3d_unsteady_var);
+#endif
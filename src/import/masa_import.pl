@@ -48,7 +48,7 @@ else
     $soln = "mms_import_example";
 }
 $name     = $soln;
-$new_masa = "  anim.push_back(new $soln<Scalar>());\n\n";
+$new_masa = "#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_$soln\n  anim.push_back(&make_solution<Scalar,$soln>);\n#endif\n\n";
 
 # get dimension
 print " Please input the MMS dimension (spatial + temporal) (default: 1):\n";
@@ -502,7 +502,7 @@ while($line = <INFILE>)
     # looking for our special moniker
     if($line =~ /-l33t-/)
     {
-	print OUTFILE "cc_sources += $name.cpp\n";
+	print OUTFILE "solution_sources += $name.cpp\n";
 	print OUTFILE $line;
     }
     else 
@@ -719,7 +719,7 @@ while($af = <ANAFILE>)
 print OUTFILE "\n\n// ----------------------------------------\n";
 print OUTFILE "// Template Instantiation(s)\n";
 print OUTFILE "// ----------------------------------------\n";
-print OUTFILE "\nMASA_INSTANTIATE_ALL(MASA::$name);\n\n";
+print OUTFILE "\n#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_$name\nMASA_INSTANTIATE_ALL(MASA::$name);\n#endif\n\n";
 
 print OUTFILE "\n\n";
 print OUTFILE "//---------------------------------------------------------\n";
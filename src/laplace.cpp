@@ -97,4 +97,6 @@ Scalar MASA::laplace_2d<Scalar>::eval_exact_phi(Scalar x,Scalar y)
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_laplace
 MASA_INSTANTIATE_ALL(MASA::laplace_2d);
+#endif
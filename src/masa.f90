@@ -35,6 +35,17 @@ module masa
   !> \file
   !! MASA Fortran Interface
 
+  !> Bits of masa_get_capabilities and masa_get_field_capabilities,
+  !! as the MASA_CAP_* macros of masa.h
+  integer(c_int), parameter :: MASA_CAP_1D        = 1
+  integer(c_int), parameter :: MASA_CAP_2D        = 2
+  integer(c_int), parameter :: MASA_CAP_3D        = 4
+  integer(c_int), parameter :: MASA_CAP_4D        = 8
+  integer(c_int), parameter :: MASA_CAP_GRADIENT  = 16
+  integer(c_int), parameter :: MASA_CAP_HESSIAN   = 32
+  integer(c_int), parameter :: MASA_CAP_TRANSIENT = 64
+  integer(c_int), parameter :: MASA_CAP_VECTORS   = 128
+
   ! -------------------------------------
   !! \name MMS Init/Selection Routines
   ! -------------------------------------
@@ -59,6 +70,44 @@ module masa
      end subroutine masa_init_passthrough
   end interface
 
+  interface
+     !> Initializes a manufactured solution of the equations
+     !! (e.g. "euler_2d") whose fields and coefficients are given by
+     !! the definitions, one "name = expression" per line or separated
+     !! by ';'. Returns 0 for success, 1 if the definitions are not valid.
+     !!
+     !! @param user_tag Handle for the newly initalized class.
+     !! @param equations The equations the source terms are derived from.
+     !! @param definitions The expressions of the fields and coefficients.
+     !!
+     integer(c_int) function masa_init_expr_passthrough(user_tag,equations,definitions) bind (C,name='masa_init_expr')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: user_tag(*)
+       character(c_char), intent(in) :: equations(*)
+       character(c_char), intent(in) :: definitions(*)
+
+     end function masa_init_expr_passthrough
+  end interface
+
+  interface
+     !> Compiles the selected solution of masa_init_expr to native code
+     !! for the current values of its parameters, kept in cache_dir
+     !! ($TMPDIR/masa_jit if empty) for later runs. Returns 0 for
+     !! success, 1 if the solution cannot be compiled.
+     !!
+     !! @param cache_dir Directory of the compiled code.
+     !!
+     integer(c_int) function masa_jit_compile_passthrough(cache_dir) bind (C,name='masa_jit_compile')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: cache_dir(*)
+
+     end function masa_jit_compile_passthrough
+  end interface
+
   interface
      !> Display (to stdout) the number of user initalized solutions. 
      !!
@@ -113,6 +162,30 @@ module masa
      end subroutine masa_sanity_check
   end interface
 
+  interface
+     !> Sets the number of threads used for batch and grid
+     !! evaluations (0 restores the MASA_NUM_THREADS default).
+     !!
+     integer(c_int) function masa_set_num_threads(nthreads) bind (C,name='masa_set_num_threads')
+       use iso_c_binding
+       implicit none
+
+       integer(c_int), value :: nthreads
+
+     end function masa_set_num_threads
+  end interface
+
+  interface
+     !> Returns the number of threads used for batch and grid
+     !! evaluations.
+     !!
+     integer(c_int) function masa_get_num_threads() bind (C,name='masa_get_num_threads')
+       use iso_c_binding
+       implicit none
+
+     end function masa_get_num_threads
+  end interface
+
   ! ---------------------------------
   !! /name MMS Parameter Routines
   ! ---------------------------------
@@ -1696,71 +1769,1350 @@ module masa
      end function masa_eval_4d_grad_rho
   end interface
 
-contains
-  
-  ! ----------------------------------------------------------------
-  ! Wrapper routines for functions which include character
-  ! strings; the wrapers insert necessary null terminators for 
-  ! subsequent use with C/C++
-  ! ----------------------------------------------------------------
-  
-  subroutine masa_init(user_tag,desired_mms_function)
-    use iso_c_binding
-    implicit none
+  ! ---------------------------------
+  ! MMS full gradient interfaces -- 2d
+  ! ---------------------------------
 
-    character(len=*) :: user_tag
-    character(len=*) :: desired_mms_function
+  interface
+     integer (c_int) function masa_eval_2d_gradient_t(x,y,grad) bind (C,name='masa_eval_2d_gradient_t')
+       use iso_c_binding
+       implicit none
 
-    call masa_init_passthrough(user_tag//C_NULL_CHAR,desired_mms_function//C_NULL_CHAR)
-    return
-  end subroutine masa_init
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
 
-  subroutine masa_select_mms(desired_mms_function)
-    use iso_c_binding
-    implicit none
+     end function masa_eval_2d_gradient_t
+  end interface
 
-    character(len=*) :: desired_mms_function
+  interface
+     integer (c_int) function masa_eval_2d_gradient_u(x,y,grad) bind (C,name='masa_eval_2d_gradient_u')
+       use iso_c_binding
+       implicit none
 
-    call masa_select_mms_passthrough(desired_mms_function//C_NULL_CHAR)
-    return
-  end subroutine masa_select_mms
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
 
-  real (c_double) function masa_get_param(param_name)
-    use iso_c_binding
-    implicit none
+     end function masa_eval_2d_gradient_u
+  end interface
 
-    character(len=*) :: param_name
+  interface
+     integer (c_int) function masa_eval_2d_gradient_v(x,y,grad) bind (C,name='masa_eval_2d_gradient_v')
+       use iso_c_binding
+       implicit none
 
-    masa_get_param =  masa_get_param_passthrough(param_name//C_NULL_CHAR)
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
 
-  end function masa_get_param
+     end function masa_eval_2d_gradient_v
+  end interface
 
-  !! \name sets the parameter value
-  subroutine masa_set_param(param_name,value)
-    use iso_c_binding
-    implicit none
+  interface
+     integer (c_int) function masa_eval_2d_gradient_w(x,y,grad) bind (C,name='masa_eval_2d_gradient_w')
+       use iso_c_binding
+       implicit none
 
-    character(len=*), intent(in)        :: param_name
-    real  (c_double), intent(in)        :: value
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
 
-    call masa_set_param_passthrough(param_name//C_NULL_CHAR,value)
+     end function masa_eval_2d_gradient_w
+  end interface
 
-  end subroutine masa_set_param
+  interface
+     integer (c_int) function masa_eval_2d_gradient_p(x,y,grad) bind (C,name='masa_eval_2d_gradient_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_2d_gradient_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_gradient_rho(x,y,grad) bind (C,name='masa_eval_2d_gradient_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_2d_gradient_rho
+  end interface
 
   ! ---------------------------------
-  ! MMS Vector/Array Routines
+  ! MMS full gradient interfaces -- 3d
   ! ---------------------------------
 
-  subroutine masa_get_array(param_name,it,arr)
-    use iso_c_binding
-    implicit none
-    
-    character(len=*)                :: param_name
-    integer (c_int)                 :: it          ! pass-by-ref is intentional
-    real    (c_double),dimension(*) :: arr
+  interface
+     integer (c_int) function masa_eval_3d_gradient_t(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_t')
+       use iso_c_binding
+       implicit none
 
-    call masa_get_array_passthrough(param_name//C_NULL_CHAR, it, arr)
-    
-  end subroutine masa_get_array
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_t
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_gradient_u(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_u')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_u
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_gradient_v(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_v')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_v
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_gradient_w(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_w')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_w
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_gradient_p(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_gradient_rho(x,y,z,grad) bind (C,name='masa_eval_3d_gradient_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_3d_gradient_rho
+  end interface
+
+  ! ---------------------------------
+  ! MMS full gradient interfaces -- 4d
+  ! ---------------------------------
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_t(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_t')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_t
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_u(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_u')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_u
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_v(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_v')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_v
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_w(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_w')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_w
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_p(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_gradient_rho(x,y,z,t,grad) bind (C,name='masa_eval_4d_gradient_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: grad
+
+     end function masa_eval_4d_gradient_rho
+  end interface
+
+  ! ---------------------------------
+  ! MMS full hessian interfaces -- 2d
+  ! ---------------------------------
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_t(x,y,hess) bind (C,name='masa_eval_2d_hessian_t')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_t
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_u(x,y,hess) bind (C,name='masa_eval_2d_hessian_u')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_u
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_v(x,y,hess) bind (C,name='masa_eval_2d_hessian_v')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_v
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_w(x,y,hess) bind (C,name='masa_eval_2d_hessian_w')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_w
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_p(x,y,hess) bind (C,name='masa_eval_2d_hessian_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_2d_hessian_rho(x,y,hess) bind (C,name='masa_eval_2d_hessian_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_2d_hessian_rho
+  end interface
+
+  ! ---------------------------------
+  ! MMS full hessian interfaces -- 3d
+  ! ---------------------------------
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_t(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_t')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_t
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_u(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_u')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_u
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_v(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_v')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_v
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_w(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_w')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_w
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_p(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_3d_hessian_rho(x,y,z,hess) bind (C,name='masa_eval_3d_hessian_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_3d_hessian_rho
+  end interface
+
+  ! ---------------------------------
+  ! MMS full hessian interfaces -- 4d
+  ! ---------------------------------
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_t(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_t')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_t
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_u(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_u')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_u
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_v(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_v')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_v
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_w(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_w')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_w
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_p(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_p')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_p
+  end interface
+
+  interface
+     integer (c_int) function masa_eval_4d_hessian_rho(x,y,z,t,hess) bind (C,name='masa_eval_4d_hessian_rho')
+       use iso_c_binding
+       implicit none
+
+       real    (c_double), value :: x
+       real    (c_double), value :: y
+       real    (c_double), value :: z
+       real    (c_double), value :: t
+       real    (c_double), dimension(*), intent(out) :: hess
+
+     end function masa_eval_4d_hessian_rho
+  end interface
+
+  ! ---------------------------------
+  !! \name Single Precision Evaluation and Float Storage
+  ! ---------------------------------
+
+  interface
+     !> Evaluates field ("exact_rho", "q_rho_u", ...) of the selected
+     !! solution at the n single precision points, in single precision.
+     !!
+     integer(c_int) function masa_eval_1d_float_passthrough(field,n,x,out) bind (C,name='masa_eval_1d_float')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_1d_float_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_2d_float_passthrough(field,n,x,y,out) bind (C,name='masa_eval_2d_float')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_2d_float_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_3d_float_passthrough(field,n,x,y,z,out) bind (C,name='masa_eval_3d_float')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(in)     :: z(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_3d_float_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_4d_float_passthrough(field,n,x,y,z,t,out) bind (C,name='masa_eval_4d_float')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(in)     :: z(*)
+       real (c_float), intent(in)     :: t(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_4d_float_passthrough
+  end interface
+
+  interface
+     !> Evaluates field ("exact_rho", "q_rho_u", ...) of the selected
+     !! solution at the n single precision points, entirely in double precision, rounding the results to single precision.
+     !!
+     integer(c_int) function masa_eval_1d_mixed_passthrough(field,n,x,out) bind (C,name='masa_eval_1d_mixed')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_1d_mixed_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_2d_mixed_passthrough(field,n,x,y,out) bind (C,name='masa_eval_2d_mixed')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_2d_mixed_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_3d_mixed_passthrough(field,n,x,y,z,out) bind (C,name='masa_eval_3d_mixed')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(in)     :: z(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_3d_mixed_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_4d_mixed_passthrough(field,n,x,y,z,t,out) bind (C,name='masa_eval_4d_mixed')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_float), intent(in)     :: x(*)
+       real (c_float), intent(in)     :: y(*)
+       real (c_float), intent(in)     :: z(*)
+       real (c_float), intent(in)     :: t(*)
+       real (c_float), intent(out)    :: out(*)
+
+     end function masa_eval_4d_mixed_passthrough
+  end interface
+
+  interface
+     !> Evaluates field ("exact_rho", "q_rho_u", ...) of the selected
+     !! solution at the n double precision points in double-double arithmetic; each result is the pair hi + lo.
+     !!
+     integer(c_int) function masa_eval_1d_dd_passthrough(field,n,x,hi,lo) bind (C,name='masa_eval_1d_dd')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(out)   :: hi(*)
+       real (c_double), intent(out)   :: lo(*)
+
+     end function masa_eval_1d_dd_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_2d_dd_passthrough(field,n,x,y,hi,lo) bind (C,name='masa_eval_2d_dd')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(out)   :: hi(*)
+       real (c_double), intent(out)   :: lo(*)
+
+     end function masa_eval_2d_dd_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_3d_dd_passthrough(field,n,x,y,z,hi,lo) bind (C,name='masa_eval_3d_dd')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(out)   :: hi(*)
+       real (c_double), intent(out)   :: lo(*)
+
+     end function masa_eval_3d_dd_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_4d_dd_passthrough(field,n,x,y,z,t,hi,lo) bind (C,name='masa_eval_4d_dd')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(in)    :: t(*)
+       real (c_double), intent(out)   :: hi(*)
+       real (c_double), intent(out)   :: lo(*)
+
+     end function masa_eval_4d_dd_passthrough
+  end interface
+
+  interface
+     !> Largest relative discrepancy of field ("exact_rho", "q_rho_u", ...)
+     !! over the n points between the double solution and its shadow instance
+     !! in shadow, "longdouble" or "doubledouble".
+     !!
+     integer(c_int) function masa_audit_1d_passthrough(field,shadow,n,x,max_rel) bind (C,name='masa_audit_1d')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       character(c_char), intent(in) :: shadow(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(out)   :: max_rel
+
+     end function masa_audit_1d_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_audit_2d_passthrough(field,shadow,n,x,y,max_rel) bind (C,name='masa_audit_2d')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       character(c_char), intent(in) :: shadow(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(out)   :: max_rel
+
+     end function masa_audit_2d_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_audit_3d_passthrough(field,shadow,n,x,y,z,max_rel) bind (C,name='masa_audit_3d')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       character(c_char), intent(in) :: shadow(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(out)   :: max_rel
+
+     end function masa_audit_3d_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_audit_4d_passthrough(field,shadow,n,x,y,z,t,max_rel) bind (C,name='masa_audit_4d')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       character(c_char), intent(in) :: shadow(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(in)    :: t(*)
+       real (c_double), intent(out)   :: max_rel
+
+     end function masa_audit_4d_passthrough
+  end interface
+
+  interface
+     !> Number of values in a snapshot of the parameters of the selected
+     !! solution.
+     !!
+     integer(c_int) function masa_param_count() bind (C,name='masa_param_count')
+       use iso_c_binding
+       implicit none
+
+     end function masa_param_count
+  end interface
+
+  interface
+     !> Copies every parameter of the selected solution into values,
+     !! which holds masa_param_count() doubles.
+     !!
+     integer(c_int) function masa_save_params(values) bind (C,name='masa_save_params')
+       use iso_c_binding
+       implicit none
+
+       real (c_double), intent(out) :: values(*)
+
+     end function masa_save_params
+  end interface
+
+  interface
+     !> Sets every parameter of the selected solution from a snapshot
+     !! of masa_save_params.
+     !!
+     integer(c_int) function masa_load_params(values) bind (C,name='masa_load_params')
+       use iso_c_binding
+       implicit none
+
+       real (c_double), intent(in) :: values(*)
+
+     end function masa_load_params
+  end interface
+
+  interface
+     !> Writes the binary form of every parameter of the selected
+     !! solution to a file, for checkpoint and restart.
+     !!
+     integer(c_int) function masa_write_params_passthrough(filename) bind (C,name='masa_write_params')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: filename(*)
+
+     end function masa_write_params_passthrough
+  end interface
+
+  interface
+     !> Sets the parameters of the selected solution from a file of
+     !! masa_write_params.
+     !!
+     integer(c_int) function masa_read_params_passthrough(filename) bind (C,name='masa_read_params')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: filename(*)
+
+     end function masa_read_params_passthrough
+  end interface
+
+  interface
+     !> Evaluates field ("exact_rho", "q_rho_u", ...) at the n points for
+     !! each of the members parameter sets in params, masa_param_count()
+     !! values per member; out holds members blocks of n values.
+     !!
+     integer(c_int) function masa_eval_1d_ensemble_passthrough(field,members,params,n,x,out) bind (C,name='masa_eval_1d_ensemble')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: members
+       real (c_double), intent(in)    :: params(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(out)   :: out(*)
+
+     end function masa_eval_1d_ensemble_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_2d_ensemble_passthrough(field,members,params,n,x,y,out) bind (C,name='masa_eval_2d_ensemble')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: members
+       real (c_double), intent(in)    :: params(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(out)   :: out(*)
+
+     end function masa_eval_2d_ensemble_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_3d_ensemble_passthrough(field,members,params,n,x,y,z,out) &
+          bind (C,name='masa_eval_3d_ensemble')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: members
+       real (c_double), intent(in)    :: params(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(out)   :: out(*)
+
+     end function masa_eval_3d_ensemble_passthrough
+  end interface
+
+  interface
+     integer(c_int) function masa_eval_4d_ensemble_passthrough(field,members,params,n,x,y,z,t,out) &
+          bind (C,name='masa_eval_4d_ensemble')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), value          :: members
+       real (c_double), intent(in)    :: params(*)
+       integer(c_int), value          :: n
+       real (c_double), intent(in)    :: x(*)
+       real (c_double), intent(in)    :: y(*)
+       real (c_double), intent(in)    :: z(*)
+       real (c_double), intent(in)    :: t(*)
+       real (c_double), intent(out)   :: out(*)
+
+     end function masa_eval_4d_ensemble_passthrough
+  end interface
+
+  ! -------------------------------------
+  !! \name Capabilities
+  ! -------------------------------------
+
+  interface
+     !> Sets caps to the MASA_CAP_* bits of the selected solution.
+     !!
+     integer(c_int) function masa_get_capabilities(caps) bind (C,name='masa_get_capabilities')
+       use iso_c_binding
+       implicit none
+
+       integer(c_int), intent(out) :: caps
+
+     end function masa_get_capabilities
+  end interface
+
+  interface
+     !> Sets dims to the MASA_CAP_1D ... MASA_CAP_4D bits of the
+     !! coordinate counts field can be evaluated at, 0 if the selected
+     !! solution does not provide it.
+     !!
+     integer(c_int) function masa_get_field_capabilities_passthrough(field,dims) &
+          bind (C,name='masa_get_field_capabilities')
+       use iso_c_binding
+       implicit none
+
+       character(c_char), intent(in) :: field(*)
+       integer(c_int), intent(out)    :: dims
+
+     end function masa_get_field_capabilities_passthrough
+  end interface
+
+contains
+  
+  ! ----------------------------------------------------------------
+  ! Wrapper routines for functions which include character
+  ! strings; the wrapers insert necessary null terminators for 
+  ! subsequent use with C/C++
+  ! ----------------------------------------------------------------
+  
+  subroutine masa_init(user_tag,desired_mms_function)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: user_tag
+    character(len=*) :: desired_mms_function
+
+    call masa_init_passthrough(user_tag//C_NULL_CHAR,desired_mms_function//C_NULL_CHAR)
+    return
+  end subroutine masa_init
+
+  integer (c_int) function masa_init_expr(user_tag,equations,definitions)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: user_tag
+    character(len=*) :: equations
+    character(len=*) :: definitions
+
+    masa_init_expr = masa_init_expr_passthrough(user_tag//C_NULL_CHAR,equations//C_NULL_CHAR,definitions//C_NULL_CHAR)
+
+  end function masa_init_expr
+
+  integer (c_int) function masa_jit_compile(cache_dir)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: cache_dir
+
+    masa_jit_compile = masa_jit_compile_passthrough(cache_dir//C_NULL_CHAR)
+
+  end function masa_jit_compile
+
+  subroutine masa_select_mms(desired_mms_function)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: desired_mms_function
+
+    call masa_select_mms_passthrough(desired_mms_function//C_NULL_CHAR)
+    return
+  end subroutine masa_select_mms
+
+  real (c_double) function masa_get_param(param_name)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: param_name
+
+    masa_get_param =  masa_get_param_passthrough(param_name//C_NULL_CHAR)
+
+  end function masa_get_param
+
+  !! \name sets the parameter value
+  subroutine masa_set_param(param_name,value)
+    use iso_c_binding
+    implicit none
+
+    character(len=*), intent(in)        :: param_name
+    real  (c_double), intent(in)        :: value
+
+    call masa_set_param_passthrough(param_name//C_NULL_CHAR,value)
+
+  end subroutine masa_set_param
+
+  ! ---------------------------------
+  ! MMS Vector/Array Routines
+  ! ---------------------------------
+
+  subroutine masa_get_array(param_name,it,arr)
+    use iso_c_binding
+    implicit none
+    
+    character(len=*)                :: param_name
+    integer (c_int)                 :: it          ! pass-by-ref is intentional
+    real    (c_double),dimension(*) :: arr
+
+    call masa_get_array_passthrough(param_name//C_NULL_CHAR, it, arr)
+    
+  end subroutine masa_get_array
+
+  ! ---------------------------------
+  ! Single Precision Evaluation and Float Storage
+  ! ---------------------------------
+
+  integer (c_int) function masa_eval_1d_float(field,n,x,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_1d_float = masa_eval_1d_float_passthrough(field//C_NULL_CHAR,n,x,out)
+
+  end function masa_eval_1d_float
+
+  integer (c_int) function masa_eval_2d_float(field,n,x,y,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_2d_float = masa_eval_2d_float_passthrough(field//C_NULL_CHAR,n,x,y,out)
+
+  end function masa_eval_2d_float
+
+  integer (c_int) function masa_eval_3d_float(field,n,x,y,z,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(in)  :: z(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_3d_float = masa_eval_3d_float_passthrough(field//C_NULL_CHAR,n,x,y,z,out)
+
+  end function masa_eval_3d_float
+
+  integer (c_int) function masa_eval_4d_float(field,n,x,y,z,t,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(in)  :: z(*)
+    real (c_float), intent(in)  :: t(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_4d_float = masa_eval_4d_float_passthrough(field//C_NULL_CHAR,n,x,y,z,t,out)
+
+  end function masa_eval_4d_float
+
+  integer (c_int) function masa_eval_1d_mixed(field,n,x,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_1d_mixed = masa_eval_1d_mixed_passthrough(field//C_NULL_CHAR,n,x,out)
+
+  end function masa_eval_1d_mixed
+
+  integer (c_int) function masa_eval_2d_mixed(field,n,x,y,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_2d_mixed = masa_eval_2d_mixed_passthrough(field//C_NULL_CHAR,n,x,y,out)
+
+  end function masa_eval_2d_mixed
+
+  integer (c_int) function masa_eval_3d_mixed(field,n,x,y,z,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(in)  :: z(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_3d_mixed = masa_eval_3d_mixed_passthrough(field//C_NULL_CHAR,n,x,y,z,out)
+
+  end function masa_eval_3d_mixed
+
+  integer (c_int) function masa_eval_4d_mixed(field,n,x,y,z,t,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)            :: field
+    integer (c_int)             :: n
+    real (c_float), intent(in)  :: x(*)
+    real (c_float), intent(in)  :: y(*)
+    real (c_float), intent(in)  :: z(*)
+    real (c_float), intent(in)  :: t(*)
+    real (c_float), intent(out) :: out(*)
+
+    masa_eval_4d_mixed = masa_eval_4d_mixed_passthrough(field//C_NULL_CHAR,n,x,y,z,t,out)
+
+  end function masa_eval_4d_mixed
+
+  integer (c_int) function masa_eval_1d_dd(field,n,x,hi,lo)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(out) :: hi(*)
+    real (c_double), intent(out) :: lo(*)
+
+    masa_eval_1d_dd = masa_eval_1d_dd_passthrough(field//C_NULL_CHAR,n,x,hi,lo)
+
+  end function masa_eval_1d_dd
+
+  integer (c_int) function masa_eval_2d_dd(field,n,x,y,hi,lo)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(out) :: hi(*)
+    real (c_double), intent(out) :: lo(*)
+
+    masa_eval_2d_dd = masa_eval_2d_dd_passthrough(field//C_NULL_CHAR,n,x,y,hi,lo)
+
+  end function masa_eval_2d_dd
+
+  integer (c_int) function masa_eval_3d_dd(field,n,x,y,z,hi,lo)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(out) :: hi(*)
+    real (c_double), intent(out) :: lo(*)
+
+    masa_eval_3d_dd = masa_eval_3d_dd_passthrough(field//C_NULL_CHAR,n,x,y,z,hi,lo)
+
+  end function masa_eval_3d_dd
+
+  integer (c_int) function masa_eval_4d_dd(field,n,x,y,z,t,hi,lo)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(in)  :: t(*)
+    real (c_double), intent(out) :: hi(*)
+    real (c_double), intent(out) :: lo(*)
+
+    masa_eval_4d_dd = masa_eval_4d_dd_passthrough(field//C_NULL_CHAR,n,x,y,z,t,hi,lo)
+
+  end function masa_eval_4d_dd
+
+  integer (c_int) function masa_audit_1d(field,shadow,n,x,max_rel)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    character(len=*)             :: shadow
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(out) :: max_rel
+
+    masa_audit_1d = masa_audit_1d_passthrough(field//C_NULL_CHAR,shadow//C_NULL_CHAR,n,x,max_rel)
+
+  end function masa_audit_1d
+
+  integer (c_int) function masa_audit_2d(field,shadow,n,x,y,max_rel)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    character(len=*)             :: shadow
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(out) :: max_rel
+
+    masa_audit_2d = masa_audit_2d_passthrough(field//C_NULL_CHAR,shadow//C_NULL_CHAR,n,x,y,max_rel)
+
+  end function masa_audit_2d
+
+  integer (c_int) function masa_audit_3d(field,shadow,n,x,y,z,max_rel)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    character(len=*)             :: shadow
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(out) :: max_rel
+
+    masa_audit_3d = masa_audit_3d_passthrough(field//C_NULL_CHAR,shadow//C_NULL_CHAR,n,x,y,z,max_rel)
+
+  end function masa_audit_3d
+
+  integer (c_int) function masa_audit_4d(field,shadow,n,x,y,z,t,max_rel)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    character(len=*)             :: shadow
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(in)  :: t(*)
+    real (c_double), intent(out) :: max_rel
+
+    masa_audit_4d = masa_audit_4d_passthrough(field//C_NULL_CHAR,shadow//C_NULL_CHAR,n,x,y,z,t,max_rel)
+
+  end function masa_audit_4d
+
+  integer (c_int) function masa_write_params(filename)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: filename
+
+    masa_write_params = masa_write_params_passthrough(filename//C_NULL_CHAR)
+
+  end function masa_write_params
+
+  integer (c_int) function masa_read_params(filename)
+    use iso_c_binding
+    implicit none
+
+    character(len=*) :: filename
+
+    masa_read_params = masa_read_params_passthrough(filename//C_NULL_CHAR)
+
+  end function masa_read_params
+
+  integer (c_int) function masa_eval_1d_ensemble(field,members,params,n,x,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: members
+    real (c_double), intent(in)  :: params(*)
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(out) :: out(*)
+
+    masa_eval_1d_ensemble = masa_eval_1d_ensemble_passthrough(field//C_NULL_CHAR,members,params,n,x,out)
+
+  end function masa_eval_1d_ensemble
+
+  integer (c_int) function masa_eval_2d_ensemble(field,members,params,n,x,y,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: members
+    real (c_double), intent(in)  :: params(*)
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(out) :: out(*)
+
+    masa_eval_2d_ensemble = masa_eval_2d_ensemble_passthrough(field//C_NULL_CHAR,members,params,n,x,y,out)
+
+  end function masa_eval_2d_ensemble
+
+  integer (c_int) function masa_eval_3d_ensemble(field,members,params,n,x,y,z,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: members
+    real (c_double), intent(in)  :: params(*)
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(out) :: out(*)
+
+    masa_eval_3d_ensemble = masa_eval_3d_ensemble_passthrough(field//C_NULL_CHAR,members,params,n,x,y,z,out)
+
+  end function masa_eval_3d_ensemble
+
+  integer (c_int) function masa_eval_4d_ensemble(field,members,params,n,x,y,z,t,out)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int)              :: members
+    real (c_double), intent(in)  :: params(*)
+    integer (c_int)              :: n
+    real (c_double), intent(in)  :: x(*)
+    real (c_double), intent(in)  :: y(*)
+    real (c_double), intent(in)  :: z(*)
+    real (c_double), intent(in)  :: t(*)
+    real (c_double), intent(out) :: out(*)
+
+    masa_eval_4d_ensemble = masa_eval_4d_ensemble_passthrough(field//C_NULL_CHAR,members,params,n,x,y,z,t,out)
+
+  end function masa_eval_4d_ensemble
+
+  integer (c_int) function masa_get_field_capabilities(field,dims)
+    use iso_c_binding
+    implicit none
+
+    character(len=*)             :: field
+    integer (c_int), intent(out) :: dims
+
+    masa_get_field_capabilities = masa_get_field_capabilities_passthrough(field//C_NULL_CHAR,dims)
+
+  end function masa_get_field_capabilities
 
 end module masa
@@ -0,0 +1,516 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_cache.cpp: opt-in persistent cache of evaluated batches and
+//                 grids, kept as memory-mapped files in a directory
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <masa_internal.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace MASA;
+
+//
+//  Every cached field is one file <key>.mgc in the cache directory:
+//
+//    offset  type        contents
+//    0       char[8]     "MASACACH"
+//    8       uint32      layout version (1)
+//    12      uint32      bytes per value (sizeof(Scalar))
+//    16      uint64      number of values
+//    24      char[40]    reserved
+//    64      Scalar[n]   the values
+//
+//  The key is a 128 bit hash of the value type, the evaluated function,
+//  the selected solution with all of its variables and vectors, and the
+//  coordinates. Files are written under a temporary name and renamed
+//  into place, so other processes only ever see complete files; a hit
+//  refreshes the modification time, which orders the LRU eviction.
+//
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+const std::size_t data_offset = 64;
+const char        magic[9]    = "MASACACH";
+
+// temporaries older than this were left behind by a crashed process
+const time_t stale_seconds = 3600;
+
+struct view
+{
+  void*       base;
+  std::size_t length;
+  bool        mapped;
+};
+
+std::mutex                    cache_mutex;
+std::string                   cache_dir;
+std::size_t                   cache_max = 0;
+std::map<const void*,view>    views;        // outstanding views by data pointer
+
+//
+//  two independent 64 bit lanes: FNV-1a and a multiplicative mix
+//
+class hasher
+{
+public:
+  hasher() : _a(14695981039346656037ULL), _b(0x9e3779b97f4a7c15ULL) {}
+
+  void add(const void* data, std::size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for(std::size_t i = 0; i < bytes; i++)
+      {
+        _a = (_a ^ p[i]) * 1099511628211ULL;
+        _b = (_b + p[i]) * 0xff51afd7ed558ccdULL;
+        _b ^= _b >> 29;
+      }
+  }
+
+  void add(const std::string& s) { add(s.data(),s.size()); add("",1); }
+
+  std::string hex() const {
+    char buf[33];
+    snprintf(buf,sizeof(buf),"%016llx%016llx",(unsigned long long)_a,(unsigned long long)_b);
+    return buf;
+  }
+
+private:
+  uint64_t _a, _b;
+};
+
+// significant bytes of a value: x87 long double carries six padding bytes
+template <typename Scalar>
+std::size_t value_bytes()
+{
+  return std::numeric_limits<Scalar>::digits == 64 && sizeof(Scalar) > 10 ? 10 : sizeof(Scalar);
+}
+
+template <typename Scalar>
+void add_values(hasher& h, const Scalar* v, std::size_t n)
+{
+  h.add(&n,sizeof(n));
+  const std::size_t bytes = value_bytes<Scalar>();
+  if(bytes == sizeof(Scalar))
+    h.add(v,n * sizeof(Scalar));
+  else
+    for(std::size_t i = 0; i < n; i++)
+      h.add(&v[i],bytes);
+}
+
+//
+//  functions are identified by the object they live in and their offset
+//  from its load address, which (unlike the address) is the same in
+//  every process; the object's size and time stamp catch rebuilds
+//
+int function_id(const void* func, std::string& id)
+{
+  Dl_info info;
+  if(dladdr(func,&info) == 0 || info.dli_fname == 0 || info.dli_fbase == 0)
+    return 1;
+
+  struct stat st;
+  if(stat(info.dli_fname,&st) != 0)
+    return 1;
+
+  std::ostringstream os;
+  os << info.dli_fname << ':' << (static_cast<const char*>(func) - static_cast<const char*>(info.dli_fbase))
+     << ':' << st.st_size << ':' << st.st_mtime;
+  id = os.str();
+  return 0;
+}
+
+void register_view(const void* data, void* base, std::size_t length, bool mapped)
+{
+  view v = { base, length, mapped };
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  views[data] = v;
+}
+
+//
+//  maps a finished cache file, checking it holds n values of Scalar
+//
+template <typename Scalar>
+const Scalar* open_entry(const std::string& path, std::size_t n)
+{
+  int fd = open(path.c_str(),O_RDONLY);
+  if(fd < 0)
+    return 0;
+
+  struct stat st;
+  const std::size_t length = data_offset + n * sizeof(Scalar);
+  if(fstat(fd,&st) != 0 || std::size_t(st.st_size) != length)
+    {
+      close(fd);
+      return 0;
+    }
+
+  void* base = mmap(0,length,PROT_READ,MAP_SHARED,fd,0);
+  futimens(fd,0); // most recently used
+  close(fd);
+  if(base == MAP_FAILED)
+    return 0;
+
+  const char* head = static_cast<const char*>(base);
+  uint32_t version, bytes;
+  uint64_t count;
+  std::memcpy(&version,head+8,4);
+  std::memcpy(&bytes,head+12,4);
+  std::memcpy(&count,head+16,8);
+  if(std::memcmp(head,magic,8) != 0 || version != 1 || bytes != sizeof(Scalar) || count != n)
+    {
+      munmap(base,length);
+      return 0;
+    }
+
+  const Scalar* data = reinterpret_cast<const Scalar*>(head + data_offset);
+  register_view(data,base,length,true);
+  return data;
+}
+
+//
+//  removes the least recently used entries until the directory fits
+//  in max_bytes, along with stale temporaries; files still mapped by
+//  any process stay valid until they are unmapped
+//
+void evict(const std::string& dir, std::size_t max_bytes)
+{
+  DIR* d = opendir(dir.c_str());
+  if(d == 0)
+    return;
+
+  std::vector<std::pair<time_t,std::string> > entries;
+  std::map<std::string,std::size_t> sizes;
+  std::size_t total = 0;
+  const time_t now  = time(0);
+
+  for(struct dirent* e = readdir(d); e; e = readdir(d))
+    {
+      std::string name = e->d_name;
+      std::string path = dir + "/" + name;
+      struct stat st;
+      if(stat(path.c_str(),&st) != 0 || !S_ISREG(st.st_mode))
+        continue;
+
+      if(name.compare(0,5,".tmp.") == 0)
+        {
+          if(now - st.st_mtime > stale_seconds)
+            unlink(path.c_str());
+        }
+      else if(name.size() > 4 && name.compare(name.size()-4,4,".mgc") == 0)
+        {
+          entries.push_back(std::make_pair(st.st_mtime,path));
+          sizes[path] = st.st_size;
+          total += st.st_size;
+        }
+    }
+  closedir(d);
+
+  std::sort(entries.begin(),entries.end());
+  for(std::size_t i = 0; i < entries.size() && total > max_bytes; i++)
+    if(unlink(entries[i].second.c_str()) == 0)
+      total -= sizes[entries[i].second];
+}
+
+//
+//  returns a view of the values of func at the given coordinates: from
+//  the cache when possible, otherwise evaluated (into a new cache entry
+//  when the cache is enabled)
+//
+template <typename Scalar>
+const Scalar* cached_eval(const char* kind, const void* func,
+                          const std::vector<const std::vector<Scalar>*>& coords, std::size_t n,
+                          const std::function<int(Scalar*)>& evaluate)
+{
+  std::string dir;
+  std::size_t max_bytes;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    dir       = cache_dir;
+    max_bytes = cache_max;
+  }
+
+  std::string fid, solution;
+  const bool cacheable = !dir.empty() && n > 0 && function_id(func,fid) == 0;
+
+  std::string path;
+  if(cacheable)
+    {
+      hasher h;
+      h.add(kind);
+      h.add(std::string(1,char(sizeof(Scalar))));
+      h.add(fid);
+      if(masa_solution_fingerprint<Scalar>(solution) == 0)
+        h.add(solution);
+      for(unsigned int c = 0; c != coords.size(); c++)
+        add_values(h,coords[c]->data(),coords[c]->size());
+
+      path = dir + "/" + h.hex() + ".mgc";
+      if(const Scalar* hit = open_entry<Scalar>(path,n))
+        return hit;
+    }
+
+  const std::size_t length = data_offset + n * sizeof(Scalar);
+
+  if(cacheable)
+    {
+      // evaluate straight into a temporary file, then publish it
+      std::ostringstream tmp;
+      tmp << dir << "/.tmp." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id())
+          << "." << path.substr(dir.size()+1);
+
+      int fd = open(tmp.str().c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+      if(fd >= 0 && ftruncate(fd,length) == 0)
+        {
+          void* base = mmap(0,length,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+          close(fd);
+          if(base != MAP_FAILED)
+            {
+              char* head = static_cast<char*>(base);
+              uint32_t version = 1, bytes = sizeof(Scalar);
+              uint64_t count   = n;
+              std::memcpy(head,magic,8);
+              std::memcpy(head+8,&version,4);
+              std::memcpy(head+12,&bytes,4);
+              std::memcpy(head+16,&count,8);
+
+              Scalar* data = reinterpret_cast<Scalar*>(head + data_offset);
+              if(evaluate(data) != 0)
+                {
+                  munmap(base,length);
+                  unlink(tmp.str().c_str());
+                  return 0;
+                }
+
+              if(msync(base,length,MS_SYNC) == 0 && rename(tmp.str().c_str(),path.c_str()) == 0)
+                {
+                  evict(dir,max_bytes);
+                  register_view(data,base,length,true);
+                  return data;
+                }
+
+              munmap(base,length);
+            }
+        }
+      else if(fd >= 0)
+        close(fd);
+
+      unlink(tmp.str().c_str());
+      std::cout << "MASA WARNING:: unable to write cache entry in " << dir << ", evaluating without the cache" << std::endl;
+    }
+
+  Scalar* data = static_cast<Scalar*>(malloc(n ? n * sizeof(Scalar) : 1));
+  if(data == 0 || evaluate(data) != 0)
+    {
+      free(data);
+      return 0;
+    }
+
+  register_view(data,data,n * sizeof(Scalar),false);
+  return data;
+}
+
+template <typename Scalar>
+std::vector<const std::vector<Scalar>*> coordinates(const std::vector<Scalar>* x,
+                                                    const std::vector<Scalar>* y = 0,
+                                                    const std::vector<Scalar>* z = 0,
+                                                    const std::vector<Scalar>* t = 0)
+{
+  std::vector<const std::vector<Scalar>*> c;
+  c.push_back(x);
+  if(y) c.push_back(y);
+  if(z) c.push_back(z);
+  if(t) c.push_back(t);
+  return c;
+}
+
+} // end anonymous namespace
+
+// ------------------------------------------------------
+// ---------- cache configuration ------------------------
+// ------------------------------------------------------
+
+//
+//  an empty directory disables the cache
+//
+int MASA::masa_cache_configure(const std::string& dir, std::size_t max_bytes)
+{
+  if(!dir.empty())
+    {
+      struct stat st;
+      if(mkdir(dir.c_str(),0755) != 0 && (stat(dir.c_str(),&st) != 0 || !S_ISDIR(st.st_mode)))
+        {
+          std::cout << "MASA ERROR:: unable to use " << dir << " as a cache directory" << std::endl;
+          return 1;
+        }
+    }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache_dir = dir;
+  cache_max = max_bytes;
+  return 0;
+}
+
+int MASA::masa_cache_release(const void* data)
+{
+  view v;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::map<const void*,view>::iterator it = views.find(data);
+    if(it == views.end())
+      {
+        std::cout << "MASA ERROR:: masa_release_view was passed an unknown view" << std::endl;
+        return 1;
+      }
+    v = it->second;
+    views.erase(it);
+  }
+
+  if(v.mapped)
+    munmap(v.base,v.length);
+  else
+    free(v.base);
+  return 0;
+}
+
+// ------------------------------------------------------
+// ---------- cached batch and grid evaluation -----------
+// ------------------------------------------------------
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_1d_batch_cached(Scalar (*func)(Scalar),
+                                              const std::vector<Scalar>& x)
+{
+  return cached_eval<Scalar>("batch1",reinterpret_cast<const void*>(func),coordinates(&x),x.size(),
+                             [&](Scalar* out) { return masa_eval_1d_batch(func,x.size(),x.data(),out); });
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_2d_batch_cached(Scalar (*func)(Scalar,Scalar),
+                                              const std::vector<Scalar>& x,
+                                              const std::vector<Scalar>& y)
+{
+  if(y.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_2d_batch_cached needs coordinate arrays of equal length" << std::endl;
+      return 0;
+    }
+
+  return cached_eval<Scalar>("batch2",reinterpret_cast<const void*>(func),coordinates(&x,&y),x.size(),
+                             [&](Scalar* out) { return masa_eval_2d_batch(func,x.size(),x.data(),y.data(),out); });
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_3d_batch_cached(Scalar (*func)(Scalar,Scalar,Scalar),
+                                              const std::vector<Scalar>& x,
+                                              const std::vector<Scalar>& y,
+                                              const std::vector<Scalar>& z)
+{
+  if(y.size() != x.size() || z.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_3d_batch_cached needs coordinate arrays of equal length" << std::endl;
+      return 0;
+    }
+
+  return cached_eval<Scalar>("batch3",reinterpret_cast<const void*>(func),coordinates(&x,&y,&z),x.size(),
+                             [&](Scalar* out) { return masa_eval_3d_batch(func,x.size(),x.data(),y.data(),z.data(),out); });
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_4d_batch_cached(Scalar (*func)(Scalar,Scalar,Scalar,Scalar),
+                                              const std::vector<Scalar>& x,
+                                              const std::vector<Scalar>& y,
+                                              const std::vector<Scalar>& z,
+                                              const std::vector<Scalar>& t)
+{
+  if(y.size() != x.size() || z.size() != x.size() || t.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_4d_batch_cached needs coordinate arrays of equal length" << std::endl;
+      return 0;
+    }
+
+  return cached_eval<Scalar>("batch4",reinterpret_cast<const void*>(func),coordinates(&x,&y,&z,&t),x.size(),
+                             [&](Scalar* out) { return masa_eval_4d_batch(func,x.size(),x.data(),y.data(),z.data(),t.data(),out); });
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_2d_grid_cached(Scalar (*func)(Scalar,Scalar),
+                                             const std::vector<Scalar>& x,
+                                             const std::vector<Scalar>& y)
+{
+  return cached_eval<Scalar>("grid2",reinterpret_cast<const void*>(func),coordinates(&x,&y),x.size()*y.size(),
+                             [&](Scalar* out) { return masa_eval_2d_grid(func,x,y,out); });
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_eval_3d_grid_cached(Scalar (*func)(Scalar,Scalar,Scalar),
+                                             const std::vector<Scalar>& x,
+                                             const std::vector<Scalar>& y,
+                                             const std::vector<Scalar>& z)
+{
+  return cached_eval<Scalar>("grid3",reinterpret_cast<const void*>(func),coordinates(&x,&y,&z),x.size()*y.size()*z.size(),
+                             [&](Scalar* out) { return masa_eval_3d_grid(func,x,y,z,out); });
+}
+
+// Instantiate for every precision
+
+#define INSTANTIATE_CACHE_FUNCTIONS(Scalar) \
+  template const Scalar* masa_eval_1d_batch_cached<Scalar>(Scalar (*)(Scalar),const std::vector<Scalar>&); \
+  template const Scalar* masa_eval_2d_batch_cached<Scalar>(Scalar (*)(Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&); \
+  template const Scalar* masa_eval_3d_batch_cached<Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&); \
+  template const Scalar* masa_eval_4d_batch_cached<Scalar>(Scalar (*)(Scalar,Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&); \
+  template const Scalar* masa_eval_2d_grid_cached <Scalar>(Scalar (*)(Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&); \
+  template const Scalar* masa_eval_3d_grid_cached <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&)
+
+namespace MASA {
+
+INSTANTIATE_CACHE_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_CACHE_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+INSTANTIATE_CACHE_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_CACHE_FUNCTIONS(DoubleDouble);
+#endif
+
+}
@@ -35,7 +35,11 @@
 //
 
 #include <masa_internal.h>
+#include <algorithm>
 #include <limits>
+#include <mutex>
+#include <set>
+#include <typeindex>
 #include <assert.h>
 
 using namespace MASA;
@@ -59,18 +63,185 @@ long double pow(long double a, double b){return pow(a,(long double)(b));};
 #endif          
 
 
+// Parameter schemas: an instance starts out on the empty schema. At its
+// first registration it looks up the schema of the class being
+// constructed; if there is one, it only checks each registration
+// against the next entry and copies nothing. The first instance of a
+// class, and one whose registrations stop matching, builds a private
+// copy instead. Once constructed, share_params looks up the schema of
+// its class, the most derived one: the instance keeps or adopts it if
+// it registered the same parameters in the same places, and offers its
+// own to the later instances if there is none yet.
+
+namespace {
+
+std::mutex& schema_lock()
+{
+  static std::mutex lock;
+  return lock;
+}
+
+std::map<std::type_index,std::shared_ptr<param_schema> >& class_schemas()
+{
+  static std::map<std::type_index,std::shared_ptr<param_schema> > schemas;
+  return schemas;
+}
+
+const std::shared_ptr<param_schema>& empty_schema()
+{
+  static const std::shared_ptr<param_schema> empty = []()
+    {
+      std::shared_ptr<param_schema> e = std::make_shared<param_schema>();
+      e->varname.push_back("");
+      e->varoff.push_back(0);
+      e->vecname.push_back("");
+      e->vecoff.push_back(0);
+      return e;
+    }();
+  return empty;
+}
+
+bool same_params(const param_schema& a, const param_schema& b)
+{
+  return a.varname == b.varname && a.varoff == b.varoff &&
+         a.vecname == b.vecname && a.vecoff == b.vecoff;
+}
+
+} // end anonymous namespace
+
+MASA::solution_name& MASA::solution_name::operator=(const std::string& name)
+{
+  static std::set<std::string> interned;
+  std::lock_guard<std::mutex> guard(schema_lock());
+
+  _name = interned.insert(name).first->c_str();
+  return *this;
+}
+
 template <typename Scalar>
 MASA::manufactured_solution<Scalar>::manufactured_solution()
+  : schema(empty_schema()),
+    schema_shared(true),
+    share_schema(true),
+    followed_vars(0),
+    followed_vecs(0)
 {  
-  std::vector<Scalar> dumvec;
-
   num_vars=0;                   // default -- will ++ for each registered variable
+  num_vec=0;                    // default -- will ++ for each registered vector
+  revision=0;
+  derive=0;
+  memo=0;
   dummy=0;
-  dumvec.resize(2);
-  vararr.push_back(&dummy);   // dummy used to start index at correct location
-  vecarr.push_back(&dumvec);   // dummy used to start index at correct location
+  transient=false;
+  fields=0;
   }
 
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::register_param(bool vector, const std::string& in, const void* place)
+{
+  const std::ptrdiff_t offset = static_cast<const char*>(place) - reinterpret_cast<const char*>(this);
+
+  if(schema == empty_schema() && share_schema)
+    {
+      // typeid is the class being constructed, usually the final one
+      std::lock_guard<std::mutex> guard(schema_lock());
+      std::map<std::type_index,std::shared_ptr<param_schema> >::const_iterator known =
+        class_schemas().find(std::type_index(typeid(*this)));
+      if(known != class_schemas().end())
+        {
+          schema = known->second;
+          followed_vars = followed_vecs = 1;
+        }
+    }
+
+  if(followed_vars)
+    {
+      std::size_t& k = vector ? followed_vecs : followed_vars;
+      const std::vector<std::string>& names = vector ? schema->vecname : schema->varname;
+      const std::vector<std::ptrdiff_t>& offs = vector ? schema->vecoff : schema->varoff;
+      if(k < names.size() && names[k] == in && offs[k] == offset)
+        {
+          k++;
+          return 0;
+        }
+      own_schema();
+    }
+
+  // variable already registered! no unique identifier can exist!
+  if((vector ? schema->vecmap : schema->varmap).count(in))
+    {
+      std::cout << "\n MASA FATAL ERROR:: \n"; 
+      std::cout << "\n Attempted to register two " << (vector ? "vectors" : "variables") << " of the same name.\n"; 
+      std::cout << " Info: error occured while constructing " << mmsname << std::endl << std::endl;
+      return 1;
+    }
+
+  if(schema_shared)
+    {
+      schema = std::make_shared<param_schema>(*schema);
+      schema_shared = false;
+    }
+
+  std::vector<std::string>& names = vector ? schema->vecname : schema->varname;
+  (vector ? schema->vecmap : schema->varmap)[in] = names.size();
+  (vector ? schema->vecoff : schema->varoff).push_back(offset);
+  names.push_back(in);
+  return 0;
+}
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::own_schema()
+{
+  std::shared_ptr<param_schema> own = std::make_shared<param_schema>();
+  own->varname.assign(schema->varname.begin(),schema->varname.begin() + followed_vars);
+  own->varoff.assign(schema->varoff.begin(),schema->varoff.begin() + followed_vars);
+  own->vecname.assign(schema->vecname.begin(),schema->vecname.begin() + followed_vecs);
+  own->vecoff.assign(schema->vecoff.begin(),schema->vecoff.begin() + followed_vecs);
+  for(std::size_t i = 1; i < own->varname.size(); i++)
+    own->varmap[own->varname[i]] = int(i);
+  for(std::size_t i = 1; i < own->vecname.size(); i++)
+    own->vecmap[own->vecname[i]] = int(i);
+
+  schema = own;
+  schema_shared = false;
+  followed_vars = followed_vecs = 0;
+}
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::share_params()
+{
+  if(followed_vars)
+    {
+      // complete, and followed as the schema of the final class
+      std::lock_guard<std::mutex> guard(schema_lock());
+      std::map<std::type_index,std::shared_ptr<param_schema> >::const_iterator known =
+        class_schemas().find(std::type_index(typeid(*this)));
+      if(share_schema && known != class_schemas().end() && known->second == schema &&
+         followed_vars == schema->varname.size() && followed_vecs == schema->vecname.size())
+        {
+          followed_vars = followed_vecs = 0;
+          return;
+        }
+    }
+  if(followed_vars)
+    own_schema();
+
+  if(schema_shared || !share_schema)
+    return;
+
+  // keyed on the complete object: typeid is only the most derived
+  // class once the constructors are done
+  std::lock_guard<std::mutex> guard(schema_lock());
+  std::pair<std::map<std::type_index,std::shared_ptr<param_schema> >::iterator,bool> known =
+    class_schemas().insert(std::make_pair(std::type_index(typeid(*this)),schema));
+
+  if(known.second || same_params(*known.first->second,*schema))
+    {
+      schema = known.first->second;
+      schema_shared = true;
+    }
+}
+
 // define PI and other constants
 namespace {
   using std::acos;
@@ -86,30 +257,13 @@ template <typename Scalar>
 const Scalar MASA::manufactured_solution<Scalar>::MASA_VAR_DEFAULT = -12345.67; // default init each var to 'crazy' val
 
 template <typename Scalar>
-int MASA::manufactured_solution<Scalar>::register_vec(std::string in,std::vector<Scalar>& vec)
+int MASA::manufactured_solution<Scalar>::register_vec(const std::string& in,std::vector<Scalar>& vec)
 {
-
-  // working fine here
-  //std::cout << (*vec).size() << std::endl;
-
   // first, check to ensure that no such vec has already been mapped
-  if(vecmap[in] <= 0) // 0 implies variable has not been registered
-    {  
-      // if vec has not been registered, register the vec
-      num_vec++;           // we want to step num_vars up by one ONLY when adding a new vec.
-      vecmap[in]=num_vec;
-      vecarr.push_back(&vec);
-    }
-  else  // variable already registered! no unique identifier can exist!
-    {
-      std::cout << "\n MASA FATAL ERROR:: \n"; 
-      std::cout << "\n Attempted to register two vectors of the same name.\n"; 
-      std::string error;
-      return_name(&error);
-      std::cout << " Info: error occured while constructing " << error << std::endl << std::endl;
-      return 1;
-    }
+  if(register_param(true,in,&vec))
+    return 1;
 
+  num_vec++;           // we want to step num_vars up by one ONLY when adding a new vec.
   return 0; // smooth sailing
   
 }// done with register_vec function
@@ -120,19 +274,16 @@ int MASA::manufactured_solution<Scalar>::get_vec(std::string name,std::vector<Sc
   std::map<std::string,int>::const_iterator selector;
   
   // find variable
-  selector = vecmap.find(name);
+  selector = schema->vecmap.find(name);
   
   // error handling
-  if(selector == vecmap.end())
+  if(selector == schema->vecmap.end())
     {
       std::cout << "\nMASA ERROR!!!:: No such variable  (" << name << ") exists\n";
       return 1;
     }
   
-  //std::cout << "this is: " << vec.size();
-  vec = *vecarr[selector->second];   // set to value 
-  //std::cout << "this is: " << vecarr[(*selector).second]->size();
-  //std::cout << "this is: " << vec.size();
+  vec = this->vec(selector->second);   // set to value 
   return 0;
 
 }
@@ -140,23 +291,22 @@ int MASA::manufactured_solution<Scalar>::get_vec(std::string name,std::vector<Sc
 template <typename Scalar>
 int MASA::manufactured_solution<Scalar>::set_vec(std::string var,std::vector<Scalar>& vec)
 {
-  //std::cout << "vec is: " << (*vec)[0] << std::endl;
-  //std::cout << "vecarr is: " << vecarr[selector->second] << std::endl;
-
   std::map<std::string,int>::const_iterator selector;
 
   // find variable
-  selector = vecmap.find(var);
+  selector = schema->vecmap.find(var);
   
   // error handling
- if(selector == vecmap.end())
+ if(selector == schema->vecmap.end())
     {
       std::cout << "\nMASA ERROR!!!:: No such array  (" << var << ") exists to be set\n";
       return 1;
     }
  
  // fix vector to same size and values as new guy
- *vecarr[selector->second] = vec;
+ this->vec(selector->second) = vec;
+ revision++;
+ update_derived();
   return 0; // exit with no error
  
 }// done with set_vec function
@@ -164,15 +314,12 @@ int MASA::manufactured_solution<Scalar>::set_vec(std::string var,std::vector<Sca
 template <typename Scalar>
 int MASA::manufactured_solution<Scalar>::display_vec()
 {
-  std::vector<Scalar>* vec;
-  
-  std::cout << "\nMASA :: Solution has " << vecmap.size() << " vector(s).\n";
+  std::cout << "\nMASA :: Solution has " << schema->vecmap.size() << " vector(s).\n";
   std::cout << "*-------------------------------------*\n" ;
 
-  for(std::map<std::string,int>::const_iterator it = vecmap.begin(); it != vecmap.end(); ++it)
+  for(std::map<std::string,int>::const_iterator it = schema->vecmap.begin(); it != schema->vecmap.end(); ++it)
     {      
-      vec = vecarr[it->second];
-      std::cout << it->first <<" is size: " << vec->size() << '\n';      
+      std::cout << it->first <<" is size: " << vec(it->second).size() << '\n';      
     }
 
   std::cout << "*-------------------------------------*\n" ;
@@ -187,16 +334,16 @@ Scalar MASA::manufactured_solution<Scalar>::get_var(std::string var)
   std::map<std::string,int>::const_iterator selector;
   
   // find variable
-  selector = varmap.find(var);
+  selector = schema->varmap.find(var);
   
   // error handling
-  if(selector == varmap.end())
+  if(selector == schema->varmap.end())
     {
       std::cout << "\nMASA ERROR!!!:: No such variable  (" << var << ") exists\n";
       return -20;
     }
   
-  return *vararr[(*selector).second];   // set to value 
+  return this->var((*selector).second);   // set to value 
   
 }// done with get_var function
 
@@ -206,22 +353,22 @@ int MASA::manufactured_solution<Scalar>::display_var()
 {
   Scalar threshold = 5 * std::numeric_limits<Scalar>::epsilon();
 
-  std::cout << "\nMASA :: Solution has " << varmap.size() << " variables.\n";
+  std::cout << "\nMASA :: Solution has " << schema->varmap.size() << " variables.\n";
   std::cout << "*-------------------------------------*\n" ;
 
-  for(std::map<std::string,int>::const_iterator it = varmap.begin(); it != varmap.end(); ++it)
+  for(std::map<std::string,int>::const_iterator it = schema->varmap.begin(); it != schema->varmap.end(); ++it)
     {   
       // adding conditional to avoid confusing our users about uninitalized variables
       // this is because the default is a bit odd... -12345.7 might appear 'set'
 
-      if(fabs(*vararr[it->second] - MASA_VAR_DEFAULT) <= threshold)
+      if(masa_any(fabs(var(it->second) - MASA_VAR_DEFAULT) <= threshold))
 	{
 	  std::cout << it->first <<" is set to: Uninitialized\n";
 	}
       else //value has been set
 	{
 	  std::cout.precision(16);
-	  std::cout << it->first <<" is set to: " << *vararr[it->second] << '\n';
+	  std::cout << it->first <<" is set to: " << var(it->second) << '\n';
 	}
       
     }    
@@ -238,17 +385,19 @@ int MASA::manufactured_solution<Scalar>::set_var(std::string var, Scalar val)
   std::map<std::string,int>::const_iterator selector;
   
   // find variable
-  selector = varmap.find(var);
+  selector = schema->varmap.find(var);
   
   // error handling
-  if( selector == varmap.end() )
+  if( selector == schema->varmap.end() )
     {
       std::cout << "\nMASA ERROR!!!:: No such variable  (" << var << ") exists to be set\n";
       return 1;
     }
   
   // set new value
-  *vararr[(*selector).second] = val;
+  this->var((*selector).second) = val;
+  revision++;
+  update_derived();
   return 0; // exit with no error
 
 }// done with set_var function
@@ -257,14 +406,24 @@ template <typename Scalar>
 int MASA::manufactured_solution<Scalar>::purge_var()
 {
   // MASA_VAR_DEFAULT
-  for(std::map<std::string,int>::const_iterator it = varmap.begin(); it != varmap.end(); ++it)
+  for(std::map<std::string,int>::const_iterator it = schema->varmap.begin(); it != schema->varmap.end(); ++it)
     {      
-      *vararr[it->second]=MASA_VAR_DEFAULT;      
+      var(it->second)=MASA_VAR_DEFAULT;      
     }
+  revision++;
+  update_derived();
   return 0;
 }// done with purge_var function
 
 
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::enable_memo(std::size_t capacity)
+{
+  delete memo;
+  memo = capacity ? new point_memo<Scalar>(capacity) : 0;
+  return 0;
+}// done with enable_memo function
+
 template <typename Scalar>
 Scalar MASA::manufactured_solution<Scalar>::pass_function(Scalar (*in_func)(Scalar),Scalar a)
 {
@@ -281,32 +440,29 @@ int MASA::manufactured_solution<Scalar>::sanity_check()
   Scalar thresh = 1.0e-10;
 
   // check all scalar values
-  for(std::map<std::string,int>::const_iterator it = varmap.begin(); it != varmap.end(); ++it)
+  for(std::map<std::string,int>::const_iterator it = schema->varmap.begin(); it != schema->varmap.end(); ++it)
     {      
-      if(std::abs((*vararr[it->second] - MASA_VAR_DEFAULT)/MASA_VAR_DEFAULT) < thresh)
+      if(masa_any(abs((var(it->second) - MASA_VAR_DEFAULT)/MASA_VAR_DEFAULT) < thresh))
 	{
 	  std::cout << "\nMASA WARNING:: " << it->first << " has not been initialized!\n";
-	  std::cout << "Current value is: " << std::abs((*vararr[it->second] - MASA_VAR_DEFAULT)/MASA_VAR_DEFAULT) << std::endl;
+	  std::cout << "Current value is: " << std::abs((var(it->second) - MASA_VAR_DEFAULT)/MASA_VAR_DEFAULT) << std::endl;
 	  flag += 1;
 	}
     }    
   
-  if(int(varmap.size()) != num_vars)
+  if(int(schema->varmap.size()) != num_vars)
     {
       std::cout << "\n MASA FATAL ERROR:: mismatch in number of variables registered.\n"; 
       std::cout << "Are you calling the method manufactured_solution.register_var? This could be causing the error.\n"; 
-      std::cout << "varmap.size() = " << varmap.size() << "; num_vars = " << num_vars << std::endl << std::endl;
+      std::cout << "varmap.size() = " << schema->varmap.size() << "; num_vars = " << num_vars << std::endl << std::endl;
       masa_exit(1);
     }
 
   
   // check all vector values -- this has a subtle bug
-  for(std::map<std::string,int>::const_iterator it = vecmap.begin(); it != vecmap.end(); ++it)
+  for(std::map<std::string,int>::const_iterator it = schema->vecmap.begin(); it != schema->vecmap.end(); ++it)
     {    
-      std::vector<Scalar>* vec;
-      vec = vecarr[it->second];
-	
-      if((*vec).size() == 0)
+      if(vec(it->second).size() == 0)
 	{
 	  std::cout << "\nMASA WARNING:: vector " << it->first << " has not been initialized!\n";
 	  flag += 1;
@@ -326,30 +482,373 @@ int MASA::manufactured_solution<Scalar>::sanity_check()
 }// done with ssanity check
 
 template <typename Scalar>
-int MASA::manufactured_solution<Scalar>::register_var(std::string in,Scalar* var)
+int MASA::manufactured_solution<Scalar>::register_var(const std::string& in,Scalar* var)
 {
   // first, check to ensure that no such variable has already been mapped
-  if(varmap[in] <= 0) // 0 implies variable has not been registered
-    {  
-      // if variable has not been registered, register the variable
-      num_vars++;           // we want to step num_vars up by one ONLY when adding a new variable.
-      varmap[in]=num_vars;
-      *var=MASA_VAR_DEFAULT;
-      vararr.push_back(var);
+  if(register_param(false,in,var))
+    return 1;
+
+  num_vars++;           // we want to step num_vars up by one ONLY when adding a new variable.
+  *var=MASA_VAR_DEFAULT;
+  return 0; // smooth sailing
+  
+}// done with register_var function
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::fingerprint(std::string& bytes) const
+{
+  bytes.append(mmsname.c_str());
+  bytes.push_back('\0');
+
+  // values are written as exact hex floats (long double has padding
+  // bytes), and the maps are ordered by name, so the result does not
+  // depend on the order in which the solution registered its variables
+  std::ostringstream os;
+  os << std::hexfloat;
+
+  for(std::map<std::string,int>::const_iterator it = schema->varmap.begin(); it != schema->varmap.end(); ++it)
+    os << it->first << '=' << var(it->second) << ';';
+
+  for(std::map<std::string,int>::const_iterator it = schema->vecmap.begin(); it != schema->vecmap.end(); ++it)
+    {
+      const std::vector<Scalar>& v = vec(it->second);
+      os << it->first << '[' << v.size() << "]=";
+      for(unsigned int i = 0; i != v.size(); i++)
+        os << v[i] << ',';
+      os << ';';
     }
-  else  // variable already registered! no unique identifier can exist!
+
+  bytes.append(os.str());
+}
+
+template <typename Scalar>
+template <typename Other>
+int MASA::manufactured_solution<Scalar>::copy_var(const manufactured_solution<Other>& other)
+{
+  std::map<std::string,int>::const_iterator selector;
+
+  // instances of the same class sharing a schema agree on the indices
+  if(schema == other.schema)
     {
-      std::cout << "\n MASA FATAL ERROR:: \n"; 
-      std::cout << "\n Attempted to register two variables of the same name.\n"; 
-      std::string error;
-      return_name(&error);
-      std::cout << " Info: error occured while constructing " << error << std::endl << std::endl;
+      for(unsigned int i = 1; i != schema->varoff.size(); i++)
+        var(i) = Scalar(other.var(i));
+      for(unsigned int i = 1; i != schema->vecoff.size(); i++)
+        vec(i).assign(other.vec(i).begin(),other.vec(i).end());
+      revision++;
+      update_derived();
+      return 0;
+    }
+
+  // both instances must be the same solution: match every variable by name
+  for(std::map<std::string,int>::const_iterator it = other.schema->varmap.begin(); it != other.schema->varmap.end(); ++it)
+    {
+      selector = schema->varmap.find(it->first);
+      if(selector == schema->varmap.end())
+        {
+          std::cout << "\nMASA ERROR!!!:: No such variable  (" << it->first << ") exists to be copied\n";
+          return 1;
+        }
+      var(selector->second) = Scalar(other.var(it->second));
+    }
+
+  for(std::map<std::string,int>::const_iterator it = other.schema->vecmap.begin(); it != other.schema->vecmap.end(); ++it)
+    {
+      selector = schema->vecmap.find(it->first);
+      if(selector == schema->vecmap.end())
+        {
+          std::cout << "\nMASA ERROR!!!:: No such array  (" << it->first << ") exists to be copied\n";
+          return 1;
+        }
+      vec(selector->second).assign(other.vec(it->second).begin(),other.vec(it->second).end());
+    }
+
+  revision++;
+  update_derived();
+  return 0;
+}
+
+// Capabilities: the fields come from the class (declare_fields), the
+// rest from what the instance registered
+
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::field_capabilities(const std::string& field) const
+{
+  if(fields == 0)
+    return 0;
+
+  std::map<std::string,int>::const_iterator it = fields->find(field);
+  return it == fields->end() ? 0 : it->second;
+}
+
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::capabilities() const
+{
+  int caps = 0;
+
+  if(fields)
+    for(std::map<std::string,int>::const_iterator it = fields->begin(); it != fields->end(); ++it)
+      {
+        caps |= it->second;
+        if(it->first.compare(0,5,"grad_") == 0)
+          caps |= MASA_CAP_GRADIENT;
+        if(it->first.compare(0,8,"hessian_") == 0)
+          caps |= MASA_CAP_HESSIAN;
+      }
+
+  if(transient)
+    caps |= MASA_CAP_TRANSIENT;
+  if(!schema->vecmap.empty())
+    caps |= MASA_CAP_VECTORS;
+
+  return caps;
+}
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::list_fields(std::vector<std::string>& names, std::vector<int>& dims) const
+{
+  names.clear();
+  dims.clear();
+  if(fields == 0)
+    return;
+
+  for(std::map<std::string,int>::const_iterator it = fields->begin(); it != fields->end(); ++it)
+    {
+      names.push_back(it->first);
+      dims.push_back(it->second);
+    }
+}
+
+// Parameter snapshots: the variables in the order the solution
+// registered them, then the elements of every vector. Index 0 of the
+// schema is a placeholder.
+
+// A snapshot holds the variables in registration order, then for each
+// vector its length and its elements
+
+template <typename Scalar>
+std::size_t MASA::manufactured_solution<Scalar>::num_params() const
+{
+  std::size_t n = schema->varoff.size() - 1;
+  for(std::size_t i = 1; i < schema->vecoff.size(); i++)
+    n += 1 + vec(i).size();
+  return n;
+}
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::save_var(Scalar* values) const
+{
+  for(std::size_t i = 1; i < schema->varoff.size(); i++)
+    *values++ = var(i);
+  for(std::size_t i = 1; i < schema->vecoff.size(); i++)
+    {
+      *values++ = Scalar(double(vec(i).size()));
+      values = std::copy(vec(i).begin(),vec(i).end(),values);
+    }
+}
+
+template <typename Scalar>
+bool MASA::manufactured_solution<Scalar>::snapshot_fits(const Scalar* values) const
+{
+  values += schema->varoff.size() - 1;
+  for(std::size_t i = 1; i < schema->vecoff.size(); i++)
+    {
+      if(masa_any(*values != Scalar(double(vec(i).size()))))
+        return false;
+      values += 1 + vec(i).size();
+    }
+  return true;
+}
+
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::load_var(const Scalar* values)
+{
+  if(!snapshot_fits(values))
+    {
+      std::cout << "MASA ERROR:: the snapshot holds vectors of other lengths than those of " << mmsname << "\n";
       return 1;
     }
 
-  return 0; // smooth sailing
-  
-}// done with register_var function
+  for(std::size_t i = 1; i < schema->varoff.size(); i++)
+    var(i) = *values++;
+  for(std::size_t i = 1; i < schema->vecoff.size(); i++)
+    {
+      values++;
+      std::copy(values,values + vec(i).size(),vec(i).begin());
+      values += vec(i).size();
+    }
+  revision++;
+  update_derived();
+  return 0;
+}
+
+// The binary form, in the byte order of the machine:
+//   "MASAPRM1", sizeof(Scalar) and its digits (uint32),
+//   the solution name, the number of variables (uint32) and for each
+//   its name and value, the number of vectors (uint32) and for each
+//   its name, length (uint64) and values
+// where names are a uint32 length and the characters. Variables and
+// vectors are set by name, so the form does not depend on the order
+// in which the solution registers them; a vector of another length
+// than the one of the solution is refused.
+
+namespace {
+
+const char param_magic[] = "MASAPRM1";
+
+void put_bytes(std::string& bytes, const void* p, std::size_t n)
+{
+  bytes.append(static_cast<const char*>(p),n);
+}
+
+void put_u32(std::string& bytes, uint32_t v) { put_bytes(bytes,&v,sizeof(v)); }
+
+void put_name(std::string& bytes, const std::string& name)
+{
+  put_u32(bytes,name.size());
+  bytes.append(name);
+}
+
+struct param_reader
+{
+  const std::string& bytes;
+  std::size_t pos;
+  bool ok;
+
+  param_reader(const std::string& b) : bytes(b), pos(0), ok(true) {}
+
+  void get_bytes(void* p, std::size_t n)
+  {
+    ok = ok && n <= bytes.size() - pos;
+    if(ok)
+      {
+        memcpy(p,bytes.data() + pos,n);
+        pos += n;
+      }
+  }
+
+  uint32_t get_u32() { uint32_t v = 0; get_bytes(&v,sizeof(v)); return v; }
+  uint64_t get_u64() { uint64_t v = 0; get_bytes(&v,sizeof(v)); return v; }
+
+  std::string get_name()
+  {
+    const uint32_t n = get_u32();
+    ok = ok && n <= bytes.size() - pos;
+    if(!ok)
+      return std::string();
+    pos += n;
+    return bytes.substr(pos - n,n);
+  }
+};
+
+} // end anonymous namespace
+
+template <typename Scalar>
+void MASA::manufactured_solution<Scalar>::serialize_var(std::string& bytes) const
+{
+  put_bytes(bytes,param_magic,8);
+  put_u32(bytes,sizeof(Scalar));
+  put_u32(bytes,std::numeric_limits<Scalar>::digits);
+  put_name(bytes,mmsname.c_str());
+
+  put_u32(bytes,schema->varmap.size());
+  for(std::map<std::string,int>::const_iterator it = schema->varmap.begin(); it != schema->varmap.end(); ++it)
+    {
+      put_name(bytes,it->first);
+      put_bytes(bytes,&var(it->second),sizeof(Scalar));
+    }
+
+  put_u32(bytes,schema->vecmap.size());
+  for(std::map<std::string,int>::const_iterator it = schema->vecmap.begin(); it != schema->vecmap.end(); ++it)
+    {
+      const std::vector<Scalar>& v = vec(it->second);
+      const uint64_t n = v.size();
+      put_name(bytes,it->first);
+      put_bytes(bytes,&n,sizeof(n));
+      if(n)
+        put_bytes(bytes,v.data(),n * sizeof(Scalar));
+    }
+}
+
+template <typename Scalar>
+int MASA::manufactured_solution<Scalar>::deserialize_var(const std::string& bytes)
+{
+  param_reader in(bytes);
+
+  char magic[8];
+  in.get_bytes(magic,8);
+  if(!in.ok || memcmp(magic,param_magic,8) != 0)
+    {
+      std::cout << "MASA ERROR:: not the binary form of MASA parameters\n";
+      return 1;
+    }
+  if(in.get_u32() != sizeof(Scalar) || in.get_u32() != uint32_t(std::numeric_limits<Scalar>::digits))
+    {
+      std::cout << "MASA ERROR:: the parameters were written in another floating point type\n";
+      return 1;
+    }
+  const std::string name = in.get_name();
+  if(in.ok && name != mmsname.c_str())
+    {
+      std::cout << "MASA ERROR:: the parameters are those of " << name << ", not of " << mmsname << "\n";
+      return 1;
+    }
+
+  // everything is read and checked before any parameter changes
+  std::vector<std::pair<int,Scalar> > vars(in.get_u32());
+  for(std::size_t i = 0; in.ok && i != vars.size(); i++)
+    {
+      const std::string param = in.get_name();
+      std::map<std::string,int>::const_iterator it = schema->varmap.find(param);
+      in.get_bytes(&vars[i].second,sizeof(Scalar));
+      if(in.ok && it == schema->varmap.end())
+        {
+          std::cout << "MASA ERROR:: " << mmsname << " has no variable " << param << " to restore\n";
+          return 1;
+        }
+      if(in.ok)
+        vars[i].first = it->second;
+    }
+
+  std::vector<std::pair<int,std::vector<Scalar> > > vecs(in.ok ? in.get_u32() : 0);
+  for(std::size_t i = 0; in.ok && i != vecs.size(); i++)
+    {
+      const std::string param = in.get_name();
+      std::map<std::string,int>::const_iterator it = schema->vecmap.find(param);
+      const uint64_t n = in.get_u64();
+      in.ok = in.ok && n <= (bytes.size() - in.pos) / sizeof(Scalar);
+      if(in.ok && it == schema->vecmap.end())
+        {
+          std::cout << "MASA ERROR:: " << mmsname << " has no vector " << param << " to restore\n";
+          return 1;
+        }
+      if(in.ok && n != vec(it->second).size())
+        {
+          std::cout << "MASA ERROR:: vector " << param << " of " << mmsname << " has " << vec(it->second).size()
+                    << " elements, not the " << n << " restored\n";
+          return 1;
+        }
+      if(in.ok)
+        {
+          vecs[i].first = it->second;
+          vecs[i].second.resize(n);
+          in.get_bytes(vecs[i].second.data(),n * sizeof(Scalar));
+        }
+    }
+
+  if(!in.ok || in.pos != bytes.size())
+    {
+      std::cout << "MASA ERROR:: the binary form of the parameters of " << mmsname << " is truncated or corrupt\n";
+      return 1;
+    }
+
+  for(std::size_t i = 0; i != vars.size(); i++)
+    var(vars[i].first) = vars[i].second;
+  for(std::size_t i = 0; i != vecs.size(); i++)
+    vec(vecs[i].first).swap(vecs[i].second);
+  revision++;
+  update_derived();
+  return 0;
+}
 
 /* ------------------------------------------------
  *
@@ -490,10 +989,10 @@ int MASA::manufactured_solution<Scalar>::poly_test()
   poly.set_coeffs( a );
 
   // Check to make sure we get back what we set
-  if( abs( a0 - poly.get_coeffs( 0 ) ) > thresh ) return_flag = 1;
-  if( abs( a1 - poly.get_coeffs( 1 ) ) > thresh ) return_flag = 1;
-  if( abs( a2 - poly.get_coeffs( 2 ) ) > thresh ) return_flag = 1;
-  if( abs( a3 - poly.get_coeffs( 3 ) ) > thresh ) return_flag = 1;
+  if( masa_any( abs( a0 - poly.get_coeffs( 0 ) ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( a1 - poly.get_coeffs( 1 ) ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( a2 - poly.get_coeffs( 2 ) ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( a3 - poly.get_coeffs( 3 ) ) > thresh ) ) return_flag = 1;
 
   // Check polynomial evaluation
   const Scalar x = 2.0;
@@ -503,7 +1002,7 @@ int MASA::manufactured_solution<Scalar>::poly_test()
   computed_value = poly( x , &ierr);
   if(ierr != 0) return_flag=1;
 
-  if( abs( exact_value - computed_value ) > thresh ) return_flag = 1;
+  if( masa_any( abs( exact_value - computed_value ) > thresh ) ) return_flag = 1;
 
   // Check derivatives
   const Scalar dx = 62;
@@ -514,10 +1013,10 @@ int MASA::manufactured_solution<Scalar>::poly_test()
 
   poly.eval_derivs( x, 4, derivs );
   
-  if( abs( exact_value - derivs[0] ) > thresh ) return_flag = 1;
-  if( abs( dx  - derivs[1] ) > thresh ) return_flag = 1;
-  if( abs( d2x - derivs[2] ) > thresh ) return_flag = 1;
-  if( abs( d3x - derivs[3] ) > thresh ) return_flag = 1;
+  if( masa_any( abs( exact_value - derivs[0] ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( dx  - derivs[1] ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( d2x - derivs[2] ) > thresh ) ) return_flag = 1;
+  if( masa_any( abs( d3x - derivs[3] ) > thresh ) ) return_flag = 1;
 
   return return_flag;
 }
@@ -566,3 +1065,20 @@ MASA_INSTANTIATE_ALL(MASA::manufactured_solution);
 MASA_INSTANTIATE_ALL(MASA::masa_test_function);
 MASA_INSTANTIATE_ALL(MASA::masa_uninit);
 MASA_INSTANTIATE_ALL(MASA::Polynomial);
+
+#ifndef MASA_LANE_MODULE
+template int MASA::manufactured_solution<double>::copy_var(const MASA::manufactured_solution<double>&);
+template int MASA::manufactured_solution<MASA::masa_simd>::copy_var(const MASA::manufactured_solution<double>&);
+#ifndef MASA_OMIT_FLOAT
+template int MASA::manufactured_solution<float>::copy_var(const MASA::manufactured_solution<float>&);
+template int MASA::manufactured_solution<float>::copy_var(const MASA::manufactured_solution<double>&);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+template int MASA::manufactured_solution<long double>::copy_var(const MASA::manufactured_solution<long double>&);
+template int MASA::manufactured_solution<long double>::copy_var(const MASA::manufactured_solution<double>&);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+template int MASA::manufactured_solution<DoubleDouble>::copy_var(const MASA::manufactured_solution<DoubleDouble>&);
+template int MASA::manufactured_solution<DoubleDouble>::copy_var(const MASA::manufactured_solution<double>&);
+#endif
+#endif
@@ -34,6 +34,8 @@
 #include <config.h>        // for MASA_EXCEPTIONS conditional
 #include <smasa.h>
 #include <map>
+#include <mutex>
+#include <type_traits>
 
 using namespace MASA;
 using namespace std;
@@ -54,16 +56,28 @@ public:
       for(typename map<std::string,manufactured_solution<Scalar>*>::iterator iter = this->_master_map.begin(); iter != this->_master_map.end(); iter++)
         delete iter->second;
 
+    for(typename map<manufactured_solution<Scalar>*,std::vector<manufactured_solution<Scalar>*> >::iterator iter = _clones.begin(); iter != _clones.end(); iter++)
+      for(unsigned int i=0; i != iter->second.size(); ++i)
+        delete iter->second[i];
+
+    for(unsigned int i=0; i != _replaced.size(); ++i)
+      delete _replaced[i];
+
     // workaround for icpc 12.1.6 "double destruct globals" bug
     _master_map.clear();
+    _clones.clear();
   }
 
   const manufactured_solution<Scalar>& get_ms() const {
+    if(_thread_pointer)
+      return *_thread_pointer;
     verify_pointer_sanity();
     return *_master_pointer;
   }
 
   manufactured_solution<Scalar>& get_ms() {
+    if(_thread_pointer)
+      return *_thread_pointer;
     verify_pointer_sanity();
     return *_master_pointer;
   }
@@ -72,10 +86,36 @@ public:
 
   void init_mms(const std::string& my_name, const std::string& masa_name);
 
+  void add_mms(const std::string& my_name, manufactured_solution<Scalar>* ms);
+
   void list_mms() const;
 
   unsigned int size() const { return _master_map.size(); }
 
+  int parallel_eval(std::size_t n, const std::function<void(std::size_t,std::size_t)>& body,
+                    const std::vector<std::size_t>& partition);
+
+  int fingerprint(std::string& bytes) const {
+    const manufactured_solution<Scalar>* ms = _thread_pointer ? _thread_pointer : _master_pointer;
+    if(ms == 0)
+      return 1;
+    ms->fingerprint(bytes);
+    return 0;
+  }
+
+  manufactured_solution<Scalar>* selected() {
+    return _thread_pointer ? _thread_pointer : _master_pointer;
+  }
+
+  int revision(const void*& solution, unsigned long& rev) const {
+    const manufactured_solution<Scalar>* ms = _thread_pointer ? _thread_pointer : _master_pointer;
+    if(ms == 0)
+      return 1;
+    solution = ms;
+    rev = ms->get_revision();
+    return 0;
+  }
+
 private:
   //
   //  this function checks the user has an active mms
@@ -84,88 +124,383 @@ private:
 
   manufactured_solution<Scalar>*             _master_pointer; // pointer to currently selected manufactured solution
   std::map<std::string, manufactured_solution<Scalar> *> _master_map; // global map b/t unique name and manuf class
+
+  // private copies of each solution for the pool worker threads, not
+  // counting those a batch running on another thread has taken out,
+  // and the copy the current thread evaluates while inside a batch
+  std::map<manufactured_solution<Scalar>*, std::vector<manufactured_solution<Scalar>*> > _clones;
+  std::mutex _clones_lock;
+  static thread_local manufactured_solution<Scalar>* _thread_pointer;
+
+  // solutions whose handle was given to another one; they are kept
+  // until the end, since copies of them are looked up by address
+  std::vector<manufactured_solution<Scalar>*> _replaced;
 };
 
+template <typename Scalar>
+thread_local manufactured_solution<Scalar>* MasterMS<Scalar>::_thread_pointer = NULL;
+
+
+// The fields a solution class evaluates: a field is available at a
+// number of coordinates when the class declares its own eval_* member
+// of that signature, instead of inheriting the default that reports an
+// error. Found from the declarations, so that nothing is evaluated.
+template <typename Sig, typename C>
+C* declared_in(Sig C::*);
+
+#define MASA_DECLARED(member)                                                   \
+  template <typename S, typename Sig>                                           \
+  auto member##_declared(int) -> decltype(declared_in<Sig>(&S::member));       \
+  template <typename S, typename Sig>                                           \
+  void member##_declared(...);
+
+MASA_DECLARED(eval_exact_t)
+MASA_DECLARED(eval_exact_u)
+MASA_DECLARED(eval_exact_v)
+MASA_DECLARED(eval_exact_w)
+MASA_DECLARED(eval_exact_p)
+MASA_DECLARED(eval_exact_phi)
+MASA_DECLARED(eval_exact_rho)
+MASA_DECLARED(eval_exact_nu)
+MASA_DECLARED(eval_exact_rho_N)
+MASA_DECLARED(eval_exact_rho_N2)
+MASA_DECLARED(eval_exact_rho_C)
+MASA_DECLARED(eval_exact_rho_C3)
+MASA_DECLARED(eval_q_t)
+MASA_DECLARED(eval_q_u)
+MASA_DECLARED(eval_q_v)
+MASA_DECLARED(eval_q_w)
+MASA_DECLARED(eval_q_e)
+MASA_DECLARED(eval_q_f)
+MASA_DECLARED(eval_q_nu)
+MASA_DECLARED(eval_q_rho)
+MASA_DECLARED(eval_q_rho_u)
+MASA_DECLARED(eval_q_rho_v)
+MASA_DECLARED(eval_q_rho_w)
+MASA_DECLARED(eval_q_rho_e)
+MASA_DECLARED(eval_q_C)
+MASA_DECLARED(eval_q_C3)
+MASA_DECLARED(eval_q_rho_C)
+MASA_DECLARED(eval_q_rho_C3)
+MASA_DECLARED(eval_q_rho_N)
+MASA_DECLARED(eval_q_rho_N2)
+MASA_DECLARED(eval_q_u_boundary)
+MASA_DECLARED(eval_g_t)
+MASA_DECLARED(eval_g_u)
+MASA_DECLARED(eval_g_v)
+MASA_DECLARED(eval_g_w)
+MASA_DECLARED(eval_g_p)
+MASA_DECLARED(eval_g_rho)
+MASA_DECLARED(eval_hess_t)
+MASA_DECLARED(eval_hess_u)
+MASA_DECLARED(eval_hess_v)
+MASA_DECLARED(eval_hess_w)
+MASA_DECLARED(eval_hess_p)
+MASA_DECLARED(eval_hess_rho)
+
+#undef MASA_DECLARED
+
+template <typename Scalar, template <typename> class Solution>
+struct solution_fields
+{
+  std::map<std::string,int> bits;
+
+  solution_fields()
+  {
+    typedef Solution<Scalar> S;
+    typedef Scalar d1(Scalar);
+    typedef Scalar d2(Scalar,Scalar);
+    typedef Scalar d3(Scalar,Scalar,Scalar);
+    typedef Scalar d4(Scalar,Scalar,Scalar,Scalar);
+    typedef Scalar f1(Scalar,Scalar (*)(Scalar));
+    typedef Scalar g2(Scalar,Scalar,int);
+    typedef Scalar g3(Scalar,Scalar,Scalar,int);
+    typedef Scalar g4(Scalar,Scalar,Scalar,Scalar,int);
+    typedef int    h2(Scalar,Scalar,Scalar*);
+    typedef int    h3(Scalar,Scalar,Scalar,Scalar*);
+    typedef int    h4(Scalar,Scalar,Scalar,Scalar,Scalar*);
+
+#define MASA_FIELD(name,member,bit,sig) \
+    if(std::is_same<decltype(member##_declared<S,sig>(0)),S*>::value) bits[name] |= bit
+    MASA_FIELD("exact_t",       eval_exact_t,        MASA_CAP_1D, d1);
+    MASA_FIELD("exact_t",       eval_exact_t,        MASA_CAP_2D, d2);
+    MASA_FIELD("exact_t",       eval_exact_t,        MASA_CAP_3D, d3);
+    MASA_FIELD("exact_t",       eval_exact_t,        MASA_CAP_4D, d4);
+    MASA_FIELD("exact_u",       eval_exact_u,        MASA_CAP_1D, d1);
+    MASA_FIELD("exact_u",       eval_exact_u,        MASA_CAP_2D, d2);
+    MASA_FIELD("exact_u",       eval_exact_u,        MASA_CAP_3D, d3);
+    MASA_FIELD("exact_u",       eval_exact_u,        MASA_CAP_4D, d4);
+    MASA_FIELD("exact_v",       eval_exact_v,        MASA_CAP_1D, d1);
+    MASA_FIELD("exact_v",       eval_exact_v,        MASA_CAP_2D, d2);
+    MASA_FIELD("exact_v",       eval_exact_v,        MASA_CAP_3D, d3);
+    MASA_FIELD("exact_v",       eval_exact_v,        MASA_CAP_4D, d4);
+    MASA_FIELD("exact_w",       eval_exact_w,        MASA_CAP_1D, d1);
+    MASA_FIELD("exact_w",       eval_exact_w,        MASA_CAP_2D, d2);
+    MASA_FIELD("exact_w",       eval_exact_w,        MASA_CAP_3D, d3);
+    MASA_FIELD("exact_w",       eval_exact_w,        MASA_CAP_4D, d4);
+    MASA_FIELD("exact_p",       eval_exact_p,        MASA_CAP_1D, d1);
+    MASA_FIELD("exact_p",       eval_exact_p,        MASA_CAP_2D, d2);
+    MASA_FIELD("exact_p",       eval_exact_p,        MASA_CAP_3D, d3);
+    MASA_FIELD("exact_p",       eval_exact_p,        MASA_CAP_4D, d4);
+    MASA_FIELD("exact_rho",     eval_exact_rho,      MASA_CAP_1D, d1);
+    MASA_FIELD("exact_rho",     eval_exact_rho,      MASA_CAP_2D, d2);
+    MASA_FIELD("exact_rho",     eval_exact_rho,      MASA_CAP_3D, d3);
+    MASA_FIELD("exact_rho",     eval_exact_rho,      MASA_CAP_4D, d4);
+    MASA_FIELD("exact_phi",     eval_exact_phi,      MASA_CAP_2D, d2);
+    MASA_FIELD("exact_nu",      eval_exact_nu,       MASA_CAP_2D, d2);
+    MASA_FIELD("exact_nu",      eval_exact_nu,       MASA_CAP_3D, d3);
+    MASA_FIELD("exact_rho_N",   eval_exact_rho_N,    MASA_CAP_1D, d1);
+    MASA_FIELD("exact_rho_N2",  eval_exact_rho_N2,   MASA_CAP_1D, d1);
+    MASA_FIELD("exact_rho_C",   eval_exact_rho_C,    MASA_CAP_1D, d1);
+    MASA_FIELD("exact_rho_C",   eval_exact_rho_C,    MASA_CAP_2D, d2);
+    MASA_FIELD("exact_rho_C",   eval_exact_rho_C,    MASA_CAP_3D, d3);
+    MASA_FIELD("exact_rho_C3",  eval_exact_rho_C3,   MASA_CAP_1D, d1);
+    MASA_FIELD("exact_rho_C3",  eval_exact_rho_C3,   MASA_CAP_2D, d2);
+    MASA_FIELD("exact_rho_C3",  eval_exact_rho_C3,   MASA_CAP_3D, d3);
+    MASA_FIELD("q_t",           eval_q_t,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_t",           eval_q_t,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_t",           eval_q_t,            MASA_CAP_3D, d3);
+    MASA_FIELD("q_t",           eval_q_t,            MASA_CAP_4D, d4);
+    MASA_FIELD("q_u",           eval_q_u,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_u",           eval_q_u,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_u",           eval_q_u,            MASA_CAP_3D, d3);
+    MASA_FIELD("q_u",           eval_q_u,            MASA_CAP_4D, d4);
+    MASA_FIELD("q_v",           eval_q_v,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_v",           eval_q_v,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_v",           eval_q_v,            MASA_CAP_3D, d3);
+    MASA_FIELD("q_v",           eval_q_v,            MASA_CAP_4D, d4);
+    MASA_FIELD("q_w",           eval_q_w,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_w",           eval_q_w,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_w",           eval_q_w,            MASA_CAP_3D, d3);
+    MASA_FIELD("q_w",           eval_q_w,            MASA_CAP_4D, d4);
+    MASA_FIELD("q_rho",         eval_q_rho,          MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho",         eval_q_rho,          MASA_CAP_2D, d2);
+    MASA_FIELD("q_rho",         eval_q_rho,          MASA_CAP_3D, d3);
+    MASA_FIELD("q_rho",         eval_q_rho,          MASA_CAP_4D, d4);
+    MASA_FIELD("q_rho_u",       eval_q_rho_u,        MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_u",       eval_q_rho_u,        MASA_CAP_2D, d2);
+    MASA_FIELD("q_rho_u",       eval_q_rho_u,        MASA_CAP_3D, d3);
+    MASA_FIELD("q_rho_u",       eval_q_rho_u,        MASA_CAP_4D, d4);
+    MASA_FIELD("q_rho_v",       eval_q_rho_v,        MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_v",       eval_q_rho_v,        MASA_CAP_2D, d2);
+    MASA_FIELD("q_rho_v",       eval_q_rho_v,        MASA_CAP_3D, d3);
+    MASA_FIELD("q_rho_v",       eval_q_rho_v,        MASA_CAP_4D, d4);
+    MASA_FIELD("q_rho_w",       eval_q_rho_w,        MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_w",       eval_q_rho_w,        MASA_CAP_2D, d2);
+    MASA_FIELD("q_rho_w",       eval_q_rho_w,        MASA_CAP_3D, d3);
+    MASA_FIELD("q_rho_w",       eval_q_rho_w,        MASA_CAP_4D, d4);
+    MASA_FIELD("q_rho_e",       eval_q_rho_e,        MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_e",       eval_q_rho_e,        MASA_CAP_2D, d2);
+    MASA_FIELD("q_rho_e",       eval_q_rho_e,        MASA_CAP_3D, d3);
+    MASA_FIELD("q_rho_e",       eval_q_rho_e,        MASA_CAP_4D, d4);
+    MASA_FIELD("q_e",           eval_q_e,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_e",           eval_q_e,            MASA_CAP_1D, f1);
+    MASA_FIELD("q_e",           eval_q_e,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_e",           eval_q_e,            MASA_CAP_3D, d3);
+    MASA_FIELD("q_e",           eval_q_e,            MASA_CAP_4D, d4);
+    MASA_FIELD("q_f",           eval_q_f,            MASA_CAP_2D, d2);
+    MASA_FIELD("q_nu",          eval_q_nu,           MASA_CAP_2D, d2);
+    MASA_FIELD("q_nu",          eval_q_nu,           MASA_CAP_3D, d3);
+    MASA_FIELD("q_C",           eval_q_C,            MASA_CAP_1D, d1);
+    MASA_FIELD("q_C3",          eval_q_C3,           MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_C",       eval_q_rho_C,        MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_C3",      eval_q_rho_C3,       MASA_CAP_1D, d1);
+    MASA_FIELD("q_rho_N",       eval_q_rho_N,        MASA_CAP_1D, f1);
+    MASA_FIELD("q_rho_N2",      eval_q_rho_N2,       MASA_CAP_1D, f1);
+    MASA_FIELD("q_boundary",    eval_q_u_boundary,   MASA_CAP_1D, d1);
+    MASA_FIELD("grad_t",        eval_g_t,            MASA_CAP_1D, d1);
+    MASA_FIELD("grad_t",        eval_g_t,            MASA_CAP_2D, g2);
+    MASA_FIELD("grad_t",        eval_g_t,            MASA_CAP_3D, g3);
+    MASA_FIELD("grad_t",        eval_g_t,            MASA_CAP_4D, g4);
+    MASA_FIELD("grad_u",        eval_g_u,            MASA_CAP_1D, d1);
+    MASA_FIELD("grad_u",        eval_g_u,            MASA_CAP_2D, g2);
+    MASA_FIELD("grad_u",        eval_g_u,            MASA_CAP_3D, g3);
+    MASA_FIELD("grad_u",        eval_g_u,            MASA_CAP_4D, g4);
+    MASA_FIELD("grad_v",        eval_g_v,            MASA_CAP_1D, d1);
+    MASA_FIELD("grad_v",        eval_g_v,            MASA_CAP_2D, g2);
+    MASA_FIELD("grad_v",        eval_g_v,            MASA_CAP_3D, g3);
+    MASA_FIELD("grad_v",        eval_g_v,            MASA_CAP_4D, g4);
+    MASA_FIELD("grad_w",        eval_g_w,            MASA_CAP_1D, d1);
+    MASA_FIELD("grad_w",        eval_g_w,            MASA_CAP_2D, g2);
+    MASA_FIELD("grad_w",        eval_g_w,            MASA_CAP_3D, g3);
+    MASA_FIELD("grad_w",        eval_g_w,            MASA_CAP_4D, g4);
+    MASA_FIELD("grad_p",        eval_g_p,            MASA_CAP_1D, d1);
+    MASA_FIELD("grad_p",        eval_g_p,            MASA_CAP_2D, g2);
+    MASA_FIELD("grad_p",        eval_g_p,            MASA_CAP_3D, g3);
+    MASA_FIELD("grad_p",        eval_g_p,            MASA_CAP_4D, g4);
+    MASA_FIELD("grad_rho",      eval_g_rho,          MASA_CAP_1D, d1);
+    MASA_FIELD("grad_rho",      eval_g_rho,          MASA_CAP_2D, g2);
+    MASA_FIELD("grad_rho",      eval_g_rho,          MASA_CAP_3D, g3);
+    MASA_FIELD("grad_rho",      eval_g_rho,          MASA_CAP_4D, g4);
+    MASA_FIELD("hessian_t",     eval_hess_t,         MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_t",     eval_hess_t,         MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_t",     eval_hess_t,         MASA_CAP_4D, h4);
+    MASA_FIELD("hessian_u",     eval_hess_u,         MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_u",     eval_hess_u,         MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_u",     eval_hess_u,         MASA_CAP_4D, h4);
+    MASA_FIELD("hessian_v",     eval_hess_v,         MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_v",     eval_hess_v,         MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_v",     eval_hess_v,         MASA_CAP_4D, h4);
+    MASA_FIELD("hessian_w",     eval_hess_w,         MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_w",     eval_hess_w,         MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_w",     eval_hess_w,         MASA_CAP_4D, h4);
+    MASA_FIELD("hessian_p",     eval_hess_p,         MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_p",     eval_hess_p,         MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_p",     eval_hess_p,         MASA_CAP_4D, h4);
+    MASA_FIELD("hessian_rho",   eval_hess_rho,       MASA_CAP_2D, h2);
+    MASA_FIELD("hessian_rho",   eval_hess_rho,       MASA_CAP_3D, h3);
+    MASA_FIELD("hessian_rho",   eval_hess_rho,       MASA_CAP_4D, h4);
+#undef MASA_FIELD
+  }
+};
 
 template <typename Scalar>
-int get_list_mms(std::vector<manufactured_solution<Scalar>*>& anim)
+struct solution_factory
+{
+  typedef manufactured_solution<Scalar>* (*type)();
+};
+
+template <typename Scalar, template <typename> class Solution>
+manufactured_solution<Scalar>* make_solution()
 {
-  // Build a temporary vector of MMS objects, then sort them into our map by name
-  anim.push_back(new masa_test_function<Scalar>());   // test function
-  anim.push_back(new masa_uninit<Scalar>()); // another test function
+  static const solution_fields<Scalar,Solution> fields;
+  manufactured_solution<Scalar>* ms = new Solution<Scalar>();
+  ms->declare_fields(fields.bits);
+  return ms;
+}
+
+template <typename Scalar>
+int get_list_mms(std::vector<typename solution_factory<Scalar>::type>& anim)
+{
+  // Build a vector of MMS constructors, then sort them into our map by name
+  anim.push_back(&make_solution<Scalar,masa_test_function>);   // test function
+  anim.push_back(&make_solution<Scalar,masa_uninit>); // another test function
   
   //  ** register solutions here - lets keep this alphabetical ** 
+  //  (each source configure may leave out sits in its own #if)
 
   // axisymmetric solutions
-  anim.push_back(new axi_cns<Scalar>());
-  anim.push_back(new axi_euler<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns
+  anim.push_back(&make_solution<Scalar,axi_cns>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler
+  anim.push_back(&make_solution<Scalar,axi_euler>);
+#endif
 
   // SMASA::
-  anim.push_back(new cp_normal<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cp_normal
+  anim.push_back(&make_solution<Scalar,cp_normal>);
+#endif
 
   // euler 
-  anim.push_back(new euler_1d<Scalar>());
-  anim.push_back(new euler_2d<Scalar>());
-  anim.push_back(new euler_3d<Scalar>());
-  anim.push_back(new euler_transient_1d<Scalar>());
-  anim.push_back(new euler_transient_2d<Scalar>());
-  anim.push_back(new euler_transient_3d<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler
+  anim.push_back(&make_solution<Scalar,euler_1d>);
+  anim.push_back(&make_solution<Scalar,euler_2d>);
+  anim.push_back(&make_solution<Scalar,euler_3d>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient
+  anim.push_back(&make_solution<Scalar,euler_transient_1d>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_2d
+  anim.push_back(&make_solution<Scalar,euler_transient_2d>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_3d
+  anim.push_back(&make_solution<Scalar,euler_transient_3d>);
+#endif
 
-  anim.push_back(new euler_chem_1d<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_chem
+  anim.push_back(&make_solution<Scalar,euler_chem_1d>);
+#endif
 
   // favre averaged navier stokes
-  anim.push_back(new fans_sa_steady_wall_bounded<Scalar>());
-  anim.push_back(new fans_sa_transient_free_shear<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_fans_sa
+  anim.push_back(&make_solution<Scalar,fans_sa_steady_wall_bounded>);
+  anim.push_back(&make_solution<Scalar,fans_sa_transient_free_shear>);
+#endif
 
   // heat equation
-  anim.push_back(new heateq_1d_steady_const<Scalar>());
-  anim.push_back(new heateq_2d_steady_const<Scalar>());
-  anim.push_back(new heateq_3d_steady_const<Scalar>());
-
-  anim.push_back(new heateq_1d_steady_var<Scalar>());
-  anim.push_back(new heateq_2d_steady_var<Scalar>());
-  anim.push_back(new heateq_3d_steady_var<Scalar>());
-
-  anim.push_back(new heateq_1d_unsteady_const<Scalar>());
-  anim.push_back(new heateq_2d_unsteady_const<Scalar>());
-  anim.push_back(new heateq_3d_unsteady_const<Scalar>());
-
-  anim.push_back(new heateq_1d_unsteady_var<Scalar>());
-  anim.push_back(new heateq_2d_unsteady_var<Scalar>());
-  anim.push_back(new heateq_3d_unsteady_var<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_heat
+  anim.push_back(&make_solution<Scalar,heateq_1d_steady_const>);
+  anim.push_back(&make_solution<Scalar,heateq_2d_steady_const>);
+  anim.push_back(&make_solution<Scalar,heateq_3d_steady_const>);
+
+  anim.push_back(&make_solution<Scalar,heateq_1d_steady_var>);
+  anim.push_back(&make_solution<Scalar,heateq_2d_steady_var>);
+  anim.push_back(&make_solution<Scalar,heateq_3d_steady_var>);
+
+  anim.push_back(&make_solution<Scalar,heateq_1d_unsteady_const>);
+  anim.push_back(&make_solution<Scalar,heateq_2d_unsteady_const>);
+  anim.push_back(&make_solution<Scalar,heateq_3d_unsteady_const>);
+
+  anim.push_back(&make_solution<Scalar,heateq_1d_unsteady_var>);
+  anim.push_back(&make_solution<Scalar,heateq_2d_unsteady_var>);
+  anim.push_back(&make_solution<Scalar,heateq_3d_unsteady_var>);
+#endif
 
   // laplacian
-  anim.push_back(new laplace_2d<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_laplace
+  anim.push_back(&make_solution<Scalar,laplace_2d>);
+#endif
 
   // navier stokes
-  anim.push_back(new navierstokes_2d_compressible<Scalar>());
-  anim.push_back(new navierstokes_3d_compressible<Scalar>());
-  anim.push_back(new navierstokes_4d_compressible_powerlaw<Scalar>());
-  anim.push_back(new navierstokes_ablation_1d_steady<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cns
+  anim.push_back(&make_solution<Scalar,navierstokes_2d_compressible>);
+  anim.push_back(&make_solution<Scalar,navierstokes_3d_compressible>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_nsctpl
+  anim.push_back(&make_solution<Scalar,navierstokes_4d_compressible_powerlaw>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ablation
+  anim.push_back(&make_solution<Scalar,navierstokes_ablation_1d_steady>);
+#endif
 
   // radiation
-  anim.push_back(new radiation_integrated_intensity<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_radiation
+  anim.push_back(&make_solution<Scalar,radiation_integrated_intensity>);
+#endif
 
   // reynolds averaged navier stokes
-  anim.push_back(new rans_sa<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_rans_sa
+  anim.push_back(&make_solution<Scalar,rans_sa>);
+#endif
 
   // sod shock tube
-  anim.push_back(new sod_1d<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_sod
+  anim.push_back(&make_solution<Scalar,sod_1d>);
+#endif
 
   // automatically generated MMS:
 
-  anim.push_back(new burgers_equation<Scalar>());
-  anim.push_back(new axi_euler_transient<Scalar>());
-  anim.push_back(new axi_cns_transient<Scalar>());
-  anim.push_back(new ad_cns_2d_crossterms<Scalar>());
-  anim.push_back(new ad_cns_3d_crossterms<Scalar>());
-  anim.push_back(new convdiff_steady_nosource_1d<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_burgers_equation
+  anim.push_back(&make_solution<Scalar,burgers_equation>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler_transient
+  anim.push_back(&make_solution<Scalar,axi_euler_transient>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns_transient
+  anim.push_back(&make_solution<Scalar,axi_cns_transient>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ad_cns_2d_crossterms
+  anim.push_back(&make_solution<Scalar,ad_cns_2d_crossterms>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ad_cns_3d_crossterms
+  anim.push_back(&make_solution<Scalar,ad_cns_3d_crossterms>);
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_convdiff_steady_nosource_1d
+  anim.push_back(&make_solution<Scalar,convdiff_steady_nosource_1d>);
+#endif
 
-  anim.push_back(new navierstokes_3d_incompressible<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_incompressible
+  anim.push_back(&make_solution<Scalar,navierstokes_3d_incompressible>);
+#endif
 
-  anim.push_back(new navierstokes_3d_incompressible_homogeneous<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_incompressible_homogeneous
+  anim.push_back(&make_solution<Scalar,navierstokes_3d_incompressible_homogeneous>);
+#endif
 
-  anim.push_back(new navierstokes_3d_transient_sutherland<Scalar>());
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_transient_sutherland
+  anim.push_back(&make_solution<Scalar,navierstokes_3d_transient_sutherland>);
+#endif
 
   // --l33t-- DO NOT EDIT THIS LINE OR ANY BELOW IT
 
@@ -173,16 +508,102 @@ int get_list_mms(std::vector<manufactured_solution<Scalar>*>& anim)
   return 0;
 }
 
+//
+// constructor of each solution by name: every solution is built once,
+// and offers its parameter layout to the instances built after it
+//
+template <typename Scalar>
+const std::map<std::string,typename solution_factory<Scalar>::type>& solution_factories()
+{
+  typedef typename solution_factory<Scalar>::type factory;
+  static const std::map<std::string,factory> factories = []()
+    {
+      std::vector<factory> anim;
+      std::map<std::string,factory> by_name;
+      get_list_mms<Scalar>(anim);
+
+      for (unsigned int i=0; i != anim.size(); ++i)
+        {
+          manufactured_solution<Scalar>* ms = anim[i]();
+          std::string name;
+          ms->return_name(&name);
+          if (name.empty())
+            {
+              std::cout << "MASA FATAL ERROR:: manufactured solution has no name!\n";
+              masa_exit(1);
+            }
+          ms->share_params();
+          by_name[name] = anim[i];
+          delete ms;
+        }
+      return by_name;
+    }();
+  return factories;
+}
+
 // Instantiations for every precision
 
 MasterMS<double>      masa_master_double;
+#ifndef MASA_OMIT_FLOAT
+MasterMS<float>       masa_master_float;
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
 MasterMS<long double> masa_master_longdouble;
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+MasterMS<DoubleDouble> masa_master_doubledouble;
+#endif
 
 // Function to return a MasterMS by precision
 template <typename Scalar>
 MasterMS<Scalar>&      masa_master() { return masa_master_double; }
+#ifndef MASA_OMIT_FLOAT
+template <>
+MasterMS<float>&       masa_master() { return masa_master_float; }
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
 template <>
 MasterMS<long double>& masa_master() { return masa_master_longdouble; }
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+template <>
+MasterMS<DoubleDouble>& masa_master() { return masa_master_doubledouble; }
+#endif
+
+// 64 bit FNV-1a of the name of a field, never 0, which marks free entries
+inline uint64_t memo_field_id(const char* name)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for(; *name; name++)
+    h = (h ^ (unsigned char)*name) * 0x100000001b3ULL;
+  return h ? h : 1;
+}
+
+// Evaluates a point through the memo of the selected solution, when one
+// is enabled; field names the public function that is evaluating
+template <typename Scalar, typename Eval, typename... Coords>
+inline Scalar memoized(const char* field, const Eval& eval, Coords... coords)
+{
+  manufactured_solution<Scalar>& ms = masa_master<Scalar>().get_ms();
+  point_memo<Scalar>* memo = ms.get_memo();
+  if(memo == 0)
+    return eval(ms);
+
+  // every call site has its own Eval, so this is hashed once per site
+  static const uint64_t id = memo_field_id(field);
+
+  const Scalar        point[] = {coords...};
+  const unsigned int  n       = sizeof...(Coords);
+  const unsigned long rev     = ms.get_revision();
+  std::size_t slot;
+  Scalar value;
+  if(memo->find(id,rev,point,n,value,slot))
+    return value;
+
+  value = eval(ms);
+  memo->store(slot,id,rev,point,n,value);
+  return value;
+}
 
 }
 
@@ -293,34 +714,205 @@ template <typename Scalar>
 void MasterMS<Scalar>::init_mms(const std::string& my_name,
                                 const std::string& masa_name)
 {
-  std::vector<manufactured_solution<Scalar>*> anim;
-  get_list_mms<Scalar>(anim); //construct maps of MMS objects
-
   std::string mapped_name = masa_name;
   MASA::masa_map(&mapped_name);
 
-  for (unsigned int i=0; i != anim.size(); ++i)
+  manufactured_solution<Scalar>* ms = MASA::masa_new_solution<Scalar>(mapped_name);
+  if (ms)
+    {
+      _master_map[my_name] = _master_pointer = ms;
+      return;
+    }
+
+  std::cout << "MASA FATAL ERROR:: no manufactured solution named " << masa_name << " found!\n";
+  masa_exit(1);
+}
+
+
+//
+//  this function initiates a manufactured solution defined by expressions
+//
+template <typename Scalar>
+int MASA::masa_init_expr(std::string unique_name, std::string equations, std::string definitions)
+{
+  manufactured_solution<Scalar>* ms = masa_new_expr_solution<Scalar>(equations, definitions);
+  if(ms == 0)
+    return 1;
+
+  masa_master<Scalar>().add_mms(unique_name, ms);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_jit_compile(std::string cache_dir)
+{
+  return masa_master<Scalar>().get_ms().jit_compile(cache_dir);
+}
+
+template <typename Scalar>
+void MasterMS<Scalar>::add_mms(const std::string& my_name,
+                               manufactured_solution<Scalar>* ms)
+{
+  typename std::map<std::string, manufactured_solution<Scalar> *>::iterator it = _master_map.find(my_name);
+  if(it != _master_map.end())
+    _replaced.push_back(it->second);
+
+  _master_map[my_name] = _master_pointer = ms;
+}
+
+
+//
+//  this function evaluates body over [0,n) on the thread pool
+//
+//  Solutions are free to keep scratch state in their members while
+//  evaluating (sod_1d, fans_sa_*), so every worker thread other than
+//  the caller gets its own copy of the selected solution, constructed
+//  once and resynchronized with the current parameters on every call.
+//
+template <typename Scalar>
+int MasterMS<Scalar>::parallel_eval(std::size_t n,
+                                    const std::function<void(std::size_t,std::size_t)>& body,
+                                    const std::vector<std::size_t>& partition)
+{
+  const unsigned int nworkers = partition.empty() ? masa_pool_workers(n) : masa_pool_workers(partition.size()-1);
+
+  if(nworkers <= 1)
+    {
+      body(0,n);
+      return 0;
+    }
+
+  if(_master_pointer == 0)
+    {
+      masa_chunk_body chunk = [&](std::size_t begin, std::size_t end, unsigned int) { body(begin,end); };
+      if(partition.empty())
+        masa_parallel_for(n,nworkers,chunk);
+      else
+        masa_parallel_static(partition,nworkers,chunk);
+      return 0;
+    }
+
+  // the batch takes its copies out of the table, so that batches
+  // started from several threads never share one
+  manufactured_solution<Scalar>* const master = _master_pointer;
+  std::vector<manufactured_solution<Scalar>*> clones;
+  {
+    std::lock_guard<std::mutex> guard(_clones_lock);
+    std::vector<manufactured_solution<Scalar>*>& spare = _clones[master];
+    while(!spare.empty() && clones.size() < nworkers-1)
+      {
+        clones.push_back(spare.back());
+        spare.pop_back();
+      }
+  }
+
+  struct give_back
+  {
+    MasterMS& owner;
+    manufactured_solution<Scalar>* master;
+    std::vector<manufactured_solution<Scalar>*>& clones;
+    ~give_back()
+    {
+      std::lock_guard<std::mutex> guard(owner._clones_lock);
+      std::vector<manufactured_solution<Scalar>*>& spare = owner._clones[master];
+      spare.insert(spare.end(),clones.begin(),clones.end());
+    }
+  } returned = {*this,master,clones};
+
+  if(clones.size() < nworkers-1)
     {
       std::string name;
-      anim[i]->return_name(&name);
-      if (name.empty())
-        {
-          std::cout << "MASA FATAL ERROR:: manufactured solution has no name!\n";
-          masa_exit(1);
-        }
-      if (name == mapped_name)
+      master->return_name(&name);
+
+      while(clones.size() < nworkers-1)
         {
-          _master_map[my_name] = _master_pointer = anim[i];
-          return;
+          manufactured_solution<Scalar>* copy = master->clone();
+          if(copy == 0)
+            copy = MASA::masa_new_solution<Scalar>(name);
+
+          if(copy == 0)
+            {
+              std::cout << "MASA FATAL ERROR:: unable to copy manufactured solution " << name << " for threaded evaluation!\n";
+              masa_exit(1);
+            }
+          clones.push_back(copy);
         }
-      else
-        delete anim[i];
     }
 
-  std::cout << "MASA FATAL ERROR:: no manufactured solution named " << masa_name << " found!\n";
-  masa_exit(1);
+  for(unsigned int i=0; i != nworkers-1; ++i)
+    if(clones[i]->copy_var(*master))
+      return 1;
+
+  masa_chunk_body chunk = [&](std::size_t begin, std::size_t end, unsigned int worker)
+    {
+      _thread_pointer = worker ? clones[worker-1] : 0;
+      body(begin,end);
+      _thread_pointer = 0;
+    };
+
+  if(partition.empty())
+    masa_parallel_for(n,nworkers,chunk);
+  else
+    masa_parallel_static(partition,nworkers,chunk);
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_parallel_eval(std::size_t n, const std::function<void(std::size_t,std::size_t)>& body,
+                             const std::vector<std::size_t>& partition)
+{
+  return masa_master<Scalar>().parallel_eval(n,body,partition);
+}
+
+
+template <typename Scalar>
+int MASA::masa_solution_fingerprint(std::string& bytes)
+{
+  return masa_master<Scalar>().fingerprint(bytes);
 }
 
+template <typename Scalar>
+int MASA::masa_enable_memo(std::size_t entries)
+{
+  return masa_master<Scalar>().get_ms().enable_memo(entries);
+}
+
+template <typename Scalar>
+int MASA::masa_memo_stats(unsigned long& hits, unsigned long& misses)
+{
+  point_memo<Scalar>* memo = masa_master<Scalar>().get_ms().get_memo();
+
+  hits = memo ? memo->hits : 0;
+  misses = memo ? memo->misses : 0;
+  return memo ? 0 : 1;
+}
+
+template <typename Scalar>
+MASA::manufactured_solution<Scalar>* MASA::masa_selected_solution()
+{
+  return masa_master<Scalar>().selected();
+}
+
+template <typename Scalar>
+int MASA::masa_solution_revision(const void*& solution, unsigned long& revision)
+{
+  return masa_master<Scalar>().revision(solution,revision);
+}
+
+template <typename Scalar>
+MASA::manufactured_solution<Scalar>* MASA::masa_new_solution(const std::string& name)
+{
+  const std::map<std::string,typename solution_factory<Scalar>::type>& factories = solution_factories<Scalar>();
+  typename std::map<std::string,typename solution_factory<Scalar>::type>::const_iterator it = factories.find(name);
+
+  if(it == factories.end())
+    return 0;
+
+  manufactured_solution<Scalar>* ms = it->second();
+  ms->share_params();
+  return ms;
+}
 
 template <typename Scalar>
 void MasterMS<Scalar>::list_mms() const
@@ -351,20 +943,21 @@ int MASA::masa_list_mms()
 template <typename Scalar>
 int MASA::masa_printid()
 {
-  std::vector<manufactured_solution<Scalar>*> anim;
+  std::vector<typename solution_factory<Scalar>::type> anim;
 
-  get_list_mms(anim); //construct list 
+  get_list_mms<Scalar>(anim); //construct list 
 
   std::cout << std::endl;
   std::cout << "\nMASA :: Available Solutions:\n";
   std::cout << "*-------------------------------------*" ;
 
-  for (typename std::vector<manufactured_solution<Scalar>*>::const_iterator it = anim.begin(); it != anim.end(); ++it) 
+  for (typename std::vector<typename solution_factory<Scalar>::type>::const_iterator it = anim.begin(); it != anim.end(); ++it) 
     {
+      manufactured_solution<Scalar>* ms = (*it)();
       std::string name;
-      (*it)->return_name(&name); // get name
+      ms->return_name(&name); // get name
       std::cout << std::endl << name;
-      delete *it;
+      delete ms;
     } // done with for loop 
 
   std::cout << "\n*-------------------------------------*\n" ;
@@ -414,6 +1007,51 @@ int MASA::masa_get_vec(std::string vector_name,std::vector<Scalar>& vector)
 }
 
 
+template <typename Scalar>
+std::size_t MASA::masa_param_count()
+{
+  return masa_master<Scalar>().get_ms().num_params();
+}
+
+template <typename Scalar>
+int MASA::masa_save_params(std::vector<Scalar>& values)
+{
+  const manufactured_solution<Scalar>& ms = masa_master<Scalar>().get_ms();
+
+  values.resize(ms.num_params());
+  ms.save_var(values.data());
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_load_params(const std::vector<Scalar>& values)
+{
+  manufactured_solution<Scalar>& ms = masa_master<Scalar>().get_ms();
+
+  if(values.size() != ms.num_params())
+    {
+      std::cout << "MASA ERROR:: masa_load_params was given " << values.size()
+                << " values, but the selected solution has " << ms.num_params() << " parameters\n";
+      return 1;
+    }
+
+  return ms.load_var(values.data());
+}
+
+template <typename Scalar>
+int MASA::masa_serialize_params(std::string& bytes)
+{
+  bytes.clear();
+  masa_master<Scalar>().get_ms().serialize_var(bytes);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_deserialize_params(const std::string& bytes)
+{
+  return masa_master<Scalar>().get_ms().deserialize_var(bytes);
+}
+
 template <typename Scalar>
 int MASA::masa_display_param()
 {
@@ -441,67 +1079,67 @@ int MASA::masa_display_vec()
 template <typename Scalar>
 Scalar MASA::masa_eval_source_t(Scalar x) //x 
 {
-  return masa_master<Scalar>().get_ms().eval_q_t(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_t(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_t(Scalar x,Scalar t) //x,t
 {
-  return masa_master<Scalar>().get_ms().eval_q_t(x,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_t(x,t); },x,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_u(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_u(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_u(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_v(Scalar x)  // for SA model
 {
-  return masa_master<Scalar>().get_ms().eval_q_v(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_v(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_w(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_w(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_w(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_u(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_u(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_u(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_v(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_v(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_v(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_w(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_w(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_w(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_e(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_e(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_e(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_boundary(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_u_boundary(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_u_boundary(x); },x);
 }
 
 template <typename Scalar>
@@ -519,31 +1157,31 @@ Scalar MASA::masa_eval_source_rho_N2(Scalar x,Scalar (*in_func)(Scalar))
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_C(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_C(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_C(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_C3(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_C3(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_C3(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_C(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_C(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_C(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_C3(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_C3(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_C3(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_e(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_q_e(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_e(x); },x);
 }
 
 template <typename Scalar>
@@ -559,61 +1197,61 @@ Scalar MASA::masa_eval_source_e(Scalar x,Scalar (*in_func)(Scalar))
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_t(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_t(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_t(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_u(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_u(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_u(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_v(Scalar x) // for SA model
 {
-  return masa_master<Scalar>().get_ms().eval_exact_v(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_v(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_w(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_w(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_w(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_p(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_p(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_p(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_N(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_N(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_N(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_N2(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_N2(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_N2(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C(x); },x);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C3(Scalar x)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C3(x);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C3(x); },x);
 }
 
 // --------------------------------
@@ -717,73 +1355,73 @@ Scalar MASA::masa_eval_grad_rho(Scalar x)
 template <typename Scalar>
 Scalar MASA::masa_eval_source_t(Scalar x,Scalar y,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_t(x,y,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_t(x,y,t); },x,y,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_f(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_f(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_f(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_u(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_u(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_u(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_v(Scalar x,Scalar y)
 {  
-  return masa_master<Scalar>().get_ms().eval_q_v(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_v(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_w(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_w(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_w(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_e(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_e(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_e(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_u(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_u(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_u(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_v(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_v(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_v(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_w(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_w(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_w(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_e(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_e(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_e(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_nu(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_q_nu(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_nu(x,y); },x,y);
 }
 
 
@@ -794,61 +1432,61 @@ Scalar MASA::masa_eval_source_nu(Scalar x,Scalar y)
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_t(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_t(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_t(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_u(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_u(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_u(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_phi(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_phi(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_phi(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_v(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_v(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_v(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_w(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_w(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_w(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_p(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_p(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_p(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_nu(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_nu(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_nu(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C(x,y); },x,y);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C3(Scalar x,Scalar y)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C3(x,y);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C3(x,y); },x,y);
 }
 
 template <typename Scalar>
@@ -901,121 +1539,121 @@ Scalar MASA::masa_eval_grad_rho(Scalar x,Scalar y,int i)
 template <typename Scalar>
 Scalar MASA::masa_eval_source_t(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_t(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_t(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_u(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_u(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_u(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_u(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_u(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_u(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_v(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_v(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_v(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_v(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_v(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_v(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_w(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_w(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_w(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_w(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_w(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_w(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho(Scalar x,Scalar y, Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho(Scalar x,Scalar y, Scalar z, Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_e(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_e(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_e(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_e(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_e(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_e(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_u(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_u(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_u(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_u(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_u(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_u(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_v(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_v(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_v(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_v(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_v(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_v(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_w(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_w(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_w(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_w(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_w(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_w(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_e(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_e(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_e(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_rho_e(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_q_rho_e(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_rho_e(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_source_nu(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_q_nu(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_q_nu(x,y,z); },x,y,z);
 }
 
   // --------------------------------
@@ -1025,91 +1663,91 @@ Scalar MASA::masa_eval_source_nu(Scalar x,Scalar y,Scalar z)
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_t(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_t(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_t(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_t(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_t(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_t(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_u(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_u(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_u(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_u(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_u(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_u(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_v(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_v(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_v(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_v(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_v(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_v(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_w(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_w(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_w(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_w(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_w(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_w(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_p(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_p(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_p(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_p(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_p(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_p(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho(Scalar x,Scalar y,Scalar z,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho(x,y,z,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho(x,y,z,t); },x,y,z,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_nu(Scalar x,Scalar y,Scalar t)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_nu(x,y,t);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_nu(x,y,t); },x,y,t);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
 Scalar MASA::masa_eval_exact_rho_C3(Scalar x,Scalar y,Scalar z)
 {
-  return masa_master<Scalar>().get_ms().eval_exact_rho_C3(x,y,z);
+  return memoized<Scalar>(__func__,[&](manufactured_solution<Scalar>& ms) { return ms.eval_exact_rho_C3(x,y,z); },x,y,z);
 }
 
 template <typename Scalar>
@@ -1184,6 +1822,229 @@ Scalar MASA::masa_eval_grad_rho(Scalar x,Scalar y,Scalar z,Scalar t,int i)
   return masa_master<Scalar>().get_ms().eval_g_rho(x,y,z,t,i);
 }
 
+/* ------------------------------------------------
+ *
+ *         full gradient and hessian of analytical terms
+ *
+ * -----------------------------------------------
+ */ 
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_t(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_t(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_t(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_t(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_t(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_t(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_u(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_u(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_u(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_u(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_u(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_u(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_v(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_v(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_v(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_v(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_v(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_v(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_w(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_w(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_w(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_w(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_w(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_w(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_p(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_p(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_p(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_p(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_p(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_p(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_rho(Scalar x,Scalar y,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_rho(x,y,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_rho(Scalar x,Scalar y,Scalar z,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_rho(x,y,z,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_gradient_rho(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* grad)
+{
+  return masa_master<Scalar>().get_ms().eval_grad_rho(x,y,z,t,grad);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_t(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_t(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_t(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_t(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_t(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_t(x,y,z,t,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_u(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_u(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_u(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_u(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_u(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_u(x,y,z,t,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_v(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_v(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_v(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_v(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_v(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_v(x,y,z,t,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_w(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_w(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_w(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_w(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_w(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_w(x,y,z,t,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_p(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_p(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_p(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_p(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_p(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_p(x,y,z,t,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_rho(Scalar x,Scalar y,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_rho(x,y,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_rho(Scalar x,Scalar y,Scalar z,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_rho(x,y,z,hess);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_hessian_rho(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* hess)
+{
+  return masa_master<Scalar>().get_ms().eval_hess_rho(x,y,z,t,hess);
+}
+
 /* ------------------------------------------------
  *
  *         utility functions
@@ -1207,6 +2068,27 @@ int MASA::masa_get_dimension(int* dim)
   return 0;
 }
 
+template <typename Scalar>
+int MASA::masa_get_capabilities(int* caps)
+{
+  *caps = masa_master<Scalar>().get_ms().capabilities();
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_get_field_capabilities(const std::string& field,int* dims)
+{
+  *dims = masa_master<Scalar>().get_ms().field_capabilities(field);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_get_fields(std::vector<std::string>& fields,std::vector<int>& dims)
+{
+  masa_master<Scalar>().get_ms().list_fields(fields,dims);
+  return 0;
+}
+
 template <typename Scalar>
 int MASA::masa_test_poly()
 {
@@ -1284,6 +2166,15 @@ int MASA::masa_get_numeric_version()
 
 #define INSTANTIATE_ALL_FUNCTIONS(Scalar) \
   template int masa_init      <Scalar>(std::string, std::string); \
+  template int masa_init_expr <Scalar>(std::string, std::string, std::string); \
+  template int masa_jit_compile <Scalar>(std::string); \
+  template int masa_solution_fingerprint <Scalar>(std::string&); \
+  template int masa_solution_revision <Scalar>(const void*&, unsigned long&); \
+  template manufactured_solution<Scalar>* masa_selected_solution <Scalar>(); \
+  template manufactured_solution<Scalar>* masa_new_solution <Scalar>(const std::string&); \
+  template int masa_enable_memo <Scalar>(std::size_t); \
+  template int masa_memo_stats <Scalar>(unsigned long&, unsigned long&); \
+  template int masa_parallel_eval <Scalar>(std::size_t, const std::function<void(std::size_t,std::size_t)>&, const std::vector<std::size_t>&); \
   template int masa_test_default <Scalar>(Scalar);		  \
   template int masa_select_mms<Scalar>(std::string); \
   template int masa_list_mms  <Scalar>(); \
@@ -1294,6 +2185,11 @@ int MASA::masa_get_numeric_version()
   template Scalar masa_get_param<Scalar>(std::string); \
   template void   masa_set_vec<Scalar>(std::string,std::vector<Scalar>&); \
   template int masa_get_vec<Scalar>(std::string,std::vector<Scalar>&); \
+  template std::size_t masa_param_count<Scalar>(); \
+  template int masa_save_params<Scalar>(std::vector<Scalar>&); \
+  template int masa_load_params<Scalar>(const std::vector<Scalar>&); \
+  template int masa_serialize_params<Scalar>(std::string&); \
+  template int masa_deserialize_params<Scalar>(const std::string&); \
   template Scalar masa_eval_source_t  <Scalar>(Scalar);         \
   template Scalar masa_eval_source_t  <Scalar>(Scalar,Scalar);  \
   template Scalar masa_eval_source_f  <Scalar>(Scalar,Scalar);  \
@@ -1411,17 +2307,64 @@ int MASA::masa_get_numeric_version()
   template Scalar masa_eval_grad_rho<Scalar>(Scalar,Scalar,int); \
   template Scalar masa_eval_grad_rho<Scalar>(Scalar,Scalar,Scalar,int); \
   template Scalar masa_eval_grad_rho<Scalar>(Scalar,Scalar,Scalar,Scalar,int); \
+  template int masa_eval_gradient_t<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_t<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_t<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_u<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_u<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_u<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_v<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_v<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_v<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_w<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_w<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_w<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_p<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_p<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_p<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_rho<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_rho<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_gradient_rho<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_t<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_t<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_t<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_u<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_u<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_u<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_v<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_v<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_v<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_w<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_w<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_w<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_p<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_p<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_p<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_rho<Scalar>(Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_rho<Scalar>(Scalar,Scalar,Scalar,Scalar*); \
+  template int masa_eval_hessian_rho<Scalar>(Scalar,Scalar,Scalar,Scalar,Scalar*); \
   template int masa_test_poly<Scalar>();                             \
   template int masa_printid<Scalar>(); \
   template int masa_display_param<Scalar>(); \
   template int masa_display_vec<Scalar>(); \
   template int masa_get_name<Scalar>(std::string*); \
   template int masa_get_dimension<Scalar>(int*); \
+  template int masa_get_capabilities<Scalar>(int*); \
+  template int masa_get_field_capabilities<Scalar>(const std::string&,int*); \
+  template int masa_get_fields<Scalar>(std::vector<std::string>&,std::vector<int>&); \
   template int masa_sanity_check<Scalar>()
 
 namespace MASA {
 
 INSTANTIATE_ALL_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_ALL_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
 INSTANTIATE_ALL_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_ALL_FUNCTIONS(DoubleDouble);
+#endif
 
 }
@@ -0,0 +1,2157 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_expr.cpp: manufactured solutions defined at run time by
+//                expression strings, compiled to register bytecode
+//                whose source terms are derived by automatic
+//                differentiation
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <config.h>
+#include <masa_internal.h>
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+class expr_graph;
+
+// a node of the graph being built, used as a scalar: the DualNumbers
+// over it derive the source terms as new nodes instead of numbers
+// (native specializations). Declared ahead of the DualNumber headers,
+// which look up its functions in std.
+struct expr_sym
+{
+  int id;
+
+  expr_sym();
+  expr_sym(long double c);
+  expr_sym(int node, bool) : id(node) {}
+
+  expr_sym& operator+=(const expr_sym& b);
+  expr_sym& operator-=(const expr_sym& b);
+  expr_sym& operator*=(const expr_sym& b);
+  expr_sym& operator/=(const expr_sym& b);
+
+  static thread_local expr_graph* graph;   // where the nodes go, per thread
+};
+
+// points expr_sym at g for the lifetime of the scope, restoring the
+// graph it pointed at before even if building the nodes throws
+class expr_graph_scope
+{
+public:
+  explicit expr_graph_scope(expr_graph& g) : _outer(expr_sym::graph) { expr_sym::graph = &g; }
+  ~expr_graph_scope() { expr_sym::graph = _outer; }
+
+private:
+  expr_graph_scope(const expr_graph_scope&);
+  expr_graph_scope& operator=(const expr_graph_scope&);
+
+  expr_graph* _outer;
+};
+
+expr_sym operator+(const expr_sym& a, const expr_sym& b);
+expr_sym operator-(const expr_sym& a, const expr_sym& b);
+expr_sym operator*(const expr_sym& a, const expr_sym& b);
+expr_sym operator/(const expr_sym& a, const expr_sym& b);
+expr_sym operator-(const expr_sym& a);
+
+} // end anonymous namespace
+
+ScalarBuiltin_true(expr_sym);
+
+CompareTypes_single(expr_sym);
+CompareTypes_all(int, expr_sym);
+CompareTypes_all(float, expr_sym);
+CompareTypes_all(double, expr_sym);
+CompareTypes_all(long double, expr_sym);
+
+namespace std {
+  expr_sym sin  (const expr_sym& a);
+  expr_sym cos  (const expr_sym& a);
+  expr_sym tan  (const expr_sym& a);
+  expr_sym asin (const expr_sym& a);
+  expr_sym acos (const expr_sym& a);
+  expr_sym atan (const expr_sym& a);
+  expr_sym sinh (const expr_sym& a);
+  expr_sym cosh (const expr_sym& a);
+  expr_sym tanh (const expr_sym& a);
+  expr_sym exp  (const expr_sym& a);
+  expr_sym log  (const expr_sym& a);
+  expr_sym log10(const expr_sym& a);
+  expr_sym sqrt (const expr_sym& a);
+  expr_sym pow  (const expr_sym& a, const expr_sym& b);
+}
+
+#include <ad_masa.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+using namespace MASA;
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * expression graph
+ *
+ * every subexpression of the definitions is a node, created once for
+ * each distinct (operation, operands) and folded when its operands are
+ * constants, so that repeated subexpressions are evaluated only once.
+ * Operands always precede the nodes using them.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+enum expr_op { OP_CONST, OP_COORD, OP_PARAM,
+               OP_NEG, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_POWI,
+               OP_SIN, OP_COS, OP_TAN, OP_ASIN, OP_ACOS, OP_ATAN,
+               OP_SINH, OP_COSH, OP_TANH, OP_EXP, OP_LOG, OP_LOG10, OP_SQRT };
+
+struct expr_function
+{
+  const char* name;
+  int         op;
+  int         args;
+};
+
+const expr_function expr_functions[] = {
+  {"sin",  OP_SIN,  1}, {"cos",  OP_COS,  1}, {"tan",  OP_TAN,  1},
+  {"asin", OP_ASIN, 1}, {"acos", OP_ACOS, 1}, {"atan", OP_ATAN, 1},
+  {"sinh", OP_SINH, 1}, {"cosh", OP_COSH, 1}, {"tanh", OP_TANH, 1},
+  {"exp",  OP_EXP,  1}, {"log",  OP_LOG,  1}, {"log10",OP_LOG10,1},
+  {"sqrt", OP_SQRT, 1}, {"pow",  OP_POW,  2}};
+
+const expr_function* find_function(const std::string& name)
+{
+  for(unsigned int i = 0; i != sizeof(expr_functions)/sizeof(expr_functions[0]); i++)
+    if(name == expr_functions[i].name)
+      return &expr_functions[i];
+  return 0;
+}
+
+// integer powers are multiplied out, by repeated squaring
+template <typename Scalar, typename T>
+T expr_powi(const T& a, int n)
+{
+  if(n < 0)
+    return Scalar(1) / expr_powi<Scalar>(a,-n);
+
+  T b = a;
+  T r = a;
+  bool first = true;
+  for(;;)
+    {
+      if(n & 1)
+        {
+          if(first)
+            r = b;
+          else
+            r = r * b;
+          first = false;
+        }
+      n >>= 1;
+      if(n == 0)
+        return r;
+      b = b * b;
+    }
+}
+
+// a^b for a constant exponent b: unlike the DualNumber pow, does not
+// differentiate through log(a), so negative bases keep finite derivatives
+template <typename Scalar>
+Scalar expr_pow(const Scalar& a, const Scalar& b)
+{
+  using std::pow;
+  return pow(a,b);
+}
+
+template <typename T, typename D, typename Scalar>
+DualNumber<T,D> expr_pow(const DualNumber<T,D>& a, const Scalar& b)
+{
+  const T dv = b * expr_pow(a.value(), b - Scalar(1));
+  return DualNumber<T,D>(expr_pow(a.value(), b), dv * a.derivatives());
+}
+
+// applies a unary or binary operation, to constants while folding and
+// to the parameter dependent nodes before each evaluation
+template <typename Scalar>
+Scalar expr_apply(int op, const Scalar& a, const Scalar& b, int n)
+{
+  using std::sin; using std::cos; using std::tan; using std::asin; using std::acos; using std::atan;
+  using std::sinh; using std::cosh; using std::tanh; using std::exp; using std::log; using std::log10;
+  using std::sqrt;
+
+  switch(op)
+    {
+    case OP_NEG:   return -a;
+    case OP_ADD:   return a + b;
+    case OP_SUB:   return a - b;
+    case OP_MUL:   return a * b;
+    case OP_DIV:   return a / b;
+    case OP_POW:   return expr_pow(a,b);
+    case OP_POWI:  return expr_powi<Scalar>(a,n);
+    case OP_SIN:   return sin(a);
+    case OP_COS:   return cos(a);
+    case OP_TAN:   return tan(a);
+    case OP_ASIN:  return asin(a);
+    case OP_ACOS:  return acos(a);
+    case OP_ATAN:  return atan(a);
+    case OP_SINH:  return sinh(a);
+    case OP_COSH:  return cosh(a);
+    case OP_TANH:  return tanh(a);
+    case OP_EXP:   return exp(a);
+    case OP_LOG:   return log(a);
+    case OP_LOG10: return log10(a);
+    case OP_SQRT:  return sqrt(a);
+    }
+  return a;
+}
+
+struct expr_node
+{
+  int         op;
+  int         a, b;     // operands, -1 if unused
+  int         n;        // coordinate, parameter or integer exponent
+  long double c;        // value of a constant
+  bool        uniform;  // does not depend on the coordinates
+
+  bool operator<(const expr_node& o) const
+  {
+    if(op != o.op) return op < o.op;
+    if(a  != o.a)  return a  < o.a;
+    if(b  != o.b)  return b  < o.b;
+    if(n  != o.n)  return n  < o.n;
+    if(std::isnan(c) || std::isnan(o.c))
+      return !std::isnan(c) && std::isnan(o.c);
+    return c < o.c;
+  }
+};
+
+class expr_graph
+{
+public:
+  std::vector<expr_node> nodes;
+
+  int constant(long double c) { return add(OP_CONST,-1,-1,0,c); }
+  int coord(int i)            { return add(OP_COORD,-1,-1,i,0); }
+  int param(int i)            { return add(OP_PARAM,-1,-1,i,0); }
+
+  bool is_constant(int i, long double c) const
+  {
+    return nodes[i].op == OP_CONST && nodes[i].c == c;
+  }
+
+  int unary(int op, int a)
+  {
+    if(nodes[a].op == OP_CONST)
+      return constant(expr_apply<long double>(op,nodes[a].c,0,0));
+    if(op == OP_NEG && nodes[a].op == OP_NEG)
+      return nodes[a].a;
+    return add(op,a,-1,0,0);
+  }
+
+  int binary(int op, int a, int b)
+  {
+    if(nodes[a].op == OP_CONST && nodes[b].op == OP_CONST)
+      return constant(expr_apply<long double>(op,nodes[a].c,nodes[b].c,0));
+
+    switch(op)
+      {
+      case OP_ADD:
+        if(is_constant(a,0)) return b;
+        if(is_constant(b,0)) return a;
+        break;
+      case OP_SUB:
+        if(is_constant(b,0)) return a;
+        if(is_constant(a,0)) return unary(OP_NEG,b);
+        break;
+      case OP_MUL:
+        if(is_constant(a,1)) return b;
+        if(is_constant(b,1)) return a;
+        if(is_constant(a,0) || is_constant(b,0)) return constant(0);
+        if(is_constant(a,-1)) return unary(OP_NEG,b);
+        if(is_constant(b,-1)) return unary(OP_NEG,a);
+        break;
+      case OP_DIV:
+        if(is_constant(b,1)) return a;
+        break;
+      case OP_POW:
+        if(nodes[b].op == OP_CONST && std::fabs(nodes[b].c) <= 16 &&
+           nodes[b].c == static_cast<int>(nodes[b].c))
+          return powi(a,static_cast<int>(nodes[b].c));
+        break;
+      }
+
+    // commutative operations are stored with their operands ordered
+    if((op == OP_ADD || op == OP_MUL) && b < a)
+      std::swap(a,b);
+
+    return add(op,a,b,0,0);
+  }
+
+  int powi(int a, int n)
+  {
+    if(n == 0) return constant(1);
+    if(n == 1) return a;
+    return add(OP_POWI,a,-1,n,0);
+  }
+
+private:
+  std::map<expr_node,int> _index;
+
+  int add(int op, int a, int b, int n, long double c)
+  {
+    expr_node e = {op,a,b,n,c,op != OP_COORD};
+    if(a >= 0) e.uniform = e.uniform && nodes[a].uniform;
+    if(b >= 0) e.uniform = e.uniform && nodes[b].uniform;
+
+    std::map<expr_node,int>::iterator it = _index.find(e);
+    if(it != _index.end())
+      return it->second;
+
+    nodes.push_back(e);
+    return _index[e] = nodes.size() - 1;
+  }
+};
+
+thread_local expr_graph* expr_sym::graph = 0;
+
+expr_sym::expr_sym()              : id(graph->constant(0)) {}
+expr_sym::expr_sym(long double c) : id(graph->constant(c)) {}
+
+expr_sym operator+(const expr_sym& a, const expr_sym& b) { return expr_sym(expr_sym::graph->binary(OP_ADD,a.id,b.id),true); }
+expr_sym operator-(const expr_sym& a, const expr_sym& b) { return expr_sym(expr_sym::graph->binary(OP_SUB,a.id,b.id),true); }
+expr_sym operator*(const expr_sym& a, const expr_sym& b) { return expr_sym(expr_sym::graph->binary(OP_MUL,a.id,b.id),true); }
+expr_sym operator/(const expr_sym& a, const expr_sym& b) { return expr_sym(expr_sym::graph->binary(OP_DIV,a.id,b.id),true); }
+expr_sym operator-(const expr_sym& a)                    { return expr_sym(expr_sym::graph->unary(OP_NEG,a.id),true); }
+
+expr_sym& expr_sym::operator+=(const expr_sym& b) { return *this = *this + b; }
+expr_sym& expr_sym::operator-=(const expr_sym& b) { return *this = *this - b; }
+expr_sym& expr_sym::operator*=(const expr_sym& b) { return *this = *this * b; }
+expr_sym& expr_sym::operator/=(const expr_sym& b) { return *this = *this / b; }
+
+} // end anonymous namespace
+
+#define MASA_EXPR_SYM_UNARY(name, op) \
+  expr_sym std::name(const expr_sym& a) { return expr_sym(expr_sym::graph->unary(op,a.id),true); }
+
+MASA_EXPR_SYM_UNARY(sin,   OP_SIN)
+MASA_EXPR_SYM_UNARY(cos,   OP_COS)
+MASA_EXPR_SYM_UNARY(tan,   OP_TAN)
+MASA_EXPR_SYM_UNARY(asin,  OP_ASIN)
+MASA_EXPR_SYM_UNARY(acos,  OP_ACOS)
+MASA_EXPR_SYM_UNARY(atan,  OP_ATAN)
+MASA_EXPR_SYM_UNARY(sinh,  OP_SINH)
+MASA_EXPR_SYM_UNARY(cosh,  OP_COSH)
+MASA_EXPR_SYM_UNARY(tanh,  OP_TANH)
+MASA_EXPR_SYM_UNARY(exp,   OP_EXP)
+MASA_EXPR_SYM_UNARY(log,   OP_LOG)
+MASA_EXPR_SYM_UNARY(log10, OP_LOG10)
+MASA_EXPR_SYM_UNARY(sqrt,  OP_SQRT)
+
+#undef MASA_EXPR_SYM_UNARY
+
+expr_sym std::pow(const expr_sym& a, const expr_sym& b)
+{
+  return expr_sym(expr_sym::graph->binary(OP_POW,a.id,b.id),true);
+}
+
+namespace {
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * bytecode
+ *
+ * the nodes depending on the coordinates are compiled to instructions
+ * on a register file of the evaluation type (Scalar for the exact
+ * fields, DualNumbers for the source terms); their operands are either
+ * registers (R) or the values of the parameter dependent nodes (U),
+ * computed in Scalar once for every change of the parameters. Registers
+ * are reused as soon as the value they hold is no longer needed, and
+ * the first ones always hold the coordinates.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+enum expr_opcode { V_ADD_RR, V_ADD_RU, V_SUB_RR, V_SUB_RU, V_SUB_UR, V_MUL_RR, V_MUL_RU,
+                   V_DIV_RR, V_DIV_RU, V_DIV_UR, V_POW_RR, V_POW_RU, V_POW_UR, V_POWI, V_NEG,
+                   V_SIN, V_COS, V_TAN, V_ASIN, V_ACOS, V_ATAN, V_SINH, V_COSH, V_TANH,
+                   V_EXP, V_LOG, V_LOG10, V_SQRT };
+
+struct expr_instr
+{
+  int op;
+  int dst, a, b;   // registers, or uniform nodes for the U operands
+  int n;           // integer exponent
+};
+
+struct expr_output
+{
+  bool uniform;    // value of uniform node index, or of register index
+  int  index;
+};
+
+struct expr_program
+{
+  std::vector<expr_instr>  code;
+  std::vector<expr_output> out;
+  unsigned int             registers;
+};
+
+void expr_compile(const expr_graph& g, const std::vector<int>& roots, unsigned int ncoord,
+                  expr_program& prog)
+{
+  const std::vector<expr_node>& nodes = g.nodes;
+  const int never = nodes.size();
+
+  // varying nodes needed by the roots, and the last node using each
+  std::vector<bool> needed(nodes.size(),false);
+  std::vector<int>  last(nodes.size(),-1);
+  for(unsigned int i = 0; i != roots.size(); i++)
+    {
+      needed[roots[i]] = true;
+      last[roots[i]] = never;
+    }
+  for(int i = nodes.size()-1; i >= 0; i--)
+    if(needed[i] && !nodes[i].uniform)
+      for(int k = 0; k != 2; k++)
+        {
+          const int o = k ? nodes[i].b : nodes[i].a;
+          if(o >= 0)
+            {
+              needed[o] = true;
+              last[o] = std::max(last[o],i);
+            }
+        }
+
+  std::vector<int> reg(nodes.size(),-1);
+  std::vector<int> free_regs;
+  prog.registers = ncoord;
+  prog.code.clear();
+
+  for(int i = 0; i != never; i++)
+    {
+      const expr_node& e = nodes[i];
+      if(!needed[i] || e.uniform)
+        continue;
+      if(e.op == OP_COORD)
+        {
+          reg[i] = e.n;
+          continue;
+        }
+
+      const bool ua = nodes[e.a].uniform;
+      const bool ub = e.b >= 0 && nodes[e.b].uniform;
+      expr_instr in = {0, 0, ua ? e.a : reg[e.a], e.b < 0 ? -1 : (ub ? e.b : reg[e.b]), e.n};
+
+      switch(e.op)
+        {
+        case OP_ADD: case OP_MUL:
+          if(ua)
+            std::swap(in.a,in.b);
+          in.op = (e.op == OP_ADD) ? (ua || ub ? V_ADD_RU : V_ADD_RR) : (ua || ub ? V_MUL_RU : V_MUL_RR);
+          break;
+        case OP_SUB: in.op = ua ? V_SUB_UR : (ub ? V_SUB_RU : V_SUB_RR); break;
+        case OP_DIV: in.op = ua ? V_DIV_UR : (ub ? V_DIV_RU : V_DIV_RR); break;
+        case OP_POW: in.op = ua ? V_POW_UR : (ub ? V_POW_RU : V_POW_RR); break;
+        case OP_POWI:  in.op = V_POWI;  break;
+        case OP_NEG:   in.op = V_NEG;   break;
+        default:       in.op = V_SIN + (e.op - OP_SIN); break;
+        }
+
+      // registers of operands used for the last time are free for the result
+      for(int k = 0; k != 2; k++)
+        {
+          const int o = k ? e.b : e.a;
+          if(o >= 0 && !nodes[o].uniform && nodes[o].op != OP_COORD && last[o] == i &&
+             (k == 0 || e.a != e.b))
+            free_regs.push_back(reg[o]);
+        }
+
+      if(free_regs.empty())
+        reg[i] = prog.registers++;
+      else
+        {
+          reg[i] = free_regs.back();
+          free_regs.pop_back();
+        }
+      in.dst = reg[i];
+      prog.code.push_back(in);
+    }
+
+  prog.out.clear();
+  for(unsigned int i = 0; i != roots.size(); i++)
+    {
+      expr_output o = {nodes[roots[i]].uniform, nodes[roots[i]].uniform ? roots[i] : reg[roots[i]]};
+      prog.out.push_back(o);
+    }
+}
+
+// runs a program on the registers r, with the uniform values u
+template <typename Scalar, typename Value>
+void expr_run(const expr_program& prog, const Scalar* u, Value* r)
+{
+  using std::sin; using std::cos; using std::tan; using std::asin; using std::acos; using std::atan;
+  using std::sinh; using std::cosh; using std::tanh; using std::exp; using std::log; using std::log10;
+  using std::sqrt; using std::pow;
+
+  const expr_instr* in  = prog.code.empty() ? 0 : &prog.code[0];
+  const expr_instr* end = in + prog.code.size();
+
+  for(; in != end; ++in)
+    switch(in->op)
+      {
+      case V_ADD_RR: r[in->dst] = r[in->a] + r[in->b]; break;
+      case V_ADD_RU: r[in->dst] = r[in->a] + u[in->b]; break;
+      case V_SUB_RR: r[in->dst] = r[in->a] - r[in->b]; break;
+      case V_SUB_RU: r[in->dst] = r[in->a] - u[in->b]; break;
+      case V_SUB_UR: r[in->dst] = u[in->a] - r[in->b]; break;
+      case V_MUL_RR: r[in->dst] = r[in->a] * r[in->b]; break;
+      case V_MUL_RU: r[in->dst] = r[in->a] * u[in->b]; break;
+      case V_DIV_RR: r[in->dst] = r[in->a] / r[in->b]; break;
+      case V_DIV_RU: r[in->dst] = r[in->a] / u[in->b]; break;
+      case V_DIV_UR: r[in->dst] = u[in->a] / r[in->b]; break;
+      case V_POW_RR: r[in->dst] = pow(r[in->a],r[in->b]); break;
+      case V_POW_RU: r[in->dst] = expr_pow(r[in->a],u[in->b]); break;
+      case V_POW_UR: r[in->dst] = pow(u[in->a],r[in->b]); break;
+      case V_POWI:   r[in->dst] = expr_powi<Scalar>(r[in->a],in->n); break;
+      case V_NEG:    r[in->dst] = -r[in->a]; break;
+      case V_SIN:    r[in->dst] = sin(r[in->a]); break;
+      case V_COS:    r[in->dst] = cos(r[in->a]); break;
+      case V_TAN:    r[in->dst] = tan(r[in->a]); break;
+      case V_ASIN:   r[in->dst] = asin(r[in->a]); break;
+      case V_ACOS:   r[in->dst] = acos(r[in->a]); break;
+      case V_ATAN:   r[in->dst] = atan(r[in->a]); break;
+      case V_SINH:   r[in->dst] = sinh(r[in->a]); break;
+      case V_COSH:   r[in->dst] = cosh(r[in->a]); break;
+      case V_TANH:   r[in->dst] = tanh(r[in->a]); break;
+      case V_EXP:    r[in->dst] = exp(r[in->a]); break;
+      case V_LOG:    r[in->dst] = log(r[in->a]); break;
+      case V_LOG10:  r[in->dst] = log10(r[in->a]); break;
+      case V_SQRT:   r[in->dst] = sqrt(r[in->a]); break;
+      }
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * equation sets
+ *
+ * the fields of the solution are followed by the coefficients of the
+ * equations, which the definitions may give as values (parameters) or
+ * as expressions of the coordinates (variable coefficients)
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+enum expr_equation { EQ_HEAT, EQ_EULER, EQ_NAVIERSTOKES };
+
+// source terms and exact fields, in the order of the virtual functions
+enum expr_term  { TERM_T, TERM_RHO, TERM_RHO_U, TERM_RHO_V, TERM_RHO_W, TERM_RHO_E, NUM_TERMS };
+enum expr_field { FIELD_T, FIELD_RHO, FIELD_U, FIELD_V, FIELD_W, FIELD_P, NUM_FIELDS };
+
+const char* const term_names[NUM_TERMS]   = {"t", "rho", "rho*u", "rho*v", "rho*w", "rho*e"};
+const char* const field_names[NUM_FIELDS] = {"T", "rho", "u", "v", "w", "p"};
+
+// registered grid names of the source terms, then of the exact fields
+const char* const grid_names[NUM_TERMS + NUM_FIELDS] =
+  {"q_t", "q_rho", "q_rho_u", "q_rho_v", "q_rho_w", "q_rho_e",
+   "exact_t", "exact_rho", "exact_u", "exact_v", "exact_w", "exact_p"};
+
+// heat equation, with the roots T, k[, rho, cp]:
+//   Q_T = rho cp dT/dt - div(k grad T)
+template <typename Scalar, typename AD>
+void expr_heat(unsigned int dim, bool unsteady, const AD* v, Scalar* Q)
+{
+  Scalar q = 0;
+  for(unsigned int i = 0; i != dim; i++)
+    q -= (v[1].value() * v[0].derivatives()[i]).derivatives()[i];
+
+  if(unsteady)
+    q += v[2].value().value() * v[3].value().value() * v[0].derivatives()[dim].value();
+
+  Q[TERM_T] = q;
+}
+
+// Euler and Navier-Stokes equations in conservative form, from the
+// roots rho, u[, v, w], p, Gamma; tau and heat are the viscous stress
+// and heat flux, NULL for the Euler equations
+template <typename Scalar, typename F>
+void expr_flow(unsigned int dim, bool unsteady, const F* f, const F (*tau)[3], const F* heat, Scalar* Q)
+{
+  const F& rho   = f[0];
+  const F* U     = f + 1;
+  const F& P     = f[1+dim];
+  const F& Gamma = f[2+dim];
+
+  // total energy
+  F rhoE = P / (Gamma - Scalar(1));
+  for(unsigned int j = 0; j != dim; j++)
+    rhoE += Scalar(0.5) * rho * U[j] * U[j];
+  const F H = rhoE + P;
+
+  Scalar q_rho = 0, q_e = 0, q_mom[3] = {0,0,0};
+  for(unsigned int i = 0; i != dim; i++)
+    {
+      const F m = rho * U[i];
+      q_rho += m.derivatives()[i];
+
+      F fe = U[i] * H;
+      for(unsigned int j = 0; j != dim; j++)
+        {
+          F flux = m * U[j];
+          if(i == j)
+            flux += P;
+          if(tau)
+            {
+              flux -= tau[i][j];
+              fe   -= U[j] * tau[i][j];
+            }
+          q_mom[j] += flux.derivatives()[i];
+        }
+      if(heat)
+        fe += heat[i];
+      q_e += fe.derivatives()[i];
+    }
+
+  if(unsteady)
+    {
+      q_rho += rho.derivatives()[dim];
+      for(unsigned int j = 0; j != dim; j++)
+        q_mom[j] += (rho * U[j]).derivatives()[dim];
+      q_e += rhoE.derivatives()[dim];
+    }
+
+  Q[TERM_RHO]   = q_rho;
+  Q[TERM_RHO_U] = q_mom[0];
+  Q[TERM_RHO_V] = q_mom[1];
+  Q[TERM_RHO_W] = q_mom[2];
+  Q[TERM_RHO_E] = q_e;
+}
+
+// Navier-Stokes equations, with the roots rho, u[, v, w], p, Gamma, mu, k, R:
+//   tau = mu (grad u + grad u^T - 2/3 div u I),  q = -k grad T,  T = p / (rho R)
+template <typename Scalar, typename AD>
+void expr_navierstokes(unsigned int dim, bool unsteady, const AD* v, Scalar* Q)
+{
+  typedef typename AD::value_type F;
+
+  const AD* U  = v + 1;
+  const F   mu = v[3+dim].value();
+  const F   k  = v[4+dim].value();
+
+  F f[6];
+  for(unsigned int i = 0; i != dim+3; i++)
+    f[i] = v[i].value();
+
+  F divU = Scalar(0);
+  for(unsigned int i = 0; i != dim; i++)
+    divU += U[i].derivatives()[i];
+
+  F tau[3][3];
+  for(unsigned int i = 0; i != dim; i++)
+    for(unsigned int j = 0; j != dim; j++)
+      {
+        tau[i][j] = mu * (U[i].derivatives()[j] + U[j].derivatives()[i]);
+        if(i == j)
+          tau[i][j] -= Scalar(2) / Scalar(3) * mu * divU;
+      }
+
+  const AD T = v[1+dim] / (v[0] * v[5+dim]);
+  F heat[3];
+  for(unsigned int i = 0; i != dim; i++)
+    heat[i] = -k * T.derivatives()[i];
+
+  expr_flow(dim,unsteady,f,tau,heat,Q);
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * definitions
+ *
+ *   name = expression
+ *
+ * one per line or separated by ';', '#' starts a comment. Expressions
+ * combine numbers, the coordinates x, y, z (and t for the unsteady
+ * equations), pi, other names and the functions above with + - * /
+ * and ^ (or **). Names defined by a number are parameters with that
+ * default value, names never defined parameters without one, and all
+ * other names stand for their expressions.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+enum expr_token_kind { TOK_NUM, TOK_ID, TOK_OP, TOK_END };
+
+struct expr_token
+{
+  int         kind;
+  std::string text;
+  long double value;
+  int         line;
+};
+
+struct expr_statement
+{
+  std::size_t begin, end;   // tokens of the expression
+  int         line;
+  int         state;        // 0 unresolved, 1 being resolved, 2 resolved
+  int         node;
+  bool        literal;      // made of numbers and functions only
+};
+
+// compiled form of a solution, shared by all its instances
+struct expr_code
+{
+  std::string  equations;     // "euler_2d", ...
+  std::string  definitions;
+  int          equation;
+  unsigned int dim;
+  bool         unsteady;
+  unsigned int ncoord;
+
+  std::vector<std::string> roots;       // fields, then coefficients
+  expr_graph               graph;
+  expr_program             source;      // all the roots, for the source terms
+  expr_program             exact[NUM_FIELDS];
+  bool                     has_field[NUM_FIELDS];
+  bool                     has_term[NUM_TERMS];
+  std::map<std::string,int> fields;     // MASA_CAP_*D bits of the terms and fields, by grid name
+
+  std::vector<std::string> params;
+  std::vector<bool>        has_default;
+  std::vector<long double> defaults;
+};
+
+class expr_compiler
+{
+public:
+  expr_compiler(expr_code& code) : _code(code) {}
+
+  int compile();
+  const std::string& error() const { return _error; }
+
+private:
+  expr_code&                            _code;
+  std::vector<expr_token>               _tokens;
+  std::map<std::string,expr_statement>  _defs;
+  std::vector<std::string>              _order;
+  std::map<std::string,int>             _param_index;
+  std::string                           _error;
+
+  int  fail(const std::string& msg, int line);
+  int  tokenize();
+  int  resolve(const std::string& name, int line);
+  int  make_param(const std::string& name, bool has_default, long double value);
+  bool is_field(const std::string& name) const;
+
+  // recursive descent over the tokens [pos,end) of one statement
+  int parse_expr   (std::size_t& pos, std::size_t end);
+  int parse_term   (std::size_t& pos, std::size_t end);
+  int parse_unary  (std::size_t& pos, std::size_t end);
+  int parse_power  (std::size_t& pos, std::size_t end);
+  int parse_primary(std::size_t& pos, std::size_t end);
+
+  bool at(std::size_t pos, std::size_t end, char op) const
+  {
+    return pos < end && _tokens[pos].kind == TOK_OP && _tokens[pos].text[0] == op;
+  }
+};
+
+int expr_compiler::fail(const std::string& msg, int line)
+{
+  if(_error.empty())
+    {
+      std::ostringstream os;
+      os << msg;
+      if(line > 0)
+        os << " (line " << line << ")";
+      _error = os.str();
+    }
+  return -1;
+}
+
+int expr_compiler::tokenize()
+{
+  const std::string& s = _code.definitions;
+  int line = 1;
+
+  for(std::size_t i = 0; i < s.size(); )
+    {
+      const char c = s[i];
+      expr_token tok = {TOK_OP, std::string(1,c), 0, line};
+
+      if(c == '#')
+        {
+          while(i < s.size() && s[i] != '\n')
+            i++;
+          continue;
+        }
+      else if(c == '\n' || c == ';')
+        {
+          tok.kind = TOK_END;
+          if(c == '\n')
+            line++;
+          i++;
+        }
+      else if(c == ' ' || c == '\t' || c == '\r')
+        {
+          i++;
+          continue;
+        }
+      else if(isdigit(c) || (c == '.' && i+1 < s.size() && isdigit(s[i+1])))
+        {
+          const char* begin = s.c_str() + i;
+          char* stop;
+          tok.kind  = TOK_NUM;
+          tok.value = strtold(begin,&stop);
+          tok.text  = std::string(begin,static_cast<const char*>(stop));
+          i += stop - begin;
+        }
+      else if(isalpha(c) || c == '_')
+        {
+          std::size_t j = i;
+          while(j < s.size() && (isalnum(s[j]) || s[j] == '_'))
+            j++;
+          tok.kind = TOK_ID;
+          tok.text = s.substr(i,j-i);
+          i = j;
+        }
+      else if(c == '*' && i+1 < s.size() && s[i+1] == '*')
+        {
+          tok.text = "^";
+          i += 2;
+        }
+      else if(std::string("+-*/^(),=").find(c) != std::string::npos)
+        i++;
+      else
+        return fail(std::string("unexpected character '") + c + "'", line);
+
+      _tokens.push_back(tok);
+    }
+
+  expr_token end = {TOK_END, "", 0, line};
+  _tokens.push_back(end);
+  return 0;
+}
+
+bool expr_compiler::is_field(const std::string& name) const
+{
+  // the first roots are the fields, the others are coefficients
+  const unsigned int nfields = _code.equation == EQ_HEAT ? 1 : _code.dim + 2;
+  for(unsigned int i = 0; i != nfields; i++)
+    if(_code.roots[i] == name)
+      return true;
+  return false;
+}
+
+int expr_compiler::make_param(const std::string& name, bool has_default, long double value)
+{
+  const int index = _code.params.size();
+  _code.params.push_back(name);
+  _code.has_default.push_back(has_default);
+  _code.defaults.push_back(value);
+  _param_index[name] = index;
+  return _code.graph.param(index);
+}
+
+int expr_compiler::resolve(const std::string& name, int line)
+{
+  static const char* const coords[] = {"x", "y", "z", "t"};
+
+  if(name == "pi" || name == "PI")
+    return _code.graph.constant(3.141592653589793238462643383279502884L);
+
+  for(unsigned int i = 0; i != 4; i++)
+    if(name == coords[i])
+      {
+        // time is the coordinate after the spatial ones
+        const unsigned int c = (i == 3) ? (_code.unsteady ? _code.dim : 4) : i;
+        if(c >= _code.ncoord || (i < 3 && i >= _code.dim))
+          return fail(_code.equations + " has no coordinate " + name, line);
+        return _code.graph.coord(c);
+      }
+
+  if(find_function(name))
+    return fail("function " + name + " used without arguments", line);
+
+  std::map<std::string,int>::const_iterator p = _param_index.find(name);
+  if(p != _param_index.end())
+    return _code.graph.param(p->second);
+
+  std::map<std::string,expr_statement>::iterator it = _defs.find(name);
+  if(it == _defs.end())
+    {
+      if(is_field(name))
+        return fail(name + " is not defined", 0);
+      return make_param(name,false,0);
+    }
+
+  expr_statement& st = it->second;
+  if(st.state == 1)
+    return fail("the definition of " + name + " refers to itself", st.line);
+  if(st.state == 2)
+    return st.node;
+
+  st.state = 1;
+  std::size_t pos = st.begin;
+  int node = parse_expr(pos,st.end);
+  if(node >= 0 && pos != st.end)
+    node = fail("unexpected '" + _tokens[pos].text + "'", st.line);
+  if(node < 0)
+    return -1;
+
+  if(st.literal && !is_field(name))
+    node = make_param(name,true,_code.graph.nodes[node].c);
+
+  st.state = 2;
+  return st.node = node;
+}
+
+int expr_compiler::parse_expr(std::size_t& pos, std::size_t end)
+{
+  int a = parse_term(pos,end);
+  while(a >= 0 && (at(pos,end,'+') || at(pos,end,'-')))
+    {
+      const int op = at(pos,end,'+') ? OP_ADD : OP_SUB;
+      const int b = parse_term(++pos,end);
+      if(b < 0)
+        return -1;
+      a = _code.graph.binary(op,a,b);
+    }
+  return a;
+}
+
+int expr_compiler::parse_term(std::size_t& pos, std::size_t end)
+{
+  int a = parse_unary(pos,end);
+  while(a >= 0 && (at(pos,end,'*') || at(pos,end,'/')))
+    {
+      const int op = at(pos,end,'*') ? OP_MUL : OP_DIV;
+      const int b = parse_unary(++pos,end);
+      if(b < 0)
+        return -1;
+      a = _code.graph.binary(op,a,b);
+    }
+  return a;
+}
+
+int expr_compiler::parse_unary(std::size_t& pos, std::size_t end)
+{
+  if(at(pos,end,'-'))
+    {
+      const int a = parse_unary(++pos,end);
+      return a < 0 ? -1 : _code.graph.unary(OP_NEG,a);
+    }
+  if(at(pos,end,'+'))
+    return parse_unary(++pos,end);
+  return parse_power(pos,end);
+}
+
+int expr_compiler::parse_power(std::size_t& pos, std::size_t end)
+{
+  const int a = parse_primary(pos,end);
+  if(a < 0 || !at(pos,end,'^'))
+    return a;
+
+  // right associative, and binds tighter than a leading minus: -x^2 = -(x^2)
+  const int b = parse_unary(++pos,end);
+  return b < 0 ? -1 : _code.graph.binary(OP_POW,a,b);
+}
+
+int expr_compiler::parse_primary(std::size_t& pos, std::size_t end)
+{
+  if(pos >= end)
+    return fail("expression ends unexpectedly",_tokens[pos].line);
+
+  const expr_token& tok = _tokens[pos++];
+
+  if(tok.kind == TOK_NUM)
+    return _code.graph.constant(tok.value);
+
+  if(tok.kind == TOK_OP && tok.text[0] == '(')
+    {
+      const int a = parse_expr(pos,end);
+      if(a >= 0 && !at(pos,end,')'))
+        return fail("missing ')'",tok.line);
+      pos++;
+      return a;
+    }
+
+  if(tok.kind != TOK_ID)
+    return fail("unexpected '" + tok.text + "'",tok.line);
+
+  if(!at(pos,end,'('))
+    return resolve(tok.text,tok.line);
+
+  const expr_function* fn = find_function(tok.text);
+  if(fn == 0)
+    return fail("unknown function " + tok.text,tok.line);
+
+  int args[2];
+  for(int i = 0; i != fn->args; i++)
+    {
+      pos++; // '(' or ','
+      args[i] = parse_expr(pos,end);
+      if(args[i] < 0)
+        return -1;
+      if(at(pos,end,i+1 == fn->args ? ',' : ')'))
+        return fail(std::string("wrong number of arguments to ") + fn->name,tok.line);
+      if(!at(pos,end,i+1 == fn->args ? ')' : ','))
+        return fail("missing ')'",tok.line);
+    }
+  pos++;
+
+  return fn->args == 1 ? _code.graph.unary(fn->op,args[0]) : _code.graph.binary(fn->op,args[0],args[1]);
+}
+
+int expr_compiler::compile()
+{
+  expr_code& c = _code;
+
+  // equations: heat_2d, euler_3d_unsteady, navierstokes_1d, ...
+  std::string eq = c.equations;
+  uptolow(eq);
+  remove_whitespace(eq);
+  c.equations = eq;
+
+  std::size_t sep = eq.find('_');
+  const std::string kind = eq.substr(0,sep);
+  const std::string rest = sep == std::string::npos ? "" : eq.substr(sep+1);
+
+  if(kind == "heat")
+    c.equation = EQ_HEAT;
+  else if(kind == "euler")
+    c.equation = EQ_EULER;
+  else if(kind == "navierstokes")
+    c.equation = EQ_NAVIERSTOKES;
+  else
+    return fail("unknown equations " + c.equations + " (heat, euler or navierstokes)",0);
+
+  if(rest.size() < 2 || rest[0] < '1' || rest[0] > '3' || rest[1] != 'd' ||
+     (rest.size() > 2 && rest.substr(2) != "_unsteady"))
+    return fail("equations " + c.equations + " are not of the form " + kind + "_<1,2,3>d[_unsteady]",0);
+
+  c.dim      = rest[0] - '0';
+  c.unsteady = rest.size() > 2;
+  c.ncoord   = c.dim + c.unsteady;
+
+  for(unsigned int i = 0; i != NUM_FIELDS; i++)
+    c.has_field[i] = false;
+  for(unsigned int i = 0; i != NUM_TERMS; i++)
+    c.has_term[i] = false;
+
+  if(c.equation == EQ_HEAT)
+    {
+      c.roots.push_back("T");
+      c.roots.push_back("k");
+      if(c.unsteady)
+        {
+          c.roots.push_back("rho");
+          c.roots.push_back("cp");
+        }
+      c.has_field[FIELD_T] = c.has_term[TERM_T] = true;
+    }
+  else
+    {
+      c.roots.push_back("rho");
+      for(unsigned int i = 0; i != c.dim; i++)
+        c.roots.push_back(field_names[FIELD_U+i]);
+      c.roots.push_back("p");
+      c.roots.push_back("Gamma");
+      if(c.equation == EQ_NAVIERSTOKES)
+        {
+          c.roots.push_back("mu");
+          c.roots.push_back("k");
+          c.roots.push_back("R");
+        }
+      c.has_field[FIELD_RHO] = c.has_field[FIELD_P] = true;
+      c.has_term[TERM_RHO]   = c.has_term[TERM_RHO_E] = true;
+      for(unsigned int i = 0; i != c.dim; i++)
+        c.has_field[FIELD_U+i] = c.has_term[TERM_RHO_U+i] = true;
+    }
+
+  // all of them take every coordinate
+  for(unsigned int i = 0; i != NUM_TERMS; i++)
+    if(c.has_term[i])
+      c.fields[grid_names[i]] = 1 << (c.ncoord - 1);
+  for(unsigned int i = 0; i != NUM_FIELDS; i++)
+    if(c.has_field[i])
+      c.fields[grid_names[NUM_TERMS + i]] = 1 << (c.ncoord - 1);
+
+  // statements
+  if(tokenize())
+    return -1;
+
+  std::size_t start = 0;
+  for(std::size_t i = 0; i != _tokens.size(); i++)
+    {
+      if(_tokens[i].kind != TOK_END)
+        continue;
+      if(i != start)
+        {
+          const expr_token& name = _tokens[start];
+          if(name.kind != TOK_ID || i - start < 3 || !at(start+1,i,'='))
+            return fail("expected name = expression",name.line);
+          if(name.text == "pi" || name.text == "PI" || find_function(name.text) ||
+             name.text == "x" || name.text == "y" || name.text == "z" || name.text == "t")
+            return fail(name.text + " cannot be defined",name.line);
+          if(_defs.count(name.text))
+            return fail(name.text + " is defined twice",name.line);
+
+          expr_statement st = {start+2, i, name.line, 0, -1, true};
+          for(std::size_t j = st.begin; j != st.end; j++)
+            if(_tokens[j].kind == TOK_ID && _tokens[j].text != "pi" && _tokens[j].text != "PI" &&
+               !(find_function(_tokens[j].text) && at(j+1,st.end,'(')))
+              st.literal = false;
+
+          _defs[name.text] = st;
+          _order.push_back(name.text);
+        }
+      start = i+1;
+    }
+
+  // the roots, then every other definition, so that all of them are checked
+  std::vector<int> roots;
+  for(unsigned int i = 0; i != c.roots.size(); i++)
+    {
+      roots.push_back(resolve(c.roots[i],0));
+      if(roots.back() < 0)
+        return -1;
+    }
+  for(unsigned int i = 0; i != _order.size(); i++)
+    if(resolve(_order[i],0) < 0)
+      return -1;
+
+  expr_compile(c.graph,roots,c.ncoord,c.source);
+
+  for(unsigned int f = 0; f != NUM_FIELDS; f++)
+    if(c.has_field[f])
+      for(unsigned int i = 0; i != c.roots.size(); i++)
+        if(c.roots[i] == field_names[f])
+          expr_compile(c.graph,std::vector<int>(1,roots[i]),c.ncoord,c.exact[f]);
+
+  return 0;
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * evaluation
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+// runs a program at p, returning the values of its roots in v; the
+// derivatives of Value are taken along the first N coordinates
+template <typename Scalar, typename Value, std::size_t N>
+void expr_run_roots(const expr_code& c, const expr_program& prog, const Scalar* u, const Scalar* p, Value* v)
+{
+  // scratch registers of each thread
+  static thread_local std::vector<Value> r;
+  if(r.size() < prog.registers)
+    r.resize(prog.registers);
+
+  for(std::size_t i = 0; i != c.ncoord; i++)
+    {
+      NumberArray<N,Scalar> unit(Scalar(0));
+      unit[i] = 1;
+      r[i] = Value(p[i],unit);
+    }
+
+  expr_run(prog,u,&r[0]);
+
+  for(unsigned int i = 0; i != prog.out.size(); i++)
+    v[i] = prog.out[i].uniform ? Value(u[prog.out[i].index]) : r[prog.out[i].index];
+}
+
+// all the source terms of the equations at p, from the values u of the
+// uniform nodes
+template <typename Scalar, std::size_t N>
+void expr_source_terms(const expr_code& c, const Scalar* u, const Scalar* p, Scalar* Q)
+{
+  typedef DualNumber<Scalar, NumberArray<N, Scalar> > FirstDerivType;
+  typedef DualNumber<FirstDerivType, NumberArray<N, FirstDerivType> > SecondDerivType;
+
+  switch(c.equation)
+    {
+    case EQ_HEAT:
+      {
+        SecondDerivType v[4];
+        expr_run_roots<Scalar,SecondDerivType,N>(c,c.source,u,p,v);
+        expr_heat(c.dim,c.unsteady,v,Q);
+        break;
+      }
+    case EQ_EULER:
+      {
+        FirstDerivType v[6];
+        expr_run_roots<Scalar,FirstDerivType,N>(c,c.source,u,p,v);
+        expr_flow<Scalar,FirstDerivType>(c.dim,c.unsteady,v,0,0,Q);
+        break;
+      }
+    case EQ_NAVIERSTOKES:
+      {
+        SecondDerivType v[9];
+        expr_run_roots<Scalar,SecondDerivType,N>(c,c.source,u,p,v);
+        expr_navierstokes(c.dim,c.unsteady,v,Q);
+        break;
+      }
+    }
+}
+
+template <typename Scalar>
+void expr_source_terms(const expr_code& c, const Scalar* u, const Scalar* p, Scalar* Q)
+{
+  switch(c.ncoord)
+    {
+    case 1: expr_source_terms<Scalar,1>(c,u,p,Q); break;
+    case 2: expr_source_terms<Scalar,2>(c,u,p,Q); break;
+    case 3: expr_source_terms<Scalar,3>(c,u,p,Q); break;
+    case 4: expr_source_terms<Scalar,4>(c,u,p,Q); break;
+    }
+}
+
+// the exact field f at p
+template <typename Scalar>
+Scalar expr_exact(const expr_code& c, int f, const Scalar* u, const Scalar* p)
+{
+  static thread_local std::vector<Scalar> r;
+  const expr_program& prog = c.exact[f];
+  if(r.size() < prog.registers)
+    r.resize(prog.registers);
+
+  for(unsigned int i = 0; i != c.ncoord; i++)
+    r[i] = p[i];
+  expr_run(prog,u,&r[0]);
+
+  return prog.out[0].uniform ? u[prog.out[0].index] : r[prog.out[0].index];
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * native code
+ *
+ * once its parameters are fixed, a solution can be specialized: the
+ * source terms are derived again, on DualNumbers of expr_sym, into a
+ * graph in which the parameter dependent nodes are constants, and that
+ * graph is written out as C++, compiled by the host compiler and
+ * loaded with dlopen. The shared objects are kept in a directory under
+ * a hash of their source, of the compiler command and of the processor,
+ * so that another run with the same parameters on the same kind of
+ * machine loads them without compiling. Only a directory of the user,
+ * closed to everyone else, is used: whoever can write to it chooses the
+ * code that is loaded.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+#ifndef MASA_JIT_CXX
+#define MASA_JIT_CXX "c++"
+#endif
+
+const char* const native_flags = " -O3 -march=native -fPIC -shared";
+
+// the type native code computes in, NULL if it cannot be compiled
+template <typename Scalar> const char* expr_native_type()  { return 0; }
+template <> const char* expr_native_type<float>()          { return "float"; }
+template <> const char* expr_native_type<double>()         { return "double"; }
+template <> const char* expr_native_type<long double>()    { return "long double"; }
+
+// what -march=native compiles for: the vendor, model and feature bits
+// of the processor, or the machine name where they cannot be read
+std::string expr_host_isa()
+{
+  std::ostringstream isa;
+  struct utsname u;
+  if(uname(&u) == 0)
+    isa << u.machine;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  unsigned int a, b, c, d, top;
+  if(__get_cpuid(0,&top,&b,&c,&d))
+    {
+      isa << ' ' << std::hex << b << ',' << d << ',' << c;
+      if(__get_cpuid(1,&a,&b,&c,&d))
+        isa << ' ' << a << ',' << c << ',' << d;
+      if(top >= 7)
+        {
+          __cpuid_count(7,0,a,b,c,d);
+          isa << ' ' << b << ',' << c << ',' << d;
+        }
+    }
+#endif
+  return isa.str();
+}
+
+// true if dir is a directory of the effective user that nobody else can write to
+bool expr_private_dir(const std::string& dir)
+{
+  struct stat st;
+  return lstat(dir.c_str(),&st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == geteuid() &&
+         (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// the functions of a loaded shared object, which stays loaded until
+// the process exits, and the parameters they were compiled for
+template <typename Scalar>
+struct expr_native
+{
+  std::vector<Scalar> params;
+  void   (*terms)(const Scalar* x, Scalar* q);
+  Scalar (*field[NUM_FIELDS])(const Scalar* x);
+};
+
+std::string expr_literal(long double c)
+{
+  if(std::isnan(c))
+    return "std::numeric_limits<masa_real>::quiet_NaN()";
+  if(std::isinf(c))
+    return c < 0 ? "-std::numeric_limits<masa_real>::infinity()" : "std::numeric_limits<masa_real>::infinity()";
+
+  // exactly, in hexadecimal
+  char buf[64];
+  snprintf(buf,sizeof(buf),"masa_real(%LaL)",c);
+  return buf;
+}
+
+std::string expr_operand(const expr_graph& g, int i)
+{
+  const expr_node& e = g.nodes[i];
+  std::ostringstream s;
+  if(e.op == OP_CONST)
+    s << expr_literal(e.c);
+  else if(e.op == OP_COORD)
+    s << "x[" << e.n << "]";
+  else
+    s << "t" << i;
+  return s.str();
+}
+
+// writes a statement for every node the roots depend on, operands first
+void expr_emit(std::ostream& out, const expr_graph& g, const std::vector<int>& roots)
+{
+  std::vector<bool> used(g.nodes.size(),false);
+  std::vector<int>  stack(roots);
+  while(!stack.empty())
+    {
+      const int i = stack.back();
+      stack.pop_back();
+      if(used[i])
+        continue;
+      used[i] = true;
+      if(g.nodes[i].a >= 0) stack.push_back(g.nodes[i].a);
+      if(g.nodes[i].b >= 0) stack.push_back(g.nodes[i].b);
+    }
+
+  for(unsigned int i = 0; i != g.nodes.size(); i++)
+    {
+      const expr_node& e = g.nodes[i];
+      if(!used[i] || e.op == OP_CONST || e.op == OP_COORD)
+        continue;
+
+      const std::string a = expr_operand(g,e.a);
+      const std::string b = e.b < 0 ? std::string() : expr_operand(g,e.b);
+
+      out << "  const masa_real t" << i << " = ";
+      switch(e.op)
+        {
+        case OP_ADD:  out << a << " + " << b; break;
+        case OP_SUB:  out << a << " - " << b; break;
+        case OP_MUL:  out << a << " * " << b; break;
+        case OP_DIV:  out << a << " / " << b; break;
+        case OP_NEG:  out << "-" << a; break;
+        case OP_POW:  out << "std::pow(" << a << ", " << b << ")"; break;
+        case OP_POWI: out << "masa_powi(" << a << ", " << e.n << ")"; break;
+        default:
+          for(unsigned int f = 0; f != sizeof(expr_functions)/sizeof(expr_functions[0]); f++)
+            if(expr_functions[f].op == e.op)
+              out << "std::" << expr_functions[f].name << "(" << a << ")";
+        }
+      out << ";\n";
+    }
+}
+
+// the C++ source of the solution with the uniform nodes fixed at u
+template <typename Scalar>
+std::string expr_native_source(const expr_code& c, const std::vector<Scalar>& u, const char* type)
+{
+  expr_graph g;
+  expr_graph_scope scope(g);
+
+  std::vector<expr_sym> su(c.graph.nodes.size());
+  for(unsigned int i = 0; i != su.size(); i++)
+    if(c.graph.nodes[i].uniform)
+      su[i] = expr_sym(static_cast<long double>(u[i]));
+
+  expr_sym p[4];
+  for(unsigned int i = 0; i != c.ncoord; i++)
+    p[i] = expr_sym(g.coord(i),true);
+
+  expr_sym q[NUM_TERMS];
+  expr_source_terms(c,&su[0],p,q);
+
+  std::ostringstream out;
+  out << "// " << c.equations << ", specialized by MASA for fixed parameters\n\n"
+      << "#include <cmath>\n#include <limits>\n\n"
+      << "typedef " << type << " masa_real;\n\n"
+      << "static inline masa_real masa_powi(masa_real b, int n)\n{\n"
+      << "  if(n < 0)\n    return masa_real(1) / masa_powi(b,-n);\n"
+      << "  masa_real r = 1;\n  for(; n; n >>= 1, b *= b)\n    if(n & 1)\n      r *= b;\n  return r;\n}\n\n";
+
+  std::vector<int> roots;
+  for(unsigned int t = 0; t != NUM_TERMS; t++)
+    if(c.has_term[t])
+      roots.push_back(q[t].id);
+
+  out << "extern \"C\" void masa_native_terms(const masa_real* x, masa_real* q)\n{\n";
+  expr_emit(out,g,roots);
+  for(unsigned int t = 0; t != NUM_TERMS; t++)
+    if(c.has_term[t])
+      out << "  q[" << t << "] = " << expr_operand(g,q[t].id) << ";\n";
+  out << "}\n";
+
+  for(unsigned int f = 0; f != NUM_FIELDS; f++)
+    if(c.has_field[f])
+      {
+        const int root = expr_exact(c,f,&su[0],p).id;
+        out << "\nextern \"C\" masa_real masa_native_field_" << f << "(const masa_real* x)\n{\n";
+        expr_emit(out,g,std::vector<int>(1,root));
+        out << "  return " << expr_operand(g,root) << ";\n}\n";
+      }
+
+  return out.str();
+}
+
+// runs the compiler command, split at blanks, on src with its output
+// going to log; no shell is involved, so the paths are taken as they are
+int expr_compile(const std::string& command, const std::string& src, const std::string& obj,
+                 const std::string& log)
+{
+  std::vector<std::string> words;
+  std::istringstream split(command);
+  for(std::string w; split >> w; )
+    words.push_back(w);
+  words.push_back("-o");
+  words.push_back(obj);
+  words.push_back(src);
+
+  std::vector<char*> argv;
+  for(std::size_t i = 0; i != words.size(); i++)
+    argv.push_back(&words[i][0]);
+  argv.push_back(0);
+
+  const pid_t pid = fork();
+  if(pid < 0)
+    return 1;
+  if(pid == 0)
+    {
+      const int fd = open(log.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+      if(fd < 0 || dup2(fd,1) < 0 || dup2(fd,2) < 0)
+        _exit(127);
+      execvp(argv[0],&argv[0]);
+      _exit(127);
+    }
+
+  int status;
+  while(waitpid(pid,&status,0) < 0)
+    if(errno != EINTR)
+      return 1;
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
+
+// loads the shared object built from source, compiling it first unless
+// dir holds it already
+template <typename Scalar>
+int expr_native_load(const expr_code& c, const std::string& dir, const std::string& source,
+                     expr_native<Scalar>& native)
+{
+  const char* env = getenv("MASA_JIT_CXX");
+  const std::string command = std::string(env && *env ? env : MASA_JIT_CXX) + native_flags;
+
+  // 64 bit FNV-1a of the source, the command and the processor
+  const std::string text = source + command + '\n' + expr_host_isa();
+  uint64_t h = 14695981039346656037ULL;
+  for(std::size_t i = 0; i != text.size(); i++)
+    h = (h ^ static_cast<unsigned char>(text[i])) * 1099511628211ULL;
+
+  char name[64];
+  snprintf(name,sizeof(name),"/masa_native_%016llx",static_cast<unsigned long long>(h));
+  const std::string so = dir + name + ".so";
+
+  if(access(so.c_str(),R_OK) != 0)
+    {
+      // built in a fresh directory and renamed into place, so other
+      // threads and processes only ever load complete files
+      std::string work = dir + name + ".XXXXXX";
+      if(mkdtemp(&work[0]) == 0)
+        {
+          std::cout << "MASA ERROR:: unable to create a directory in " << dir << "\n";
+          return 1;
+        }
+      const std::string src = work + "/masa_native.cpp", obj = work + "/masa_native.so", log = work + "/masa_native.log";
+
+      FILE* fp = fopen(src.c_str(),"w");
+      if(fp == 0 || fwrite(source.data(),1,source.size(),fp) != source.size() || fclose(fp) != 0)
+        {
+          std::cout << "MASA ERROR:: unable to write " << src << "\n";
+          remove(src.c_str());
+          rmdir(work.c_str());
+          return 1;
+        }
+
+      if(expr_compile(command,src,obj,log) != 0 || rename(obj.c_str(),so.c_str()) != 0)
+        {
+          std::cout << "MASA ERROR:: compiling " << src << " failed, see " << log << "\n";
+          remove(obj.c_str());
+          return 1;
+        }
+      remove(src.c_str());
+      remove(log.c_str());
+      rmdir(work.c_str());
+    }
+
+  void* handle = dlopen(so.c_str(),RTLD_NOW | RTLD_LOCAL);
+  if(handle == 0)
+    {
+      std::cout << "MASA ERROR:: cannot load " << so << ", " << dlerror() << "\n";
+      return 1;
+    }
+
+  bool complete = (native.terms = reinterpret_cast<void (*)(const Scalar*,Scalar*)>(dlsym(handle,"masa_native_terms"))) != 0;
+  for(unsigned int f = 0; f != NUM_FIELDS; f++)
+    {
+      std::ostringstream sym;
+      sym << "masa_native_field_" << f;
+      native.field[f] = c.has_field[f] ? reinterpret_cast<Scalar (*)(const Scalar*)>(dlsym(handle,sym.str().c_str())) : 0;
+      complete = complete && (native.field[f] != 0 || !c.has_field[f]);
+    }
+
+  if(!complete)
+    {
+      std::cout << "MASA ERROR:: " << so << " is not a specialization of " << c.equations << "\n";
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * grid evaluation
+ *
+ * on the fixed points of a registered grid, the source terms are
+ * derived again on DualNumbers of expr_sym, this time keeping the
+ * parameters as nodes, and every node of that graph records the
+ * parameters it depends on. A change of parameters only affects the
+ * nodes depending on one of them; the others keep their values, and
+ * those read by affected nodes are kept as columns over the whole
+ * grid, for as long as later changes stay within the same parameters.
+ * Sweeping mu thus recomputes the viscous terms from the columns of
+ * their coordinate dependent factors, and nothing else.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+const unsigned int grid_block = 64;   // points evaluated together
+
+// an operation on m points
+template <typename Scalar>
+void expr_apply_block(int op, const Scalar* a, const Scalar* b, int n, Scalar* r, unsigned int m)
+{
+  switch(op)
+    {
+    case OP_NEG: for(unsigned int k = 0; k != m; k++) r[k] = -a[k];       break;
+    case OP_ADD: for(unsigned int k = 0; k != m; k++) r[k] = a[k] + b[k]; break;
+    case OP_SUB: for(unsigned int k = 0; k != m; k++) r[k] = a[k] - b[k]; break;
+    case OP_MUL: for(unsigned int k = 0; k != m; k++) r[k] = a[k] * b[k]; break;
+    case OP_DIV: for(unsigned int k = 0; k != m; k++) r[k] = a[k] / b[k]; break;
+    default:
+      for(unsigned int k = 0; k != m; k++)
+        r[k] = expr_apply<Scalar>(op,a[k],b ? b[k] : Scalar(0),n);
+    }
+}
+
+template <typename Scalar>
+class expr_grid : public grid_cache<Scalar>
+{
+public:
+  expr_grid(std::shared_ptr<const expr_code> code);
+
+  std::shared_ptr<const expr_code> code;
+
+  // root r (a term, or NUM_TERMS + a field) with the parameters params
+  // on the n points coords, into values; current if values holds it
+  // already for earlier parameters
+  void eval(const std::vector<Scalar>& params, int r, std::size_t n,
+            const Scalar* const* coords, Scalar* values, bool current);
+
+  int root(int r) const { return _root[r]; }
+
+private:
+  expr_graph                        _graph;
+  int                               _root[NUM_TERMS + NUM_FIELDS];   // -1 if not defined
+  std::vector<std::vector<bool> >   _deps;       // parameters each node depends on
+
+  std::vector<Scalar>               _at;         // parameters the columns were computed with
+  std::vector<bool>                 _swept;      // parameters the columns do not depend on
+  std::vector<std::vector<Scalar> > _column;     // kept node values, empty if not kept
+  std::vector<Scalar>               _root_at[NUM_TERMS + NUM_FIELDS];
+
+  bool depends(int i, const std::vector<bool>& params) const
+  {
+    for(unsigned int j = 0; j != params.size(); j++)
+      if(params[j] && _deps[i][j])
+        return true;
+    return false;
+  }
+};
+
+template <typename Scalar>
+expr_grid<Scalar>::expr_grid(std::shared_ptr<const expr_code> c)
+  : code(c)
+{
+  const std::vector<expr_node>& nodes = c->graph.nodes;
+  expr_graph& g = _graph;
+  expr_graph_scope scope(g);
+
+  // the uniform nodes again, over the parameters instead of their values
+  std::vector<expr_sym> su(nodes.size());
+  for(unsigned int i = 0; i != nodes.size(); i++)
+    {
+      const expr_node& e = nodes[i];
+      if(!e.uniform)
+        continue;
+      if(e.op == OP_CONST)
+        su[i] = expr_sym(e.c);
+      else if(e.op == OP_PARAM)
+        su[i] = expr_sym(g.param(e.n),true);
+      else if(e.op == OP_POWI)
+        su[i] = expr_sym(g.powi(su[e.a].id,e.n),true);
+      else if(e.b < 0)
+        su[i] = expr_sym(g.unary(e.op,su[e.a].id),true);
+      else
+        su[i] = expr_sym(g.binary(e.op,su[e.a].id,su[e.b].id),true);
+    }
+
+  expr_sym p[4];
+  for(unsigned int i = 0; i != c->ncoord; i++)
+    p[i] = expr_sym(g.coord(i),true);
+
+  expr_sym q[NUM_TERMS];
+  expr_source_terms(*c,&su[0],p,q);
+
+  for(unsigned int t = 0; t != NUM_TERMS; t++)
+    _root[t] = c->has_term[t] ? q[t].id : -1;
+  for(unsigned int f = 0; f != NUM_FIELDS; f++)
+    _root[NUM_TERMS+f] = c->has_field[f] ? expr_exact(*c,f,&su[0],p).id : -1;
+
+  _deps.assign(g.nodes.size(),std::vector<bool>(c->params.size(),false));
+  for(unsigned int i = 0; i != g.nodes.size(); i++)
+    {
+      const expr_node& e = g.nodes[i];
+      if(e.op == OP_PARAM)
+        _deps[i][e.n] = true;
+      for(unsigned int j = 0; j != c->params.size(); j++)
+        _deps[i][j] = _deps[i][j] || (e.a >= 0 && _deps[e.a][j]) || (e.b >= 0 && _deps[e.b][j]);
+    }
+  _column.resize(g.nodes.size());
+}
+
+template <typename Scalar>
+void expr_grid<Scalar>::eval(const std::vector<Scalar>& params, int r, std::size_t n,
+                             const Scalar* const* coords, Scalar* values, bool current)
+{
+  const std::vector<expr_node>& nodes = _graph.nodes;
+  const int id = _root[r];
+  const unsigned int np = params.size();
+
+  // unchanged if none of the parameters it depends on changed
+  if(current && _root_at[r].size() == np)
+    {
+      bool same = true;
+      for(unsigned int j = 0; same && j != np; j++)
+        same = !_deps[id][j] || _root_at[r][j] == params[j];
+      if(same)
+        return;
+    }
+
+  // the columns hold as long as only the parameters they were kept
+  // for change; any other change starts over, keeping the columns for
+  // the parameters it changed
+  std::vector<bool> changed(np,_at.empty());
+  bool within = !_at.empty();
+  for(unsigned int j = 0; j != np && !_at.empty(); j++)
+    {
+      changed[j] = !(_at[j] == params[j]);
+      within = within && (!changed[j] || _swept[j]);
+    }
+  if(!within)
+    {
+      _swept.assign(np,false);
+      if(!_at.empty())
+        _swept = changed;
+      for(unsigned int i = 0; i != _column.size(); i++)
+        std::vector<Scalar>().swap(_column[i]);
+    }
+  _at = params;
+  _root_at[r] = params;
+
+  // the uniform nodes, with the parameters
+  std::vector<Scalar> u(nodes.size());
+  for(unsigned int i = 0; i != nodes.size(); i++)
+    {
+      const expr_node& e = nodes[i];
+      if(!e.uniform)
+        continue;
+      switch(e.op)
+        {
+        case OP_CONST: u[i] = Scalar(e.c);     break;
+        case OP_PARAM: u[i] = params[e.n];     break;
+        default:
+          u[i] = expr_apply<Scalar>(e.op,u[e.a],e.b < 0 ? Scalar(0) : u[e.b],e.n);
+        }
+    }
+
+  if(nodes[id].uniform || nodes[id].op == OP_COORD || !_column[id].empty())
+    {
+      for(std::size_t k = 0; k != n; k++)
+        values[k] = nodes[id].uniform ? u[id] : (_column[id].empty() ? coords[nodes[id].n][k] : _column[id][k]);
+      return;
+    }
+
+  // nodes to compute: those read by the root, down to the kept columns
+  enum { UNUSED, UNIFORM, COORD, KEPT, KEEP, TEMP };
+  std::vector<int> kind(id+1,UNUSED);
+  kind[id] = TEMP;
+  for(int i = id; i >= 0; i--)
+    {
+      if(kind[i] != TEMP && kind[i] != KEEP)
+        continue;
+      const bool affected = depends(i,_swept);
+      for(int k = 0; k != 2; k++)
+        {
+          const int o = k ? nodes[i].b : nodes[i].a;
+          if(o < 0 || kind[o] == KEEP)
+            continue;
+          if(nodes[o].uniform)
+            kind[o] = UNIFORM;
+          else if(nodes[o].op == OP_COORD)
+            kind[o] = COORD;
+          else if(!_column[o].empty())
+            kind[o] = KEPT;
+          else if(affected && !depends(o,_swept))
+            {
+              kind[o] = KEEP;
+              _column[o].resize(n);
+            }
+          else
+            kind[o] = TEMP;
+        }
+    }
+
+  // temporaries share the scratch slots once their last reader is done
+  std::vector<int> last(id+1,-1), slot(id+1,-1), order, free_slots;
+  unsigned int nslots = 0;
+  for(int i = 0; i <= id; i++)
+    if(kind[i] == TEMP || kind[i] == KEEP)
+      {
+        if(nodes[i].a >= 0) last[nodes[i].a] = i;
+        if(nodes[i].b >= 0) last[nodes[i].b] = i;
+      }
+  for(int i = 0; i < id; i++)
+    if(kind[i] == TEMP || kind[i] == KEEP)
+      {
+        order.push_back(i);
+        for(int k = 0; k != 2; k++)
+          {
+            const int o = k ? nodes[i].b : nodes[i].a;
+            if(o >= 0 && kind[o] == TEMP && last[o] == i && (k == 0 || nodes[i].a != o))
+              free_slots.push_back(slot[o]);
+          }
+        if(kind[i] == TEMP)
+          {
+            if(free_slots.empty())
+              slot[i] = nslots++;
+            else
+              {
+                slot[i] = free_slots.back();
+                free_slots.pop_back();
+              }
+          }
+      }
+  order.push_back(id);
+
+  // uniform operands, spread over a block
+  std::vector<Scalar> spread;
+  for(int i = 0; i <= id; i++)
+    if(kind[i] == UNIFORM)
+      {
+        slot[i] = spread.size();
+        spread.resize(spread.size() + grid_block,u[i]);
+      }
+
+  masa_parallel_for(n,masa_pool_workers(n),[&](std::size_t begin, std::size_t end, unsigned int)
+    {
+      std::vector<Scalar> scratch(nslots * grid_block);
+      std::vector<const Scalar*> src(id+1,0);
+
+      for(std::size_t b0 = begin; b0 < end; b0 += grid_block)
+        {
+          const unsigned int m = std::min<std::size_t>(grid_block,end-b0);
+          for(unsigned int j = 0; j != order.size(); j++)
+            {
+              const int i = order[j];
+              const expr_node& e = nodes[i];
+              const Scalar* a[2] = {0, 0};
+              for(int k = 0; k != 2; k++)
+                {
+                  const int o = k ? e.b : e.a;
+                  if(o < 0)
+                    continue;
+                  switch(kind[o])
+                    {
+                    case UNIFORM: a[k] = &spread[slot[o]];       break;
+                    case COORD:   a[k] = coords[nodes[o].n] + b0; break;
+                    case KEPT:    a[k] = &_column[o][b0];        break;
+                    default:      a[k] = src[o];
+                    }
+                }
+
+              Scalar* out = i == id ? values + b0
+                : (kind[i] == KEEP ? &_column[i][b0] : &scratch[slot[i] * grid_block]);
+              expr_apply_block<Scalar>(e.op,a[0],a[1],e.n,out,m);
+              src[i] = out;
+            }
+        }
+    });
+}
+
+/*
+ * -------------------------------------------------------------------------------------------
+ *
+ * masa_expr
+ *
+ * a manufactured solution compiled from definitions. The parameter
+ * dependent nodes are recomputed whenever the parameters change; a
+ * source term evaluates all the terms of the equations at once, and
+ * the other terms at the same point are then returned without
+ * evaluating again. After jit_compile, the native code is used for as
+ * long as the parameters keep the values it was compiled for.
+ *
+ * -------------------------------------------------------------------------------------------
+ */
+
+template <typename Scalar>
+class masa_expr : public manufactured_solution<Scalar>
+{
+public:
+  masa_expr(std::shared_ptr<const expr_code> code);
+  int init_var();
+
+  manufactured_solution<Scalar>* clone() const
+  {
+    masa_expr<Scalar>* ms = new masa_expr<Scalar>(_code);
+    ms->_native = _native;
+    return ms;
+  }
+
+  int jit_compile(const std::string& dir);
+
+  int eval_grid(std::shared_ptr<grid_cache<Scalar> >& cache, const std::string& field, unsigned int dims,
+                std::size_t n, const Scalar* const* coords, Scalar* values, bool current);
+
+  void fingerprint(std::string& bytes) const
+  {
+    manufactured_solution<Scalar>::fingerprint(bytes);
+    bytes.append(_code->definitions);
+  }
+
+#define MASA_EXPR_EVAL(function, kind, index)                                                          \
+  Scalar function(Scalar x)                             { const Scalar p[] = {x};       return eval(kind,index,p,1); } \
+  Scalar function(Scalar x, Scalar y)                   { const Scalar p[] = {x,y};     return eval(kind,index,p,2); } \
+  Scalar function(Scalar x, Scalar y, Scalar z)         { const Scalar p[] = {x,y,z};   return eval(kind,index,p,3); } \
+  Scalar function(Scalar x, Scalar y, Scalar z, Scalar t){ const Scalar p[] = {x,y,z,t}; return eval(kind,index,p,4); }
+
+  MASA_EXPR_EVAL(eval_q_t,       true,  TERM_T)
+  MASA_EXPR_EVAL(eval_q_rho,     true,  TERM_RHO)
+  MASA_EXPR_EVAL(eval_q_rho_u,   true,  TERM_RHO_U)
+  MASA_EXPR_EVAL(eval_q_rho_v,   true,  TERM_RHO_V)
+  MASA_EXPR_EVAL(eval_q_rho_w,   true,  TERM_RHO_W)
+  MASA_EXPR_EVAL(eval_q_rho_e,   true,  TERM_RHO_E)
+  MASA_EXPR_EVAL(eval_exact_t,   false, FIELD_T)
+  MASA_EXPR_EVAL(eval_exact_rho, false, FIELD_RHO)
+  MASA_EXPR_EVAL(eval_exact_u,   false, FIELD_U)
+  MASA_EXPR_EVAL(eval_exact_v,   false, FIELD_V)
+  MASA_EXPR_EVAL(eval_exact_w,   false, FIELD_W)
+  MASA_EXPR_EVAL(eval_exact_p,   false, FIELD_P)
+
+#undef MASA_EXPR_EVAL
+
+private:
+  std::shared_ptr<const expr_code> _code;
+  std::vector<Scalar>              _params;
+  std::vector<Scalar>              _uniform;        // values of the uniform nodes
+  unsigned long                    _uniform_revision;
+  bool                             _uniform_valid;
+
+  Scalar                           _point[4];       // last point the source terms were evaluated at
+  unsigned long                    _point_revision;
+  bool                             _point_valid;
+  Scalar                           _terms[NUM_TERMS];
+
+  std::shared_ptr<const expr_native<Scalar> > _native;
+  bool                             _native_current; // _native was compiled for the parameters
+
+  Scalar eval(bool source, int index, const Scalar* p, unsigned int n);
+  void   update_uniform();
+};
+
+template <typename Scalar>
+masa_expr<Scalar>::masa_expr(std::shared_ptr<const expr_code> code)
+  : _code(code),
+    _params(code->params.size()),
+    _uniform(code->graph.nodes.size()),
+    _uniform_revision(0),
+    _uniform_valid(false),
+    _point_revision(0),
+    _point_valid(false),
+    _native_current(false)
+{
+  this->mmsname = "expr_" + code->equations;
+  this->dimension = code->dim;
+  this->transient = code->unsteady;
+  this->declare_fields(code->fields);
+
+  // the parameters live in _params, and differ between expressions
+  this->share_schema = false;
+  for(unsigned int i = 0; i != _params.size(); i++)
+    this->register_var(code->params[i],&_params[i]);
+
+  this->init_var();
+}
+
+template <typename Scalar>
+int masa_expr<Scalar>::init_var()
+{
+  int err = 0;
+
+  for(unsigned int i = 0; i != _params.size(); i++)
+    if(_code->has_default[i])
+      err += this->set_var(_code->params[i],Scalar(_code->defaults[i]));
+
+  return err;
+}
+
+template <typename Scalar>
+void masa_expr<Scalar>::update_uniform()
+{
+  if(_uniform_valid && _uniform_revision == this->get_revision())
+    return;
+
+  const std::vector<expr_node>& nodes = _code->graph.nodes;
+  for(unsigned int i = 0; i != nodes.size(); i++)
+    {
+      const expr_node& e = nodes[i];
+      if(!e.uniform)
+        continue;
+      switch(e.op)
+        {
+        case OP_CONST: _uniform[i] = Scalar(e.c);     break;
+        case OP_PARAM: _uniform[i] = _params[e.n];    break;
+        default:
+          _uniform[i] = expr_apply<Scalar>(e.op,_uniform[e.a],e.b < 0 ? Scalar(0) : _uniform[e.b],e.n);
+        }
+    }
+
+  _native_current = _native && _native->params == _params;
+
+  _uniform_revision = this->get_revision();
+  _uniform_valid = true;
+}
+
+template <typename Scalar>
+int masa_expr<Scalar>::jit_compile(const std::string& dir)
+{
+  const char* type = expr_native_type<Scalar>();
+  if(type == 0)
+    {
+      std::cout << "MASA ERROR:: native code is compiled for float, double and long double solutions only\n";
+      return 1;
+    }
+
+  // $XDG_CACHE_HOME/masa_jit, or one directory per user in $TMPDIR
+  std::string cache = dir;
+  if(cache.empty())
+    {
+      const char* xdg = getenv("XDG_CACHE_HOME");
+      const char* tmp = getenv("TMPDIR");
+      std::ostringstream path;
+      if(xdg && *xdg)
+        path << xdg << "/masa_jit";
+      else
+        path << (tmp && *tmp ? tmp : "/tmp") << "/masa_jit-" << geteuid();
+      cache = path.str();
+    }
+
+  mkdir(cache.c_str(),0700);
+  if(!expr_private_dir(cache))
+    {
+      std::cout << "MASA ERROR:: unable to use " << cache << " as a directory for native code,"
+                << " it must be a directory of the user that no one else can write to\n";
+      return 1;
+    }
+
+  update_uniform();
+
+  std::shared_ptr<expr_native<Scalar> > native(new expr_native<Scalar>);
+  native->params = _params;
+  if(expr_native_load(*_code,cache,expr_native_source(*_code,_uniform,type),*native))
+    return 1;
+
+  _native = native;
+  _uniform_valid = false;
+  _point_valid = false;
+  return 0;
+}
+
+template <typename Scalar>
+int masa_expr<Scalar>::eval_grid(std::shared_ptr<grid_cache<Scalar> >& cache, const std::string& field,
+                                 unsigned int dims, std::size_t n, const Scalar* const* coords,
+                                 Scalar* values, bool current)
+{
+  int r = 0;
+  while(r != NUM_TERMS + NUM_FIELDS && field != grid_names[r])
+    r++;
+
+  // anything else is left to the point evaluations, which report it
+  if(dims != _code->ncoord || r == NUM_TERMS + NUM_FIELDS)
+    return -1;
+
+  expr_grid<Scalar>* g = dynamic_cast<expr_grid<Scalar>*>(cache.get());
+  if(g == 0 || g->code != _code)
+    {
+      g = new expr_grid<Scalar>(_code);
+      cache.reset(g);
+    }
+  if(g->root(r) < 0)
+    return -1;
+
+  g->eval(_params,r,n,coords,values,current);
+  return 0;
+}
+
+template <typename Scalar>
+Scalar masa_expr<Scalar>::eval(bool source, int index, const Scalar* p, unsigned int n)
+{
+  const expr_code& c = *_code;
+
+  if(n != c.ncoord || !(source ? c.has_term[index] : c.has_field[index]))
+    {
+      if(source)
+        std::cout << "MASA ERROR:: Source term (" << term_names[index] << ") is unavailable for " << this->mmsname << " at " << n << " coordinates.\n";
+      else
+        std::cout << "MASA ERROR:: Analytical Solution (" << field_names[index] << ") is unavailable for " << this->mmsname << " at " << n << " coordinates.\n";
+      return -1.33;
+    }
+
+  update_uniform();
+
+  if(!source)
+    return _native_current ? _native->field[index](p) : expr_exact(c,index,&_uniform[0],p);
+
+  bool same = _point_valid && _point_revision == this->get_revision();
+  for(unsigned int i = 0; same && i != n; i++)
+    same = _point[i] == p[i];
+
+  if(!same)
+    {
+      if(_native_current)
+        _native->terms(p,_terms);
+      else
+        expr_source_terms(c,&_uniform[0],p,_terms);
+      for(unsigned int i = 0; i != n; i++)
+        _point[i] = p[i];
+      _point_revision = this->get_revision();
+      _point_valid = true;
+    }
+
+  return _terms[index];
+}
+
+} // end anonymous namespace
+
+template <typename Scalar>
+MASA::manufactured_solution<Scalar>* MASA::masa_new_expr_solution(const std::string& equations,
+                                                                   const std::string& definitions)
+{
+  std::shared_ptr<expr_code> code(new expr_code);
+  code->equations   = equations;
+  code->definitions = definitions;
+
+  expr_compiler compiler(*code);
+  if(compiler.compile())
+    {
+      std::cout << "MASA ERROR:: " << compiler.error() << " in the definitions of " << equations << "\n";
+      return 0;
+    }
+
+  return new masa_expr<Scalar>(code);
+}
+
+namespace MASA
+{
+  template manufactured_solution<double>* masa_new_expr_solution<double>(const std::string&, const std::string&);
+#ifndef MASA_OMIT_FLOAT
+  template manufactured_solution<float>* masa_new_expr_solution<float>(const std::string&, const std::string&);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+  template manufactured_solution<long double>* masa_new_expr_solution<long double>(const std::string&, const std::string&);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+  template manufactured_solution<DoubleDouble>* masa_new_expr_solution<DoubleDouble>(const std::string&, const std::string&);
+#endif
+}
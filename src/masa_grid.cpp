@@ -0,0 +1,347 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_grid.cpp: registered point sets whose exact and source fields
+//                are evaluated once and handed out without copying
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <masa_internal.h>
+#include <mutex>
+
+using namespace MASA;
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+template <typename Scalar>
+struct field
+{
+  std::vector<Scalar> values;
+  const void*         solution;   // solution and parameter revision the
+  unsigned long       revision;   // values were computed with
+};
+
+template <typename Scalar>
+struct grid
+{
+  std::mutex lock;   // held while a field of the grid is looked up or computed
+  int dimension;
+  std::vector<Scalar> x, y, z;
+  std::map<std::string,field<Scalar> > fields;
+  std::shared_ptr<grid_cache<Scalar> > cache;   // kept by the solution between evaluations
+};
+
+// the registry lock is only held to find, add or drop a grid; a grid
+// stays alive while a field of it is computed, even if it is released
+template <typename Scalar>
+struct registry
+{
+  std::mutex                                     lock;
+  std::map<int,std::shared_ptr<grid<Scalar> > > grids;
+  int                                            next;
+
+  registry() : next(1) {}
+};
+
+template <typename Scalar>
+registry<Scalar>& grids()
+{
+  static registry<Scalar> r;
+  return r;
+}
+
+// field names, "exact_<var>" and "q_<var>", for each dimension
+template <typename Scalar>
+struct field_table
+{
+  std::map<std::string,Scalar (*)(Scalar)>               d1;
+  std::map<std::string,Scalar (*)(Scalar,Scalar)>        d2;
+  std::map<std::string,Scalar (*)(Scalar,Scalar,Scalar)> d3;
+
+  field_table()
+  {
+#define MASA_GRID_FIELD(table,name,func) table[name] = func<Scalar>
+    MASA_GRID_FIELD(d1,"exact_p",      masa_eval_exact_p);
+    MASA_GRID_FIELD(d1,"exact_rho",    masa_eval_exact_rho);
+    MASA_GRID_FIELD(d1,"exact_rho_C",  masa_eval_exact_rho_C);
+    MASA_GRID_FIELD(d1,"exact_rho_C3", masa_eval_exact_rho_C3);
+    MASA_GRID_FIELD(d1,"exact_rho_N",  masa_eval_exact_rho_N);
+    MASA_GRID_FIELD(d1,"exact_rho_N2", masa_eval_exact_rho_N2);
+    MASA_GRID_FIELD(d1,"exact_t",      masa_eval_exact_t);
+    MASA_GRID_FIELD(d1,"exact_u",      masa_eval_exact_u);
+    MASA_GRID_FIELD(d1,"exact_v",      masa_eval_exact_v);
+    MASA_GRID_FIELD(d1,"exact_w",      masa_eval_exact_w);
+    MASA_GRID_FIELD(d1,"q_C",          masa_eval_source_C);
+    MASA_GRID_FIELD(d1,"q_C3",         masa_eval_source_C3);
+    MASA_GRID_FIELD(d1,"q_boundary",   masa_eval_source_boundary);
+    MASA_GRID_FIELD(d1,"q_e",          masa_eval_source_e);
+    MASA_GRID_FIELD(d1,"q_rho",        masa_eval_source_rho);
+    MASA_GRID_FIELD(d1,"q_rho_C",      masa_eval_source_rho_C);
+    MASA_GRID_FIELD(d1,"q_rho_C3",     masa_eval_source_rho_C3);
+    MASA_GRID_FIELD(d1,"q_rho_e",      masa_eval_source_rho_e);
+    MASA_GRID_FIELD(d1,"q_rho_u",      masa_eval_source_rho_u);
+    MASA_GRID_FIELD(d1,"q_rho_v",      masa_eval_source_rho_v);
+    MASA_GRID_FIELD(d1,"q_rho_w",      masa_eval_source_rho_w);
+    MASA_GRID_FIELD(d1,"q_t",          masa_eval_source_t);
+    MASA_GRID_FIELD(d1,"q_u",          masa_eval_source_u);
+    MASA_GRID_FIELD(d1,"q_v",          masa_eval_source_v);
+    MASA_GRID_FIELD(d1,"q_w",          masa_eval_source_w);
+
+    MASA_GRID_FIELD(d2,"exact_nu",     masa_eval_exact_nu);
+    MASA_GRID_FIELD(d2,"exact_p",      masa_eval_exact_p);
+    MASA_GRID_FIELD(d2,"exact_phi",    masa_eval_exact_phi);
+    MASA_GRID_FIELD(d2,"exact_rho",    masa_eval_exact_rho);
+    MASA_GRID_FIELD(d2,"exact_rho_C",  masa_eval_exact_rho_C);
+    MASA_GRID_FIELD(d2,"exact_rho_C3", masa_eval_exact_rho_C3);
+    MASA_GRID_FIELD(d2,"exact_t",      masa_eval_exact_t);
+    MASA_GRID_FIELD(d2,"exact_u",      masa_eval_exact_u);
+    MASA_GRID_FIELD(d2,"exact_v",      masa_eval_exact_v);
+    MASA_GRID_FIELD(d2,"exact_w",      masa_eval_exact_w);
+    MASA_GRID_FIELD(d2,"q_e",          masa_eval_source_e);
+    MASA_GRID_FIELD(d2,"q_f",          masa_eval_source_f);
+    MASA_GRID_FIELD(d2,"q_nu",         masa_eval_source_nu);
+    MASA_GRID_FIELD(d2,"q_rho",        masa_eval_source_rho);
+    MASA_GRID_FIELD(d2,"q_rho_e",      masa_eval_source_rho_e);
+    MASA_GRID_FIELD(d2,"q_rho_u",      masa_eval_source_rho_u);
+    MASA_GRID_FIELD(d2,"q_rho_v",      masa_eval_source_rho_v);
+    MASA_GRID_FIELD(d2,"q_rho_w",      masa_eval_source_rho_w);
+    MASA_GRID_FIELD(d2,"q_t",          masa_eval_source_t);
+    MASA_GRID_FIELD(d2,"q_u",          masa_eval_source_u);
+    MASA_GRID_FIELD(d2,"q_v",          masa_eval_source_v);
+    MASA_GRID_FIELD(d2,"q_w",          masa_eval_source_w);
+
+    MASA_GRID_FIELD(d3,"exact_nu",     masa_eval_exact_nu);
+    MASA_GRID_FIELD(d3,"exact_p",      masa_eval_exact_p);
+    MASA_GRID_FIELD(d3,"exact_rho",    masa_eval_exact_rho);
+    MASA_GRID_FIELD(d3,"exact_rho_C",  masa_eval_exact_rho_C);
+    MASA_GRID_FIELD(d3,"exact_rho_C3", masa_eval_exact_rho_C3);
+    MASA_GRID_FIELD(d3,"exact_t",      masa_eval_exact_t);
+    MASA_GRID_FIELD(d3,"exact_u",      masa_eval_exact_u);
+    MASA_GRID_FIELD(d3,"exact_v",      masa_eval_exact_v);
+    MASA_GRID_FIELD(d3,"exact_w",      masa_eval_exact_w);
+    MASA_GRID_FIELD(d3,"q_e",          masa_eval_source_e);
+    MASA_GRID_FIELD(d3,"q_nu",         masa_eval_source_nu);
+    MASA_GRID_FIELD(d3,"q_rho",        masa_eval_source_rho);
+    MASA_GRID_FIELD(d3,"q_rho_e",      masa_eval_source_rho_e);
+    MASA_GRID_FIELD(d3,"q_rho_u",      masa_eval_source_rho_u);
+    MASA_GRID_FIELD(d3,"q_rho_v",      masa_eval_source_rho_v);
+    MASA_GRID_FIELD(d3,"q_rho_w",      masa_eval_source_rho_w);
+    MASA_GRID_FIELD(d3,"q_t",          masa_eval_source_t);
+    MASA_GRID_FIELD(d3,"q_u",          masa_eval_source_u);
+    MASA_GRID_FIELD(d3,"q_v",          masa_eval_source_v);
+    MASA_GRID_FIELD(d3,"q_w",          masa_eval_source_w);
+#undef MASA_GRID_FIELD
+  }
+};
+
+template <typename Scalar>
+const field_table<Scalar>& table()
+{
+  static const field_table<Scalar> t;
+  return t;
+}
+
+template <typename Func>
+Func lookup(const std::map<std::string,Func>& funcs, const std::string& name)
+{
+  typename std::map<std::string,Func>::const_iterator it = funcs.find(name);
+  return it == funcs.end() ? 0 : it->second;
+}
+
+// (re)computes values in place, so the array never moves; current if
+// they hold the field of the same solution for earlier parameters
+// the grid of handle, NULL if there is none
+template <typename Scalar>
+std::shared_ptr<grid<Scalar> > find_grid(int handle)
+{
+  registry<Scalar>& r = grids<Scalar>();
+  std::lock_guard<std::mutex> guard(r.lock);
+
+  typename std::map<int,std::shared_ptr<grid<Scalar> > >::const_iterator g = r.grids.find(handle);
+  return g == r.grids.end() ? std::shared_ptr<grid<Scalar> >() : g->second;
+}
+
+template <typename Scalar>
+int compute(grid<Scalar>& g, manufactured_solution<Scalar>& ms, const std::string& name,
+            std::vector<Scalar>& values, bool current)
+{
+  const field_table<Scalar>& t = table<Scalar>();
+  const std::size_t n = g.x.size();
+
+  values.resize(n);
+
+  // solutions tracking what their parameters affect update only that
+  const Scalar* coords[] = {g.x.data(), g.y.data(), g.z.data()};
+  int err = ms.eval_grid(g.cache,name,g.dimension,n,coords,values.data(),current);
+  if(err >= 0)
+    return err;
+
+  err = 1;
+  switch(g.dimension)
+    {
+    case 1:
+      if(Scalar (*f)(Scalar) = lookup(t.d1,name))
+        err = masa_eval_1d_batch(f,n,g.x.data(),values.data());
+      else
+        std::cout << "MASA ERROR:: no 1D field " << name << " to evaluate on a registered grid" << std::endl;
+      break;
+    case 2:
+      if(Scalar (*f)(Scalar,Scalar) = lookup(t.d2,name))
+        err = masa_eval_2d_batch(f,n,g.x.data(),g.y.data(),values.data());
+      else
+        std::cout << "MASA ERROR:: no 2D field " << name << " to evaluate on a registered grid" << std::endl;
+      break;
+    case 3:
+      if(Scalar (*f)(Scalar,Scalar,Scalar) = lookup(t.d3,name))
+        err = masa_eval_3d_batch(f,n,g.x.data(),g.y.data(),g.z.data(),values.data());
+      else
+        std::cout << "MASA ERROR:: no 3D field " << name << " to evaluate on a registered grid" << std::endl;
+      break;
+    }
+  return err;
+}
+
+} // end anonymous namespace
+
+template <typename Scalar>
+int MASA::masa_register_grid(const Scalar* x, const Scalar* y, const Scalar* z, std::size_t n)
+{
+  if(x == 0 || (y == 0 && z != 0))
+    {
+      std::cout << "MASA ERROR:: masa_register_grid needs x, and y before z" << std::endl;
+      return -1;
+    }
+
+  std::shared_ptr<grid<Scalar> > g = std::make_shared<grid<Scalar> >();
+  g->dimension = z ? 3 : (y ? 2 : 1);
+  g->x.assign(x,x+n);
+  if(y)
+    g->y.assign(y,y+n);
+  if(z)
+    g->z.assign(z,z+n);
+
+  registry<Scalar>& r = grids<Scalar>();
+  std::lock_guard<std::mutex> guard(r.lock);
+
+  const int handle = r.next++;
+  r.grids[handle] = g;
+  return handle;
+}
+
+template <typename Scalar>
+const Scalar* MASA::masa_grid_field(int handle, const std::string& name)
+{
+  std::shared_ptr<grid<Scalar> > g = find_grid<Scalar>(handle);
+  if(!g)
+    {
+      std::cout << "MASA ERROR:: masa_grid_field was passed an unknown grid handle (" << handle << ")" << std::endl;
+      return 0;
+    }
+  std::lock_guard<std::mutex> guard(g->lock);
+
+  const void*   solution;
+  unsigned long revision;
+  manufactured_solution<Scalar>* ms = masa_selected_solution<Scalar>();
+  if(ms == 0 || masa_solution_revision<Scalar>(solution,revision))
+    {
+      std::cout << "MASA ERROR:: masa_grid_field needs a selected solution" << std::endl;
+      return 0;
+    }
+
+  typename std::map<std::string,field<Scalar> >::iterator f = g->fields.find(name);
+  const bool known = f != g->fields.end();
+  if(known && f->second.solution == solution && f->second.revision == revision)
+    return f->second.values.data();
+
+  // first request, or the solution or its parameters changed since
+  const bool current = known && f->second.solution == solution;
+  if(!known)
+    f = g->fields.insert(std::make_pair(name,field<Scalar>())).first;
+  if(compute(*g,*ms,name,f->second.values,current))
+    {
+      g->fields.erase(f);
+      return 0;
+    }
+  f->second.solution = solution;
+  f->second.revision = revision;
+  return f->second.values.data();
+}
+
+template <typename Scalar>
+int MASA::masa_evict_field(int handle, const std::string& name)
+{
+  std::shared_ptr<grid<Scalar> > g = find_grid<Scalar>(handle);
+  if(!g)
+    {
+      std::cout << "MASA ERROR:: masa_evict_field was passed an unknown grid handle (" << handle << ")" << std::endl;
+      return 1;
+    }
+
+  std::lock_guard<std::mutex> guard(g->lock);
+  g->fields.erase(name);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::masa_release_grid(int handle)
+{
+  registry<Scalar>& r = grids<Scalar>();
+  std::lock_guard<std::mutex> guard(r.lock);
+
+  if(r.grids.erase(handle) == 0)
+    {
+      std::cout << "MASA ERROR:: masa_release_grid was passed an unknown grid handle (" << handle << ")" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+// Instantiate for every precision
+
+#define INSTANTIATE_GRID_FUNCTIONS(Scalar) \
+  template int           masa_register_grid<Scalar>(const Scalar*,const Scalar*,const Scalar*,std::size_t); \
+  template const Scalar* masa_grid_field   <Scalar>(int,const std::string&); \
+  template int           masa_evict_field  <Scalar>(int,const std::string&); \
+  template int           masa_release_grid <Scalar>(int)
+
+namespace MASA {
+
+INSTANTIATE_GRID_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_GRID_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+INSTANTIATE_GRID_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_GRID_FUNCTIONS(DoubleDouble);
+#endif
+
+}
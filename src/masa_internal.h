@@ -34,21 +34,103 @@
 //
 
 #include <masa.h>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <vector>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include "numberarray.h"
+#include "masa_lane_math.h"
+#include "doubledouble.h"
+
+// DoubleDouble also appears inside the derivative types of the AD
+// solutions, where it takes the place of a builtin floating point type
+ScalarBuiltin_true(DoubleDouble);
+
+CompareTypes_single(DoubleDouble);
+CompareTypes_all(unsigned int, DoubleDouble);
+CompareTypes_all(int, DoubleDouble);
+CompareTypes_all(float, DoubleDouble);
+CompareTypes_all(double, DoubleDouble);
+CompareTypes_all(long double, DoubleDouble);
 
 using std::cos;
 using std::sin;
 using std::pow;
 
+// found by argument dependent lookup for the lane type below
+using std::abs;
+using std::acos;
+using std::asin;
+using std::atan;
+using std::erf;
+using std::exp;
+using std::fabs;
+using std::log;
+using std::sqrt;
+
+#include "masa_math.h"
+
+// Instantiations of the optional Scalar types, which configure can
+// leave out (--with-masa-scalars)
+#ifdef MASA_OMIT_FLOAT
+#define MASA_INSTANTIATE_FLOAT(my_class)
+#else
+#define MASA_INSTANTIATE_FLOAT(my_class) template class my_class<float>;
+#endif
+
+#ifdef MASA_OMIT_LONGDOUBLE
+#define MASA_INSTANTIATE_LONGDOUBLE(my_class)
+#else
+#define MASA_INSTANTIATE_LONGDOUBLE(my_class) template class my_class<long double>;
+#endif
+
+#ifdef MASA_OMIT_DOUBLEDOUBLE
+#define MASA_INSTANTIATE_DOUBLEDOUBLE(my_class)
+#else
+#define MASA_INSTANTIATE_DOUBLEDOUBLE(my_class) template class my_class<DoubleDouble>;
+#endif
+
 // Macro for declaring MASA classes with all supported Scalar types
-#define MASA_INSTANTIATE_ALL(my_class) template class my_class<double>; \
-                                       template class my_class<long double>
+#define MASA_INSTANTIATE_ALL(my_class) MASA_INSTANTIATE_FLOAT(my_class) \
+                                       template class my_class<double>; \
+                                       MASA_INSTANTIATE_LONGDOUBLE(my_class) \
+                                       MASA_INSTANTIATE_DOUBLEDOUBLE(my_class) \
+                                       template class my_class<MASA::masa_simd>
+
+// Macro for classes whose control flow depends on the values being
+// computed, which therefore cannot evaluate several points at once
+#define MASA_INSTANTIATE_SCALARS(my_class) MASA_INSTANTIATE_FLOAT(my_class) \
+                                           MASA_INSTANTIATE_LONGDOUBLE(my_class) \
+                                           MASA_INSTANTIATE_DOUBLEDOUBLE(my_class) \
+                                           template class my_class<double>
+
+// A solution source is built unless configure was given a list of
+// sources without it (--with-masa-solutions), so that its
+// instantiations and registrations sit in
+//   #if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cns
+#ifdef MASA_SOLUTIONS_SELECTED
+#define MASA_ALL_SOLUTIONS 0
+#else
+#define MASA_ALL_SOLUTIONS 1
+#endif
+
+// the lane kernel modules built for other instruction sets only carry
+// the lane instantiations (see masa_lanes.cpp)
+#ifdef MASA_LANE_MODULE
+#undef  MASA_INSTANTIATE_ALL
+#undef  MASA_INSTANTIATE_SCALARS
+#define MASA_INSTANTIATE_ALL(my_class) template class my_class<MASA::masa_simd>
+#define MASA_INSTANTIATE_SCALARS(my_class) static_assert(true,"")
+#endif
 
 
 // overload for pgi compilers
@@ -64,6 +146,25 @@ using std::pow;
 namespace MASA
 {
 
+  // Points evaluated by one call of a solution instantiated for the lane
+  // type: every operation and math function of the expressions is
+  // applied lane by lane, in loops the compiler turns into vector code;
+  // sin, cos, exp, log and pow go through the kernels of masa_lane_math.h
+  const unsigned int masa_simd_lanes = lane_math::lanes;
+  typedef NumberArray<masa_simd_lanes,double> masa_simd;
+
+  // true if the comparison holds for any lane
+  inline bool masa_any(bool b) { return b; }
+
+  template <std::size_t size>
+  inline bool masa_any(const NumberArray<size,bool>& b)
+  {
+    for(std::size_t i = 0; i != size; ++i)
+      if(b[i])
+        return true;
+    return false;
+  }
+
   // masa map functions here
   // probably want to hide this from the user eventually
   int masa_map_solution  (std::string, std::string);
@@ -77,6 +178,342 @@ namespace MASA
   void remove_line(std::string&);
   void remove_whitespace(std::string&);
 
+  // work-stealing evaluation pool (masa_threads.cpp): body(begin,end,worker)
+  // is called on chunks of [0,n); worker 0 is always the calling thread
+  typedef std::function<void(std::size_t,std::size_t,unsigned int)> masa_chunk_body;
+  int masa_pool_set_threads(int nthreads);
+  int masa_pool_threads();
+  unsigned int masa_pool_workers(std::size_t n);
+  void masa_parallel_for(std::size_t n, unsigned int nworkers, const masa_chunk_body& body);
+
+  // static variant: slab [partition[s],partition[s+1]) always runs on worker s % nworkers
+  void masa_parallel_static(const std::vector<std::size_t>& partition, unsigned int nworkers,
+                            const masa_chunk_body& body);
+  int  masa_check_partition(const char* name, std::size_t n, const std::vector<std::size_t>& partition);
+
+  // runs body(begin,end) over [0,n) on the pool, with every worker
+  // thread evaluating a private copy of the selected solution; an empty
+  // partition selects work stealing, otherwise the static slabs are used (masa_core.cpp)
+  template <typename Scalar>
+  int masa_parallel_eval(std::size_t n, const std::function<void(std::size_t,std::size_t)>& body,
+                         const std::vector<std::size_t>& partition = std::vector<std::size_t>());
+
+  // raw bytes identifying the selected solution and all its parameters,
+  // returns 1 if no solution is selected (masa_core.cpp)
+  template <typename Scalar>
+  int masa_solution_fingerprint(std::string& bytes);
+
+  // identity and parameter revision of the selected solution, a
+  // (solution,revision) pair never repeats for different parameters;
+  // returns 1 if no solution is selected (masa_core.cpp)
+  template <typename Scalar>
+  int masa_solution_revision(const void*& solution, unsigned long& revision);
+
+  // the solution the current thread evaluates, NULL if none is selected (masa_core.cpp)
+  template <typename Scalar> class manufactured_solution;
+
+  template <typename Scalar>
+  manufactured_solution<Scalar>* masa_selected_solution();
+
+  // a new, uninitialized instance of the solution called name, NULL if
+  // there is none (masa_core.cpp)
+  template <typename Scalar>
+  manufactured_solution<Scalar>* masa_new_solution(const std::string& name);
+
+  // a new solution of the equations ("euler_2d", ...) with the fields
+  // and parameters given by definitions, NULL after printing what is
+  // wrong with them (masa_expr.cpp)
+  template <typename Scalar>
+  manufactured_solution<Scalar>* masa_new_expr_solution(const std::string& equations,
+                                                        const std::string& definitions);
+
+  // evaluates field ("exact_rho", "q_rho_u", ...) of the selected double
+  // solution at n points, masa_simd_lanes points per call (masa_simd.cpp)
+  int masa_simd_eval(const char* caller, const std::string& field, unsigned int dims,
+                     std::size_t n, const double* const* coords, double* out);
+
+  // the same for float points: evaluated in float by a float instance of
+  // the selected double solution, or, if mixed, wholly in double and
+  // rounded, float being only the storage (masa_simd.cpp)
+  int masa_float_eval(const char* caller, const std::string& field, unsigned int dims,
+                      std::size_t n, const float* const* coords, float* out, bool mixed);
+
+  // the same for double points, evaluated by a DoubleDouble instance of
+  // the selected double solution; each result is returned as the pair
+  // hi[i] + lo[i] (masa_simd.cpp)
+  int masa_dd_eval(const char* caller, const std::string& field, unsigned int dims,
+                   std::size_t n, const double* const* coords, double* hi, double* lo);
+
+  // the largest relative discrepancy between field of the selected
+  // double solution and of its shadow ("longdouble" or "doubledouble")
+  // instance over n double points (masa_simd.cpp)
+  int masa_audit_eval(const char* caller, const std::string& field, const std::string& shadow,
+                      unsigned int dims, std::size_t n, const double* const* coords, double& max_rel);
+
+  // evaluates field of the selected double solution at n points for each
+  // of nmembers parameter sets, the rows of params in the layout of
+  // masa_save_params; out[k*n+i] is member k at point i (masa_simd.cpp)
+  int masa_ensemble_eval(const char* caller, const std::string& field, unsigned int dims,
+                         std::size_t nmembers, const double* params,
+                         std::size_t n, const double* const* coords, double* out);
+
+  // new lane instances of every solution that can evaluate several
+  // points at once (masa_lanes.cpp)
+  int masa_lane_solutions(std::vector<manufactured_solution<masa_simd>*>& anim);
+
+  // on-disk cache of evaluated fields (masa_cache.cpp)
+  int masa_cache_configure(const std::string& dir, std::size_t max_bytes);
+  int masa_cache_release(const void* view);
+
+  /*
+   * -------------------------------------------------------------------------------------------
+   *
+   * point_memo
+   *
+   * fixed-capacity, open-addressing table of point evaluations of one
+   * solution instance, keyed on the evaluating function (a nonzero id
+   * derived from its name, so the layout of the table does not depend
+   * on code addresses), the number of coordinates and their bit
+   * patterns. Every entry carries the
+   * parameter revision it was computed with, so changing any variable
+   * or vector invalidates the whole table without touching it.
+   *
+   * -------------------------------------------------------------------------------------------
+   */
+
+  template <typename Scalar>
+  class point_memo
+  {
+  public:
+    explicit point_memo(std::size_t capacity) : hits(0), misses(0), _next(0)
+    {
+      std::size_t size = probes;
+      while(size < capacity)
+        size *= 2;
+      _entries.assign(size,entry());
+      _mask = size - 1;
+    }
+
+    // looks up the point; on a miss, slot is where store() should put it
+    bool find(uint64_t field, unsigned long revision, const Scalar* point,
+              unsigned int n, Scalar& value, std::size_t& slot)
+    {
+      uint64_t key[max_coords*words];
+      std::size_t home = hash(field,point,n,key);
+      bool free = false;
+      for(unsigned int p = 0; p < probes; p++)
+        {
+          const std::size_t i = (home + p) & _mask;
+          const entry& e = _entries[i];
+          if(e.field == 0 || e.revision != revision)
+            {
+              if(!free)
+                slot = i;   // empty or stale: reusable
+              free = true;
+              continue;
+            }
+          if(e.field == field && e.n == n && memcmp(e.key,key,n*words*sizeof(uint64_t)) == 0)
+            {
+              value = e.value;
+              hits++;
+              return true;
+            }
+        }
+      if(!free)
+        slot = (home + _next++ % probes) & _mask; // window full: replace round robin
+      misses++;
+      return false;
+    }
+
+    void store(std::size_t slot, uint64_t field, unsigned long revision,
+               const Scalar* point, unsigned int n, Scalar value)
+    {
+      entry& e = _entries[slot];
+      hash(field,point,n,e.key);
+      e.field    = field;
+      e.revision = revision;
+      e.n        = n;
+      e.value    = value;
+    }
+
+    std::size_t capacity() const { return _entries.size(); }
+
+    unsigned long hits;
+    unsigned long misses;
+
+  private:
+    static const unsigned int max_coords = 4;
+    static const unsigned int probes     = 8;
+    // x87 long double carries 10 significant bytes, the rest is padding
+    static const std::size_t  bytes = std::numeric_limits<Scalar>::digits == 64 ? 10 : sizeof(Scalar);
+    static const unsigned int words = (bytes + 7) / 8;
+
+    struct entry
+    {
+      uint64_t      field;
+      unsigned long revision;
+      unsigned int  n;
+      uint64_t      key[max_coords*words];
+      Scalar        value;
+    };
+
+    std::size_t hash(uint64_t field, const Scalar* point, unsigned int n, uint64_t* key) const
+    {
+      uint64_t h = field ^ (uint64_t(n) << 56);
+      for(unsigned int c = 0; c < n; c++)
+        {
+          uint64_t w[words] = {0};
+          memcpy(w,point+c,bytes);
+          for(unsigned int k = 0; k < words; k++)
+            {
+              key[c*words+k] = w[k];
+              h = (h ^ w[k]) * 0x9e3779b97f4a7c15ULL;
+              h ^= h >> 29;
+            }
+        }
+      return std::size_t(h) & _mask;
+    }
+
+    std::vector<entry> _entries;
+    std::size_t        _mask;
+    unsigned int       _next;
+  };
+
+  /*
+   * -------------------------------------------------------------------------------------------
+   *
+   * fused_residual
+   *
+   * every source term of a solution whose equations are evaluated in
+   * one automatic differentiation sweep (ad_residual.h), kept per thread
+   * for the last instance, point and parameter revision it was computed
+   * at, so that the components asked for one after another at a point
+   * share that sweep
+   *
+   * -------------------------------------------------------------------------------------------
+   */
+
+  template <typename Scalar, unsigned int ncoords, unsigned int ncomponents>
+  class fused_residual
+  {
+  public:
+    fused_residual() : _id(next_id()) {}
+    fused_residual(const fused_residual&) : _id(next_id()) {}   // copies of a solution keep their own
+    fused_residual& operator=(const fused_residual&) {return *this;}
+
+    // the components this thread computed at the point, NULL if they are not held
+    const Scalar* find(unsigned long revision, const Scalar* point) const
+    {
+      const entry& e = last();
+      if(e.id != _id || e.revision != revision)
+        return 0;
+      for(unsigned int c = 0; c < ncoords; c++)
+        if(memcmp(point+c,e.point+c,bytes) != 0)
+          return 0;
+      return e.q;
+    }
+
+    // keeps the components q computed at the point for this thread,
+    // returns the kept copy
+    const Scalar* store(unsigned long revision, const Scalar* point, const Scalar* q) const
+    {
+      entry& e = last();
+      for(unsigned int c = 0; c < ncoords; c++)
+        e.point[c] = point[c];
+      for(unsigned int c = 0; c < ncomponents; c++)
+        e.q[c] = q[c];
+      e.revision = revision;
+      e.id       = _id;
+      return e.q;
+    }
+
+  private:
+    // x87 long double carries 10 significant bytes, the rest is padding
+    static const std::size_t bytes = std::numeric_limits<Scalar>::digits == 64 ? 10 : sizeof(Scalar);
+
+    struct entry
+    {
+      unsigned long id;        // of the fused_residual, 0 if none
+      unsigned long revision;
+      Scalar        point[ncoords];
+      Scalar        q[ncomponents];
+    };
+
+    static entry& last()
+    {
+      static thread_local entry e = entry();
+      return e;
+    }
+
+    static unsigned long next_id()
+    {
+      static std::atomic<unsigned long> n(0);
+      return ++n;
+    }
+
+    const unsigned long _id;
+  };
+
+  /*
+   * -------------------------------------------------------------------------------------------
+   *
+   * grid_cache
+   *
+   * what a solution keeps between evaluations on the fixed points of a
+   * registered grid (masa_grid.cpp): a solution that knows which
+   * parameters each of its intermediate values depends on holds the
+   * values a change of parameters leaves intact here, and recomputes
+   * only the others
+   *
+   * -------------------------------------------------------------------------------------------
+   */
+
+  template <typename Scalar>
+  class grid_cache
+  {
+  public:
+    virtual ~grid_cache() {}
+  };
+
+  // The parameters of a solution class: the index of each variable and
+  // vector by name, and where it lives in an instance, as the byte offset
+  // from its manufactured_solution. The first instance of a class builds
+  // one, and the later instances share it and carry only their values
+  // (masa_class.cpp). Entry 0 of each list is a placeholder, indices
+  // start at 1.
+  struct param_schema
+  {
+    std::map<std::string,int>   varmap;    // index of each variable
+    std::vector<std::string>    varname;   // name of each variable
+    std::vector<std::ptrdiff_t> varoff;    // place of each variable
+
+    std::map<std::string,int>   vecmap;    // index of each vector
+    std::vector<std::string>    vecname;   // name of each vector
+    std::vector<std::ptrdiff_t> vecoff;    // place of each vector
+  };
+
+  // The name of a solution: string literals are kept by address, other
+  // names are interned once (masa_class.cpp), so instances carry no copy
+  class solution_name
+  {
+  public:
+    solution_name() : _name("") {}
+
+    solution_name& operator=(const char* literal) { _name = literal; return *this; }
+    solution_name& operator=(const std::string& name);
+
+    const char* c_str() const { return _name; }
+    operator std::string() const { return _name; }
+
+  private:
+    const char* _name;
+  };
+
+  inline std::ostream& operator<<(std::ostream& os, const solution_name& name)
+  {
+    return os << name.c_str();
+  }
+
   /*
    * -------------------------------------------------------------------------------------------
    *
@@ -93,6 +530,7 @@ namespace MASA
   template <typename Scalar>
   class manufactured_solution
   {
+    template <typename Other> friend class manufactured_solution;
 
   private:
     Scalar Tan;                          // analytical solution
@@ -105,22 +543,60 @@ namespace MASA
     int num_vars;
     int num_vec;
 
-    std::map<std::string,int> varmap;    // map to each variable
-    std::vector<Scalar*>  vararr;        // arr of pointers to each variable
+    std::shared_ptr<param_schema> schema;  // names and places of the variables and vectors
+    bool schema_shared;                  // schema is shared with other instances, copied before a change
+    bool share_schema;                   // false if the instances of the class differ in their parameters
+    std::size_t followed_vars;           // while the registrations match a class schema: the entries matched so far,
+    std::size_t followed_vecs;           //   placeholders included; 0 otherwise
+
+    Scalar& var(int i)
+    { return *reinterpret_cast<Scalar*>(reinterpret_cast<char*>(this) + schema->varoff[i]); }
+    const Scalar& var(int i) const
+    { return *reinterpret_cast<const Scalar*>(reinterpret_cast<const char*>(this) + schema->varoff[i]); }
 
-    std::map<std::string,int> vecmap;           // map to each vector
-    std::vector<std::vector<Scalar>* >  vecarr; // vector of pointers to each vector
+    std::vector<Scalar>& vec(int i)
+    { return *reinterpret_cast<std::vector<Scalar>*>(reinterpret_cast<char*>(this) + schema->vecoff[i]); }
+    const std::vector<Scalar>& vec(int i) const
+    { return *reinterpret_cast<const std::vector<Scalar>*>(reinterpret_cast<const char*>(this) + schema->vecoff[i]); }
 
-    std::string mmsname;                 // the name of the manufactured solution
+    int register_param(bool,const std::string&,const void*);  // extends the schema, or checks it against the one of the class
+    void own_schema();                                        // replaces a followed schema with a copy of the entries matched
+
+    solution_name mmsname;               // the name of the manufactured solution
     int dimension;                       // dimension of the solution
+    bool transient;                      // the last coordinate is time
+    const std::map<std::string,int>* fields;  // MASA_CAP_*D bits of each field the class evaluates, NULL if unknown
+    unsigned long revision;              // bumped every time a variable or vector is changed
+    point_memo<Scalar>* memo;            // memoized point evaluations, NULL unless enabled
+
+    // constants the source terms derive from the parameters alone,
+    // folded out of them by cse_utils/masa_cse.pl: the constructors it
+    // rewrites size the block once and name the function computing it,
+    // which runs again whenever the parameters change, so evaluating a
+    // term only reads its part of the block
+    std::vector<Scalar> derived_block;
+    void (*derive)(manufactured_solution<Scalar>&);   // computes derived_block, NULL if the class has none
+
+    void use_derived_constants(std::size_t count, void (*fill)(manufactured_solution<Scalar>&))
+    {
+      derived_block.assign(count,Scalar(0));
+      derive = fill;
+      fill(*this);
+    }
+
+    const Scalar* derived_constants(std::size_t offset) const {return &derived_block[offset];}
+    void update_derived() {if(derive) derive(*this);}  // after every change of the parameters
 
   public:
     static const Scalar pi;
     static const Scalar PI;
 
     // functions to override
-    virtual ~manufactured_solution(){};   // destructor
+    virtual ~manufactured_solution(){delete memo;};   // destructor
     virtual int init_var() = 0;           // inits all variables to selected values
+    virtual manufactured_solution<Scalar>* clone() const {return 0;}  // new instance for another thread, NULL if built by name
+    virtual int jit_compile(const std::string&) {std::cout << "MASA ERROR:: " << mmsname << " cannot be compiled to native code, only solutions of masa_init_expr can.\n"; return 1;}  // specializes for the current parameters
+    virtual int eval_grid(std::shared_ptr<grid_cache<Scalar> >&,const std::string&,unsigned int,std::size_t,const Scalar* const*,Scalar*,bool) {return -1;}  // field on the points of a registered grid, -1 if untracked
 
   /*
    * -------------------------------------------------------------------------------------------
@@ -258,35 +734,99 @@ namespace MASA
    * -------------------------------------------------------------------------------------------
    */
 
-    virtual Scalar eval_g_t(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_t(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_t(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_t(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    // the component gradients that reached the default below, on this thread
+    static unsigned long& gradient_defaults() {static thread_local unsigned long n = 0; return n;}
+    Scalar no_gradient() {gradient_defaults()++; std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n"; return -1.33;}
+
+    virtual Scalar eval_g_t(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_t(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_t(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_t(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+    virtual Scalar eval_g_u(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_u(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_u(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_u(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+    virtual Scalar eval_g_v(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_v(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_v(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_v(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+    virtual Scalar eval_g_w(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_w(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_w(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_w(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+    virtual Scalar eval_g_p(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_p(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_p(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_p(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+    virtual Scalar eval_g_rho(Scalar)                          {return no_gradient();};  // returns value of 1d gradient
+    virtual Scalar eval_g_rho(Scalar,Scalar,int)               {return no_gradient();};  // returns value of 2d gradient
+    virtual Scalar eval_g_rho(Scalar,Scalar,Scalar,int)        {return no_gradient();};  // returns value of 3d gradient
+    virtual Scalar eval_g_rho(Scalar,Scalar,Scalar,Scalar,int) {return no_gradient();};  // returns value of 3d, time-varying gradient
+
+  /*
+   * -------------------------------------------------------------------------------------------
+   *
+   * full gradient and hessian of the analytical solution in one call
+   *
+   * the gradient defaults fall back to the component-wise eval_g_* methods,
+   * and return 1 when any component is unavailable; solutions override
+   * them to share subexpressions between components.
+   * hessians are returned row-major (dim x dim).
+   *
+   * -------------------------------------------------------------------------------------------
+   */
+    virtual int eval_grad_t(Scalar x,Scalar y,Scalar* g)                  {const unsigned long d=gradient_defaults(); g[0]=eval_g_t(x,y,1); g[1]=eval_g_t(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_t(Scalar x,Scalar y,Scalar z,Scalar* g)         {const unsigned long d=gradient_defaults(); g[0]=eval_g_t(x,y,z,1); g[1]=eval_g_t(x,y,z,2); g[2]=eval_g_t(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_t(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_t(x,y,z,t,1); g[1]=eval_g_t(x,y,z,t,2); g[2]=eval_g_t(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
+
+    virtual int eval_grad_u(Scalar x,Scalar y,Scalar* g)                  {const unsigned long d=gradient_defaults(); g[0]=eval_g_u(x,y,1); g[1]=eval_g_u(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_u(Scalar x,Scalar y,Scalar z,Scalar* g)         {const unsigned long d=gradient_defaults(); g[0]=eval_g_u(x,y,z,1); g[1]=eval_g_u(x,y,z,2); g[2]=eval_g_u(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_u(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_u(x,y,z,t,1); g[1]=eval_g_u(x,y,z,t,2); g[2]=eval_g_u(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
+
+    virtual int eval_grad_v(Scalar x,Scalar y,Scalar* g)                  {const unsigned long d=gradient_defaults(); g[0]=eval_g_v(x,y,1); g[1]=eval_g_v(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_v(Scalar x,Scalar y,Scalar z,Scalar* g)         {const unsigned long d=gradient_defaults(); g[0]=eval_g_v(x,y,z,1); g[1]=eval_g_v(x,y,z,2); g[2]=eval_g_v(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_v(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_v(x,y,z,t,1); g[1]=eval_g_v(x,y,z,t,2); g[2]=eval_g_v(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
+
+    virtual int eval_grad_w(Scalar x,Scalar y,Scalar* g)                  {const unsigned long d=gradient_defaults(); g[0]=eval_g_w(x,y,1); g[1]=eval_g_w(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_w(Scalar x,Scalar y,Scalar z,Scalar* g)         {const unsigned long d=gradient_defaults(); g[0]=eval_g_w(x,y,z,1); g[1]=eval_g_w(x,y,z,2); g[2]=eval_g_w(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_w(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_w(x,y,z,t,1); g[1]=eval_g_w(x,y,z,t,2); g[2]=eval_g_w(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
+
+    virtual int eval_grad_p(Scalar x,Scalar y,Scalar* g)                  {const unsigned long d=gradient_defaults(); g[0]=eval_g_p(x,y,1); g[1]=eval_g_p(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_p(Scalar x,Scalar y,Scalar z,Scalar* g)         {const unsigned long d=gradient_defaults(); g[0]=eval_g_p(x,y,z,1); g[1]=eval_g_p(x,y,z,2); g[2]=eval_g_p(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_p(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_p(x,y,z,t,1); g[1]=eval_g_p(x,y,z,t,2); g[2]=eval_g_p(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
+
+    virtual int eval_grad_rho(Scalar x,Scalar y,Scalar* g)                {const unsigned long d=gradient_defaults(); g[0]=eval_g_rho(x,y,1); g[1]=eval_g_rho(x,y,2); return gradient_defaults() != d;};  // 2d gradient
+    virtual int eval_grad_rho(Scalar x,Scalar y,Scalar z,Scalar* g)       {const unsigned long d=gradient_defaults(); g[0]=eval_g_rho(x,y,z,1); g[1]=eval_g_rho(x,y,z,2); g[2]=eval_g_rho(x,y,z,3); return gradient_defaults() != d;};  // 3d gradient
+    virtual int eval_grad_rho(Scalar x,Scalar y,Scalar z,Scalar t,Scalar* g){const unsigned long d=gradient_defaults(); g[0]=eval_g_rho(x,y,z,t,1); g[1]=eval_g_rho(x,y,z,t,2); g[2]=eval_g_rho(x,y,z,t,3); return gradient_defaults() != d;};  // 3d, time-varying gradient
 
-    virtual Scalar eval_g_u(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_u(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_u(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_u(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    virtual int eval_hess_t  (Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_t  (Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_t  (Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
 
-    virtual Scalar eval_g_v(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_v(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_v(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_v(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    virtual int eval_hess_u  (Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_u  (Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_u  (Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
 
-    virtual Scalar eval_g_w(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_w(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_w(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_w(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    virtual int eval_hess_v  (Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_v  (Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_v  (Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
 
-    virtual Scalar eval_g_p(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_p(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_p(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_p(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    virtual int eval_hess_w  (Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_w  (Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_w  (Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
 
-    virtual Scalar eval_g_rho(Scalar)                          {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 1d gradient
-    virtual Scalar eval_g_rho(Scalar,Scalar,int)               {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 2d gradient
-    virtual Scalar eval_g_rho(Scalar,Scalar,Scalar,int)        {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d gradient
-    virtual Scalar eval_g_rho(Scalar,Scalar,Scalar,Scalar,int) {std::cout << "MASA ERROR:: gradient is unavailable or not properly loaded.\n";   return -1.33;};  // returns value of 3d, time-varying gradient
+    virtual int eval_hess_p  (Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_p  (Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_p  (Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
+
+    virtual int eval_hess_rho(Scalar,Scalar,Scalar*               ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 2d hessian
+    virtual int eval_hess_rho(Scalar,Scalar,Scalar,Scalar*        ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d hessian
+    virtual int eval_hess_rho(Scalar,Scalar,Scalar,Scalar,Scalar* ) {std::cout << "MASA ERROR:: hessian is unavailable or not properly loaded.\n";   return 1;};  // 3d, time-varying hessian
 
   /*
    * -------------------------------------------------------------------------------------------
@@ -300,8 +840,21 @@ namespace MASA
     Scalar pass_function(Scalar (*)(Scalar),Scalar);
     int set_var(std::string,Scalar);                             // sets variable value
     int set_vec(std::string,std::vector<Scalar>&);               // sets vector value
-    int register_var(std::string, Scalar*);                      // this registers a variable
-    int register_vec(std::string, std::vector<Scalar>& );        // this registers a vector
+    int register_var(const std::string&, Scalar*);               // this registers a variable
+    int register_vec(const std::string&, std::vector<Scalar>& ); // this registers a vector
+    void share_params();                                         // once constructed: adopts the schema of the class, or offers this one
+    template <typename Other>
+    int copy_var(const manufactured_solution<Other>&);           // copies all variables and vectors of another instance
+    virtual void fingerprint(std::string&) const;                // appends name, variables and vectors as raw bytes
+    std::size_t num_params() const;                              // number of variables plus vector lengths and elements
+    void save_var(Scalar*) const;                                // copies all parameters out, in registration order
+    bool snapshot_fits(const Scalar*) const;                     // the vector lengths of a snapshot are those of the instance
+    int load_var(const Scalar*);                                 // copies all parameters back in, 1 if they do not fit
+    void serialize_var(std::string&) const;                      // appends the binary form of all parameters
+    int deserialize_var(const std::string&);                     // sets all parameters from their binary form
+    unsigned long get_revision() const {return revision;}        // changes whenever any parameter changes
+    int enable_memo(std::size_t);                                // memoizes point evaluations, 0 disables
+    point_memo<Scalar>* get_memo() {return memo;}
 
     int sanity_check();                                          // checks that all variables to the class have been initalized
     int poly_test();                                             // regression method for poly class (see below)
@@ -309,8 +862,12 @@ namespace MASA
     Scalar get_var(std::string);                                 // returns variable value
     int display_var();                                           // print all variable names and values
     int display_vec();                                           // print all variable names and values
-    void return_name(std::string* inname){inname->assign(mmsname);};  // method: returns name
+    void return_name(std::string* inname){inname->assign(mmsname.c_str());};  // method: returns name
     void return_dim (int* indim)    {*indim=dimension;};         // method: returns dimension of solution
+    void declare_fields(const std::map<std::string,int>& f) {fields=&f;}  // the fields of the class, see masa_core.cpp
+    int field_capabilities(const std::string&) const;            // MASA_CAP_*D bits of a field, 0 if unavailable
+    int capabilities() const;                                    // MASA_CAP_* bits of the solution
+    void list_fields(std::vector<std::string>&,std::vector<int>&) const;  // every available field, with its MASA_CAP_*D bits
 
   /*
    * -------------------------------------------------------------------------------------------
@@ -740,6 +1297,16 @@ namespace MASA
 
     Scalar eval_g_rho(Scalar,Scalar,int);
 
+    int eval_grad_u  (Scalar,Scalar,Scalar*);   // full gradient of analytical solution
+    int eval_grad_v  (Scalar,Scalar,Scalar*);
+    int eval_grad_p  (Scalar,Scalar,Scalar*);
+    int eval_grad_rho(Scalar,Scalar,Scalar*);
+
+    int eval_hess_u  (Scalar,Scalar,Scalar*);   // hessian of analytical solution
+    int eval_hess_v  (Scalar,Scalar,Scalar*);
+    int eval_hess_p  (Scalar,Scalar,Scalar*);
+    int eval_hess_rho(Scalar,Scalar,Scalar*);
+
   };
 
   template <typename Scalar>
@@ -813,6 +1380,18 @@ namespace MASA
     Scalar eval_g_p  (Scalar,Scalar,Scalar,int);
     Scalar eval_g_rho(Scalar,Scalar,Scalar,int);
 
+    int eval_grad_u  (Scalar,Scalar,Scalar,Scalar*);   // full gradient of analytical solution
+    int eval_grad_v  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_w  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_p  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_rho(Scalar,Scalar,Scalar,Scalar*);
+
+    int eval_hess_u  (Scalar,Scalar,Scalar,Scalar*);   // hessian of analytical solution
+    int eval_hess_v  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_w  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_p  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_rho(Scalar,Scalar,Scalar,Scalar*);
+
   };
   // ------------------------------------------------------
   // ------------------------- euler - transient ----------
@@ -1410,6 +1989,16 @@ namespace MASA
 
     Scalar eval_g_rho(Scalar,Scalar,int);
 
+    int eval_grad_u  (Scalar,Scalar,Scalar*);   // full gradient of analytical solution
+    int eval_grad_v  (Scalar,Scalar,Scalar*);
+    int eval_grad_p  (Scalar,Scalar,Scalar*);
+    int eval_grad_rho(Scalar,Scalar,Scalar*);
+
+    int eval_hess_u  (Scalar,Scalar,Scalar*);   // hessian of analytical solution
+    int eval_hess_v  (Scalar,Scalar,Scalar*);
+    int eval_hess_p  (Scalar,Scalar,Scalar*);
+    int eval_hess_rho(Scalar,Scalar,Scalar*);
+
 
   };
 
@@ -1485,6 +2074,18 @@ namespace MASA
     Scalar eval_g_p  (Scalar,Scalar,Scalar,int);
     Scalar eval_g_rho(Scalar,Scalar,Scalar,int);
 
+    int eval_grad_u  (Scalar,Scalar,Scalar,Scalar*);   // full gradient of analytical solution
+    int eval_grad_v  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_w  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_p  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_grad_rho(Scalar,Scalar,Scalar,Scalar*);
+
+    int eval_hess_u  (Scalar,Scalar,Scalar,Scalar*);   // hessian of analytical solution
+    int eval_hess_v  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_w  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_p  (Scalar,Scalar,Scalar,Scalar*);
+    int eval_hess_rho(Scalar,Scalar,Scalar,Scalar*);
+
   }; // done with navier stokes 3d class
 
 // External nsctpl::manufactured_solution implementation pulled into MASA namespace
@@ -1529,6 +2130,21 @@ namespace MASA
     Scalar eval_g_t  (Scalar x, Scalar y, Scalar z, Scalar t, int i) { return this->grad_T  (x,y,z,t,i); }
     Scalar eval_g_p  (Scalar x, Scalar y, Scalar z, Scalar t, int i) { return this->grad_p  (x,y,z,t,i); }
 
+    // full gradient and hessian of solution
+    int eval_grad_rho(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+    int eval_grad_u  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+    int eval_grad_v  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+    int eval_grad_w  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+    int eval_grad_t  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+    int eval_grad_p  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g);
+
+    int eval_hess_rho(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+    int eval_hess_u  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+    int eval_hess_v  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+    int eval_hess_w  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+    int eval_hess_t  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+    int eval_hess_p  (Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h);
+
   }; // done with navierstokes_4d_compressible_powerlaw class
 
   template <typename Scalar>
@@ -1982,6 +2598,9 @@ private:
   Scalar mu;
   Scalar L;
 
+  fused_residual<Scalar,2,4> fused;  // source terms this thread computed last
+  const Scalar* eval_residual(Scalar,Scalar) const;
+
 public:
   ad_cns_2d_crossterms();
   int init_var();
@@ -1993,6 +2612,14 @@ public:
   Scalar eval_exact_v(Scalar,Scalar);
   Scalar eval_exact_p(Scalar,Scalar);
   Scalar eval_exact_rho(Scalar,Scalar);
+  int eval_grad_u(Scalar,Scalar,Scalar*);
+  int eval_grad_v(Scalar,Scalar,Scalar*);
+  int eval_grad_p(Scalar,Scalar,Scalar*);
+  int eval_grad_rho(Scalar,Scalar,Scalar*);
+  int eval_hess_u(Scalar,Scalar,Scalar*);
+  int eval_hess_v(Scalar,Scalar,Scalar*);
+  int eval_hess_p(Scalar,Scalar,Scalar*);
+  int eval_hess_rho(Scalar,Scalar,Scalar*);
 };}
 
 
@@ -2048,6 +2675,9 @@ private:
   Scalar mu;
   Scalar L;
 
+  fused_residual<Scalar,3,5> fused;  // source terms this thread computed last
+  const Scalar* eval_residual(Scalar,Scalar,Scalar) const;
+
 public:
   ad_cns_3d_crossterms();
   int init_var();
@@ -2110,6 +2740,9 @@ private:
   Scalar kx;
   Scalar kz;
 
+  fused_residual<Scalar,3,3> fused;  // source terms this thread computed last
+  const Scalar* eval_residual(Scalar,Scalar,Scalar) const;
+
 public:
   navierstokes_3d_incompressible();
   int init_var();
@@ -2150,6 +2783,9 @@ private:
   Scalar ky;
   Scalar kz;
 
+  fused_residual<Scalar,3,3> fused;  // source terms this thread computed last
+  const Scalar* eval_residual(Scalar,Scalar,Scalar) const;
+
 public:
   navierstokes_3d_incompressible_homogeneous();
   int init_var();
@@ -0,0 +1,388 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_lane_math.h: sin, cos, exp, log and pow of the four double
+//                   lanes of masa_simd, as straight line polynomial
+//                   code over the lanes instead of a libm call each
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#ifndef __masa_lane_math_h__
+#define __masa_lane_math_h__
+
+#include "numberarray.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+
+//
+// The kernels are those of fdlibm (Sun Microsystems, freely
+// redistributable): range reduction, then the same minimax polynomials,
+// with the branches of the scalar code turned into selects so that the
+// loops over the lanes vectorize. They are within about 2 ulp of the C
+// library. Lanes outside the range a kernel handles (large angles,
+// overflow, zero, negative or non-finite arguments) send the whole call
+// to the C library, lane by lane.
+//
+namespace MASA
+{
+namespace lane_math
+{
+  const std::size_t lanes = 4;
+  typedef NumberArray<lanes,double> vec;
+
+  inline uint64_t to_bits(double d)     { uint64_t u; memcpy(&u,&d,sizeof(d)); return u; }
+  inline double   from_bits(uint64_t u) { double d; memcpy(&d,&u,sizeof(d)); return d; }
+
+  // adding 1.5*2^52 rounds |a| < 2^51 to an integer, which the low bits
+  // of the sum then hold in two's complement
+  const double round_shift = 6755399441055744.0;
+
+  // largest |x| reduced by pi/2 with the three part constant: n*pio2_1
+  // stays exact for n below 2^20
+  const double trig_limit = 1.0e5;
+
+  // x = n*pi/2 + r + lo, |r| <= pi/4, in two rounds of the medium
+  // reduction of e_rem_pio2.c; quadrant gets n mod 4
+  inline double trig_reduce(double x, double& lo, uint64_t& quadrant)
+  {
+    const double two_over_pi = 6.36619772367581382433e-01;
+    const double pio2_1  = 1.57079632673412561417e+00;   // first 33 bits of pi/2
+    const double pio2_2  = 6.07710050630396597660e-11;   // next 33 bits
+    const double pio2_2t = 2.02226624879595063154e-21;   // pi/2 - (pio2_1 + pio2_2)
+
+    const double shifted = x * two_over_pi + round_shift;
+    const double n = shifted - round_shift;
+    quadrant = to_bits(shifted) & 3;
+
+    const double t = x - n * pio2_1;
+    const double w = n * pio2_2;
+    const double r = t - w;
+    const double w2 = n * pio2_2t - ((t - r) - w);
+    const double hi = r - w2;
+    lo = (r - hi) - w2;
+    return hi;
+  }
+
+  // sin(x + y), |x| <= pi/4, y the tail of x (__kernel_sin)
+  inline double kernel_sin(double x, double y)
+  {
+    const double S1 = -1.66666666666666324348e-01, S2 =  8.33333333332248946124e-03,
+                 S3 = -1.98412698298579493134e-04, S4 =  2.75573137070700676789e-06,
+                 S5 = -2.50507602534068634195e-08, S6 =  1.58969099521155010221e-10;
+    const double z = x * x;
+    const double w = z * z;
+    const double r = S2 + z * (S3 + z * S4) + z * w * (S5 + z * S6);
+    const double v = z * x;
+    return x - ((z * (0.5 * y - v * r) - y) - v * S1);
+  }
+
+  // cos(x + y), |x| <= pi/4, y the tail of x (__kernel_cos)
+  inline double kernel_cos(double x, double y)
+  {
+    const double C1 =  4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                 C3 =  2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                 C5 =  2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+    const double z = x * x;
+    const double w = z * z;
+    const double r = z * (C1 + z * (C2 + z * C3)) + w * w * (C4 + z * (C5 + z * C6));
+    const double hz = 0.5 * z;
+    const double one_hz = 1.0 - hz;
+    return one_hz + (((1.0 - one_hz) - hz) + (z * r - x * y));
+  }
+
+  // sin of the reduced angle in quadrant q: s, c, -s, -c; the cos is
+  // that of quadrant q + 1. Both are computed and picked with bit masks,
+  // as a branch would keep the loop scalar
+  inline double quadrant_select(double s, double c, uint64_t q)
+  {
+    const uint64_t odd = uint64_t(0) - (q & 1);
+    return from_bits(((to_bits(s) & ~odd) | (to_bits(c) & odd)) ^ ((q & 2) << 62));
+  }
+
+  inline bool trig_in_range(const vec& a)
+  {
+    bool in = true;
+    for(std::size_t i = 0; i != lanes; ++i)
+      in &= std::fabs(a[i]) <= trig_limit;
+    return in;
+  }
+
+  inline vec sin(const vec& a)
+  {
+    vec s;
+    if(!trig_in_range(a))
+      {
+        for(std::size_t i = 0; i != lanes; ++i)
+          s[i] = std::sin(a[i]);
+        return s;
+      }
+    for(std::size_t i = 0; i != lanes; ++i)
+      {
+        uint64_t q;
+        double lo;
+        const double r = trig_reduce(a[i],lo,q);
+        s[i] = quadrant_select(kernel_sin(r,lo),kernel_cos(r,lo),q);
+      }
+    return s;
+  }
+
+  inline vec cos(const vec& a)
+  {
+    vec c;
+    if(!trig_in_range(a))
+      {
+        for(std::size_t i = 0; i != lanes; ++i)
+          c[i] = std::cos(a[i]);
+        return c;
+      }
+    for(std::size_t i = 0; i != lanes; ++i)
+      {
+        uint64_t q;
+        double lo;
+        const double r = trig_reduce(a[i],lo,q);
+        c[i] = quadrant_select(kernel_sin(r,lo),kernel_cos(r,lo),q + 1);
+      }
+    return c;
+  }
+
+  // exp(x), |x| <= 708 (e_exp.c): x = k*ln2 + r, exp(r) from a rational
+  // approximation, then scaled by 2^k through the exponent bits
+  const double exp_limit = 708.0;
+
+  inline double kernel_exp(double x)
+  {
+    const double ln2_hi = 6.93147180369123816490e-01, ln2_lo = 1.90821492927058770002e-10,
+                 inv_ln2 = 1.44269504088896338700e+00;
+    const double P1 =  1.66666666666666019037e-01, P2 = -2.77777777770155933842e-03,
+                 P3 =  6.61375632143793436117e-05, P4 = -1.65339022054652515390e-06,
+                 P5 =  4.13813679705723846039e-08;
+
+    const double shifted = x * inv_ln2 + round_shift;
+    const double k = shifted - round_shift;
+    const double hi = x - k * ln2_hi;
+    const double lo = k * ln2_lo;
+    const double r = hi - lo;
+    const double t = r * r;
+    const double c = r - t * (P1 + t * (P2 + t * (P3 + t * (P4 + t * P5))));
+    const double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+    // the low 11 bits of the shifted sum plus the bias are those of k + 1023
+    return y * from_bits((to_bits(shifted) + 1023) << 52);
+  }
+
+  inline vec exp(const vec& a)
+  {
+    vec e;
+    bool in = true;
+    for(std::size_t i = 0; i != lanes; ++i)
+      in &= std::fabs(a[i]) <= exp_limit;
+    if(!in)
+      {
+        for(std::size_t i = 0; i != lanes; ++i)
+          e[i] = std::exp(a[i]);
+        return e;
+      }
+    for(std::size_t i = 0; i != lanes; ++i)
+      e[i] = kernel_exp(a[i]);
+    return e;
+  }
+
+  // log(x) of a positive, normal, finite x (e_log.c): x = 2^k (1+f),
+  // sqrt(2)/2 < 1+f < sqrt(2), log(1+f) from s = f/(2+f); lo gets the
+  // rounding error of the final sum, for pow
+  inline double kernel_log(double x, double& lo)
+  {
+    const double ln2_hi = 6.93147180369123816490e-01, ln2_lo = 1.90821492927058770002e-10;
+    const double Lg1 = 6.666666666666735130e-01, Lg2 = 3.999999999940941908e-01,
+                 Lg3 = 2.857142874366239149e-01, Lg4 = 2.222219843214978396e-01,
+                 Lg5 = 1.818357216161805012e-01, Lg6 = 1.531383769920937332e-01,
+                 Lg7 = 1.479819860511658591e-01;
+
+    const uint64_t u = to_bits(x);
+    const int32_t high = int32_t(u >> 32);
+    const int32_t hx = high & 0x000fffff;
+    const int32_t i = (hx + 0x95f64) & 0x100000;
+    const int32_t k = (high >> 20) - 1023 + (i >> 20);
+    const double m = from_bits((uint64_t(uint32_t(hx | (i ^ 0x3ff00000))) << 32) | (u & 0xffffffffULL));
+
+    const double f = m - 1.0;
+    const double s = f / (2.0 + f);
+    const double dk = k;
+    const double z = s * s;
+    const double w = z * z;
+    const double R = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7))) + w * (Lg2 + w * (Lg4 + w * Lg6));
+    const double hfsq = 0.5 * f * f;
+    const bool away = ((hx - 0x6147a) | (0x6b851 - hx)) > 0;
+    const double tail = away ? f - (hfsq - (s * (hfsq + R) + dk * ln2_lo))
+                             : f - (s * (f - R) - dk * ln2_lo);
+
+    // k ln2_hi is exact and, unless 0, larger than the tail
+    const double hi = dk * ln2_hi + tail;
+    lo = tail - (hi - dk * ln2_hi);
+    return hi;
+  }
+
+  inline double kernel_log(double x)
+  {
+    double lo;
+    return kernel_log(x,lo);
+  }
+
+  // p + e == a * b exactly, as DoubleDouble::two_prod
+  inline double two_prod(double a, double b, double& e)
+  {
+    const double p = a * b;
+#ifdef FP_FAST_FMA
+    e = std::fma(a, b, -p);
+#else
+    const double splitter = 134217729.0;   // 2^27 + 1
+    const double ta = splitter * a, tb = splitter * b;
+    const double ah = ta - (ta - a), al = a - ah;
+    const double bh = tb - (tb - b), bl = b - bh;
+    e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+    return p;
+  }
+
+  inline bool log_in_range(const vec& a)
+  {
+    bool in = true;
+    for(std::size_t i = 0; i != lanes; ++i)
+      in &= a[i] >= std::numeric_limits<double>::min() && a[i] <= std::numeric_limits<double>::max();
+    return in;
+  }
+
+  inline vec log(const vec& a)
+  {
+    vec l;
+    if(!log_in_range(a))
+      {
+        for(std::size_t i = 0; i != lanes; ++i)
+          l[i] = std::log(a[i]);
+        return l;
+      }
+    for(std::size_t i = 0; i != lanes; ++i)
+      l[i] = kernel_log(a[i]);
+    return l;
+  }
+
+  // x^y: the same small integer exponent in every lane (the squares and
+  // cubes of the source terms) by repeated squaring, other exponents of
+  // positive bases as exp(y log x), with y log x carried to twice the
+  // precision and its low part applied as exp(hi) (1 + lo)
+  const int pow_max_integer = 64;
+
+  inline vec pow(const vec& x, const vec& y)
+  {
+    vec p;
+    bool integer = true;
+    for(std::size_t i = 0; i != lanes; ++i)
+      integer &= y[i] == y[0];
+    integer &= y[0] == std::floor(y[0]) && std::fabs(y[0]) <= pow_max_integer;
+
+    if(integer)
+      {
+        int n = int(std::fabs(y[0]));
+        vec base = x, result = 1.0;
+        for(; n; n >>= 1)
+          {
+            if(n & 1)
+              result *= base;
+            base *= base;
+          }
+        if(y[0] < 0)
+          for(std::size_t i = 0; i != lanes; ++i)
+            result[i] = 1.0 / result[i];
+        return result;
+      }
+
+    bool in = log_in_range(x);
+    vec e, e_lo;
+    if(in)
+      for(std::size_t i = 0; i != lanes; ++i)
+        {
+          double l_lo, p_lo;
+          const double l = kernel_log(x[i],l_lo);
+          e[i] = two_prod(y[i],l,p_lo);
+          e_lo[i] = p_lo + y[i] * l_lo;
+          in &= std::fabs(e[i]) <= exp_limit;
+        }
+    if(!in)
+      {
+        for(std::size_t i = 0; i != lanes; ++i)
+          p[i] = std::pow(x[i],y[i]);
+        return p;
+      }
+    for(std::size_t i = 0; i != lanes; ++i)
+      {
+        const double h = kernel_exp(e[i]);
+        p[i] = h + h * e_lo[i];
+      }
+    return p;
+  }
+
+} // end namespace lane_math
+} // end namespace MASA
+
+// the NumberArray functions of the lane type use the kernels above
+namespace std {
+
+template <>
+inline NumberArray<4,double> sin<4,double> (const NumberArray<4,double>& a) { return MASA::lane_math::sin(a); }
+
+template <>
+inline NumberArray<4,double> cos<4,double> (const NumberArray<4,double>& a) { return MASA::lane_math::cos(a); }
+
+template <>
+inline NumberArray<4,double> exp<4,double> (const NumberArray<4,double>& a) { return MASA::lane_math::exp(a); }
+
+template <>
+inline NumberArray<4,double> log<4,double> (const NumberArray<4,double>& a) { return MASA::lane_math::log(a); }
+
+template <>
+inline NumberArray<4,double> pow<4,double,double> (const NumberArray<4,double>& a, const NumberArray<4,double>& b)
+{ return MASA::lane_math::pow(a,b); }
+
+template <>
+inline NumberArray<4,double> pow<4,double,double> (const NumberArray<4,double>& a, const double& b)
+{ return MASA::lane_math::pow(a,NumberArray<4,double>(b)); }
+
+template <>
+inline NumberArray<4,double> pow<4,double,int> (const NumberArray<4,double>& a, const int& b)
+{ return MASA::lane_math::pow(a,NumberArray<4,double>(b)); }
+
+template <>
+inline NumberArray<4,double> pow<4,double,double> (const double& a, const NumberArray<4,double>& b)
+{ return MASA::lane_math::pow(NumberArray<4,double>(a),b); }
+
+} // namespace std
+
+#endif // __masa_lane_math_h__
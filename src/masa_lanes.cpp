@@ -0,0 +1,144 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_lanes.cpp: the solutions with a lane instantiation; also the
+//                 entry point of the lane kernel modules
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <smasa.h>
+
+using namespace MASA;
+
+//
+//  Lane instantiations of every solution that can evaluate several
+//  points at once; the others (data dependent branches, or automatic
+//  differentiation types that cannot nest the lane type) are evaluated
+//  point by point instead
+//
+int MASA::masa_lane_solutions(std::vector<manufactured_solution<masa_simd>*>& anim)
+{
+  typedef masa_simd Scalar;
+
+  anim.push_back(new masa_test_function<Scalar>());
+  anim.push_back(new masa_uninit<Scalar>());
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns
+  anim.push_back(new axi_cns<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler
+  anim.push_back(new axi_euler<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler
+  anim.push_back(new euler_1d<Scalar>());
+  anim.push_back(new euler_2d<Scalar>());
+  anim.push_back(new euler_3d<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient
+  anim.push_back(new euler_transient_1d<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_2d
+  anim.push_back(new euler_transient_2d<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_transient_3d
+  anim.push_back(new euler_transient_3d<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_euler_chem
+  anim.push_back(new euler_chem_1d<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_heat
+  anim.push_back(new heateq_1d_steady_const<Scalar>());
+  anim.push_back(new heateq_2d_steady_const<Scalar>());
+  anim.push_back(new heateq_3d_steady_const<Scalar>());
+
+  anim.push_back(new heateq_1d_steady_var<Scalar>());
+  anim.push_back(new heateq_2d_steady_var<Scalar>());
+  anim.push_back(new heateq_3d_steady_var<Scalar>());
+
+  anim.push_back(new heateq_1d_unsteady_const<Scalar>());
+  anim.push_back(new heateq_2d_unsteady_const<Scalar>());
+  anim.push_back(new heateq_3d_unsteady_const<Scalar>());
+
+  anim.push_back(new heateq_1d_unsteady_var<Scalar>());
+  anim.push_back(new heateq_2d_unsteady_var<Scalar>());
+  anim.push_back(new heateq_3d_unsteady_var<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_laplace
+  anim.push_back(new laplace_2d<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_cns
+  anim.push_back(new navierstokes_2d_compressible<Scalar>());
+  anim.push_back(new navierstokes_3d_compressible<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_nsctpl
+  anim.push_back(new navierstokes_4d_compressible_powerlaw<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_ablation
+  anim.push_back(new navierstokes_ablation_1d_steady<Scalar>());
+#endif
+
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_burgers_equation
+  anim.push_back(new burgers_equation<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_euler_transient
+  anim.push_back(new axi_euler_transient<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_axi_cns_transient
+  anim.push_back(new axi_cns_transient<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_convdiff_steady_nosource_1d
+  anim.push_back(new convdiff_steady_nosource_1d<Scalar>());
+#endif
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_transient_sutherland
+  anim.push_back(new navierstokes_3d_transient_sutherland<Scalar>());
+#endif
+
+  return 0;
+}
+
+#ifdef MASA_LANE_MODULE
+
+//
+//  A lane kernel module is this file and the sources of the solutions
+//  above, compiled for one instruction set (e.g. -march=x86-64-v3) and
+//  linked with -Bsymbolic, so that everything it calls is its own
+//  copy. libmasa loads the best one the processor supports, see
+//  lane_kernels() in masa_simd.cpp
+//
+extern "C" int masa_lane_module_solutions(std::vector<manufactured_solution<masa_simd>*>& anim)
+{
+  return masa_lane_solutions(anim);
+}
+
+#endif
@@ -0,0 +1,57 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_math.cpp: fused sine and cosine
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <config.h>
+#include <masa_internal.h>
+
+using namespace MASA;
+
+void MASA::masa_sincos(double a, double& s, double& c)
+{
+#ifdef HAVE_SINCOS
+  ::sincos(a,&s,&c);
+#else
+  s = std::sin(a);
+  c = std::cos(a);
+#endif
+}
+
+void MASA::masa_sincos(long double a, long double& s, long double& c)
+{
+#ifdef HAVE_SINCOSL
+  ::sincosl(a,&s,&c);
+#else
+  s = std::sin(a);
+  c = std::cos(a);
+#endif
+}
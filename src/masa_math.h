@@ -0,0 +1,70 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_math.h: fused sine and cosine, sharing one range reduction
+//              between the two
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#ifndef __masa_math_h__
+#define __masa_math_h__
+
+#include "doubledouble.h"
+
+#include <cmath>
+
+namespace MASA
+{
+
+  // sin(a) and cos(a) with a single range reduction where the C
+  // library offers sincos, separate calls otherwise
+  void masa_sincos(double a, double& s, double& c);
+  void masa_sincos(long double a, long double& s, long double& c);
+
+  // one double-double reduction and series for the pair, where sin and
+  // cos would each do both
+  inline void masa_sincos(const DoubleDouble& a, DoubleDouble& s, DoubleDouble& c)
+  {
+    DoubleDoubleDetail::sincos_kernel(a.hi(), a.lo(), s, c);
+  }
+
+  // the other scalar types (float, DualNumber, lanes)
+  // use their own sin and cos
+  template <typename Scalar, typename Angle>
+  inline void masa_sincos(const Angle& a, Scalar& s, Scalar& c)
+  {
+    using std::sin;
+    using std::cos;
+    s = sin(a);
+    c = cos(a);
+  }
+
+} // end namespace MASA
+
+#endif // __masa_math_h__
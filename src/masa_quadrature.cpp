@@ -0,0 +1,364 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+// $Author$
+// $Id$
+//
+// masa_quadrature.cpp: cell-averaged and quadrature-integrated source
+//                      terms over boxes and tetrahedra
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <masa_internal.h>
+#include <cmath>
+
+using namespace MASA;
+
+// Anonymous namespace for local helper functions
+namespace {
+
+//
+// P_n(z) and P_n'(z) from the three-term Legendre recurrence
+//
+template <typename Scalar>
+void legendre(int n, Scalar z, Scalar& p, Scalar& dp)
+{
+  Scalar p0 = 1;
+  Scalar p1 = z;
+  for(int k = 2; k <= n; k++)
+    {
+      Scalar p2 = ((2*k-1) * z * p1 - (k-1) * p0) / k;
+      p0 = p1;
+      p1 = p2;
+    }
+  p  = p1;
+  dp = n * (p0 - z * p1) / (1 - z * z);
+}
+
+//
+// Gauss-Legendre abscissae/weights on [-1,1], roots found by Newton
+// iteration from the Tricomi initial guess
+//
+template <typename Scalar>
+void gauss_legendre_rule(int n, std::vector<Scalar>& x, std::vector<Scalar>& w)
+{
+  const Scalar pi  = std::acos(Scalar(-1));
+  const Scalar tol = 4 * std::numeric_limits<Scalar>::epsilon();
+
+  x.resize(n);
+  w.resize(n);
+
+  for(int i = 0; i < n/2; i++)
+    {
+      Scalar z = std::cos(pi * (i + Scalar(0.75)) / (n + Scalar(0.5)));
+      Scalar p,dp;
+
+      for(int it = 0; it < 100; it++)
+        {
+          legendre(n,z,p,dp);
+          Scalar dz = p / dp;
+          z -= dz;
+          if(std::abs(dz) <= tol)
+            break;
+        }
+      legendre(n,z,p,dp);
+
+      x[i]     = -z;
+      x[n-1-i] =  z;
+      w[i]     = 2 / ((1 - z * z) * dp * dp);
+      w[n-1-i] = w[i];
+    }
+
+  // the middle root of an odd rule is exactly zero
+  if(n % 2 == 1)
+    {
+      Scalar p,dp;
+      legendre(n,Scalar(0),p,dp);
+      x[n/2] = 0;
+      w[n/2] = 2 / (dp * dp);
+    }
+}
+
+// the integrals return NaN for a bad order, the other routines 1
+int check_order(int order)
+{
+  if(order < 1)
+    {
+      std::cout << "MASA ERROR:: quadrature order must be at least 1, received "
+                << order << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+template <typename Scalar>
+Scalar no_integral()
+{
+  return std::numeric_limits<Scalar>::quiet_NaN();
+}
+
+//
+// per-axis table: quadrature points and scaled weights for every cell
+// along one axis, laid out as pts[cell*order + q]
+//
+template <typename Scalar>
+void axis_table(const std::vector<Scalar>& nodes,
+                const std::vector<Scalar>& gx,
+                const std::vector<Scalar>& gw,
+                std::vector<Scalar>& pts,
+                std::vector<Scalar>& wts)
+{
+  const std::size_t order  = gx.size();
+  const std::size_t ncells = nodes.size() - 1;
+
+  pts.resize(ncells * order);
+  wts.resize(ncells * order);
+
+  for(std::size_t c = 0; c < ncells; c++)
+    {
+      Scalar mid  = (nodes[c+1] + nodes[c]) / 2;
+      Scalar half = (nodes[c+1] - nodes[c]) / 2;
+      for(std::size_t q = 0; q < order; q++)
+        {
+          pts[c*order+q] = mid + half * gx[q];
+          wts[c*order+q] = half * gw[q];
+        }
+    }
+}
+
+} // end anonymous namespace
+
+template <typename Scalar>
+int MASA::masa_gauss_legendre(int order,
+                              std::vector<Scalar>& abscissae,
+                              std::vector<Scalar>& weights)
+{
+  if(check_order(order))
+    return 1;
+
+  gauss_legendre_rule(order,abscissae,weights);
+  return 0;
+}
+
+template <typename Scalar>
+Scalar MASA::masa_integrate_box(Scalar (*source)(Scalar,Scalar,Scalar),
+                                Scalar x0,Scalar x1,
+                                Scalar y0,Scalar y1,
+                                Scalar z0,Scalar z1,
+                                int order,
+                                Scalar (*weight)(Scalar,Scalar,Scalar))
+{
+  if(check_order(order))
+    return no_integral<Scalar>();
+
+  std::vector<Scalar> gx,gw;
+  gauss_legendre_rule(order,gx,gw);
+
+  std::vector<Scalar> nx(2),ny(2),nz(2);
+  nx[0] = x0; nx[1] = x1;
+  ny[0] = y0; ny[1] = y1;
+  nz[0] = z0; nz[1] = z1;
+
+  std::vector<Scalar> px,wx,py,wy,pz,wz;
+  axis_table(nx,gx,gw,px,wx);
+  axis_table(ny,gx,gw,py,wy);
+  axis_table(nz,gx,gw,pz,wz);
+
+  Scalar sum = 0;
+  for(int k = 0; k < order; k++)
+    for(int j = 0; j < order; j++)
+      {
+        Scalar wjk = wy[j] * wz[k];
+        for(int i = 0; i < order; i++)
+          {
+            Scalar f = source(px[i],py[j],pz[k]);
+            if(weight)
+              f *= weight(px[i],py[j],pz[k]);
+            sum += wx[i] * wjk * f;
+          }
+      }
+
+  return sum;
+}
+
+template <typename Scalar>
+Scalar MASA::masa_average_box(Scalar (*source)(Scalar,Scalar,Scalar),
+                              Scalar x0,Scalar x1,
+                              Scalar y0,Scalar y1,
+                              Scalar z0,Scalar z1,
+                              int order)
+{
+  Scalar vol = (x1 - x0) * (y1 - y0) * (z1 - z0);
+  return masa_integrate_box<Scalar>(source,x0,x1,y0,y1,z0,z1,order,0) / vol;
+}
+
+template <typename Scalar>
+int MASA::masa_average_grid(Scalar (*source)(Scalar,Scalar,Scalar),
+                            const std::vector<Scalar>& xnodes,
+                            const std::vector<Scalar>& ynodes,
+                            const std::vector<Scalar>& znodes,
+                            int order,
+                            std::vector<Scalar>& averages)
+{
+  if(check_order(order))
+    return 1;
+
+  if(xnodes.size() < 2 || ynodes.size() < 2 || znodes.size() < 2)
+    {
+      std::cout << "MASA ERROR:: masa_average_grid needs at least two nodes per axis"
+                << std::endl;
+      return 1;
+    }
+
+  const std::size_t nx = xnodes.size() - 1;
+  const std::size_t ny = ynodes.size() - 1;
+  const std::size_t nz = znodes.size() - 1;
+  const std::size_t q  = order;
+
+  std::vector<Scalar> gx,gw;
+  gauss_legendre_rule(order,gx,gw);
+
+  // the per-axis tables are built once and shared by every cell in
+  // the corresponding row, column and layer of the grid
+  std::vector<Scalar> px,wx,py,wy,pz,wz;
+  axis_table(xnodes,gx,gw,px,wx);
+  axis_table(ynodes,gx,gw,py,wy);
+  axis_table(znodes,gx,gw,pz,wz);
+
+  averages.assign(nx*ny*nz,Scalar(0));
+
+  // rows of cells (fixed j,k) are independent and go to the thread pool
+  return masa_parallel_eval<Scalar>(ny*nz,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t r = begin; r < end; r++)
+        {
+          const std::size_t j = r % ny;
+          const std::size_t k = r / ny;
+          Scalar* row = &averages[r*nx];
+
+          for(std::size_t kq = k*q; kq < (k+1)*q; kq++)
+            for(std::size_t jq = j*q; jq < (j+1)*q; jq++)
+              {
+                const Scalar wjk = wy[jq] * wz[kq];
+                for(std::size_t iq = 0; iq < nx*q; iq++)
+                  row[iq/q] += wx[iq] * wjk * source(px[iq],py[jq],pz[kq]);
+              }
+
+          for(std::size_t i = 0; i < nx; i++)
+            row[i] /= (xnodes[i+1] - xnodes[i]) *
+                      (ynodes[j+1] - ynodes[j]) *
+                      (znodes[k+1] - znodes[k]);
+        }
+    });
+}
+
+template <typename Scalar>
+Scalar MASA::masa_integrate_tet(Scalar (*source)(Scalar,Scalar,Scalar),
+                                const Scalar v0[3],const Scalar v1[3],
+                                const Scalar v2[3],const Scalar v3[3],
+                                int order,
+                                Scalar (*weight)(Scalar,Scalar,Scalar))
+{
+  if(check_order(order))
+    return no_integral<Scalar>();
+
+  std::vector<Scalar> gx,gw;
+  gauss_legendre_rule(order,gx,gw);
+
+  // map the rule to [0,1]
+  for(int q = 0; q < order; q++)
+    {
+      gx[q] = (gx[q] + 1) / 2;
+      gw[q] = gw[q] / 2;
+    }
+
+  Scalar e1[3],e2[3],e3[3];
+  for(int d = 0; d < 3; d++)
+    {
+      e1[d] = v1[d] - v0[d];
+      e2[d] = v2[d] - v0[d];
+      e3[d] = v3[d] - v0[d];
+    }
+
+  // |det| of the affine map is six times the tetrahedron volume
+  Scalar det = e1[0] * (e2[1] * e3[2] - e2[2] * e3[1])
+             - e1[1] * (e2[0] * e3[2] - e2[2] * e3[0])
+             + e1[2] * (e2[0] * e3[1] - e2[1] * e3[0]);
+  det = std::abs(det);
+
+  // collapsed (Duffy) coordinates: the unit cube is mapped onto the
+  // reference simplex with barycentrics l1 = a, l2 = b(1-a),
+  // l3 = c(1-a)(1-b) and jacobian (1-a)^2 (1-b)
+  Scalar sum = 0;
+  for(int i = 0; i < order; i++)
+    {
+      const Scalar a  = gx[i];
+      const Scalar ja = gw[i] * (1 - a) * (1 - a);
+      for(int j = 0; j < order; j++)
+        {
+          const Scalar b   = gx[j] * (1 - a);
+          const Scalar jab = ja * gw[j] * (1 - gx[j]);
+          for(int k = 0; k < order; k++)
+            {
+              const Scalar c = gx[k] * (1 - a) * (1 - gx[j]);
+              Scalar p[3];
+              for(int d = 0; d < 3; d++)
+                p[d] = v0[d] + a * e1[d] + b * e2[d] + c * e3[d];
+
+              Scalar f = source(p[0],p[1],p[2]);
+              if(weight)
+                f *= weight(p[0],p[1],p[2]);
+              sum += jab * gw[k] * f;
+            }
+        }
+    }
+
+  return det * sum;
+}
+
+//
+// instantiate the quadrature routines
+//
+#define INSTANTIATE_QUADRATURE_FUNCTIONS(Scalar) \
+  template int    masa_gauss_legendre<Scalar>(int,std::vector<Scalar>&,std::vector<Scalar>&); \
+  template Scalar masa_integrate_box <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),Scalar,Scalar,Scalar,Scalar,Scalar,Scalar,int,Scalar (*)(Scalar,Scalar,Scalar)); \
+  template Scalar masa_average_box   <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),Scalar,Scalar,Scalar,Scalar,Scalar,Scalar,int); \
+  template int    masa_average_grid  <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,int,std::vector<Scalar>&); \
+  template Scalar masa_integrate_tet <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const Scalar*,const Scalar*,const Scalar*,const Scalar*,int,Scalar (*)(Scalar,Scalar,Scalar))
+
+namespace MASA {
+
+INSTANTIATE_QUADRATURE_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_QUADRATURE_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+INSTANTIATE_QUADRATURE_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_QUADRATURE_FUNCTIONS(DoubleDouble);
+#endif
+
+}
@@ -0,0 +1,1146 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_simd.cpp: evaluation of several points per call through the
+//                solutions instantiated for the lane type masa_simd,
+//                of several parameter sets per call (ensembles), and
+//                of float points in single precision or with double
+//                arithmetic
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <config.h>
+#include <smasa.h>
+#include <dlfcn.h>
+#include <mutex>
+
+using namespace MASA;
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+typedef int (*lane_factory)(std::vector<manufactured_solution<masa_simd>*>&);
+
+// where the lane instances come from: the solutions built into libmasa,
+// or a lane kernel module compiled for a wider instruction set
+struct lane_kernels
+{
+  lane_factory create;
+  std::string  isa;
+};
+
+#if defined(MASA_MULTIARCH) && defined(__x86_64__) && defined(__GNUC__)
+
+// the modules configure --enable-multiarch builds, best first
+struct lane_module
+{
+  const char* isa;
+  const char* file;
+  bool        supported;
+};
+
+// looks for file next to libmasa (build tree) or in its masa/
+// subdirectory (installed, pkglibdir)
+void* open_module(const char* file)
+{
+  Dl_info info;
+  if(dladdr(reinterpret_cast<void*>(&masa_lane_solutions),&info) == 0 || info.dli_fname == 0)
+    return 0;
+
+  std::string dir(info.dli_fname);
+  dir.erase(dir.find_last_of('/') + 1);
+
+  const std::string candidates[] = {dir + "masa/" + file, dir + file};
+  for(unsigned int i = 0; i < 2; i++)
+    if(void* handle = dlopen(candidates[i].c_str(),RTLD_NOW | RTLD_LOCAL))
+      return handle;
+  return 0;
+}
+
+#endif
+
+//
+//  Chooses the lane kernels once, on first use: the module for the best
+//  instruction set the processor supports, unless MASA_LANE_ISA names
+//  another one ("baseline" for the built-in kernels). Modules stay
+//  loaded until the process exits, the lane instances live as long.
+//
+const lane_kernels& select_lane_kernels()
+{
+  static const lane_kernels kernels = []()
+    {
+      lane_kernels k = {&masa_lane_solutions, "baseline"};
+      const char* wanted = getenv("MASA_LANE_ISA");
+
+#if defined(MASA_MULTIARCH) && defined(__x86_64__) && defined(__GNUC__)
+      __builtin_cpu_init();
+      const lane_module modules[] =
+        {{"x86-64-v4", "masa_lanes_x86_64_v4.so", __builtin_cpu_supports("x86-64-v4") != 0},
+         {"x86-64-v3", "masa_lanes_x86_64_v3.so", __builtin_cpu_supports("x86-64-v3") != 0}};
+
+      for(unsigned int i = 0; i < sizeof(modules)/sizeof(modules[0]); i++)
+        {
+          if(!modules[i].supported || (wanted && modules[i].isa != std::string(wanted)))
+            continue;
+
+          void* handle = open_module(modules[i].file);
+          lane_factory create = handle ? reinterpret_cast<lane_factory>(dlsym(handle,"masa_lane_module_solutions")) : 0;
+          if(create)
+            {
+              k.create = create;
+              k.isa    = modules[i].isa;
+              break;
+            }
+          std::cout << "MASA WARNING:: cannot load the " << modules[i].isa
+                    << " lane kernels, " << (handle ? "bad module" : dlerror()) << std::endl;
+        }
+#endif
+
+      if(wanted && k.isa != wanted)
+        std::cout << "MASA WARNING:: MASA_LANE_ISA=" << wanted << " is not available, using "
+                  << k.isa << " lane kernels" << std::endl;
+      return k;
+    }();
+
+  return kernels;
+}
+
+// the terms of the solution interface, by field name and dimension
+template <typename Scalar>
+struct members
+{
+  typedef manufactured_solution<Scalar> ms;
+
+  std::map<std::string,Scalar (ms::*)(Scalar)>                      d1;
+  std::map<std::string,Scalar (ms::*)(Scalar,Scalar)>               d2;
+  std::map<std::string,Scalar (ms::*)(Scalar,Scalar,Scalar)>        d3;
+  std::map<std::string,Scalar (ms::*)(Scalar,Scalar,Scalar,Scalar)> d4;
+
+  members()
+  {
+#define MASA_SIMD_TERM(table,name,member) table[name] = &ms::member
+    MASA_SIMD_TERM(d1,"exact_t",      eval_exact_t);
+    MASA_SIMD_TERM(d1,"exact_u",      eval_exact_u);
+    MASA_SIMD_TERM(d1,"exact_v",      eval_exact_v);
+    MASA_SIMD_TERM(d1,"exact_w",      eval_exact_w);
+    MASA_SIMD_TERM(d1,"exact_p",      eval_exact_p);
+    MASA_SIMD_TERM(d1,"exact_rho",    eval_exact_rho);
+    MASA_SIMD_TERM(d1,"exact_rho_N",  eval_exact_rho_N);
+    MASA_SIMD_TERM(d1,"exact_rho_N2", eval_exact_rho_N2);
+    MASA_SIMD_TERM(d1,"exact_rho_C",  eval_exact_rho_C);
+    MASA_SIMD_TERM(d1,"exact_rho_C3", eval_exact_rho_C3);
+    MASA_SIMD_TERM(d1,"q_t",          eval_q_t);
+    MASA_SIMD_TERM(d1,"q_u",          eval_q_u);
+    MASA_SIMD_TERM(d1,"q_v",          eval_q_v);
+    MASA_SIMD_TERM(d1,"q_w",          eval_q_w);
+    MASA_SIMD_TERM(d1,"q_e",          eval_q_e);
+    MASA_SIMD_TERM(d1,"q_rho",        eval_q_rho);
+    MASA_SIMD_TERM(d1,"q_rho_u",      eval_q_rho_u);
+    MASA_SIMD_TERM(d1,"q_rho_v",      eval_q_rho_v);
+    MASA_SIMD_TERM(d1,"q_rho_w",      eval_q_rho_w);
+    MASA_SIMD_TERM(d1,"q_rho_e",      eval_q_rho_e);
+    MASA_SIMD_TERM(d1,"q_C",          eval_q_C);
+    MASA_SIMD_TERM(d1,"q_C3",         eval_q_C3);
+    MASA_SIMD_TERM(d1,"q_rho_C",      eval_q_rho_C);
+    MASA_SIMD_TERM(d1,"q_rho_C3",     eval_q_rho_C3);
+    MASA_SIMD_TERM(d1,"q_boundary",   eval_q_u_boundary);
+
+    MASA_SIMD_TERM(d2,"exact_t",      eval_exact_t);
+    MASA_SIMD_TERM(d2,"exact_u",      eval_exact_u);
+    MASA_SIMD_TERM(d2,"exact_v",      eval_exact_v);
+    MASA_SIMD_TERM(d2,"exact_w",      eval_exact_w);
+    MASA_SIMD_TERM(d2,"exact_p",      eval_exact_p);
+    MASA_SIMD_TERM(d2,"exact_phi",    eval_exact_phi);
+    MASA_SIMD_TERM(d2,"exact_rho",    eval_exact_rho);
+    MASA_SIMD_TERM(d2,"exact_rho_C",  eval_exact_rho_C);
+    MASA_SIMD_TERM(d2,"exact_rho_C3", eval_exact_rho_C3);
+    MASA_SIMD_TERM(d2,"exact_nu",     eval_exact_nu);
+    MASA_SIMD_TERM(d2,"q_t",          eval_q_t);
+    MASA_SIMD_TERM(d2,"q_u",          eval_q_u);
+    MASA_SIMD_TERM(d2,"q_v",          eval_q_v);
+    MASA_SIMD_TERM(d2,"q_w",          eval_q_w);
+    MASA_SIMD_TERM(d2,"q_e",          eval_q_e);
+    MASA_SIMD_TERM(d2,"q_f",          eval_q_f);
+    MASA_SIMD_TERM(d2,"q_nu",         eval_q_nu);
+    MASA_SIMD_TERM(d2,"q_rho",        eval_q_rho);
+    MASA_SIMD_TERM(d2,"q_rho_u",      eval_q_rho_u);
+    MASA_SIMD_TERM(d2,"q_rho_v",      eval_q_rho_v);
+    MASA_SIMD_TERM(d2,"q_rho_w",      eval_q_rho_w);
+    MASA_SIMD_TERM(d2,"q_rho_e",      eval_q_rho_e);
+
+    MASA_SIMD_TERM(d3,"exact_t",      eval_exact_t);
+    MASA_SIMD_TERM(d3,"exact_u",      eval_exact_u);
+    MASA_SIMD_TERM(d3,"exact_v",      eval_exact_v);
+    MASA_SIMD_TERM(d3,"exact_w",      eval_exact_w);
+    MASA_SIMD_TERM(d3,"exact_p",      eval_exact_p);
+    MASA_SIMD_TERM(d3,"exact_rho",    eval_exact_rho);
+    MASA_SIMD_TERM(d3,"exact_rho_C",  eval_exact_rho_C);
+    MASA_SIMD_TERM(d3,"exact_rho_C3", eval_exact_rho_C3);
+    MASA_SIMD_TERM(d3,"exact_nu",     eval_exact_nu);
+    MASA_SIMD_TERM(d3,"q_t",          eval_q_t);
+    MASA_SIMD_TERM(d3,"q_u",          eval_q_u);
+    MASA_SIMD_TERM(d3,"q_v",          eval_q_v);
+    MASA_SIMD_TERM(d3,"q_w",          eval_q_w);
+    MASA_SIMD_TERM(d3,"q_e",          eval_q_e);
+    MASA_SIMD_TERM(d3,"q_nu",         eval_q_nu);
+    MASA_SIMD_TERM(d3,"q_rho",        eval_q_rho);
+    MASA_SIMD_TERM(d3,"q_rho_u",      eval_q_rho_u);
+    MASA_SIMD_TERM(d3,"q_rho_v",      eval_q_rho_v);
+    MASA_SIMD_TERM(d3,"q_rho_w",      eval_q_rho_w);
+    MASA_SIMD_TERM(d3,"q_rho_e",      eval_q_rho_e);
+
+    MASA_SIMD_TERM(d4,"exact_t",      eval_exact_t);
+    MASA_SIMD_TERM(d4,"exact_u",      eval_exact_u);
+    MASA_SIMD_TERM(d4,"exact_v",      eval_exact_v);
+    MASA_SIMD_TERM(d4,"exact_w",      eval_exact_w);
+    MASA_SIMD_TERM(d4,"exact_p",      eval_exact_p);
+    MASA_SIMD_TERM(d4,"exact_rho",    eval_exact_rho);
+    MASA_SIMD_TERM(d4,"q_t",          eval_q_t);
+    MASA_SIMD_TERM(d4,"q_u",          eval_q_u);
+    MASA_SIMD_TERM(d4,"q_v",          eval_q_v);
+    MASA_SIMD_TERM(d4,"q_w",          eval_q_w);
+    MASA_SIMD_TERM(d4,"q_e",          eval_q_e);
+    MASA_SIMD_TERM(d4,"q_rho",        eval_q_rho);
+    MASA_SIMD_TERM(d4,"q_rho_u",      eval_q_rho_u);
+    MASA_SIMD_TERM(d4,"q_rho_v",      eval_q_rho_v);
+    MASA_SIMD_TERM(d4,"q_rho_w",      eval_q_rho_w);
+    MASA_SIMD_TERM(d4,"q_rho_e",      eval_q_rho_e);
+#undef MASA_SIMD_TERM
+  }
+};
+
+template <typename Scalar>
+const members<Scalar>& terms()
+{
+  static const members<Scalar> t;
+  return t;
+}
+
+template <typename Member>
+Member lookup(const std::map<std::string,Member>& table, const std::string& name)
+{
+  typename std::map<std::string,Member>::const_iterator it = table.find(name);
+  return it == table.end() ? 0 : it->second;
+}
+
+// new instance of the solution called name for the Twin type, NULL if
+// it has none
+template <typename Twin>
+manufactured_solution<Twin>* new_twin(const std::string& name);
+
+template <>
+manufactured_solution<masa_simd>* new_twin<masa_simd>(const std::string& name)
+{
+  std::vector<manufactured_solution<masa_simd>*> anim;
+  manufactured_solution<masa_simd>* lanes = 0;
+  std::string candidate;
+
+  select_lane_kernels().create(anim);
+  for(unsigned int i = 0; i < anim.size(); i++)
+    {
+      anim[i]->return_name(&candidate);
+      if(lanes == 0 && candidate == name)
+        lanes = anim[i];
+      else
+        delete anim[i];
+    }
+  if(lanes)
+    lanes->share_params();
+  return lanes;
+}
+
+#ifndef MASA_OMIT_FLOAT
+template <>
+manufactured_solution<float>* new_twin<float>(const std::string& name)
+{
+  return masa_new_solution<float>(name);
+}
+#endif
+
+#ifndef MASA_OMIT_LONGDOUBLE
+template <>
+manufactured_solution<long double>* new_twin<long double>(const std::string& name)
+{
+  return masa_new_solution<long double>(name);
+}
+#endif
+
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+template <>
+manufactured_solution<DoubleDouble>* new_twin<DoubleDouble>(const std::string& name)
+{
+  return masa_new_solution<DoubleDouble>(name);
+}
+#endif
+
+//
+//  Instance of each double solution for the Twin type (the lane type,
+//  float, long double or DoubleDouble), with the parameter revision it was last synchronized at
+//
+template <typename Twin>
+class twins
+{
+public:
+  struct twin
+  {
+    manufactured_solution<Twin>* ms;
+    unsigned long                revision;
+  };
+
+  ~twins()
+  {
+    for(typename std::map<const void*,twin>::iterator it = _twins.begin(); it != _twins.end(); ++it)
+      delete it->second.ms;
+  }
+
+  // NULL if the solution has no instance for Twin
+  manufactured_solution<Twin>* get(manufactured_solution<double>& ms)
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    typename std::map<const void*,twin>::iterator it = _twins.find(&ms);
+    if(it == _twins.end())
+      {
+        std::string name;
+        ms.return_name(&name);
+
+        twin t = {new_twin<Twin>(name), 0};
+        if(t.ms)
+          t.revision = ms.get_revision() + 1; // forces the first synchronization
+        it = _twins.insert(std::make_pair(static_cast<const void*>(&ms),t)).first;
+      }
+
+    twin& t = it->second;
+    if(t.ms && t.revision != ms.get_revision())
+      {
+        if(t.ms->copy_var(ms))
+          return 0;
+        t.revision = ms.get_revision();
+      }
+    return t.ms;
+  }
+
+private:
+  std::mutex                 _lock;
+  std::map<const void*,twin> _twins;
+};
+
+template <typename Twin>
+twins<Twin>& twins_of()
+{
+  static twins<Twin> t;
+  return t;
+}
+
+// loads point i, or for the lane type points [i,i+masa_simd_lanes)
+// with the last point repeated past the end
+template <typename Scalar, typename Real>
+struct point
+{
+  static const std::size_t width = 1;
+
+  static Scalar load(const Real* c, std::size_t i, std::size_t)
+  {
+    return Scalar(c[i]);
+  }
+
+  static void store(Real* out, std::size_t i, std::size_t, const Scalar& v)
+  {
+    out[i] = Real(v);
+  }
+};
+
+template <typename Real>
+struct point<masa_simd,Real>
+{
+  static const std::size_t width = masa_simd_lanes;
+
+  static masa_simd load(const Real* c, std::size_t i, std::size_t n)
+  {
+    masa_simd v;
+    for(unsigned int l = 0; l != masa_simd_lanes; ++l)
+      v[l] = c[std::min(i+l,n-1)];
+    return v;
+  }
+
+  static void store(Real* out, std::size_t i, std::size_t n, const masa_simd& v)
+  {
+    for(unsigned int l = 0; l != masa_simd_lanes && i+l < n; ++l)
+      out[i+l] = Real(v[l]);
+  }
+};
+
+// evaluates one term on every point, masa_simd_lanes at a time with the
+// lane instance, or one at a time with any other; points
+// and results are converted from and to Real
+template <typename Scalar, typename Real>
+void evaluate(manufactured_solution<Scalar>& ms, const members<Scalar>& t, const std::string& field,
+              unsigned int dims, std::size_t n, const Real* const* c, Real* out, int& err)
+{
+  typedef point<Scalar,Real> p;
+  const std::size_t step = p::width;
+  err = 1;
+
+  switch(dims)
+    {
+    case 1:
+      if(Scalar (manufactured_solution<Scalar>::*f)(Scalar) = lookup(t.d1,field))
+        {
+          for(std::size_t i = 0; i < n; i += step)
+            p::store(out,i,n,(ms.*f)(p::load(c[0],i,n)));
+          err = 0;
+        }
+      break;
+    case 2:
+      if(Scalar (manufactured_solution<Scalar>::*f)(Scalar,Scalar) = lookup(t.d2,field))
+        {
+          for(std::size_t i = 0; i < n; i += step)
+            p::store(out,i,n,(ms.*f)(p::load(c[0],i,n),p::load(c[1],i,n)));
+          err = 0;
+        }
+      break;
+    case 3:
+      if(Scalar (manufactured_solution<Scalar>::*f)(Scalar,Scalar,Scalar) = lookup(t.d3,field))
+        {
+          for(std::size_t i = 0; i < n; i += step)
+            p::store(out,i,n,(ms.*f)(p::load(c[0],i,n),p::load(c[1],i,n),p::load(c[2],i,n)));
+          err = 0;
+        }
+      break;
+    case 4:
+      if(Scalar (manufactured_solution<Scalar>::*f)(Scalar,Scalar,Scalar,Scalar) = lookup(t.d4,field))
+        {
+          for(std::size_t i = 0; i < n; i += step)
+            p::store(out,i,n,(ms.*f)(p::load(c[0],i,n),p::load(c[1],i,n),
+                                     p::load(c[2],i,n),p::load(c[3],i,n)));
+          err = 0;
+        }
+      break;
+    }
+}
+
+// evaluates with the lane instance of the double solution ms if it has
+// one, or point by point with ms itself
+template <typename Real>
+void evaluate_double(manufactured_solution<double>& ms, const std::string& field, unsigned int dims,
+                     std::size_t n, const Real* const* c, Real* out, int& err)
+{
+  if(manufactured_solution<masa_simd>* lanes = twins_of<masa_simd>().get(ms))
+    evaluate(*lanes,terms<masa_simd>(),field,dims,n,c,out,err);
+  else
+    evaluate(ms,terms<double>(),field,dims,n,c,out,err);
+}
+
+// one term of the solution interface, looked up once, evaluated at
+// points given as arrays of dims coordinates
+template <typename Scalar>
+struct term_at
+{
+  typedef manufactured_solution<Scalar> ms;
+
+  Scalar (ms::*f1)(Scalar);
+  Scalar (ms::*f2)(Scalar,Scalar);
+  Scalar (ms::*f3)(Scalar,Scalar,Scalar);
+  Scalar (ms::*f4)(Scalar,Scalar,Scalar,Scalar);
+
+  term_at(const members<Scalar>& t, const std::string& field, unsigned int dims)
+    : f1(dims == 1 ? lookup(t.d1,field) : 0), f2(dims == 2 ? lookup(t.d2,field) : 0),
+      f3(dims == 3 ? lookup(t.d3,field) : 0), f4(dims == 4 ? lookup(t.d4,field) : 0) {}
+
+  bool found() const { return f1 || f2 || f3 || f4; }
+
+  Scalar operator()(ms& s, const Scalar* p) const
+  {
+    if(f1) return (s.*f1)(p[0]);
+    if(f2) return (s.*f2)(p[0],p[1]);
+    if(f3) return (s.*f3)(p[0],p[1],p[2]);
+    return (s.*f4)(p[0],p[1],p[2],p[3]);
+  }
+};
+
+// the largest relative discrepancy between field evaluated by the
+// double solution ms and by its twin in the wider Shadow type, over the
+// n points; absolute where the shadow value is zero, NaN if either
+// evaluation gives one
+template <typename Shadow>
+void audit(manufactured_solution<double>& ms, manufactured_solution<Shadow>& shadow,
+           const std::string& field, unsigned int dims, std::size_t n,
+           const double* const* coords, double& max_rel, int& err)
+{
+  std::vector<double> d(n);
+  evaluate(ms,terms<double>(),field,dims,n,coords,d.data(),err);
+  if(err)
+    return;
+
+  // double points are exact in the wider type
+  std::vector<Shadow> c(dims*n);
+  std::vector<Shadow> s(n);
+  const Shadow* cp[4];
+  for(unsigned int k = 0; k != dims; k++)
+    {
+      std::copy(coords[k],coords[k]+n,c.begin()+k*n);
+      cp[k] = &c[k*n];
+    }
+  evaluate(shadow,terms<Shadow>(),field,dims,n,cp,s.data(),err);
+  if(err)
+    return;
+
+  max_rel = 0;
+  for(std::size_t i = 0; i != n && max_rel == max_rel; i++)
+    {
+      const Shadow diff = Shadow(d[i]) - s[i];
+      const double rel  = std::fabs(static_cast<double>(s[i] == Shadow(0) ? diff : diff / s[i]));
+      if(!(rel <= max_rel))
+        max_rel = rel;
+    }
+}
+
+} // end anonymous namespace
+
+int MASA::masa_simd_eval(const char* caller, const std::string& field, unsigned int dims,
+                         std::size_t n, const double* const* coords, double* out)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  if(ms == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " needs a selected solution" << std::endl;
+      return 1;
+    }
+  if(n == 0)
+    return 0;
+
+  int err;
+  evaluate_double(*ms,field,dims,n,coords,out,err);
+
+  if(err)
+    std::cout << "MASA ERROR:: " << caller << " has no " << dims << "D term " << field << std::endl;
+  return err;
+}
+
+int MASA::masa_float_eval(const char* caller, const std::string& field, unsigned int dims,
+                          std::size_t n, const float* const* coords, float* out, bool mixed)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  if(ms == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " needs a selected solution" << std::endl;
+      return 1;
+    }
+  if(n == 0)
+    return 0;
+
+  int err = 1;
+  if(mixed)
+    evaluate_double(*ms,field,dims,n,coords,out,err);
+#ifndef MASA_OMIT_FLOAT
+  else if(manufactured_solution<float>* single = twins_of<float>().get(*ms))
+    evaluate(*single,terms<float>(),field,dims,n,coords,out,err);
+#endif
+  else
+    {
+      std::cout << "MASA ERROR:: " << caller << " cannot make a float instance of the selected solution" << std::endl;
+      return 1;
+    }
+
+  if(err)
+    std::cout << "MASA ERROR:: " << caller << " has no " << dims << "D term " << field << std::endl;
+  return err;
+}
+
+int MASA::masa_dd_eval(const char* caller, const std::string& field, unsigned int dims,
+                       std::size_t n, const double* const* coords, double* hi, double* lo)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  if(ms == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " needs a selected solution" << std::endl;
+      return 1;
+    }
+  if(n == 0)
+    return 0;
+
+#ifdef MASA_OMIT_DOUBLEDOUBLE
+  std::cout << "MASA ERROR:: " << caller << " needs the doubledouble scalar type, left out of this build" << std::endl;
+  return 1;
+#else
+  manufactured_solution<DoubleDouble>* dd = twins_of<DoubleDouble>().get(*ms);
+  if(dd == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " cannot make a double-double instance of the selected solution" << std::endl;
+      return 1;
+    }
+
+  // double points are exact double-doubles
+  std::vector<DoubleDouble> c(dims*n);
+  std::vector<DoubleDouble> out(n);
+  const DoubleDouble* cp[4];
+  for(unsigned int d = 0; d != dims; d++)
+    {
+      std::copy(coords[d],coords[d]+n,c.begin()+d*n);
+      cp[d] = &c[d*n];
+    }
+
+  int err;
+  evaluate(*dd,terms<DoubleDouble>(),field,dims,n,cp,out.data(),err);
+
+  if(err)
+    {
+      std::cout << "MASA ERROR:: " << caller << " has no " << dims << "D term " << field << std::endl;
+      return err;
+    }
+
+  for(std::size_t i = 0; i != n; i++)
+    {
+      hi[i] = out[i].hi();
+      lo[i] = out[i].lo();
+    }
+  return 0;
+#endif
+}
+
+int MASA::masa_audit_eval(const char* caller, const std::string& field, const std::string& shadow,
+                          unsigned int dims, std::size_t n, const double* const* coords, double& max_rel)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  if(ms == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " needs a selected solution" << std::endl;
+      return 1;
+    }
+
+  max_rel = 0;
+  if(n == 0)
+    return 0;
+
+  int err = 1;
+  bool twin = false;
+  if(shadow == "longdouble")
+    {
+#ifndef MASA_OMIT_LONGDOUBLE
+      if(manufactured_solution<long double>* ld = twins_of<long double>().get(*ms))
+        {
+          audit(*ms,*ld,field,dims,n,coords,max_rel,err);
+          twin = true;
+        }
+#endif
+    }
+  else if(shadow == "doubledouble")
+    {
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+      if(manufactured_solution<DoubleDouble>* dd = twins_of<DoubleDouble>().get(*ms))
+        {
+          audit(*ms,*dd,field,dims,n,coords,max_rel,err);
+          twin = true;
+        }
+#endif
+    }
+  else
+    {
+      std::cout << "MASA ERROR:: " << caller << " shadows in longdouble or doubledouble, not " << shadow << std::endl;
+      return 1;
+    }
+
+  if(!twin)
+    {
+      std::cout << "MASA ERROR:: " << caller << " cannot make a " << shadow << " instance of the selected solution" << std::endl;
+      return 1;
+    }
+
+  if(err)
+    std::cout << "MASA ERROR:: " << caller << " has no " << dims << "D term " << field << std::endl;
+  return err;
+}
+
+//
+//  Every member of the ensemble on every point. Expression solutions
+//  evaluate one member after the other on the points as on a registered
+//  grid, so the intermediate values not depending on the parameters the
+//  members differ in (the trigonometric factors of fixed wave numbers,
+//  ...) are computed only once. Solutions with a lane instance evaluate
+//  masa_simd_lanes members per call, each lane holding the parameters of
+//  one; the others one member at a time. Either way the groups of
+//  members are spread over the worker threads, and the parameters of
+//  the selected solution are left as they were.
+//
+int MASA::masa_ensemble_eval(const char* caller, const std::string& field, unsigned int dims,
+                             std::size_t nmembers, const double* params,
+                             std::size_t n, const double* const* coords, double* out)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  if(ms == 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " needs a selected solution" << std::endl;
+      return 1;
+    }
+
+  const term_at<double> f(terms<double>(),field,dims);
+  if(!f.found())
+    {
+      std::cout << "MASA ERROR:: " << caller << " has no " << dims << "D term " << field << std::endl;
+      return 1;
+    }
+  if(nmembers == 0 || n == 0)
+    return 0;
+
+  const std::size_t np = ms->num_params();
+  for(std::size_t k = 0; k != nmembers; k++)
+    if(!ms->snapshot_fits(params + k*np))
+      {
+        std::cout << "MASA ERROR:: " << caller << " was given member " << k
+                  << " with vectors of other lengths than those of the selected solution" << std::endl;
+        return 1;
+      }
+
+  std::vector<double> saved(np);
+  ms->save_var(saved.data());
+
+  std::shared_ptr<grid_cache<double> > cache;
+  ms->load_var(params);
+  int err = ms->eval_grid(cache,field,dims,n,coords,out,false);
+  for(std::size_t k = 1; err == 0 && k != nmembers; k++)
+    {
+      ms->load_var(params + k*np);
+      err = ms->eval_grid(cache,field,dims,n,coords,out + k*n,false);
+    }
+
+  if(err < 0 && twins_of<masa_simd>().get(*ms))
+    {
+      const term_at<masa_simd> lf(terms<masa_simd>(),field,dims);
+      const std::size_t groups = (nmembers + masa_simd_lanes - 1) / masa_simd_lanes;
+
+      ms->load_var(saved.data());
+      err = masa_parallel_eval<double>(groups,[&](std::size_t begin, std::size_t end)
+        {
+          manufactured_solution<double>& own = *masa_selected_solution<double>();
+          manufactured_solution<masa_simd>& lanes = *twins_of<masa_simd>().get(own);
+          std::vector<masa_simd> lane_params(np);
+          masa_simd p[4];
+
+          for(std::size_t g = begin; g != end; g++)
+            {
+              // the last group repeats its last member past the end
+              const std::size_t first = g * masa_simd_lanes;
+              for(std::size_t j = 0; j != np; j++)
+                for(unsigned int l = 0; l != masa_simd_lanes; l++)
+                  lane_params[j][l] = params[std::min(first+l,nmembers-1)*np + j];
+              lanes.load_var(lane_params.data());
+
+              for(std::size_t i = 0; i != n; i++)
+                {
+                  for(unsigned int d = 0; d != dims; d++)
+                    p[d] = coords[d][i];
+                  const masa_simd v = lf(lanes,p);
+                  for(unsigned int l = 0; l != masa_simd_lanes && first+l < nmembers; l++)
+                    out[(first+l)*n + i] = v[l];
+                }
+            }
+          lanes.copy_var(own);
+        });
+    }
+  else if(err < 0)
+    {
+      ms->load_var(saved.data());
+      err = masa_parallel_eval<double>(nmembers,[&](std::size_t begin, std::size_t end)
+        {
+          manufactured_solution<double>& own = *masa_selected_solution<double>();
+          for(std::size_t k = begin; k != end; k++)
+            {
+              own.load_var(params + k*np);
+              for(std::size_t i = 0; i != n; i++)
+                {
+                  double p[4];
+                  for(unsigned int d = 0; d != dims; d++)
+                    p[d] = coords[d][i];
+                  out[k*n + i] = f(own,p);
+                }
+            }
+        });
+    }
+
+  ms->load_var(saved.data());
+  return err;
+}
+
+int MASA::masa_get_lane_isa(std::string* isa)
+{
+  *isa = select_lane_kernels().isa;
+  return 0;
+}
+
+int MASA::masa_eval_1d_lanes(const std::string& field,
+                             const std::vector<double>& x,std::vector<double>& out)
+{
+  const double* c[] = {x.data()};
+
+  out.resize(x.size());
+  return masa_simd_eval("masa_eval_1d_lanes",field,1,x.size(),c,out.data());
+}
+
+int MASA::masa_eval_2d_lanes(const std::string& field,
+                             const std::vector<double>& x,const std::vector<double>& y,
+                             std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data()};
+
+  if(y.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_2d_lanes needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  out.resize(x.size());
+  return masa_simd_eval("masa_eval_2d_lanes",field,2,x.size(),c,out.data());
+}
+
+int MASA::masa_eval_3d_lanes(const std::string& field,
+                             const std::vector<double>& x,const std::vector<double>& y,
+                             const std::vector<double>& z,std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data(), z.data()};
+
+  if(y.size() != x.size() || z.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_3d_lanes needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  out.resize(x.size());
+  return masa_simd_eval("masa_eval_3d_lanes",field,3,x.size(),c,out.data());
+}
+
+int MASA::masa_eval_4d_lanes(const std::string& field,
+                             const std::vector<double>& x,const std::vector<double>& y,
+                             const std::vector<double>& z,const std::vector<double>& t,
+                             std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  if(y.size() != x.size() || z.size() != x.size() || t.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_4d_lanes needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  out.resize(x.size());
+  return masa_simd_eval("masa_eval_4d_lanes",field,4,x.size(),c,out.data());
+}
+
+int MASA::masa_eval_1d_float(const std::string& field,
+                             const std::vector<float>& x,std::vector<float>& out)
+{
+  const float* c[] = {x.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_1d_float",field,1,x.size(),c,out.data(),false);
+}
+
+int MASA::masa_eval_2d_float(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_2d_float",field,2,x.size(),c,out.data(),false);
+}
+
+int MASA::masa_eval_3d_float(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             const std::vector<float>& z,std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data(), z.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_3d_float",field,3,x.size(),c,out.data(),false);
+}
+
+int MASA::masa_eval_4d_float(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             const std::vector<float>& z,const std::vector<float>& t,
+                             std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_4d_float",field,4,x.size(),c,out.data(),false);
+}
+
+int MASA::masa_eval_1d_mixed(const std::string& field,
+                             const std::vector<float>& x,std::vector<float>& out)
+{
+  const float* c[] = {x.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_1d_mixed",field,1,x.size(),c,out.data(),true);
+}
+
+int MASA::masa_eval_2d_mixed(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_2d_mixed",field,2,x.size(),c,out.data(),true);
+}
+
+int MASA::masa_eval_3d_mixed(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             const std::vector<float>& z,std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data(), z.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_3d_mixed",field,3,x.size(),c,out.data(),true);
+}
+
+int MASA::masa_eval_4d_mixed(const std::string& field,
+                             const std::vector<float>& x,const std::vector<float>& y,
+                             const std::vector<float>& z,const std::vector<float>& t,
+                             std::vector<float>& out)
+{
+  const float* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  out.resize(x.size());
+  return masa_float_eval("masa_eval_4d_mixed",field,4,x.size(),c,out.data(),true);
+}
+
+int MASA::masa_eval_1d_dd(const std::string& field,
+                          const std::vector<double>& x,
+                          std::vector<double>& hi,std::vector<double>& lo)
+{
+  const double* c[] = {x.data()};
+
+  hi.resize(x.size());
+  lo.resize(x.size());
+  return masa_dd_eval("masa_eval_1d_dd",field,1,x.size(),c,hi.data(),lo.data());
+}
+
+int MASA::masa_eval_2d_dd(const std::string& field,
+                          const std::vector<double>& x,const std::vector<double>& y,
+                          std::vector<double>& hi,std::vector<double>& lo)
+{
+  const double* c[] = {x.data(), y.data()};
+
+  if(y.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_2d_dd needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  hi.resize(x.size());
+  lo.resize(x.size());
+  return masa_dd_eval("masa_eval_2d_dd",field,2,x.size(),c,hi.data(),lo.data());
+}
+
+int MASA::masa_eval_3d_dd(const std::string& field,
+                          const std::vector<double>& x,const std::vector<double>& y,
+                          const std::vector<double>& z,
+                          std::vector<double>& hi,std::vector<double>& lo)
+{
+  const double* c[] = {x.data(), y.data(), z.data()};
+
+  if(y.size() != x.size() || z.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_3d_dd needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  hi.resize(x.size());
+  lo.resize(x.size());
+  return masa_dd_eval("masa_eval_3d_dd",field,3,x.size(),c,hi.data(),lo.data());
+}
+
+int MASA::masa_eval_4d_dd(const std::string& field,
+                          const std::vector<double>& x,const std::vector<double>& y,
+                          const std::vector<double>& z,const std::vector<double>& t,
+                          std::vector<double>& hi,std::vector<double>& lo)
+{
+  const double* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  if(y.size() != x.size() || z.size() != x.size() || t.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_4d_dd needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  hi.resize(x.size());
+  lo.resize(x.size());
+  return masa_dd_eval("masa_eval_4d_dd",field,4,x.size(),c,hi.data(),lo.data());
+}
+
+namespace {
+
+// audits every field in turn; a field the solution lacks is reported
+// and left at zero, the others are still measured
+int audit_fields(const char* caller, const std::vector<std::string>& fields, const std::string& shadow,
+                 unsigned int dims, std::size_t n, const double* const* coords, std::vector<double>& max_rel)
+{
+  int err = 0;
+
+  max_rel.assign(fields.size(),0.);
+  for(std::size_t f = 0; f != fields.size(); f++)
+    if(masa_audit_eval(caller,fields[f],shadow,dims,n,coords,max_rel[f]))
+      err = 1;
+  return err;
+}
+
+} // end anonymous namespace
+
+int MASA::masa_audit_1d(const std::vector<std::string>& fields,const std::string& shadow,
+                        const std::vector<double>& x,std::vector<double>& max_rel)
+{
+  const double* c[] = {x.data()};
+
+  return audit_fields("masa_audit_1d",fields,shadow,1,x.size(),c,max_rel);
+}
+
+int MASA::masa_audit_2d(const std::vector<std::string>& fields,const std::string& shadow,
+                        const std::vector<double>& x,const std::vector<double>& y,
+                        std::vector<double>& max_rel)
+{
+  const double* c[] = {x.data(), y.data()};
+
+  if(y.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_audit_2d needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return audit_fields("masa_audit_2d",fields,shadow,2,x.size(),c,max_rel);
+}
+
+int MASA::masa_audit_3d(const std::vector<std::string>& fields,const std::string& shadow,
+                        const std::vector<double>& x,const std::vector<double>& y,
+                        const std::vector<double>& z,std::vector<double>& max_rel)
+{
+  const double* c[] = {x.data(), y.data(), z.data()};
+
+  if(y.size() != x.size() || z.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_audit_3d needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return audit_fields("masa_audit_3d",fields,shadow,3,x.size(),c,max_rel);
+}
+
+int MASA::masa_audit_4d(const std::vector<std::string>& fields,const std::string& shadow,
+                        const std::vector<double>& x,const std::vector<double>& y,
+                        const std::vector<double>& z,const std::vector<double>& t,
+                        std::vector<double>& max_rel)
+{
+  const double* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  if(y.size() != x.size() || z.size() != x.size() || t.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_audit_4d needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return audit_fields("masa_audit_4d",fields,shadow,4,x.size(),c,max_rel);
+}
+
+namespace {
+
+// the ensemble of the parameter sets in params, rows of the
+// masa_param_count() parameters of the selected solution, into out
+int ensemble(const char* caller, const std::string& field, unsigned int dims,
+             const std::vector<double>& params, std::size_t n, const double* const* coords,
+             std::vector<double>& out)
+{
+  manufactured_solution<double>* ms = masa_selected_solution<double>();
+  const std::size_t np = ms ? ms->num_params() : 1;
+
+  if(np == 0 || params.size() % np != 0)
+    {
+      std::cout << "MASA ERROR:: " << caller << " cannot split " << params.size()
+                << " values into parameter sets of " << np << std::endl;
+      return 1;
+    }
+
+  out.resize(params.size() / np * n);
+  return masa_ensemble_eval(caller,field,dims,params.size() / np,params.data(),n,coords,out.data());
+}
+
+} // end anonymous namespace
+
+int MASA::masa_eval_1d_ensemble(const std::string& field,const std::vector<double>& params,
+                                const std::vector<double>& x,std::vector<double>& out)
+{
+  const double* c[] = {x.data()};
+
+  return ensemble("masa_eval_1d_ensemble",field,1,params,x.size(),c,out);
+}
+
+int MASA::masa_eval_2d_ensemble(const std::string& field,const std::vector<double>& params,
+                                const std::vector<double>& x,const std::vector<double>& y,
+                                std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data()};
+
+  if(y.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_2d_ensemble needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return ensemble("masa_eval_2d_ensemble",field,2,params,x.size(),c,out);
+}
+
+int MASA::masa_eval_3d_ensemble(const std::string& field,const std::vector<double>& params,
+                                const std::vector<double>& x,const std::vector<double>& y,
+                                const std::vector<double>& z,std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data(), z.data()};
+
+  if(y.size() != x.size() || z.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_3d_ensemble needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return ensemble("masa_eval_3d_ensemble",field,3,params,x.size(),c,out);
+}
+
+int MASA::masa_eval_4d_ensemble(const std::string& field,const std::vector<double>& params,
+                                const std::vector<double>& x,const std::vector<double>& y,
+                                const std::vector<double>& z,const std::vector<double>& t,
+                                std::vector<double>& out)
+{
+  const double* c[] = {x.data(), y.data(), z.data(), t.data()};
+
+  if(y.size() != x.size() || z.size() != x.size() || t.size() != x.size())
+    {
+      std::cout << "MASA ERROR:: masa_eval_4d_ensemble needs coordinate arrays of equal length" << std::endl;
+      return 1;
+    }
+
+  return ensemble("masa_eval_4d_ensemble",field,4,params,x.size(),c,out);
+}
@@ -0,0 +1,279 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_stream.cpp: out-of-core evaluation of 3D grids, slab by slab,
+//                  into a memory-mapped output file
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <masa_internal.h>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace MASA;
+
+//
+//  File layout (native byte order):
+//
+//    offset  type                 contents
+//    0       char[8]              "MASAGRID"
+//    8       uint32               layout version (1)
+//    12      uint32               bytes per value (sizeof(Scalar))
+//    16      uint64[3]            nx, ny, nz
+//    40      uint64               nfields
+//    48      uint64               data offset (a multiple of 4096)
+//    56      char[nfields][32]    field names, NUL padded
+//    ...     Scalar[nx+ny+nz]     x, y and z coordinates
+//    data    Scalar[nfields][nz][ny][nx]
+//
+//  i.e. every field is stored contiguously, x varying fastest.
+//
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+const std::size_t header_bytes = 56;
+const std::size_t name_bytes   = 32;
+const std::size_t data_align   = 4096;
+
+// default slab size when none is requested: about 64 MB for all fields
+const std::size_t auto_slab_bytes = std::size_t(64) << 20;
+
+//
+//  one mapped window of the output file
+//
+struct window
+{
+  void*       base;
+  std::size_t length;
+};
+
+//
+//  maps [offset,offset+bytes) of the file; mmap needs page aligned
+//  offsets, so the window may start a little before the data
+//
+int map_window(int fd, std::size_t offset, std::size_t bytes, window& w, char*& data)
+{
+  const std::size_t page    = sysconf(_SC_PAGESIZE);
+  const std::size_t aligned = offset - offset % page;
+
+  w.length = bytes + (offset - aligned);
+  w.base   = mmap(0,w.length,PROT_READ | PROT_WRITE,MAP_SHARED,fd,aligned);
+  if(w.base == MAP_FAILED)
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid unable to map the output file" << std::endl;
+      return 1;
+    }
+
+  data = static_cast<char*>(w.base) + (offset - aligned);
+  return 0;
+}
+
+//
+//  writes a finished slab back to the file and releases its pages
+//
+void flush_windows(std::vector<window> windows, int* err)
+{
+  for(unsigned int i = 0; i != windows.size(); i++)
+    {
+      if(msync(windows[i].base,windows[i].length,MS_SYNC) != 0)
+        *err = 1;
+      munmap(windows[i].base,windows[i].length);
+    }
+}
+
+template <typename T>
+void put(std::vector<char>& buf, std::size_t offset, T value)
+{
+  std::memcpy(&buf[offset],&value,sizeof(T));
+}
+
+} // end anonymous namespace
+
+//
+//  Slabs of whole z-planes are evaluated in turn straight into mapped
+//  windows of the file. While the pool evaluates slab k+1, a writer
+//  thread flushes and unmaps slab k, so at most two slabs are ever
+//  resident.
+//
+template <typename Scalar>
+int MASA::masa_stream_3d_grid(const std::string& filename,
+                              const std::vector<Scalar (*)(Scalar,Scalar,Scalar)>& fields,
+                              const std::vector<std::string>& names,
+                              const std::vector<Scalar>& x,
+                              const std::vector<Scalar>& y,
+                              const std::vector<Scalar>& z,
+                              std::size_t slab_planes)
+{
+  if(fields.empty() || names.size() != fields.size())
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid needs one name per field" << std::endl;
+      return 1;
+    }
+
+  for(unsigned int f = 0; f != names.size(); f++)
+    if(names[f].size() >= name_bytes)
+      {
+        std::cout << "MASA ERROR:: masa_stream_3d_grid field name " << names[f]
+                  << " is longer than " << name_bytes-1 << " characters" << std::endl;
+        return 1;
+      }
+
+  const std::size_t nx      = x.size();
+  const std::size_t ny      = y.size();
+  const std::size_t nz      = z.size();
+  const std::size_t nfields = fields.size();
+  const std::size_t plane   = nx * ny;
+
+  if(plane * nz == 0)
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid needs at least one point per axis" << std::endl;
+      return 1;
+    }
+
+  if(slab_planes == 0)
+    slab_planes = std::max<std::size_t>(1,auto_slab_bytes / (nfields * plane * sizeof(Scalar)));
+
+  // header, names and coordinates, data padded to the next 4096 bytes
+  std::size_t meta = header_bytes + nfields * name_bytes + (nx + ny + nz) * sizeof(Scalar);
+  std::size_t data_offset = (meta + data_align - 1) / data_align * data_align;
+  std::size_t field_bytes = plane * nz * sizeof(Scalar);
+
+  std::vector<char> header(data_offset,0);
+  std::memcpy(&header[0],"MASAGRID",8);
+  put<uint32_t>(header,8,1);
+  put<uint32_t>(header,12,sizeof(Scalar));
+  put<uint64_t>(header,16,nx);
+  put<uint64_t>(header,24,ny);
+  put<uint64_t>(header,32,nz);
+  put<uint64_t>(header,40,nfields);
+  put<uint64_t>(header,48,data_offset);
+  for(std::size_t f = 0; f != nfields; f++)
+    std::memcpy(&header[header_bytes + f * name_bytes],names[f].c_str(),names[f].size());
+
+  std::size_t pos = header_bytes + nfields * name_bytes;
+  std::memcpy(&header[pos],&x[0],nx * sizeof(Scalar)); pos += nx * sizeof(Scalar);
+  std::memcpy(&header[pos],&y[0],ny * sizeof(Scalar)); pos += ny * sizeof(Scalar);
+  std::memcpy(&header[pos],&z[0],nz * sizeof(Scalar));
+
+  int fd = open(filename.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+  if(fd < 0)
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid unable to open " << filename << std::endl;
+      return 1;
+    }
+
+  if(ftruncate(fd,data_offset + nfields * field_bytes) != 0 ||
+     pwrite(fd,&header[0],data_offset,0) != ssize_t(data_offset))
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid unable to write " << filename << std::endl;
+      close(fd);
+      return 1;
+    }
+
+  int err = 0;
+  int flush_err = 0;
+  std::thread writer;
+
+  for(std::size_t k0 = 0; k0 < nz && !err; k0 += slab_planes)
+    {
+      const std::size_t k1  = std::min(nz,k0 + slab_planes);
+      const std::size_t pts = (k1 - k0) * plane;
+
+      std::vector<window> windows(nfields);
+      std::vector<Scalar*> out(nfields);
+      for(std::size_t f = 0; f != nfields && !err; f++)
+        {
+          char* data;
+          err = map_window(fd,data_offset + f * field_bytes + k0 * plane * sizeof(Scalar),
+                           pts * sizeof(Scalar),windows[f],data);
+          out[f] = reinterpret_cast<Scalar*>(data);
+        }
+
+      if(!err)
+        err = masa_parallel_eval<Scalar>(nfields * pts,[&](std::size_t begin, std::size_t end)
+          {
+            for(std::size_t p = begin; p < end; p++)
+              {
+                const std::size_t f = p / pts;
+                const std::size_t q = p % pts + k0 * plane;
+                out[f][p % pts] = fields[f](x[q % nx],y[(q % plane) / nx],z[q / plane]);
+              }
+          });
+
+      // the previous slab must be on disk before this one is handed off
+      if(writer.joinable())
+        writer.join();
+
+      if(err)
+        {
+          for(std::size_t f = 0; f != nfields; f++)
+            if(windows[f].base && windows[f].base != MAP_FAILED)
+              munmap(windows[f].base,windows[f].length);
+          break;
+        }
+
+      writer = std::thread(flush_windows,windows,&flush_err);
+    }
+
+  if(writer.joinable())
+    writer.join();
+
+  if(close(fd) != 0 || flush_err)
+    {
+      std::cout << "MASA ERROR:: masa_stream_3d_grid unable to write back " << filename << std::endl;
+      return 1;
+    }
+
+  return err;
+}
+
+// Instantiate for every precision
+
+#define INSTANTIATE_STREAM_FUNCTIONS(Scalar) \
+  template int masa_stream_3d_grid<Scalar>(const std::string&,const std::vector<Scalar (*)(Scalar,Scalar,Scalar)>&,const std::vector<std::string>&,const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,std::size_t)
+
+namespace MASA {
+
+INSTANTIATE_STREAM_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_STREAM_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+INSTANTIATE_STREAM_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_STREAM_FUNCTIONS(DoubleDouble);
+#endif
+
+}
@@ -0,0 +1,807 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// masa_threads.cpp: work-stealing thread pool and the threaded batch
+//                   and grid evaluation routines built on top of it
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <masa_internal.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace MASA;
+
+// Anonymous namespace for local helper class/functions
+namespace {
+
+typedef std::pair<std::size_t,std::size_t> chunk;
+
+// chunks handed to each worker per batch: enough slack for stealing
+// to even out solutions whose cost varies strongly in space
+const std::size_t chunks_per_worker = 16;
+
+// true on pool threads, and on the calling thread while it runs a job
+thread_local bool in_pool = false;
+
+unsigned int default_threads()
+{
+  const char* env = getenv("MASA_NUM_THREADS");
+  if(env)
+    {
+      char* end;
+      long n = strtol(env,&end,10);
+      if(end != env && *end == '\0' && n > 0)
+        return n;
+
+      std::cout << "MASA WARNING:: ignoring invalid MASA_NUM_THREADS=" << env << std::endl;
+    }
+
+  unsigned int n = std::thread::hardware_concurrency();
+  return n ? n : 1;
+}
+
+//
+//  MASA_THREAD_AFFINITY=close pins pool worker id to the id-th of the
+//  P processors the thread starting the pool may run on, =spread to
+//  the id*P/nthreads-th; unset or none leaves placement to the system.
+//  The calling thread takes part in every job as participant 0 and is
+//  never pinned here.
+//
+enum affinity_policy {affinity_none, affinity_close, affinity_spread};
+
+affinity_policy thread_affinity()
+{
+  static const affinity_policy policy = []()
+    {
+      const char* env = getenv("MASA_THREAD_AFFINITY");
+      if(!env || !strcmp(env,"none"))
+        return affinity_none;
+      if(!strcmp(env,"close"))
+        return affinity_close;
+      if(!strcmp(env,"spread"))
+        return affinity_spread;
+
+      std::cout << "MASA WARNING:: ignoring invalid MASA_THREAD_AFFINITY=" << env << std::endl;
+      return affinity_none;
+    }();
+  return policy;
+}
+
+void pin_worker(unsigned int id, unsigned int nthreads)
+{
+  const affinity_policy policy = thread_affinity();
+  if(policy == affinity_none)
+    return;
+
+#ifdef __linux__
+  cpu_set_t allowed;
+  if(sched_getaffinity(0,sizeof(allowed),&allowed))
+    return;
+
+  std::vector<int> cpus;
+  for(int c = 0; c < CPU_SETSIZE; c++)
+    if(CPU_ISSET(c,&allowed))
+      cpus.push_back(c);
+  if(cpus.empty())
+    return;
+
+  const std::size_t slot = policy == affinity_close ? id % cpus.size()
+                         : std::size_t(id) * cpus.size() / nthreads % cpus.size();
+  cpu_set_t one;
+  CPU_ZERO(&one);
+  CPU_SET(cpus[slot],&one);
+  pthread_setaffinity_np(pthread_self(),sizeof(one),&one);
+#else
+  (void)id;
+  (void)nthreads;
+#endif
+}
+
+//
+//  Each participant owns a deque of contiguous chunks: it works
+//  through its own from the front and, once empty, steals from the
+//  back of the others so that the stolen work is far away from what
+//  the owner is touching. Static jobs disable stealing, so that a
+//  given slab of the output is always written by the same thread.
+//
+class ThreadPool
+{
+public:
+  ThreadPool () : _nthreads(default_threads()), _stop(false), _generation(0),
+                  _active(0), _accepting(false), _busy(0), _steal(true),
+                  _remaining(0), _body(0) {}
+
+  ~ThreadPool () { shutdown(); }
+
+  void forked();
+
+  unsigned int size() const { return _nthreads; }
+
+  void resize(unsigned int n) {
+    std::lock_guard<std::mutex> job(_job_mutex);
+    shutdown();
+    _nthreads = n;
+  }
+
+  void run(std::size_t n, unsigned int nworkers, const masa_chunk_body& body);
+  void run_static(const std::vector<std::size_t>& partition, unsigned int nworkers,
+                  const masa_chunk_body& body);
+
+private:
+  struct queue {
+    std::mutex         lock;
+    std::deque<chunk>  chunks;
+  };
+
+  void start();
+  void shutdown();
+  void worker_loop(unsigned int id);
+  bool take(unsigned int id, chunk& work);
+  void drain(unsigned int id);
+  void execute(unsigned int nworkers, std::size_t nchunks, bool steal,
+               const masa_chunk_body& body);
+
+  unsigned int              _nthreads; // participants, including the caller
+  std::vector<std::thread>  _workers;
+  std::vector<queue>        _queues;
+
+  std::mutex                _job_mutex;  // one job at a time
+  std::mutex                _mutex;      // guards the job state below
+  std::condition_variable   _wake;
+  std::condition_variable   _done;
+  bool                      _stop;
+  unsigned long             _generation;
+  unsigned int              _active;     // participants of the current job
+  bool                      _accepting;  // workers may still join the job
+  unsigned int              _busy;       // workers inside drain()
+  bool                      _steal;      // dynamic (true) or static job
+  std::atomic<std::size_t>  _remaining;  // chunks not yet finished
+
+  const masa_chunk_body*    _body;
+  std::exception_ptr        _error;
+};
+
+void ThreadPool::start()
+{
+  _stop = false;
+  _queues = std::vector<queue>(_nthreads);
+  for(unsigned int id = 1; id < _nthreads; id++)
+    _workers.push_back(std::thread(&ThreadPool::worker_loop,this,id));
+}
+
+//
+//  only the forking thread survives in a child process: forget the
+//  workers, whose handles can be neither joined nor destroyed, and
+//  reset the locks any of them may have held; the next job in the
+//  child starts a fresh set of workers
+//
+void ThreadPool::forked()
+{
+  new std::vector<std::thread>(std::move(_workers)); // leaked on purpose
+  _workers.clear();
+
+  new (&_job_mutex) std::mutex();
+  new (&_mutex) std::mutex();
+  new (&_wake) std::condition_variable();
+  new (&_done) std::condition_variable();
+  _stop      = false;
+  _accepting = false;
+  _busy      = 0;
+}
+
+void ThreadPool::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+
+  for(unsigned int i = 0; i != _workers.size(); i++)
+    {
+      // exit() called from a worker (masa_exit) must not join itself
+      if(_workers[i].get_id() == std::this_thread::get_id())
+        _workers[i].detach();
+      else
+        _workers[i].join();
+    }
+  _workers.clear();
+}
+
+void ThreadPool::worker_loop(unsigned int id)
+{
+  in_pool = true;
+  pin_worker(id,_nthreads);
+  unsigned long seen = 0;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  while(true)
+    {
+      _wake.wait(lock, [&]{ return _stop || _generation != seen; });
+      if(_stop)
+        return;
+
+      // a worker waking up after the job was wound down sits it out
+      seen = _generation;
+      if(!_accepting || id >= _active)
+        continue;
+
+      _busy++;
+      lock.unlock();
+      drain(id);
+      lock.lock();
+      if(--_busy == 0)
+        _done.notify_all();
+    }
+}
+
+bool ThreadPool::take(unsigned int id, chunk& work)
+{
+  {
+    std::lock_guard<std::mutex> own(_queues[id].lock);
+    if(!_queues[id].chunks.empty())
+      {
+        work = _queues[id].chunks.front();
+        _queues[id].chunks.pop_front();
+        return true;
+      }
+  }
+
+  for(unsigned int i = 1; _steal && i < _active; i++)
+    {
+      queue& victim = _queues[(id + i) % _active];
+      std::lock_guard<std::mutex> steal(victim.lock);
+      if(!victim.chunks.empty())
+        {
+          work = victim.chunks.back();
+          victim.chunks.pop_back();
+          return true;
+        }
+    }
+
+  return false;
+}
+
+void ThreadPool::drain(unsigned int id)
+{
+  chunk work;
+  while(take(id,work))
+    {
+      try
+        {
+          (*_body)(work.first,work.second,id);
+        }
+      catch(...)
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if(!_error)
+            _error = std::current_exception();
+        }
+
+      if(--_remaining == 0)
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::run(std::size_t n, unsigned int nworkers, const masa_chunk_body& body)
+{
+  std::lock_guard<std::mutex> job(_job_mutex);
+
+  if(_workers.size() + 1 != _nthreads)
+    start();
+
+  if(nworkers > _nthreads)
+    nworkers = _nthreads;
+
+  // deal contiguous blocks of chunks to the participants
+  const std::size_t nchunks = std::min<std::size_t>(n,nworkers * chunks_per_worker);
+  for(unsigned int w = 0; w < nworkers; w++)
+    {
+      std::size_t cbegin = nchunks *  w    / nworkers;
+      std::size_t cend   = nchunks * (w+1) / nworkers;
+      for(std::size_t c = cbegin; c < cend; c++)
+        _queues[w].chunks.push_back(chunk(n * c / nchunks, n * (c+1) / nchunks));
+    }
+
+  execute(nworkers,nchunks,true,body);
+}
+
+void ThreadPool::run_static(const std::vector<std::size_t>& partition, unsigned int nworkers,
+                            const masa_chunk_body& body)
+{
+  std::lock_guard<std::mutex> job(_job_mutex);
+
+  if(_workers.size() + 1 != _nthreads)
+    start();
+
+  if(nworkers > _nthreads)
+    nworkers = _nthreads;
+
+  // slab s always goes to worker s % nworkers, like an OpenMP static schedule
+  const std::size_t nslabs = partition.size() - 1;
+  for(std::size_t s = 0; s < nslabs; s++)
+    _queues[s % nworkers].chunks.push_back(chunk(partition[s],partition[s+1]));
+
+  execute(nworkers,nslabs,false,body);
+}
+
+void ThreadPool::execute(unsigned int nworkers, std::size_t nchunks, bool steal,
+                         const masa_chunk_body& body)
+{
+  _body      = &body;
+  _error     = std::exception_ptr();
+  _remaining = nchunks;
+  _steal     = steal;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _active    = nworkers;
+    _accepting = true;
+    _generation++;
+  }
+  _wake.notify_all();
+
+  in_pool = true;
+  drain(0);
+  in_pool = false;
+
+  // no worker may still be looking at the queues when the next job
+  // refills them, so wait for the stragglers as well as the chunks
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [&]{ return _remaining == 0; });
+    _accepting = false;
+    _done.wait(lock, [&]{ return _busy == 0; });
+  }
+  _body = 0;
+
+  if(_error)
+    std::rethrow_exception(_error);
+}
+
+void pool_forked();
+
+ThreadPool& pool()
+{
+  static ThreadPool masa_pool;
+  static bool registered = pthread_atfork(0,0,pool_forked) == 0;
+  (void)registered;
+  return masa_pool;
+}
+
+void pool_forked()
+{
+  pool().forked();
+}
+
+//
+//  checks every coordinate array has as many points as the first
+//
+template <typename Scalar>
+int check_batch(const char* name, std::size_t n, const std::vector<Scalar>& coords)
+{
+  if(coords.size() != n)
+    {
+      std::cout << "MASA ERROR:: " << name << " needs coordinate arrays of equal length"
+                << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+} // end anonymous namespace
+
+// ------------------------------------------------------
+// ---------- internal pool interface --------------------
+// ------------------------------------------------------
+
+unsigned int MASA::masa_pool_workers(std::size_t n)
+{
+  // nested batches run serially on the thread that issued them
+  if(in_pool || n < 2)
+    return 1;
+
+  return std::min<std::size_t>(pool().size(),n);
+}
+
+void MASA::masa_parallel_for(std::size_t n, unsigned int nworkers, const masa_chunk_body& body)
+{
+  if(n == 0)
+    return;
+
+  if(nworkers <= 1 || in_pool)
+    {
+      body(0,n,0);
+      return;
+    }
+
+  pool().run(n,nworkers,body);
+}
+
+void MASA::masa_parallel_static(const std::vector<std::size_t>& partition, unsigned int nworkers,
+                                const masa_chunk_body& body)
+{
+  if(partition.size() < 2 || partition.back() == 0)
+    return;
+
+  if(nworkers <= 1 || in_pool)
+    {
+      body(0,partition.back(),0);
+      return;
+    }
+
+  pool().run_static(partition,nworkers,body);
+}
+
+//
+//  a partition is a list of slab offsets 0 = p[0] <= p[1] <= ... <= p[S] = n
+//
+int MASA::masa_check_partition(const char* name, std::size_t n, const std::vector<std::size_t>& partition)
+{
+  if(partition.empty())
+    return 0;
+
+  bool valid = partition.size() >= 2 && partition.front() == 0 && partition.back() == n;
+  for(std::size_t s = 1; valid && s < partition.size(); s++)
+    valid = partition[s-1] <= partition[s];
+
+  if(!valid)
+    {
+      std::cout << "MASA ERROR:: " << name << " was passed a partition that does not cover all "
+                << n << " points in order" << std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+//
+//  sets the number of threads used for batch and grid evaluations,
+//  0 restores the default (MASA_NUM_THREADS, or all hardware threads)
+//
+int MASA::masa_pool_set_threads(int n)
+{
+  if(n < 0)
+    {
+      std::cout << "MASA ERROR:: number of threads must be positive (or 0 for the default)"
+                << std::endl;
+      return 1;
+    }
+
+  pool().resize(n ? n : default_threads());
+  return 0;
+}
+
+int MASA::masa_pool_threads()
+{
+  return pool().size();
+}
+
+// ------------------------------------------------------
+// ---------- static partitions and field allocation ------
+// ------------------------------------------------------
+
+//
+//  splits nplanes planes of plane_size points into nslabs slabs the
+//  same way an OpenMP schedule(static) loop over the planes does: the
+//  first nplanes % nslabs slabs get one extra plane
+//
+int MASA::masa_static_partition(std::size_t nplanes, std::size_t plane_size, int nslabs,
+                                std::vector<std::size_t>& partition)
+{
+  if(nslabs < 0)
+    {
+      std::cout << "MASA ERROR:: number of slabs must be positive (or 0 for one per thread)"
+                << std::endl;
+      return 1;
+    }
+
+  const std::size_t slabs = nslabs ? nslabs : masa_pool_threads();
+  const std::size_t q     = nplanes / slabs;
+  const std::size_t r     = nplanes % slabs;
+
+  partition.resize(slabs+1);
+  partition[0] = 0;
+  for(std::size_t s = 0; s < slabs; s++)
+    partition[s+1] = partition[s] + (q + (s < r ? 1 : 0)) * plane_size;
+
+  return 0;
+}
+
+//
+//  the pages of the field are first touched by the thread that will
+//  later evaluate (and, with a matching partition, solve on) each slab
+//
+template <typename Scalar>
+Scalar* MASA::masa_alloc_field(std::size_t n, const std::vector<std::size_t>& partition)
+{
+  if(masa_check_partition("masa_alloc_field",n,partition))
+    return 0;
+
+  void* mem = 0;
+  if(n == 0 || posix_memalign(&mem,4096,n * sizeof(Scalar)) != 0)
+    {
+      std::cout << "MASA ERROR:: masa_alloc_field unable to allocate " << n << " values"
+                << std::endl;
+      return 0;
+    }
+
+  Scalar* field = static_cast<Scalar*>(mem);
+  masa_chunk_body touch = [&](std::size_t begin, std::size_t end, unsigned int)
+    {
+      for(std::size_t i = begin; i < end; i++)
+        field[i] = 0;
+    };
+
+  if(partition.empty())
+    {
+      std::vector<std::size_t> slabs;
+      masa_static_partition(n,1,0,slabs);
+      masa_parallel_static(slabs,masa_pool_workers(slabs.size()-1),touch);
+    }
+  else
+    masa_parallel_static(partition,masa_pool_workers(partition.size()-1),touch);
+
+  return field;
+}
+
+template <typename Scalar>
+void MASA::masa_free_field(Scalar* field)
+{
+  free(field);
+}
+
+// ------------------------------------------------------
+// ---------- batch evaluation ---------------------------
+// ------------------------------------------------------
+
+template <typename Scalar>
+int MASA::masa_eval_1d_batch(Scalar (*func)(Scalar),std::size_t n,
+                             const Scalar* x,Scalar* out,
+                             const std::vector<std::size_t>& partition)
+{
+  if(masa_check_partition("masa_eval_1d_batch",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t i = begin; i < end; i++)
+        out[i] = func(x[i]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_2d_batch(Scalar (*func)(Scalar,Scalar),std::size_t n,
+                             const Scalar* x,const Scalar* y,Scalar* out,
+                             const std::vector<std::size_t>& partition)
+{
+  if(masa_check_partition("masa_eval_2d_batch",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t i = begin; i < end; i++)
+        out[i] = func(x[i],y[i]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_3d_batch(Scalar (*func)(Scalar,Scalar,Scalar),std::size_t n,
+                             const Scalar* x,const Scalar* y,const Scalar* z,Scalar* out,
+                             const std::vector<std::size_t>& partition)
+{
+  if(masa_check_partition("masa_eval_3d_batch",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t i = begin; i < end; i++)
+        out[i] = func(x[i],y[i],z[i]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_4d_batch(Scalar (*func)(Scalar,Scalar,Scalar,Scalar),std::size_t n,
+                             const Scalar* x,const Scalar* y,const Scalar* z,const Scalar* t,
+                             Scalar* out,const std::vector<std::size_t>& partition)
+{
+  if(masa_check_partition("masa_eval_4d_batch",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t i = begin; i < end; i++)
+        out[i] = func(x[i],y[i],z[i],t[i]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_1d_batch(Scalar (*func)(Scalar),
+                             const std::vector<Scalar>& x,
+                             std::vector<Scalar>& out)
+{
+  out.resize(x.size());
+  return masa_eval_1d_batch(func,x.size(),x.data(),out.data());
+}
+
+template <typename Scalar>
+int MASA::masa_eval_2d_batch(Scalar (*func)(Scalar,Scalar),
+                             const std::vector<Scalar>& x,
+                             const std::vector<Scalar>& y,
+                             std::vector<Scalar>& out)
+{
+  if(check_batch("masa_eval_2d_batch",x.size(),y))
+    return 1;
+
+  out.resize(x.size());
+  return masa_eval_2d_batch(func,x.size(),x.data(),y.data(),out.data());
+}
+
+template <typename Scalar>
+int MASA::masa_eval_3d_batch(Scalar (*func)(Scalar,Scalar,Scalar),
+                             const std::vector<Scalar>& x,
+                             const std::vector<Scalar>& y,
+                             const std::vector<Scalar>& z,
+                             std::vector<Scalar>& out)
+{
+  if(check_batch("masa_eval_3d_batch",x.size(),y) ||
+     check_batch("masa_eval_3d_batch",x.size(),z))
+    return 1;
+
+  out.resize(x.size());
+  return masa_eval_3d_batch(func,x.size(),x.data(),y.data(),z.data(),out.data());
+}
+
+template <typename Scalar>
+int MASA::masa_eval_4d_batch(Scalar (*func)(Scalar,Scalar,Scalar,Scalar),
+                             const std::vector<Scalar>& x,
+                             const std::vector<Scalar>& y,
+                             const std::vector<Scalar>& z,
+                             const std::vector<Scalar>& t,
+                             std::vector<Scalar>& out)
+{
+  if(check_batch("masa_eval_4d_batch",x.size(),y) ||
+     check_batch("masa_eval_4d_batch",x.size(),z) ||
+     check_batch("masa_eval_4d_batch",x.size(),t))
+    return 1;
+
+  out.resize(x.size());
+  return masa_eval_4d_batch(func,x.size(),x.data(),y.data(),z.data(),t.data(),out.data());
+}
+
+// ------------------------------------------------------
+// ---------- grid evaluation ----------------------------
+// ------------------------------------------------------
+
+template <typename Scalar>
+int MASA::masa_eval_2d_grid(Scalar (*func)(Scalar,Scalar),
+                            const std::vector<Scalar>& x,
+                            const std::vector<Scalar>& y,
+                            Scalar* out,
+                            const std::vector<std::size_t>& partition)
+{
+  const std::size_t nx = x.size();
+  const std::size_t n  = nx * y.size();
+
+  if(masa_check_partition("masa_eval_2d_grid",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t p = begin; p < end; p++)
+        out[p] = func(x[p % nx],y[p / nx]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_3d_grid(Scalar (*func)(Scalar,Scalar,Scalar),
+                            const std::vector<Scalar>& x,
+                            const std::vector<Scalar>& y,
+                            const std::vector<Scalar>& z,
+                            Scalar* out,
+                            const std::vector<std::size_t>& partition)
+{
+  const std::size_t nx  = x.size();
+  const std::size_t nxy = nx * y.size();
+  const std::size_t n   = nxy * z.size();
+
+  if(masa_check_partition("masa_eval_3d_grid",n,partition))
+    return 1;
+
+  return masa_parallel_eval<Scalar>(n,[&](std::size_t begin, std::size_t end)
+    {
+      for(std::size_t p = begin; p < end; p++)
+        out[p] = func(x[p % nx],y[(p % nxy) / nx],z[p / nxy]);
+    },partition);
+}
+
+template <typename Scalar>
+int MASA::masa_eval_2d_grid(Scalar (*func)(Scalar,Scalar),
+                            const std::vector<Scalar>& x,
+                            const std::vector<Scalar>& y,
+                            std::vector<Scalar>& out)
+{
+  out.resize(x.size() * y.size());
+  return masa_eval_2d_grid(func,x,y,out.data());
+}
+
+template <typename Scalar>
+int MASA::masa_eval_3d_grid(Scalar (*func)(Scalar,Scalar,Scalar),
+                            const std::vector<Scalar>& x,
+                            const std::vector<Scalar>& y,
+                            const std::vector<Scalar>& z,
+                            std::vector<Scalar>& out)
+{
+  out.resize(x.size() * y.size() * z.size());
+  return masa_eval_3d_grid(func,x,y,z,out.data());
+}
+
+// Instantiate for every precision
+
+#define INSTANTIATE_THREADED_FUNCTIONS(Scalar) \
+  template Scalar* masa_alloc_field<Scalar>(std::size_t,const std::vector<std::size_t>&); \
+  template void masa_free_field<Scalar>(Scalar*); \
+  template int masa_eval_1d_batch<Scalar>(Scalar (*)(Scalar),std::size_t,const Scalar*,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_2d_batch<Scalar>(Scalar (*)(Scalar,Scalar),std::size_t,const Scalar*,const Scalar*,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_3d_batch<Scalar>(Scalar (*)(Scalar,Scalar,Scalar),std::size_t,const Scalar*,const Scalar*,const Scalar*,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_4d_batch<Scalar>(Scalar (*)(Scalar,Scalar,Scalar,Scalar),std::size_t,const Scalar*,const Scalar*,const Scalar*,const Scalar*,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_1d_batch<Scalar>(Scalar (*)(Scalar),const std::vector<Scalar>&,std::vector<Scalar>&); \
+  template int masa_eval_2d_batch<Scalar>(Scalar (*)(Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,std::vector<Scalar>&); \
+  template int masa_eval_3d_batch<Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,std::vector<Scalar>&); \
+  template int masa_eval_4d_batch<Scalar>(Scalar (*)(Scalar,Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,std::vector<Scalar>&); \
+  template int masa_eval_2d_grid <Scalar>(Scalar (*)(Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_3d_grid <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,Scalar*,const std::vector<std::size_t>&); \
+  template int masa_eval_2d_grid <Scalar>(Scalar (*)(Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,std::vector<Scalar>&); \
+  template int masa_eval_3d_grid <Scalar>(Scalar (*)(Scalar,Scalar,Scalar),const std::vector<Scalar>&,const std::vector<Scalar>&,const std::vector<Scalar>&,std::vector<Scalar>&)
+
+namespace MASA {
+
+INSTANTIATE_THREADED_FUNCTIONS(double);
+#ifndef MASA_OMIT_FLOAT
+INSTANTIATE_THREADED_FUNCTIONS(float);
+#endif
+#ifndef MASA_OMIT_LONGDOUBLE
+INSTANTIATE_THREADED_FUNCTIONS(long double);
+#endif
+#ifndef MASA_OMIT_DOUBLEDOUBLE
+INSTANTIATE_THREADED_FUNCTIONS(DoubleDouble);
+#endif
+
+}
@@ -24,7 +24,7 @@
 
 #include <masa_internal.h>
 
-#include <ad_masa.h>
+#include <ad_residual.h>
 
 
 
@@ -95,125 +95,64 @@ int MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::init_var()
 // Source Terms
 // ----------------------------------------
 
-// u component of velocity source term
+// momentum source terms at a point, from one derivative sweep shared
+// by all of them
 template <typename Scalar>
-Scalar MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_q_u(Scalar x1, Scalar y1, Scalar z1)
+const Scalar* MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_residual(Scalar x1, Scalar y1, Scalar z1) const
 {
   typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
   typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
   typedef DualNumber<SecondDerivType, NumberArray<NDIM, SecondDerivType> > ThirdDerivType;
   typedef ThirdDerivType ADScalar;
 
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Arbitrary manufactured solutions
-  U[0]       = a * helper_f(beta,kx,x)                  * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z).derivatives()[2];
-  U[1]       = b * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z).derivatives()[2];
-  U[2]       = c * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z);
-  ADScalar P = d * helper_f(beta,kx,x)                  * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z);
-
-  // NS equation residuals
-  NumberArray<NDIM, Scalar> Q_u = 
-    raw_value(
-
-	      // convective term
-	      -divergence(U.outerproduct(U))
-
-	      // pressure
-	      - P.derivatives()
-
-	      // dissipation
-	      + nu * divergence(gradient(U)));
-
-  return -Q_u[0];
+  typedef ad_incompressible_ns<Scalar, NDIM> Operator;
+
+  const Scalar point[NDIM] = {x1, y1, z1};
+  const Scalar* cached = fused.find(this->revision,point);
+  if(cached)
+    return cached;
+
+  Scalar Q[3];
+  ad_residual<ADScalar>(Operator(nu,-1),
+    [this](const NumberArray<NDIM, ADScalar>& X, typename Operator::template state<ADScalar>& s)
+    {
+      const ADScalar& x = X[0];
+      const ADScalar& y = X[1];
+      const ADScalar& z = X[2];
+
+      // Arbitrary manufactured solutions
+      s.U[0]     = a * helper_f(beta,kx,x)                  * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z).derivatives()[2];
+      s.U[1]     = b * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z).derivatives()[2];
+      s.U[2]     = c * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z);
+      s.P        = d * helper_f(beta,kx,x)                  * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z);
+    },
+    point,Q);
+
+  return fused.store(this->revision,point,Q);
+}
 
+// u component of velocity source term
+template <typename Scalar>
+Scalar MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_q_u(Scalar x1, Scalar y1, Scalar z1)
+{
+  return eval_residual(x1,y1,z1)[0];
 }
 
 // v component of velocity source term
 template <typename Scalar>
 Scalar MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_q_v(Scalar x1, Scalar y1, Scalar z1)
 {
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef DualNumber<SecondDerivType, NumberArray<NDIM, SecondDerivType> > ThirdDerivType;
-  typedef ThirdDerivType ADScalar;
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Arbitrary manufactured solutions
-  U[0]       = a * helper_f(beta,kx,x)                  * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z).derivatives()[2];
-  U[1]       = b * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z).derivatives()[2];
-  U[2]       = c * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z);
-  ADScalar P = d * helper_f(beta,kx,x)                  * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z);
-
-  // NS equation residuals
-  NumberArray<NDIM, Scalar> Q_u = 
-    raw_value(
-
-	      // convective term
-	      -divergence(U.outerproduct(U))
-
-	      // pressure
-	      - P.derivatives()
-
-	      // dissipation
-	      + nu * divergence(gradient(U)));
-
-  return -Q_u[1];
-
+  return eval_residual(x1,y1,z1)[1];
 }
 
 // w component of velocity source term
 template <typename Scalar>
 Scalar MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_q_w(Scalar x1, Scalar y1, Scalar z1)
 {
-  typedef DualNumber<Scalar, NumberArray<NDIM, Scalar> > FirstDerivType;
-  typedef DualNumber<FirstDerivType, NumberArray<NDIM, FirstDerivType> > SecondDerivType;
-  typedef DualNumber<SecondDerivType, NumberArray<NDIM, SecondDerivType> > ThirdDerivType;
-  typedef ThirdDerivType ADScalar;
-
-  // Treat velocity as a vector
-  NumberArray<NDIM, ADScalar> U;
-
-  ADScalar x = ADScalar(x1,NumberArrayUnitVector<NDIM, 0, Scalar>::value());
-  ADScalar y = ADScalar(y1,NumberArrayUnitVector<NDIM, 1, Scalar>::value());
-  ADScalar z = ADScalar(z1,NumberArrayUnitVector<NDIM, 2, Scalar>::value());
-
-  // Arbitrary manufactured solutions
-  U[0]       = a * helper_f(beta,kx,x)                  * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z).derivatives()[2];
-  U[1]       = b * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z).derivatives()[2];
-  U[2]       = c * helper_f(beta,kx,x).derivatives()[0] * helper_g(delta,ky,y).derivatives()[1] * helper_h(gamma,kz,z);
-  ADScalar P = d * helper_f(beta,kx,x)                  * helper_g(delta,ky,y)                  * helper_h(gamma,kz,z);
-
-  // NS equation residuals
-  NumberArray<NDIM, Scalar> Q_u = 
-    raw_value(
-
-	      // convective term
-	      -divergence(U.outerproduct(U))
-
-	      // pressure
-	      - P.derivatives()
-
-	      // dissipation
-	      + nu * divergence(gradient(U)));
-
-  return -Q_u[2];
-
+  return eval_residual(x1,y1,z1)[2];
 }
 
 
-
 // ----------------------------------------
 // Analytical Terms
 // ----------------------------------------
@@ -300,7 +239,9 @@ Scalar MASA::navierstokes_3d_incompressible_homogeneous<Scalar>::eval_exact_p(Sc
 // Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::navierstokes_3d_incompressible_homogeneous);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_incompressible_homogeneous
+MASA_INSTANTIATE_SCALARS(MASA::navierstokes_3d_incompressible_homogeneous);
+#endif
 
 
 
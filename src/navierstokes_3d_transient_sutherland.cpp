@@ -39,6 +39,7 @@ MASA::navierstokes_3d_transient_sutherland<Scalar>::navierstokes_3d_transient_su
 {
   this->mmsname = "navierstokes_3d_transient_sutherland";
   this->dimension = 4;
+  this->transient = true;
 
   this->register_var("L",&L);
   this->register_var("Lt",&Lt);
@@ -399,7 +400,9 @@ Scalar MASA::navierstokes_3d_transient_sutherland<Scalar>::eval_exact_w(Scalar x
 // Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_navierstokes_3d_transient_sutherland
 MASA_INSTANTIATE_ALL(MASA::navierstokes_3d_transient_sutherland);
+#endif
 
 
 
@@ -56,6 +56,7 @@ MASA::navierstokes_4d_compressible_powerlaw<Scalar>::navierstokes_4d_compressibl
 {
   this->mmsname   = "navierstokes_4d_compressible_powerlaw";
   this->dimension = 4; // x + y + z + t = 4
+  this->transient = true;
 
   // Register parameters using nsctpl::manufactured_solution::foreach_parameter
   registration_helper<Scalar> rh(this);
@@ -89,8 +90,145 @@ int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::init_var()
   return 0;
 }
 
+// ----------------------------------------
+//   Full Gradient and Hessian of Solution
+// ----------------------------------------
+
+namespace {
+
+// spatial gradient of one nsctpl primitive solution
+template <typename Primitive, typename Scalar>
+void primitive_gradient(const Primitive& f, Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  g[0] = f._x(x,y,z,t);
+  g[1] = f._y(x,y,z,t);
+  g[2] = f._z(x,y,z,t);
+}
+
+// spatial hessian (row-major, symmetric) of one nsctpl primitive solution
+template <typename Primitive, typename Scalar>
+void primitive_hessian(const Primitive& f, Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  h[0] = f._xx(x,y,z,t);
+  h[4] = f._yy(x,y,z,t);
+  h[8] = f._zz(x,y,z,t);
+  h[1] = h[3] = f._xy(x,y,z,t);
+  h[2] = h[6] = f._xz(x,y,z,t);
+  h[5] = h[7] = f._yz(x,y,z,t);
+}
+
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_rho(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  primitive_gradient(this->rho,x,y,z,t,g);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_u(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  primitive_gradient(this->u,x,y,z,t,g);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_v(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  primitive_gradient(this->v,x,y,z,t,g);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_w(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  primitive_gradient(this->w,x,y,z,t,g);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_t(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  primitive_gradient(this->T,x,y,z,t,g);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_rho(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  primitive_hessian(this->rho,x,y,z,t,h);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_u(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  primitive_hessian(this->u,x,y,z,t,h);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_v(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  primitive_hessian(this->v,x,y,z,t,h);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_w(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  primitive_hessian(this->w,x,y,z,t,h);
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_t(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  primitive_hessian(this->T,x,y,z,t,h);
+  return 0;
+}
+
+// p = rho R T: the product rule reuses rho, T and their derivatives
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_grad_p(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* g)
+{
+  const Scalar rho = this->rho(x,y,z,t);
+  const Scalar T   = this->T(x,y,z,t);
+  Scalar grho[3], gT[3];
+
+  primitive_gradient(this->rho,x,y,z,t,grho);
+  primitive_gradient(this->T,  x,y,z,t,gT);
+
+  for(int i = 0; i < 3; i++)
+    g[i] = this->R * (grho[i] * T + rho * gT[i]);
+
+  return 0;
+}
+
+template <typename Scalar>
+int MASA::navierstokes_4d_compressible_powerlaw<Scalar>::eval_hess_p(Scalar x, Scalar y, Scalar z, Scalar t, Scalar* h)
+{
+  const Scalar rho = this->rho(x,y,z,t);
+  const Scalar T   = this->T(x,y,z,t);
+  Scalar grho[3], gT[3], hrho[9], hT[9];
+
+  primitive_gradient(this->rho,x,y,z,t,grho);
+  primitive_gradient(this->T,  x,y,z,t,gT);
+  primitive_hessian (this->rho,x,y,z,t,hrho);
+  primitive_hessian (this->T,  x,y,z,t,hT);
+
+  for(int i = 0; i < 3; i++)
+    for(int j = 0; j < 3; j++)
+      h[3*i+j] = this->R * (hrho[3*i+j] * T + grho[i] * gT[j] + gT[i] * grho[j] + rho * hT[3*i+j]);
+
+  return 0;
+}
+
 // ----------------------------------------
 //   Template Instantiation(s)
 // ----------------------------------------
 
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_nsctpl
 MASA_INSTANTIATE_ALL(MASA::navierstokes_4d_compressible_powerlaw);
+#endif
@@ -291,6 +291,8 @@ NumberArray_std_unary(cosh)
 NumberArray_std_unary(tanh)
 NumberArray_std_unary(sqrt)
 NumberArray_std_unary(abs)
+NumberArray_std_unary(fabs)
+NumberArray_std_unary(erf)
 NumberArray_std_binary(max)
 NumberArray_std_binary(min)
 NumberArray_std_unary(ceil)
@@ -101,7 +101,7 @@ int MASA::radiation_integrated_intensity<Scalar>::init_var()
   err += this->set_var("no_gauss",25);
 
   // set size of vectors and set default values
-  vec_mean.resize(no_gauss);
+  vec_mean.resize(int(no_gauss));
   vec_mean[0]=0.2;
   for(int it = 1;it<int(vec_mean.size());it++)
     {
@@ -110,7 +110,7 @@ int MASA::radiation_integrated_intensity<Scalar>::init_var()
     }
 
   
-  vec_amp.resize(no_gauss);
+  vec_amp.resize(int(no_gauss));
   vec_amp[0] = 7.4462631920000945;
   vec_amp[1] = 6.6885970491068861;
   vec_amp[2] = 9.5002692320883099;
@@ -137,8 +137,8 @@ int MASA::radiation_integrated_intensity<Scalar>::init_var()
   vec_amp[23]= 8.2387298156815334;
   vec_amp[24]= 7.2546185321547242;
   
-  vec_stdev.resize(no_gauss);    
-  vec_amp.resize(no_gauss);
+  vec_stdev.resize(int(no_gauss));    
+  vec_amp.resize(int(no_gauss));
   for(int it = 0;it<int(vec_amp.size());it++)
     {
       vec_stdev[it]=0.05; 
@@ -246,4 +246,6 @@ Scalar MASA::radiation_integrated_intensity<Scalar>::phi(Scalar x)
 //   Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::radiation_integrated_intensity);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_radiation
+MASA_INSTANTIATE_SCALARS(MASA::radiation_integrated_intensity);
+#endif
@@ -362,4 +362,6 @@ Scalar MASA::rans_sa<Scalar>::vt(Scalar eta)
 //   Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::rans_sa);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_rans_sa
+MASA_INSTANTIATE_SCALARS(MASA::rans_sa);
+#endif
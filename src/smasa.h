@@ -36,10 +36,6 @@
 #include <vector>
 #include <stdlib.h>
 
-// Macro for declaring MASA classes with all supported Scalar types
-#define MASA_INSTANTIATE_ALL(my_class) template class my_class<double>; \
-                                       template class my_class<long double>
-
 namespace MASA 
 {
 
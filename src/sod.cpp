@@ -75,6 +75,7 @@ MASA::sod_1d<Scalar>::sod_1d()
 {
   this->mmsname = "sod_1d";
   this->dimension=1;
+  this->transient=true;
 
   this->register_var("Gamma",&Gamma);
   this->register_var("mu",&mu);
@@ -446,4 +447,6 @@ Scalar MASA::sod_1d<Scalar>::rtbis(Scalar x1,Scalar x2,Scalar xacc,int JMAX)
 //   Template Instantiation(s)
 // ----------------------------------------
 
-MASA_INSTANTIATE_ALL(MASA::sod_1d);
+#if MASA_ALL_SOLUTIONS || MASA_SOLUTION_sod
+MASA_INSTANTIATE_SCALARS(MASA::sod_1d);
+#endif
@@ -95,7 +95,9 @@ int main()
 
 #ifndef portland_compiler
   err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
   err += run_regression<long double>();
+#endif
 #endif
 
   return err;
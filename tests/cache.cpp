@@ -0,0 +1,201 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// cache.cpp: program that tests the on-disk cache of batch and grid
+//            evaluations
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace MASA;
+using namespace std;
+
+const char* cache_dir = "cache_test_dir";
+
+int evaluations = 0;
+
+template<typename Scalar>
+Scalar counted_source(Scalar x,Scalar y,Scalar z)
+{
+  evaluations++;
+  return masa_eval_source_t<Scalar>(x,y,z);
+}
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: cache " << what << "\n";
+  exit(1);
+}
+
+int entries(bool remove_all = false)
+{
+  int count = 0;
+  DIR* d = opendir(cache_dir);
+  if(d == 0)
+    return 0;
+  for(struct dirent* e = readdir(d); e; e = readdir(d))
+    {
+      string name = e->d_name;
+      if(name == "." || name == "..")
+        continue;
+      count++;
+      if(remove_all)
+        unlink((string(cache_dir) + "/" + name).c_str());
+    }
+  closedir(d);
+  return count;
+}
+
+template<typename Scalar>
+void check(const Scalar* view,const std::vector<Scalar>& expect,const char* what)
+{
+  if(view == 0)
+    fail(what);
+  for(unsigned int i = 0; i < expect.size(); i++)
+    if(view[i] != expect[i])
+      fail(what);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  entries(true);
+  masa_enable_cache(cache_dir,size_t(1) << 30);
+
+  masa_init<Scalar>("cache-test","heateq_3d_steady_const");
+  masa_init_param<Scalar>();
+
+  std::vector<Scalar> x(9),y(8),z(7),expect;
+  for(unsigned int i = 0; i < x.size(); i++) x[i] = Scalar(i)/8;
+  for(unsigned int j = 0; j < y.size(); j++) y[j] = Scalar(j)/7;
+  for(unsigned int k = 0; k < z.size(); k++) z[k] = Scalar(k)/6;
+  masa_eval_3d_grid<Scalar>(masa_eval_source_t<Scalar>,x,y,z,expect);
+
+  // first request evaluates and stores, the second maps the stored file
+  evaluations = 0;
+  const Scalar* first = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  check(first,expect,"first evaluation");
+  if(evaluations != int(expect.size()) || entries() != 1)
+    fail("did not store the first evaluation");
+
+  const Scalar* second = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  check(second,expect,"cache hit");
+  if(evaluations != int(expect.size()))
+    fail("re-evaluated an identical request");
+
+  masa_release_view(first);
+  masa_release_view(second);
+
+  // new parameters or coordinates are a new entry
+  masa_set_param<Scalar>("k_0",Scalar(2.5));
+  const Scalar* other = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  if(evaluations != 2*int(expect.size()) || entries() != 2 || other[3] == expect[3])
+    fail("hit with different parameters");
+  masa_release_view(other);
+
+  x[0] = Scalar(-0.5);
+  other = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  if(evaluations != 3*int(expect.size()) || entries() != 3)
+    fail("hit with different coordinates");
+  masa_release_view(other);
+
+  // room for a single entry: older entries are evicted
+  masa_enable_cache(cache_dir,expect.size() * sizeof(Scalar) + 100);
+  x[0] = Scalar(-0.25);
+  other = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  if(entries() != 1)
+    fail("did not evict least recently used entries");
+  masa_release_view(other);
+
+  // concurrent processes sharing the directory all see complete entries
+  masa_enable_cache(cache_dir,size_t(1) << 30);
+  masa_init_param<Scalar>();
+  x[0] = 0;
+  std::vector<pid_t> children;
+  for(int c = 0; c < 4; c++)
+    {
+      pid_t pid = fork();
+      if(pid == 0)
+        {
+          for(int rep = 0; rep < 20; rep++)
+            {
+              const Scalar* v = masa_eval_3d_grid_cached<Scalar>(masa_eval_source_t<Scalar>,x,y,z);
+              for(unsigned int i = 0; i < expect.size(); i++)
+                if(v == 0 || v[i] != expect[i])
+                  _exit(1);
+              masa_release_view(v);
+            }
+          _exit(0);
+        }
+      children.push_back(pid);
+    }
+
+  for(unsigned int c = 0; c < children.size(); c++)
+    {
+      int status;
+      waitpid(children[c],&status,0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        fail("returned a bad entry to a concurrent process");
+    }
+
+  // without a cache directory the values are simply evaluated
+  masa_disable_cache();
+  evaluations = 0;
+  const Scalar* plain = masa_eval_3d_grid_cached<Scalar>(counted_source<Scalar>,x,y,z);
+  check(plain,expect,"uncached evaluation");
+  if(evaluations != int(expect.size()))
+    fail("used the cache after masa_disable_cache");
+  masa_release_view(plain);
+
+  if(masa_release_view(plain) != 1)
+    fail("released a view twice");
+
+  entries(true);
+  rmdir(cache_dir);
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  // the children of the concurrency test restart the thread pool
+  masa_set_num_threads(2);
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
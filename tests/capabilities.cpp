@@ -0,0 +1,127 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// capabilities.cpp: program that tests the capability bits of solutions
+//                   and of their fields
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: capabilities " << what << "\n";
+  exit(1);
+}
+
+template<typename Scalar>
+int field(const string& name)
+{
+  int dims = -1;
+  if(masa_get_field_capabilities<Scalar>(name,&dims))
+    fail("cannot query a field");
+  return dims;
+}
+
+template<typename Scalar>
+int solution()
+{
+  int caps = -1;
+  if(masa_get_capabilities<Scalar>(&caps))
+    fail("cannot query a solution");
+  return caps;
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  vector<string> fields;
+  vector<int> dims;
+
+  // steady, two dimensional, with gradients and no vectors
+  masa_init<Scalar>("euler","euler_2d");
+  if(field<Scalar>("q_rho_u") != MASA_CAP_2D || field<Scalar>("exact_rho") != MASA_CAP_2D)
+    fail("misses the euler_2d fields");
+  if(field<Scalar>("q_rho_w") || field<Scalar>("q_t") || field<Scalar>("no_such_field"))
+    fail("reports fields euler_2d does not have");
+  if(field<Scalar>("grad_u") != MASA_CAP_2D)
+    fail("misses the euler_2d gradients");
+  if((solution<Scalar>() & (MASA_CAP_1D | MASA_CAP_2D | MASA_CAP_3D | MASA_CAP_4D)) != MASA_CAP_2D ||
+     !(solution<Scalar>() & MASA_CAP_GRADIENT) ||
+     (solution<Scalar>() & (MASA_CAP_TRANSIENT | MASA_CAP_VECTORS)))
+    fail("describes euler_2d wrongly");
+
+  // every listed field is one the queries report
+  masa_get_fields<Scalar>(fields,dims);
+  if(fields.empty() || fields.size() != dims.size())
+    fail("does not list the euler_2d fields");
+  for(unsigned int i = 0; i != fields.size(); i++)
+    if(dims[i] == 0 || field<Scalar>(fields[i]) != dims[i])
+      fail("lists fields the queries do not report");
+
+  // time is the last coordinate
+  masa_init<Scalar>("transient","euler_transient_1d");
+  if(!(solution<Scalar>() & MASA_CAP_TRANSIENT) || field<Scalar>("q_rho") != MASA_CAP_2D)
+    fail("describes euler_transient_1d wrongly");
+
+  // vector parameters
+  masa_init<Scalar>("radiation","radiation_integrated_intensity");
+  if(!(solution<Scalar>() & MASA_CAP_VECTORS) || field<Scalar>("q_u") != MASA_CAP_1D)
+    fail("describes radiation_integrated_intensity wrongly");
+
+  // a solution with no terms at all
+  masa_init<Scalar>("nothing","masa_uninit");
+  masa_get_fields<Scalar>(fields,dims);
+  if(solution<Scalar>() != 0 || !fields.empty())
+    fail("gives masa_uninit capabilities");
+
+  // solutions of masa_init_expr know theirs from the equations
+  masa_init_expr<Scalar>("expr","heat_1d_unsteady","T = A * sin(x) * cos(t); A = 2; k = 1; cp = 1; rho = 1");
+  if(field<Scalar>("q_t") != MASA_CAP_2D || field<Scalar>("exact_t") != MASA_CAP_2D ||
+     field<Scalar>("q_rho") || !(solution<Scalar>() & MASA_CAP_TRANSIENT))
+    fail("describes heat_1d_unsteady wrongly");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
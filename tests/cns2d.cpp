@@ -452,7 +452,9 @@ int main()
   int err=0;
 
   err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
   err += run_regression<long double>();
+#endif
 
   return err;
 }
@@ -0,0 +1,116 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// cse.cpp: program that tests the source terms rewritten by
+//          cse_utils/masa_cse.pl against their Maple originals
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cse_check.h>
+
+using namespace std;
+
+// Evaluates both forms of a source term at random parameters and
+// points. The rewrite keeps the order of the operations, so the
+// results agree bit for bit, or with --enable-cse-powers, differ
+// only by the rounding of the pow() calls it replaced: a few ulps of
+// the size of the terms summed up.
+template <typename Scalar>
+struct tester
+{
+  unsigned int terms;
+  unsigned int failures;
+
+  tester() : terms(0), failures(0) { srand(31415); }
+
+  template <typename Check>
+  void operator()(Check& c)
+  {
+    vector<Scalar*> m;
+    c.members(m);
+
+    const Scalar tol = 8 * numeric_limits<Scalar>::epsilon();
+    Scalar p[4];
+
+    terms++;
+    for(int trial = 0; trial != 200; trial++)
+      {
+        for(unsigned int i = 0; i != m.size(); i++)
+          *m[i] = 0.5 + Scalar(rand()) / RAND_MAX;
+        for(unsigned int d = 0; d != Check::dims; d++)
+          p[d] = 0.1 + 0.8 * Scalar(rand()) / RAND_MAX;
+
+        Scalar maple = c.maple(p);
+        Scalar cse   = c.cse(p);
+
+        if(std::isnan(maple) && std::isnan(cse))
+          continue;
+
+        if(masa_cse_check::exact ? maple != cse : !(fabs(maple - cse) <= tol * c.magnitude(p)))
+          {
+            cout << "\nMASA REGRESSION TEST FAILED: cse " << Check::name() << "\n";
+            cout.precision(numeric_limits<Scalar>::digits10 + 2);
+            cout << "maple = " << maple << ", cse = " << cse << "\n";
+            failures++;
+            return;
+          }
+      }
+  }
+};
+
+template <typename Scalar>
+int run()
+{
+  tester<Scalar> t;
+  masa_cse_check::check_all<Scalar>(t);
+
+  if(t.terms == 0)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: cse found no source terms\n";
+      return 1;
+    }
+  return t.failures != 0;
+}
+
+int main()
+{
+  int err = 0;
+
+  err += run<double>();
+  err += run<long double>();
+
+  return err;
+}
@@ -0,0 +1,118 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// derived_constants.cpp: program that tests that the parameter constants
+//                        folded out of the source terms follow the parameters
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: derived_constants " << what << "\n";
+  exit(1);
+}
+
+// the selected euler_2d solution against a fresh instance with the
+// same parameters, at every point
+template<typename Scalar>
+void check(const vector<Scalar>& x, const vector<Scalar>& y, const vector<Scalar>& q, const char* what)
+{
+  const char* params[] = {"u_0", "u_x", "u_y", "v_0", "v_x", "v_y", "rho_0", "rho_x", "rho_y",
+                          "p_0", "p_x", "p_y", "a_px", "a_py", "a_rhox", "a_rhoy", "a_ux", "a_uy",
+                          "a_vx", "a_vy", "Gamma", "mu", "k", "L"};
+  vector<Scalar> values;
+  for(unsigned int i = 0; i != sizeof(params)/sizeof(params[0]); i++)
+    values.push_back(masa_get_param<Scalar>(params[i]));
+
+  masa_init<Scalar>("fresh","euler_2d");
+  for(unsigned int i = 0; i != values.size(); i++)
+    masa_set_param<Scalar>(params[i],values[i]);
+  for(unsigned int i = 0; i != x.size(); i++)
+    if(masa_eval_source_rho_u<Scalar>(x[i],y[i]) != q[i])
+      fail(what);
+  masa_select_mms<Scalar>("euler");
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const unsigned int n = 300;
+  vector<Scalar> x(n),y(n),q;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(i)/n;
+      y[i] = Scalar(i%13)/13;
+    }
+
+  masa_init<Scalar>("euler","euler_2d");
+  masa_init_param<Scalar>();
+
+  // point evaluations before and after changes of the parameters the
+  // constants derive from
+  const char* changes[] = {"a_rhox", "rho_x", "a_uy", "L", "a_px"};
+  for(int c = 0; c != 5; c++)
+    {
+      q.resize(n);
+      for(unsigned int i = 0; i != n; i++)
+        q[i] = masa_eval_source_rho_u<Scalar>(x[i],y[i]);
+      check(x,y,q,"after a parameter change");
+      masa_set_param<Scalar>(changes[c],masa_get_param<Scalar>(changes[c]) * Scalar(1.5));
+    }
+
+  // the worker threads evaluate copies, brought up to date before
+  // every batch
+  masa_set_num_threads(4);
+  for(int c = 0; c != 5; c++)
+    {
+      masa_set_param<Scalar>(changes[c],masa_get_param<Scalar>(changes[c]) * Scalar(0.75));
+      masa_eval_2d_batch<Scalar>(masa_eval_source_rho_u<Scalar>,x,y,q);
+      check(x,y,q,"in a batch after a parameter change");
+    }
+  masa_set_num_threads(0);
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
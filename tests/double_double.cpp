@@ -0,0 +1,141 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// double_double.cpp: program that tests the DoubleDouble Scalar and the
+//                    double-double evaluations
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <doubledouble.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: double_double " << what << "\n";
+  exit(1);
+}
+
+// a within a few units of 2^-104 of the reference pair (hi,lo)
+void check(const string& what, const DoubleDouble& a, double hi, double lo)
+{
+  DoubleDouble ref(hi,lo);
+  if(fabs((a - ref).hi()) > 16 * numeric_limits<DoubleDouble>::epsilon().hi() * fabs(hi))
+    fail(what);
+}
+
+int main()
+{
+#if defined(MASA_OMIT_DOUBLEDOUBLE) || defined(MASA_OMIT_LONGDOUBLE)
+  // skipped: this build left out the doubledouble and long double instances
+  return 77;
+#else
+  // reference values to 60 digits, rounded to pairs
+  const DoubleDouble x = 0.7;
+  check("sin", sin(x),         0.644217687237691,    2.8740567927338755e-18);
+  check("cos", cos(x),         0.7648421872844885,  -4.013780434022238e-17);
+  check("exp", exp(x),         2.0137527074704766,  -2.0058243549764793e-16);
+  check("log", log(x),        -0.35667494393873245,  4.82556379937662e-18);
+  check("sqrt", sqrt(x),       0.8366600265340756,  -4.12265279558505e-17);
+  check("atan", atan(x),       0.6107259643892086,   2.2418914462967458e-17);
+  check("erf", erf(x),         0.6778011938374184,   5.860416063065593e-18);
+  check("erf tail", erf(DoubleDouble(3.5)), 0.9999992569016276, 4.9647279187212204e-17);
+  check("pow", pow(x,2.5),     0.409963413001697,   -2.1147976179140544e-17);
+  check("sin reduction", sin(DoubleDouble(100.0)), -0.5063656411097588, -3.050947053792115e-18);
+  check("division", DoubleDouble(1.0)/3.0 * 3.0, 1.0, 0.0);
+
+  for(int i = -40; i <= 40; i++)
+    {
+      DoubleDouble a = 0.37 * i;
+      DoubleDouble s = sin(a), c = cos(a);
+      check("pythagoras", s*s + c*c, 1.0, 0.0);
+      check("exp and log", log(exp(a)) + 1.0, (a + 1.0).hi(), (a + 1.0).lo());
+    }
+
+  // the solutions themselves, against long double
+  const long double leps = numeric_limits<long double>::epsilon();
+  masa_init<long double>("ld","navierstokes_3d_compressible");
+  masa_init_param<long double>();
+  masa_init<DoubleDouble>("dd","navierstokes_3d_compressible");
+  masa_init_param<DoubleDouble>();
+  if(masa_sanity_check<DoubleDouble>())
+    fail("parameters");
+
+  const unsigned int n = 53;
+  vector<double> px(n),py(n),pz(n),hi,lo;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      px[i] = double(i)/n;
+      py[i] = double(i%7)/7 + 0.05;
+      pz[i] = double(i%11)/11 + 0.05;
+
+      long double q = masa_eval_source_rho_e<long double>(px[i],py[i],pz[i]);
+      DoubleDouble qq = masa_eval_source_rho_e<DoubleDouble>(px[i],py[i],pz[i]);
+      if(fabsl(static_cast<long double>(qq) - q) > 1.0e4 * leps * max(1.0L,fabsl(q)))
+        fail("source term far from the long double one");
+    }
+
+  // double-double evaluation of the selected double solution
+  masa_init<double>("ns","navierstokes_3d_compressible");
+  masa_init_param<double>();
+
+  for(int pass = 0; pass < 2; pass++)
+    {
+      if(masa_eval_3d_dd("q_rho_e",px,py,pz,hi,lo))
+        fail("evaluation");
+      if(hi.size() != n || lo.size() != n)
+        fail("size");
+
+      // the same arithmetic as the DoubleDouble instance, given the
+      // double parameters (a_ux is 5/3 rounded to double)
+      masa_set_param<DoubleDouble>("a_ux",masa_get_param<double>("a_ux"));
+      masa_set_param<DoubleDouble>("mu",masa_get_param<double>("mu"));
+      for(unsigned int i = 0; i < n; i++)
+        {
+          if(fabs(lo[i]) > 0.5 * fabs(hi[i]) * numeric_limits<double>::epsilon())
+            fail("result pair not normalized");
+
+          DoubleDouble q = masa_eval_source_rho_e<DoubleDouble>(px[i],py[i],pz[i]);
+          if(q.hi() != hi[i] || q.lo() != lo[i])
+            fail("result differs from the DoubleDouble instance");
+        }
+
+      // parameter changes reach the double-double instance
+      masa_set_param<double>("mu",masa_get_param<double>("mu")*2);
+    }
+
+  if(masa_eval_3d_dd("no_such_term",px,py,pz,hi,lo) != 1)
+    fail("accepted an unknown term");
+
+  return 0;
+#endif
+}
@@ -0,0 +1,159 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// ensemble.cpp: program that tests the evaluation of many parameter
+//               sets in one call against evaluating each in turn
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <functional>
+
+using namespace MASA;
+using namespace std;
+
+const double thresh = 1.0e-13;
+
+// neither is a multiple of the lane count
+const unsigned int members = 7;
+const unsigned int n = 103;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: ensemble " << what << "\n";
+  exit(1);
+}
+
+// the selected solution with each of params scaled by 1 + k/10 in member k
+vector<double> ensemble_params(const vector<string>& params)
+{
+  vector<double> base,row,rows;
+
+  masa_save_params<double>(base);
+  for(unsigned int k = 0; k != members; k++)
+    {
+      masa_load_params<double>(base);
+      for(unsigned int p = 0; p != params.size(); p++)
+        masa_set_param<double>(params[p],masa_get_param<double>(params[p]) * (1 + 0.1*k));
+      masa_save_params<double>(row);
+      rows.insert(rows.end(),row.begin(),row.end());
+    }
+  masa_load_params<double>(base);
+  return rows;
+}
+
+// out against value(i) at point i, for each member set in turn; the
+// parameters must have been left as they were
+void check(const vector<double>& rows, const vector<double>& out,
+           const function<double(unsigned int)>& value, const string& what)
+{
+  vector<double> base;
+  masa_save_params<double>(base);
+
+  if(out.size() != members * n)
+    fail(what + " size");
+
+  const vector<double>::size_type np = rows.size() / members;
+  for(unsigned int k = 0; k != members; k++)
+    {
+      masa_load_params<double>(vector<double>(rows.begin() + k*np,rows.begin() + (k+1)*np));
+      for(unsigned int i = 0; i != n; i++)
+        {
+          const double expect = value(i);
+          nancheck(out[k*n + i]);
+          if(fabs(out[k*n + i] - expect) > thresh * max(1.0,fabs(expect)))
+            fail(what);
+        }
+    }
+  masa_load_params<double>(base);
+}
+
+void run(const vector<double>& x, const vector<double>& y, const vector<double>& z)
+{
+  vector<double> rows,out,before,after;
+
+  // several members per lane instance call
+  masa_init<double>("euler","euler_2d");
+  masa_init_param<double>();
+  masa_save_params<double>(before);
+  rows = ensemble_params({"u_0", "a_rhox", "Gamma"});
+  if(masa_eval_2d_ensemble("q_rho_u",rows,x,y,out))
+    fail("euler_2d");
+  masa_save_params<double>(after);
+  if(after != before)
+    fail("euler_2d changed the parameters");
+  check(rows,out,[&](unsigned int i) { return masa_eval_source_rho_u<double>(x[i],y[i]); },"euler_2d");
+
+  // one member at a time
+  masa_init<double>("ad_cns","ad_cns_3d_crossterms");
+  masa_init_param<double>();
+  rows = ensemble_params({"u_0", "a_ux", "mu"});
+  if(masa_eval_3d_ensemble("exact_u",rows,x,y,z,out))
+    fail("ad_cns_3d_crossterms");
+  check(rows,out,[&](unsigned int i) { return masa_eval_exact_u<double>(x[i],y[i],z[i]); },"ad_cns_3d_crossterms");
+
+  // members differing in the amplitude share sin(w * x)
+  masa_init_expr<double>("expr","heat_1d","T = A * sin(w * x) + B * x * x; A = 2.5; w = 3; B = 0.5; k = 2");
+  rows = ensemble_params({"A", "B"});
+  if(masa_eval_1d_ensemble("q_t",rows,x,out))
+    fail("expr");
+  check(rows,out,[&](unsigned int i) { return masa_eval_source_t<double>(x[i]); },"expr");
+  rows = ensemble_params({"w"});
+  if(masa_eval_1d_ensemble("exact_t",rows,x,out))
+    fail("expr exact_t");
+  check(rows,out,[&](unsigned int i) { return masa_eval_exact_t<double>(x[i]); },"expr exact_t");
+
+  // malformed calls
+  rows.pop_back();
+  if(masa_eval_1d_ensemble("q_t",rows,x,out) != 1)
+    fail("accepted a partial parameter set");
+  rows = ensemble_params({"A"});
+  if(masa_eval_1d_ensemble("q_no_such_term",rows,x,out) != 1)
+    fail("accepted an unknown term");
+}
+
+int main()
+{
+  vector<double> x(n),y(n),z(n);
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = double(i)/n;
+      y[i] = double(i%7)/7 + 0.05;
+      z[i] = double(i%11)/11 + 0.05;
+    }
+
+  run(x,y,z);
+
+  // the members spread over the worker threads
+  masa_set_num_threads(4);
+  run(x,y,z);
+  masa_set_num_threads(0);
+
+  return 0;
+}
@@ -0,0 +1,335 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// expr.cpp: program that tests solutions defined by expression strings
+//           against the built in solutions with the same fields
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <string>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+const string euler_2d_definitions =
+  "# fields of euler_2d and navierstokes_2d_compressible\n"
+  "rho = rho_0 + rho_x * sin(a_rhox * pi * x / L) + rho_y * cos(a_rhoy * pi * y / L)\n"
+  "u   = u_0 + u_x * sin(a_ux * pi * x / L) + u_y * cos(a_uy * pi * y / L)\n"
+  "v   = v_0 + v_x * cos(a_vx * pi * x / L) + v_y * sin(a_vy * pi * y / L)\n"
+  "p   = p_0 + p_x * cos(a_px * pi * x / L) + p_y * sin(a_py * pi * y / L)\n";
+
+const string cns_3d_definitions =
+  "rho = rho_0 + rho_x * sin(a_rhox * pi * x / L) + rho_y * cos(a_rhoy * pi * y / L) + rho_z * sin(a_rhoz * pi * z / L);"
+  "u = u_0 + u_x * sin(a_ux * pi * x / L) + u_y * cos(a_uy * pi * y / L) + u_z * cos(a_uz * pi * z / L);"
+  "v = v_0 + v_x * cos(a_vx * pi * x / L) + v_y * sin(a_vy * pi * y / L) + v_z * sin(a_vz * pi * z / L);"
+  "w = w_0 + w_x * sin(a_wx * pi * x / L) + w_y * sin(a_wy * pi * y / L) + w_z * cos(a_wz * pi * z / L);"
+  "p = p_0 + p_x * cos(a_px * pi * x / L) + p_y * sin(a_py * pi * y / L) + p_z * cos(a_pz * pi * z / L)";
+
+const string heat_2d_definitions =
+  "T  = cos(A_x * x + A_t * t) * cos(B_y * y + B_t * t) * cos(D_t * t)\n"
+  "k  = k_0\n"
+  "cp = cp_0\n";
+
+template<typename Scalar>
+void check(const string& what, Scalar expr, Scalar builtin, Scalar scale)
+{
+  const Scalar thresh = 1e4 * numeric_limits<Scalar>::epsilon();
+
+  nancheck(expr);
+  if(fabs(expr - builtin) > thresh * scale)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: expr " << what << "\n";
+      cout.precision(numeric_limits<Scalar>::digits10 + 2);
+      cout << "expression = " << expr << ", built in = " << builtin << "\n";
+      exit(1);
+    }
+}
+
+// parameters of the flow solutions: u_0, u_x, a_ux, ..., L
+vector<string> flow_params(int dim, bool viscous)
+{
+  const char* fields[] = {"rho", "p", "u", "v", "w"};
+  const char* coords[] = {"x", "y", "z"};
+  vector<string> names;
+
+  for(int f = 0; f != 2 + dim; f++)
+    {
+      names.push_back(string(fields[f]) + "_0");
+      for(int d = 0; d != dim; d++)
+        {
+          names.push_back(string(fields[f]) + "_" + coords[d]);
+          names.push_back(string("a_") + fields[f] + coords[d]);
+        }
+    }
+  names.push_back("L");
+  names.push_back("Gamma");
+  if(viscous)
+    {
+      names.push_back("mu");
+      names.push_back("k");
+      names.push_back("R");
+    }
+  return names;
+}
+
+template<typename Scalar>
+void copy_params(const string& from, const string& to, const vector<string>& names)
+{
+  for(unsigned int i = 0; i != names.size(); i++)
+    {
+      masa_select_mms<Scalar>(from);
+      Scalar value = masa_get_param<Scalar>(names[i]);
+      masa_select_mms<Scalar>(to);
+      masa_set_param<Scalar>(names[i],value);
+    }
+}
+
+template<typename Scalar>
+void compare_flow_2d(const string& builtin, const string& equations)
+{
+  masa_init<Scalar>("builtin",builtin);
+  masa_init_param<Scalar>();
+
+  if(masa_init_expr<Scalar>("expr",equations,euler_2d_definitions))
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_init_expr " << equations << "\n";
+      exit(1);
+    }
+  copy_params<Scalar>("builtin","expr",flow_params(2,equations != "euler_2d"));
+  if(masa_sanity_check<Scalar>())
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: " << equations << " parameters\n";
+      exit(1);
+    }
+
+  for(int i = 0; i != 20; i++)
+    for(int j = 0; j != 20; j++)
+      {
+        const Scalar x = Scalar(i) / 19;
+        const Scalar y = Scalar(j) / 23 + Scalar(0.1);
+        Scalar e[9], b[9];
+
+        masa_select_mms<Scalar>("expr");
+        e[0] = masa_eval_source_rho  <Scalar>(x,y);
+        e[1] = masa_eval_source_rho_u<Scalar>(x,y);
+        e[2] = masa_eval_source_rho_v<Scalar>(x,y);
+        e[3] = masa_eval_source_rho_e<Scalar>(x,y);
+        e[4] = masa_eval_exact_rho   <Scalar>(x,y);
+        e[5] = masa_eval_exact_u     <Scalar>(x,y);
+        e[6] = masa_eval_exact_v     <Scalar>(x,y);
+        e[7] = masa_eval_exact_p     <Scalar>(x,y);
+
+        masa_select_mms<Scalar>("builtin");
+        b[0] = masa_eval_source_rho  <Scalar>(x,y);
+        b[1] = masa_eval_source_rho_u<Scalar>(x,y);
+        b[2] = masa_eval_source_rho_v<Scalar>(x,y);
+        b[3] = masa_eval_source_rho_e<Scalar>(x,y);
+        b[4] = masa_eval_exact_rho   <Scalar>(x,y);
+        b[5] = masa_eval_exact_u     <Scalar>(x,y);
+        b[6] = masa_eval_exact_v     <Scalar>(x,y);
+        b[7] = masa_eval_exact_p     <Scalar>(x,y);
+
+        // the source terms are sums of terms of the size of rho*e*u/L
+        const Scalar scale = 1 + fabs(b[4] * b[5] * b[7]);
+        for(int k = 0; k != 8; k++)
+          check<Scalar>(equations + " term " + char('0'+k),e[k],b[k],k < 4 ? scale : 1 + fabs(b[k]));
+      }
+}
+
+template<typename Scalar>
+void compare_cns_3d()
+{
+  masa_init<Scalar>("builtin","navierstokes_3d_compressible");
+  masa_init_param<Scalar>();
+  masa_init_expr<Scalar>("expr","navierstokes_3d",cns_3d_definitions);
+  copy_params<Scalar>("builtin","expr",flow_params(3,true));
+
+  for(int i = 0; i != 5; i++)
+    for(int j = 0; j != 5; j++)
+      for(int l = 0; l != 5; l++)
+        {
+          const Scalar x = Scalar(i) / 5, y = Scalar(j) / 7 + Scalar(0.1), z = Scalar(l) / 3;
+          Scalar (*terms[])(Scalar,Scalar,Scalar) = {masa_eval_source_rho<Scalar>, masa_eval_source_rho_u<Scalar>,
+                                                     masa_eval_source_rho_v<Scalar>, masa_eval_source_rho_w<Scalar>,
+                                                     masa_eval_source_rho_e<Scalar>, masa_eval_exact_w<Scalar>};
+          masa_select_mms<Scalar>("builtin");
+          const Scalar scale = 1 + fabs(masa_eval_exact_rho<Scalar>(x,y,z) * masa_eval_exact_p<Scalar>(x,y,z) *
+                                        masa_eval_exact_u<Scalar>(x,y,z));
+          for(int k = 0; k != 6; k++)
+            {
+              masa_select_mms<Scalar>("builtin");
+              const Scalar b = terms[k](x,y,z);
+              masa_select_mms<Scalar>("expr");
+              check<Scalar>(string("navierstokes_3d term ") + char('0'+k),terms[k](x,y,z),b,scale);
+            }
+        }
+}
+
+template<typename Scalar>
+void compare_heat_2d_unsteady()
+{
+  const char* params[] = {"A_x", "A_t", "B_y", "B_t", "D_t", "k_0", "cp_0", "rho"};
+
+  masa_init<Scalar>("builtin","heateq_2d_unsteady_const");
+  masa_init_param<Scalar>();
+  masa_init_expr<Scalar>("expr","heat_2d_unsteady",heat_2d_definitions);
+  copy_params<Scalar>("builtin","expr",vector<string>(params,params+8));
+
+  for(int i = 0; i != 10; i++)
+    for(int j = 0; j != 10; j++)
+      {
+        const Scalar x = Scalar(i) / 9, y = Scalar(j) / 11, t = Scalar(i+j) / 7;
+
+        masa_select_mms<Scalar>("builtin");
+        const Scalar q = masa_eval_source_t<Scalar>(x,y,t);
+        const Scalar T = masa_eval_exact_t<Scalar>(x,y,t);
+
+        masa_select_mms<Scalar>("expr");
+        check<Scalar>("heat_2d_unsteady source",masa_eval_source_t<Scalar>(x,y,t),q,1 + fabs(q));
+        check<Scalar>("heat_2d_unsteady exact",masa_eval_exact_t<Scalar>(x,y,t),T,1);
+      }
+}
+
+// variable conductivity, and a parameter defined by its default value
+template<typename Scalar>
+void check_heat_1d()
+{
+  masa_init_expr<Scalar>("expr","Heat_1D","T = A * sin(x); A = 2.5; k = 1 + x");
+
+  if(masa_get_param<Scalar>("A") != Scalar(2.5))
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: expr default parameter\n";
+      exit(1);
+    }
+
+  for(int pass = 0; pass != 2; pass++)
+    {
+      const Scalar A = pass ? 3 : 2.5;
+      if(pass)
+        masa_set_param<Scalar>("A",A);
+
+      for(int i = 0; i != 10; i++)
+        {
+          const Scalar x = Scalar(i) / 9;
+          check<Scalar>("heat_1d variable conductivity",masa_eval_source_t<Scalar>(x),
+                        A * ((1 + x) * sin(x) - cos(x)),Scalar(1));
+          check<Scalar>("heat_1d exact",masa_eval_exact_t<Scalar>(x),A * sin(x),Scalar(1));
+        }
+    }
+
+  masa_init_param<Scalar>();
+  check<Scalar>("heat_1d masa_init_param",masa_eval_exact_t<Scalar>(Scalar(1)),Scalar(2.5) * sin(Scalar(1)),Scalar(1));
+}
+
+// definitions that must be refused, leaving the selected solution alone
+template<typename Scalar>
+void check_errors()
+{
+  const char* bad[][2] = {
+    {"euler_2d",         "rho = 1; u = x; v = y"},          // no p
+    {"heat_2d",          "T = sin(z)"},                     // no z in 2d
+    {"heat_1d",          "T = sin(t)"},                     // nor t when steady
+    {"heat_2d",          "T = sin(x"},
+    {"heat_1d",          "T = a; a = T"},
+    {"heat_1d",          "T = x; T = 2*x"},
+    {"heat_1d",          "T = erf(x)"},
+    {"heat_1d",          "T = pow(x)"},
+    {"heat_1d",          "x = 1; T = x"},
+    {"stokes_2d",        "T = x"},
+    {"euler_4d",         "T = x"}};
+
+  masa_init_expr<Scalar>("good","heat_1d","T = x*x; k = 2");
+
+  for(unsigned int i = 0; i != sizeof(bad)/sizeof(bad[0]); i++)
+    if(masa_init_expr<Scalar>("bad",bad[i][0],bad[i][1]) == 0)
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: expr accepted " << bad[i][0] << ": " << bad[i][1] << "\n";
+        exit(1);
+      }
+
+  check<Scalar>("selection after errors",masa_eval_source_t<Scalar>(Scalar(0.5)),Scalar(-4),Scalar(1));
+}
+
+// the worker threads evaluate copies of the solution
+template<typename Scalar>
+void check_threads()
+{
+  const int n = 2000;
+  vector<Scalar> x(n),y(n),serial(n),batch;
+
+  for(int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(i)/n;
+      y[i] = Scalar(i%37 + 1)/38;
+    }
+
+  masa_set_num_threads(3);
+  masa_init<Scalar>("builtin","euler_2d");
+  masa_init_param<Scalar>();
+  masa_init_expr<Scalar>("threads","euler_2d",euler_2d_definitions);
+  copy_params<Scalar>("builtin","threads",flow_params(2,false));
+
+  for(int i = 0; i < n; i++)
+    serial[i] = masa_eval_source_rho_e<Scalar>(x[i],y[i]);
+  masa_eval_2d_batch<Scalar>(masa_eval_source_rho_e<Scalar>,x,y,batch);
+
+  for(int i = 0; i < n; i++)
+    if(batch[i] != serial[i])
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: expr batch differs at point " << i << "\n";
+        exit(1);
+      }
+  masa_set_num_threads(1);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  compare_flow_2d<Scalar>("euler_2d","euler_2d");
+  compare_flow_2d<Scalar>("navierstokes_2d_compressible","navierstokes_2d");
+  compare_cns_3d<Scalar>();
+  compare_heat_2d_unsteady<Scalar>();
+  check_heat_1d<Scalar>();
+  check_errors<Scalar>();
+  check_threads<Scalar>();
+
+  return 0;
+}
+
+int main()
+{
+  int err = 0;
+
+  err += run_regression<double>();
+  err += run_regression<long double>();
+
+  return err;
+}
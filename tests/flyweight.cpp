@@ -0,0 +1,121 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// flyweight.cpp: program that tests many instances of one solution,
+//                which share its parameter layout but not their values
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <sstream>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: flyweight " << what << "\n";
+  exit(1);
+}
+
+string member(unsigned int i)
+{
+  ostringstream name;
+  name << "member " << i;
+  return name.str();
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const unsigned int members = 1000;
+  const Scalar x = 0.3, y = 0.7;
+  vector<Scalar> q(members);
+
+  // every member has a mean velocity of its own
+  for(unsigned int i = 0; i != members; i++)
+    {
+      if(masa_init<Scalar>(member(i),"euler_2d"))
+        fail("cannot create a member");
+      masa_init_param<Scalar>();
+      masa_set_param<Scalar>("u_0",Scalar(1 + i) / members);
+      if(masa_sanity_check<Scalar>())
+        fail("creates a member with uninitialized parameters");
+    }
+
+  for(unsigned int i = 0; i != members; i++)
+    {
+      masa_select_mms<Scalar>(member(i));
+      if(masa_get_param<Scalar>("u_0") != Scalar(1 + i) / members)
+        fail("shares parameter values between members");
+      q[i] = masa_eval_source_rho_u<Scalar>(x,y);
+      if(i && q[i] == q[i-1])
+        fail("evaluates members with the parameters of another");
+    }
+
+  // changing one member leaves the others alone
+  masa_select_mms<Scalar>(member(0));
+  masa_set_param<Scalar>("a_rhox",masa_get_param<Scalar>("a_rhox") + 1);
+  for(unsigned int i = 1; i != members; i++)
+    {
+      masa_select_mms<Scalar>(member(i));
+      if(masa_eval_source_rho_u<Scalar>(x,y) != q[i])
+        fail("changes a member through another");
+    }
+
+  // a snapshot of one member restores another exactly
+  vector<Scalar> saved;
+  masa_select_mms<Scalar>(member(members-1));
+  masa_save_params<Scalar>(saved);
+  masa_select_mms<Scalar>(member(1));
+  if(masa_load_params<Scalar>(saved) ||
+     masa_eval_source_rho_u<Scalar>(x,y) != q[members-1])
+    fail("does not copy parameters between members");
+
+  // the members of other solutions keep their own layout
+  masa_init<Scalar>("other","euler_1d");
+  masa_init_param<Scalar>();
+  if(masa_param_count<Scalar>() == 24 || masa_sanity_check<Scalar>())
+    fail("gives euler_1d the parameters of euler_2d");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
@@ -0,0 +1,172 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+// $Author$
+// $Id$
+//
+// grad_hess.cpp: program that tests the full gradient and hessian
+//                evaluations against the component-wise gradients and
+//                finite differences
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+
+using namespace MASA;
+using namespace std;
+
+typedef int (*grad_func_3d)(double,double,double,double*);
+typedef double (*comp_func_3d)(double,double,double,int);
+
+typedef int (*grad_func_2d)(double,double,double*);
+typedef double (*comp_func_2d)(double,double,int);
+typedef double (*exact_func_2d)(double,double);
+
+// relative difference, guarded against tiny denominators
+double reldiff(double a, double b)
+{
+  return fabs(a-b)/max(1.0,fabs(b));
+}
+
+// gradient must agree with the component-wise gradient, and the
+// hessian with a central difference of the gradient
+int check_3d(grad_func_3d grad, grad_func_3d hess, comp_func_3d comp,
+             double x, double y, double z)
+{
+  double g[3], h[9], gp[3], gm[3];
+  const double eps = 1e-6;
+
+  grad(x,y,z,g);
+  for(int i = 0; i < 3; i++)
+    threshcheck(reldiff(g[i],comp(x,y,z,i+1)),1e-13);
+
+  hess(x,y,z,h);
+  for(int j = 0; j < 3; j++)
+    {
+      double xp[3] = {x,y,z};
+      double xm[3] = {x,y,z};
+      xp[j] += eps;
+      xm[j] -= eps;
+      grad(xp[0],xp[1],xp[2],gp);
+      grad(xm[0],xm[1],xm[2],gm);
+      for(int i = 0; i < 3; i++)
+        threshcheck(reldiff(h[3*i+j],(gp[i]-gm[i])/(2*eps)),1e-6);
+    }
+
+  // symmetry
+  threshcheck(fabs(h[1]-h[3]),1e-13);
+  threshcheck(fabs(h[2]-h[6]),1e-13);
+  threshcheck(fabs(h[5]-h[7]),1e-13);
+
+  return 0;
+}
+
+int check_2d(grad_func_2d grad, grad_func_2d hess, exact_func_2d exact,
+             double x, double y)
+{
+  double g[2], h[4], gp[2], gm[2];
+  const double eps = 1e-6;
+
+  // gradient against a central difference of the exact solution
+  grad(x,y,g);
+  threshcheck(reldiff(g[0],(exact(x+eps,y)-exact(x-eps,y))/(2*eps)),1e-6);
+  threshcheck(reldiff(g[1],(exact(x,y+eps)-exact(x,y-eps))/(2*eps)),1e-6);
+
+  hess(x,y,h);
+  grad(x+eps,y,gp);
+  grad(x-eps,y,gm);
+  threshcheck(reldiff(h[0],(gp[0]-gm[0])/(2*eps)),1e-6);
+  threshcheck(reldiff(h[2],(gp[1]-gm[1])/(2*eps)),1e-6);
+  grad(x,y+eps,gp);
+  grad(x,y-eps,gm);
+  threshcheck(reldiff(h[1],(gp[0]-gm[0])/(2*eps)),1e-6);
+  threshcheck(reldiff(h[3],(gp[1]-gm[1])/(2*eps)),1e-6);
+
+  return 0;
+}
+
+int main()
+{
+  double g[3];
+  double x = 0.3, y = 0.7, z = 0.45;
+
+  // closed-form solutions, with shared subexpressions
+  masa_init<double>("cns3d","navierstokes_3d_compressible");
+  masa_init_param<double>();
+
+  check_3d(masa_eval_gradient_u  <double>,masa_eval_hessian_u  <double>,masa_eval_grad_u  <double>,x,y,z);
+  check_3d(masa_eval_gradient_v  <double>,masa_eval_hessian_v  <double>,masa_eval_grad_v  <double>,x,y,z);
+  check_3d(masa_eval_gradient_w  <double>,masa_eval_hessian_w  <double>,masa_eval_grad_w  <double>,x,y,z);
+  check_3d(masa_eval_gradient_p  <double>,masa_eval_hessian_p  <double>,masa_eval_grad_p  <double>,x,y,z);
+  check_3d(masa_eval_gradient_rho<double>,masa_eval_hessian_rho<double>,masa_eval_grad_rho<double>,x,y,z);
+
+  masa_init<double>("euler3d","euler_3d");
+  masa_init_param<double>();
+
+  check_3d(masa_eval_gradient_u  <double>,masa_eval_hessian_u  <double>,masa_eval_grad_u  <double>,x,y,z);
+  check_3d(masa_eval_gradient_rho<double>,masa_eval_hessian_rho<double>,masa_eval_grad_rho<double>,x,y,z);
+
+  // automatic differentiation
+  masa_init<double>("ad_cns_2d","ad_cns_2d_crossterms");
+  masa_init_param<double>();
+
+  check_2d(masa_eval_gradient_u  <double>,masa_eval_hessian_u  <double>,masa_eval_exact_u  <double>,x,y);
+  check_2d(masa_eval_gradient_v  <double>,masa_eval_hessian_v  <double>,masa_eval_exact_v  <double>,x,y);
+  check_2d(masa_eval_gradient_p  <double>,masa_eval_hessian_p  <double>,masa_eval_exact_p  <double>,x,y);
+  check_2d(masa_eval_gradient_rho<double>,masa_eval_hessian_rho<double>,masa_eval_exact_rho<double>,x,y);
+
+  // the default falls back on the component-wise gradient
+  masa_init<double>("cns2d","navierstokes_2d_compressible");
+  masa_init_param<double>();
+  if(masa_eval_gradient_u<double>(x,y,g) != 0)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: gradient of u reported unavailable\n";
+      exit(1);
+    }
+  threshcheck(fabs(g[0]-masa_eval_grad_u<double>(x,y,1)),1e-13);
+  threshcheck(fabs(g[1]-masa_eval_grad_u<double>(x,y,2)),1e-13);
+
+  // and reports a field the solution does not have
+  if(masa_eval_gradient_w<double>(x,y,g) == 0)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: missing gradient of w reported available\n";
+      exit(1);
+    }
+
+  // time-varying solution: compare against the component-wise gradient
+  masa_init<double>("nsctpl","navierstokes_4d_compressible_powerlaw");
+  double t = 0.2, h[9], hp[9];
+  masa_eval_gradient_p<double>(x,y,z,t,g);
+  for(int i = 0; i < 3; i++)
+    threshcheck(reldiff(g[i],masa_eval_grad_p<double>(x,y,z,t,i+1)),1e-13);
+
+  masa_eval_hessian_p<double>(x,y,z,t,h);
+  masa_eval_gradient_p<double>(x+1e-6,y,z,t,hp);
+  masa_eval_gradient_p<double>(x-1e-6,y,z,t,g);
+  for(int i = 0; i < 3; i++)
+    threshcheck(reldiff(h[3*i],(hp[i]-g[i])/2e-6),1e-6);
+
+  return 0;
+}
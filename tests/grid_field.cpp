@@ -0,0 +1,131 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// grid_field.cpp: program that tests the fields of registered grids
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: grid_field " << what << "\n";
+  exit(1);
+}
+
+template<typename Scalar>
+void check(const Scalar* field,const std::vector<Scalar>& expect,const char* what)
+{
+  if(field == 0)
+    fail(what);
+  for(unsigned int i = 0; i < expect.size(); i++)
+    if(field[i] != expect[i])
+      fail(what);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const unsigned int n = 500;
+  std::vector<Scalar> x(n),y(n),z(n),expect;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(i)/n;
+      y[i] = Scalar(i%7)/7;
+      z[i] = Scalar(i%11)/11;
+    }
+
+  masa_init<Scalar>("grid-3d","euler_3d");
+  masa_init_param<Scalar>();
+
+  int grid = masa_register_grid<Scalar>(&x[0],&y[0],&z[0],n);
+  if(grid <= 0)
+    fail("did not register a 3D grid");
+
+  // the first request evaluates, later ones return the same array
+  masa_eval_3d_batch<Scalar>(masa_eval_source_rho_u<Scalar>,x,y,z,expect);
+  const Scalar* rho_u = masa_grid_field<Scalar>(grid,"q_rho_u");
+  check(rho_u,expect,"q_rho_u");
+  if(masa_grid_field<Scalar>(grid,"q_rho_u") != rho_u)
+    fail("did not return the stored field");
+
+  masa_eval_3d_batch<Scalar>(masa_eval_exact_p<Scalar>,x,y,z,expect);
+  check(masa_grid_field<Scalar>(grid,"exact_p"),expect,"exact_p");
+
+  // a parameter change reevaluates in place
+  masa_set_param<Scalar>("u_0",masa_get_param<Scalar>("u_0")*2);
+  masa_eval_3d_batch<Scalar>(masa_eval_source_rho_u<Scalar>,x,y,z,expect);
+  if(masa_grid_field<Scalar>(grid,"q_rho_u") != rho_u)
+    fail("moved the field when reevaluating");
+  check(rho_u,expect,"q_rho_u after a parameter change");
+
+  // so does selecting another solution
+  masa_init<Scalar>("grid-3d-ns","navierstokes_3d_compressible");
+  masa_init_param<Scalar>();
+  masa_eval_3d_batch<Scalar>(masa_eval_source_rho_u<Scalar>,x,y,z,expect);
+  check(masa_grid_field<Scalar>(grid,"q_rho_u"),expect,"q_rho_u of another solution");
+
+  if(masa_grid_field<Scalar>(grid,"q_no_such_field") != 0)
+    fail("returned an unknown field");
+
+  if(masa_evict_field<Scalar>(grid,"q_rho_u") != 0)
+    fail("did not evict a field");
+  check(masa_grid_field<Scalar>(grid,"q_rho_u"),expect,"q_rho_u after eviction");
+
+  // 1D grids
+  masa_init<Scalar>("grid-1d","euler_1d");
+  masa_init_param<Scalar>();
+  int line = masa_register_grid<Scalar>(&x[0],(const Scalar*)0,(const Scalar*)0,n);
+  masa_eval_1d_batch<Scalar>(masa_eval_source_rho_e<Scalar>,x,expect);
+  check(masa_grid_field<Scalar>(line,"q_rho_e"),expect,"1D q_rho_e");
+  if(masa_grid_field<Scalar>(line,"q_f") != 0)
+    fail("returned a 2D field on a 1D grid");
+
+  if(masa_release_grid<Scalar>(grid) != 0 || masa_release_grid<Scalar>(line) != 0)
+    fail("did not release the grids");
+  if(masa_release_grid<Scalar>(grid) != 1 || masa_grid_field<Scalar>(grid,"q_rho_u") != 0)
+    fail("accepted a released grid");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
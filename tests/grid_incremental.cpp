@@ -0,0 +1,181 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// grid_incremental.cpp: registered grids of expression solutions
+//                       recompute only what a parameter change affects
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <string>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+const string cns_3d_definitions =
+  "rho = rho_0 + rho_x * sin(a_rhox * pi * x / L) + rho_y * cos(a_rhoy * pi * y / L) + rho_z * sin(a_rhoz * pi * z / L);"
+  "u = u_0 + u_x * sin(a_ux * pi * x / L) + u_y * cos(a_uy * pi * y / L) + u_z * cos(a_uz * pi * z / L);"
+  "v = v_0 + v_x * cos(a_vx * pi * x / L) + v_y * sin(a_vy * pi * y / L) + v_z * sin(a_vz * pi * z / L);"
+  "w = w_0 + w_x * sin(a_wx * pi * x / L) + w_y * sin(a_wy * pi * y / L) + w_z * cos(a_wz * pi * z / L);"
+  "p = p_0 + p_x * cos(a_px * pi * x / L) + p_y * sin(a_py * pi * y / L) + p_z * cos(a_pz * pi * z / L)";
+
+const char* const names[] = {"q_rho", "q_rho_u", "q_rho_v", "q_rho_w", "q_rho_e", "exact_rho", "exact_p"};
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: grid_incremental " << what << "\n";
+  exit(1);
+}
+
+// every field on the grid against the point evaluations
+template<typename Scalar>
+void check_all(int grid, const vector<Scalar>& x, const vector<Scalar>& y, const vector<Scalar>& z,
+               const string& what)
+{
+  Scalar (*funcs[])(Scalar,Scalar,Scalar) = {masa_eval_source_rho<Scalar>, masa_eval_source_rho_u<Scalar>,
+                                             masa_eval_source_rho_v<Scalar>, masa_eval_source_rho_w<Scalar>,
+                                             masa_eval_source_rho_e<Scalar>, masa_eval_exact_rho<Scalar>,
+                                             masa_eval_exact_p<Scalar>};
+  const Scalar thresh = 1e4 * numeric_limits<Scalar>::epsilon();
+
+  for(int f = 0; f != 7; f++)
+    {
+      vector<Scalar> expect;
+      masa_eval_3d_batch<Scalar>(funcs[f],x,y,z,expect);
+      Scalar scale = 1;
+      for(unsigned int i = 0; i != expect.size(); i++)
+        scale = max(scale,Scalar(fabs(expect[i])));
+
+      const Scalar* values = masa_grid_field<Scalar>(grid,names[f]);
+      if(values == 0)
+        fail(what + ": no " + names[f]);
+      for(unsigned int i = 0; i != expect.size(); i++)
+        {
+          nancheck(values[i]);
+          if(fabs(values[i] - expect[i]) > thresh * scale)
+            fail(what + ": " + names[f]);
+        }
+    }
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const unsigned int n = 1000;
+  vector<Scalar> x(n),y(n),z(n);
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(i)/n;
+      y[i] = Scalar(i%7)/7 + Scalar(0.1);
+      z[i] = Scalar(i%11)/11;
+    }
+
+  // the parameters of the builtin solution
+  const char* fields[] = {"rho", "p", "u", "v", "w"};
+  const char* dirs[]   = {"x", "y", "z"};
+  vector<string> params;
+  for(int f = 0; f != 5; f++)
+    {
+      params.push_back(string(fields[f]) + "_0");
+      for(int d = 0; d != 3; d++)
+        {
+          params.push_back(string(fields[f]) + "_" + dirs[d]);
+          params.push_back(string("a_") + fields[f] + dirs[d]);
+        }
+    }
+  const char* constants[] = {"L", "Gamma", "mu", "k", "R"};
+  params.insert(params.end(),constants,constants+5);
+
+  masa_init<Scalar>("builtin","navierstokes_3d_compressible");
+  masa_init_param<Scalar>();
+  if(masa_init_expr<Scalar>("expr","navierstokes_3d",cns_3d_definitions) != 0)
+    fail("did not compile the definitions");
+  for(unsigned int i = 0; i != params.size(); i++)
+    {
+      masa_select_mms<Scalar>("builtin");
+      const Scalar value = masa_get_param<Scalar>(params[i]);
+      masa_select_mms<Scalar>("expr");
+      masa_set_param<Scalar>(params[i],value);
+    }
+
+  int grid = masa_register_grid<Scalar>(&x[0],&y[0],&z[0],n);
+  check_all<Scalar>(grid,x,y,z,"first evaluation");
+
+  // a viscosity sweep: the first change keeps the columns independent
+  // of mu, the next ones reuse them
+  const Scalar mu = masa_get_param<Scalar>("mu");
+  for(int s = 1; s <= 4; s++)
+    {
+      masa_set_param<Scalar>("mu",mu * (1 + s));
+      check_all<Scalar>(grid,x,y,z,"mu sweep");
+    }
+
+  // the exact fields do not depend on mu, and are left alone: a value
+  // overwritten since survives another change of mu
+  Scalar* rho = const_cast<Scalar*>(masa_grid_field<Scalar>(grid,"exact_rho"));
+  const Scalar saved = rho[0];
+  rho[0] = -1;
+  masa_set_param<Scalar>("mu",mu);
+  if(masa_grid_field<Scalar>(grid,"exact_rho") != rho || rho[0] != -1)
+    fail("reevaluated exact_rho after a change of mu");
+  rho[0] = saved;
+
+  // other parameters start over
+  masa_set_param<Scalar>("Gamma",masa_get_param<Scalar>("Gamma") * Scalar(1.1));
+  check_all<Scalar>(grid,x,y,z,"Gamma change");
+  masa_set_param<Scalar>("k",masa_get_param<Scalar>("k") * 3);
+  masa_set_param<Scalar>("rho_x",masa_get_param<Scalar>("rho_x") * Scalar(0.5));
+  check_all<Scalar>(grid,x,y,z,"k and rho_x change");
+  masa_set_param<Scalar>("k",masa_get_param<Scalar>("k") / 2);
+  check_all<Scalar>(grid,x,y,z,"k change");
+  masa_set_param<Scalar>("mu",mu * 10);
+  check_all<Scalar>(grid,x,y,z,"mu change after k");
+
+  // switching solutions back and forth
+  masa_select_mms<Scalar>("builtin");
+  check_all<Scalar>(grid,x,y,z,"builtin solution");
+  masa_select_mms<Scalar>("expr");
+  check_all<Scalar>(grid,x,y,z,"expression solution again");
+
+  masa_release_grid<Scalar>(grid);
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
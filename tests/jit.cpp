@@ -0,0 +1,207 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+// $Author$
+// $Id$
+//
+// jit.cpp: program that tests the native code compiled for solutions
+//          defined by expression strings against their bytecode
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+const string definitions =
+  "rho = rho_0 + rho_x * sin(a_rhox * pi * x / L) + rho_y * cos(a_rhoy * pi * y / L)\n"
+  "u   = u_0 + u_x * sin(a_ux * pi * x / L) + u_y * cos(a_uy * pi * y / L)\n"
+  "v   = v_0 + v_x * cos(a_vx * pi * x / L) + v_y * sin(a_vy * pi * y / L)\n"
+  "p   = p_0 + p_x * cos(a_px * pi * x / L) + p_y * sin(a_py * pi * y / L)\n"
+  "mu  = mu_0 * (1 + x^2)\n";
+
+const char* const params[] = {
+  "rho_0", "rho_x", "rho_y", "a_rhox", "a_rhoy", "u_0", "u_x", "u_y", "a_ux", "a_uy",
+  "v_0", "v_x", "v_y", "a_vx", "a_vy", "p_0", "p_x", "p_y", "a_px", "a_py",
+  "L", "Gamma", "mu_0", "k", "R"};
+
+const int npoints = 200;
+
+// the source terms and exact fields at npoints points
+template<typename Scalar>
+vector<Scalar> evaluate()
+{
+  vector<Scalar> v;
+  for(int i = 0; i != npoints; i++)
+    {
+      const Scalar x = Scalar(i % 17) / 16;
+      const Scalar y = Scalar(i % 13) / 12 + Scalar(0.1);
+      v.push_back(masa_eval_source_rho  <Scalar>(x,y));
+      v.push_back(masa_eval_source_rho_u<Scalar>(x,y));
+      v.push_back(masa_eval_source_rho_v<Scalar>(x,y));
+      v.push_back(masa_eval_source_rho_e<Scalar>(x,y));
+      v.push_back(masa_eval_exact_rho   <Scalar>(x,y));
+      v.push_back(masa_eval_exact_u     <Scalar>(x,y));
+      v.push_back(masa_eval_exact_p     <Scalar>(x,y));
+    }
+  return v;
+}
+
+template<typename Scalar>
+void init(const string& handle)
+{
+  if(masa_init_expr<Scalar>(handle,"navierstokes_2d",definitions))
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_init_expr\n";
+      exit(1);
+    }
+  for(unsigned int i = 0; i != sizeof(params)/sizeof(params[0]); i++)
+    masa_set_param<Scalar>(params[i],Scalar(0.5) + Scalar(i % 7) / 5);
+}
+
+// number of shared objects in dir
+int count_objects(const string& dir)
+{
+  int n = 0;
+  DIR* d = opendir(dir.c_str());
+  while(dirent* e = d ? readdir(d) : 0)
+    {
+      const string name = e->d_name;
+      n += name.size() > 3 && name.compare(name.size()-3,3,".so") == 0;
+    }
+  if(d)
+    closedir(d);
+  return n;
+}
+
+template<typename Scalar>
+void compare(const string& what, const vector<Scalar>& native, const vector<Scalar>& bytecode)
+{
+  const Scalar thresh = 1e4 * numeric_limits<Scalar>::epsilon();
+
+  for(int k = 0; k != 7; k++)
+    {
+      Scalar scale = 1;
+      for(unsigned int i = k; i < bytecode.size(); i += 7)
+        scale = max(scale,Scalar(fabs(bytecode[i])));
+
+      for(unsigned int i = k; i < bytecode.size(); i += 7)
+        {
+          nancheck(native[i]);
+          if(fabs(native[i] - bytecode[i]) > thresh * scale)
+            {
+              cout << "\nMASA REGRESSION TEST FAILED: jit " << what << " value " << i << "\n";
+              cout.precision(numeric_limits<Scalar>::digits10 + 2);
+              cout << "native = " << native[i] << ", bytecode = " << bytecode[i] << "\n";
+              exit(1);
+            }
+        }
+    }
+}
+
+template<typename Scalar>
+int run_regression(const string& dir)
+{
+  init<Scalar>("expr");
+  const vector<Scalar> bytecode = evaluate<Scalar>();
+
+  const int before = count_objects(dir);
+  if(masa_jit_compile<Scalar>(dir) || count_objects(dir) != before + 1)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_jit_compile\n";
+      return 1;
+    }
+  compare("compiled",evaluate<Scalar>(),bytecode);
+
+  // the same solution and parameters again: loaded from the cache
+  init<Scalar>("again");
+  if(masa_jit_compile<Scalar>(dir) || count_objects(dir) != before + 1)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_jit_compile did not reuse the native code\n";
+      return 1;
+    }
+  compare("cached",evaluate<Scalar>(),bytecode);
+
+  // with another parameter value, the bytecode is used again
+  masa_set_param<Scalar>("u_0",Scalar(3));
+  const vector<Scalar> changed = evaluate<Scalar>();
+  init<Scalar>("reference");
+  masa_set_param<Scalar>("u_0",Scalar(3));
+  if(evaluate<Scalar>() != changed)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: native code used after a parameter changed\n";
+      return 1;
+    }
+
+  // built in solutions cannot be specialized
+  masa_init<Scalar>("builtin","euler_2d");
+  if(masa_jit_compile<Scalar>(dir) == 0)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_jit_compile accepted euler_2d\n";
+      return 1;
+    }
+
+  return 0;
+}
+
+int main()
+{
+  // blanks and quotes in the cache directory reach the compiler as they are
+  char dir[] = "/tmp/masa jit 'test'.XXXXXX";
+  if(mkdtemp(dir) == 0)
+    return 1;
+
+  int err = 0;
+  err += run_regression<double>(dir);
+  err += run_regression<long double>(dir);
+
+  // a directory others can write to is refused
+  init<double>("shared");
+  chmod(dir,0770);
+  if(masa_jit_compile<double>(dir) == 0)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_jit_compile used a group writable directory\n";
+      err++;
+    }
+
+  DIR* d = opendir(dir);
+  while(dirent* e = d ? readdir(d) : 0)
+    if(e->d_name[0] != '.')
+      unlink((string(dir) + "/" + e->d_name).c_str());
+  if(d)
+    closedir(d);
+  rmdir(dir);
+
+  return err;
+}
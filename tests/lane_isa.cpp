@@ -0,0 +1,100 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// lane_isa.cpp: program that tests the choice of lane kernels
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <cstring>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: lane_isa " << what << "\n";
+  exit(1);
+}
+
+int main()
+{
+  string isa;
+  char cisa[32];
+
+  masa_get_lane_isa(&isa);
+  if(isa != "baseline" && isa != "x86-64-v3" && isa != "x86-64-v4")
+    fail("unknown instruction set " + isa);
+
+  // the choice is made once
+  if(masa_get_lane_isa(cisa,sizeof(cisa)) || isa != cisa)
+    fail("C interface disagrees");
+  if(masa_get_lane_isa(cisa,int(isa.size())) != 1)
+    fail("C interface overflowed its buffer");
+
+#if defined(MASA_MULTIARCH) && defined(__x86_64__) && defined(__GNUC__)
+  // without an override, the widest supported modules are used
+  __builtin_cpu_init();
+  if(getenv("MASA_LANE_ISA") == 0)
+    {
+      const char* best = __builtin_cpu_supports("x86-64-v4") ? "x86-64-v4" :
+                         __builtin_cpu_supports("x86-64-v3") ? "x86-64-v3" : "baseline";
+      if(isa != best)
+        fail("chose " + isa + " instead of " + best);
+    }
+#else
+  if(isa != "baseline")
+    fail("loaded " + isa + " kernels that were not built");
+#endif
+
+  // the module kernels evaluate the same expressions, up to contractions
+  // into fused multiply-adds
+  const unsigned int n = 101;
+  vector<double> x(n),y(n),z(n),out;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = double(i)/n;
+      y[i] = double(i%7)/7 + 0.05;
+      z[i] = double(i%11)/11 + 0.05;
+    }
+
+  masa_init<double>("lanes","navierstokes_3d_compressible");
+  masa_init_param<double>();
+  if(masa_eval_3d_lanes("q_rho_e",x,y,z,out))
+    fail("evaluation");
+  for(unsigned int i = 0; i < n; i++)
+    {
+      double expect = masa_eval_source_rho_e<double>(x[i],y[i],z[i]);
+      if(fabs(out[i] - expect) > 1.0e-13 * max(1.0,fabs(expect)))
+        fail(isa + " kernels disagree with the point-wise evaluation");
+    }
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// math.cpp: program that tests the fused sine and cosine kernel and
+//           the lane kernels of masa_simd
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <masa_math.h>
+#include <masa_lane_math.h>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: math " << what << "\n";
+  exit(1);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const Scalar pi = std::acos(Scalar(-1));
+  const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  const int n = 500;
+
+  // the fused kernel gives what separate calls give
+  for(int i = 0; i < n; i++)
+    {
+      Scalar a = Scalar(i - n/2) * pi / 37;
+      Scalar s, c;
+      masa_sincos(a,s,c);
+      if(std::abs(s - std::sin(a)) > 2*eps || std::abs(c - std::cos(a)) > 2*eps)
+        fail("sincos disagrees with sin and cos");
+    }
+
+  return 0;
+}
+
+// lane by lane distance of the kernel results to the C library, in
+// units of eps relative to the size of the C library result
+typedef NumberArray<4,double> lanes;
+
+double lane_error(const lanes& kernel, double (*libm)(double), const lanes& a)
+{
+  double worst = 0;
+  for(int i = 0; i < 4; i++)
+    {
+      const double expect = libm(a[i]);
+      if(kernel[i] != expect)
+        worst = max(worst,fabs(kernel[i] - expect) / (numeric_limits<double>::epsilon() * fabs(expect)));
+    }
+  return worst;
+}
+
+int run_lanes()
+{
+  const double eps = numeric_limits<double>::epsilon();
+  lanes a, x, y;
+
+  for(int i = 0; i < 4000; i++)
+    {
+      for(int l = 0; l < 4; l++)
+        {
+          const int k = 4*i + l;
+          a[l] = (k - 8000) * 0.01237;
+          x[l] = 0.001 + (k % 997) * 0.3;
+          y[l] = (k % 41) * 0.25 - 5.1;
+        }
+      if(lane_error(std::sin(a),std::sin,a) > 2 || lane_error(std::cos(a),std::cos,a) > 2)
+        fail("lane sin or cos");
+      if(lane_error(std::exp(a),std::exp,a) > 2 || lane_error(std::log(x),std::log,x) > 2)
+        fail("lane exp or log");
+
+      // pow loses the accuracy of log x to the scale of y log x
+      const lanes p = std::pow(x,y), p3 = std::pow(x,-3);
+      for(int l = 0; l < 4; l++)
+        if(fabs(p[l] - std::pow(x[l],y[l])) > 4 * eps * (1 + fabs(y[l] * std::log(x[l]))) * p[l] ||
+           fabs(p3[l] - std::pow(x[l],-3.0)) > 4 * eps * p3[l])
+          fail("lane pow");
+    }
+
+  // arguments the kernels do not cover go to the C library
+  const double outside[4] = {1e6, -0.0, 800, numeric_limits<double>::quiet_NaN()};
+  for(int l = 0; l < 4; l++)
+    a[l] = outside[l];
+  const lanes s = std::sin(a), e = std::exp(a), g = std::log(a);
+  for(int l = 0; l < 3; l++)
+    if(s[l] != std::sin(a[l]) || e[l] != std::exp(a[l]) || g[l] != std::log(a[l]))
+      fail("lane fallback");
+  if(!std::isnan(s[3]) || !std::isnan(e[3]) || !std::isnan(g[3]))
+    fail("lane NaN");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_lanes();
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
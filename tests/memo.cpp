@@ -0,0 +1,131 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// memo.cpp: program that tests the memoization of point evaluations
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: memo " << what << "\n";
+  exit(1);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const int n = 200;
+  std::vector<Scalar> x(n),y(n),z(n),rho_u(n),exact(n);
+  unsigned long hits,misses;
+
+  masa_init<Scalar>("memo-test","euler_3d");
+  masa_init_param<Scalar>();
+
+  for(int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(i)/n;
+      y[i] = Scalar(i%9)/9;
+      z[i] = Scalar(i%13)/13;
+      rho_u[i] = masa_eval_source_rho_u<Scalar>(x[i],y[i],z[i]);
+      exact[i] = masa_eval_exact_rho<Scalar>(x[i],y[i],z[i]);
+    }
+
+  if(masa_memo_stats<Scalar>(hits,misses) != 1)
+    fail("reported statistics without a memo");
+
+  // lightly loaded, so that no probe window overflows; the fields are
+  // keyed by name, so the layout is the same in every build
+  masa_enable_memo<Scalar>(8192);
+
+  // every term is evaluated once, then answered from the table
+  for(int rep = 0; rep < 3; rep++)
+    for(int i = 0; i < n; i++)
+      {
+        if(masa_eval_source_rho_u<Scalar>(x[i],y[i],z[i]) != rho_u[i] ||
+           masa_eval_exact_rho<Scalar>(x[i],y[i],z[i]) != exact[i])
+          fail("changed a value");
+      }
+  masa_memo_stats<Scalar>(hits,misses);
+  if(misses != 2*n || hits != 4*n)
+    fail("did not reuse repeated points");
+
+  // -0 and 0 are different points
+  masa_enable_memo<Scalar>(1024);
+  masa_eval_source_rho_u<Scalar>(Scalar(0),y[1],z[1]);
+  masa_eval_source_rho_u<Scalar>(-Scalar(0),y[1],z[1]);
+  masa_memo_stats<Scalar>(hits,misses);
+  if(hits != 0 || misses != 2)
+    fail("matched different bit patterns");
+
+  // a parameter change invalidates every entry
+  masa_set_param<Scalar>("u_0",masa_get_param<Scalar>("u_0")*2);
+  masa_enable_memo<Scalar>(1024);
+  for(int i = 0; i < n; i++)
+    masa_eval_source_rho_u<Scalar>(x[i],y[i],z[i]);
+  masa_set_param<Scalar>("u_0",masa_get_param<Scalar>("u_0")/2);
+  for(int i = 0; i < n; i++)
+    if(masa_eval_source_rho_u<Scalar>(x[i],y[i],z[i]) != rho_u[i])
+      fail("returned a value computed with old parameters");
+  masa_memo_stats<Scalar>(hits,misses);
+  if(hits != 0 || misses != 2*n)
+    fail("hit after a parameter change");
+
+  // a small table keeps working once full
+  masa_enable_memo<Scalar>(16);
+  for(int rep = 0; rep < 2; rep++)
+    for(int i = 0; i < n; i++)
+      if(masa_eval_source_rho_u<Scalar>(x[i],y[i],z[i]) != rho_u[i])
+        fail("full table returned a wrong value");
+  masa_memo_stats<Scalar>(hits,misses);
+  if(hits + misses != 2*n)
+    fail("lost lookups in a full table");
+
+  masa_enable_memo<Scalar>(0);
+  if(masa_memo_stats<Scalar>(hits,misses) != 1)
+    fail("did not turn the memo off");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
@@ -0,0 +1,149 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// param_snapshot.cpp: program that tests saving, restoring and serializing
+//                     the parameters of a solution
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: param_snapshot " << what << "\n";
+  exit(1);
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const Scalar x = 0.3, y = 0.7;
+  vector<Scalar> saved, changed;
+  string bytes;
+
+  masa_init<Scalar>("euler","euler_2d");
+  masa_init_param<Scalar>();
+  const Scalar q = masa_eval_source_rho_u<Scalar>(x,y);
+
+  // a snapshot holds every parameter, and brings them all back
+  masa_save_params<Scalar>(saved);
+  if(saved.size() != masa_param_count<Scalar>() || saved.size() != 24)
+    fail("counts the euler_2d parameters wrongly");
+
+  masa_set_param<Scalar>("mu",masa_get_param<Scalar>("mu") * 2);
+  masa_set_param<Scalar>("a_rhox",masa_get_param<Scalar>("a_rhox") + 1);
+  const Scalar q_changed = masa_eval_source_rho_u<Scalar>(x,y);
+  if(q_changed == q)
+    fail("test does not change the source term");
+  masa_save_params<Scalar>(changed);
+
+  if(masa_load_params<Scalar>(saved) || masa_eval_source_rho_u<Scalar>(x,y) != q)
+    fail("does not restore a snapshot");
+  if(masa_load_params<Scalar>(changed) || masa_eval_source_rho_u<Scalar>(x,y) != q_changed)
+    fail("does not restore a second snapshot");
+
+  // a snapshot of the wrong length changes nothing
+  changed.pop_back();
+  if(masa_load_params<Scalar>(changed) == 0 || masa_eval_source_rho_u<Scalar>(x,y) != q_changed)
+    fail("accepts a snapshot of the wrong length");
+
+  // the binary form round trips exactly
+  masa_load_params<Scalar>(saved);
+  masa_serialize_params<Scalar>(bytes);
+  masa_init_param<Scalar>();
+  masa_set_param<Scalar>("L",3);
+  if(masa_deserialize_params<Scalar>(bytes) || masa_eval_source_rho_u<Scalar>(x,y) != q)
+    fail("does not restore the binary form");
+
+  // and is refused by another solution, or when truncated
+  masa_init<Scalar>("euler 1d","euler_1d");
+  if(masa_deserialize_params<Scalar>(bytes) == 0)
+    fail("restores the parameters of another solution");
+  masa_select_mms<Scalar>("euler");
+  masa_set_param<Scalar>("L",3);
+  if(masa_deserialize_params<Scalar>(bytes.substr(0,bytes.size() - 1)) == 0 ||
+     masa_get_param<Scalar>("L") != 3)
+    fail("restores a truncated binary form");
+
+  // vectors are part of both forms
+  masa_init<Scalar>("radiation","radiation_integrated_intensity");
+  const Scalar u = masa_eval_source_u<Scalar>(x);
+  masa_save_params<Scalar>(saved);
+  if(saved.size() != 1 + 3 * (1 + 25))
+    fail("counts the radiation parameters wrongly");
+  masa_serialize_params<Scalar>(bytes);
+
+  vector<Scalar> amp;
+  masa_get_vec<Scalar>("vec_amp",amp);
+  for(unsigned int i = 0; i != amp.size(); i++)
+    amp[i] *= 2;
+  masa_set_vec<Scalar>("vec_amp",amp);
+  if(masa_eval_source_u<Scalar>(x) == u)
+    fail("test does not change the radiation source term");
+
+  if(masa_load_params<Scalar>(saved) || masa_eval_source_u<Scalar>(x) != u)
+    fail("does not restore the vectors of a snapshot");
+  masa_set_vec<Scalar>("vec_amp",amp);
+  if(masa_deserialize_params<Scalar>(bytes) || masa_eval_source_u<Scalar>(x) != u)
+    fail("does not restore the vectors of the binary form");
+
+  // neither form is taken for vectors of another length
+  amp.pop_back();
+  masa_set_vec<Scalar>("vec_amp",amp);
+  vector<Scalar> shorter;
+  masa_save_params<Scalar>(shorter);
+  if(masa_load_params<Scalar>(shorter) != 0)
+    fail("does not restore a snapshot of its own vectors");
+  if(masa_load_params<Scalar>(vector<Scalar>(saved.begin(),saved.end() - 1)) == 0)
+    fail("restores a snapshot with vectors of another length");
+  if(masa_deserialize_params<Scalar>(bytes) == 0)
+    fail("restores a binary form with vectors of another length");
+  vector<Scalar> kept;
+  masa_get_vec<Scalar>("vec_amp",kept);
+  if(kept != amp)
+    fail("changes the vectors while refusing a snapshot");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
@@ -0,0 +1,117 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// precision.cpp: program that tests the single precision and float storage
+//                evaluations
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: precision " << what << "\n";
+  exit(1);
+}
+
+int main()
+{
+#if defined(MASA_OMIT_FLOAT)
+  // skipped: this build left out the float instances
+  return 77;
+#else
+  const float feps = numeric_limits<float>::epsilon();
+
+  // the whole interface in single precision
+  masa_init<float>("single","heateq_3d_steady_const");
+  masa_init_param<float>();
+  if(masa_sanity_check<float>())
+    fail("float parameters");
+  masa_init<double>("double","heateq_3d_steady_const");
+  masa_init_param<double>();
+  for(int i = 0; i < 20; i++)
+    {
+      float x = i*0.05f, y = 0.3f + i*0.01f, z = 0.7f - i*0.02f;
+      double t = masa_eval_exact_t<double>(x,y,z);
+      if(fabs(masa_eval_exact_t<float>(x,y,z) - t) > 8*feps*max(1.0,fabs(t)))
+        fail("float exact solution");
+    }
+
+  // evaluation of float points, following the selected double solution
+  const unsigned int n = 103;
+  vector<float> x(n),y(n),z(n),single,mixed;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = float(i)/n;
+      y[i] = float(i%7)/7 + 0.05f;
+      z[i] = float(i%11)/11 + 0.05f;
+    }
+
+  masa_init<double>("ns","navierstokes_3d_compressible");
+  masa_init_param<double>();
+
+  for(int pass = 0; pass < 2; pass++)
+    {
+      if(masa_eval_3d_float("q_rho_e",x,y,z,single) || masa_eval_3d_mixed("q_rho_e",x,y,z,mixed))
+        fail("evaluation");
+      if(single.size() != n || mixed.size() != n)
+        fail("size");
+
+      double scale = 0, single_err = 0, mixed_err = 0;
+      for(unsigned int i = 0; i < n; i++)
+        {
+          double q = masa_eval_source_rho_e<double>(x[i],y[i],z[i]);
+          scale = max(scale,fabs(q));
+
+          // mixed results are the double ones, rounded once
+          if(mixed[i] != float(q))
+            fail("mixed result is not the rounded double one");
+          single_err = max(single_err,fabs(single[i] - q));
+          mixed_err  = max(mixed_err, fabs(mixed[i] - q));
+        }
+
+      if(single_err > 1.0e-3 * scale)
+        fail("single precision result far from the double one");
+      if(mixed_err > single_err)
+        fail("mixed precision less accurate than single");
+
+      // parameter changes reach the float instance
+      masa_set_param<double>("mu",masa_get_param<double>("mu")*2);
+    }
+
+  if(masa_eval_3d_float("no_such_term",x,y,z,single) != 1)
+    fail("accepted an unknown term");
+
+  return 0;
+#endif
+}
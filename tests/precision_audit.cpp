@@ -0,0 +1,129 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// precision_audit.cpp: program that tests the precision audit of the
+//                      double solutions against their wider shadows
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <doubledouble.h>
+#include <vector>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: precision_audit " << what << "\n";
+  exit(1);
+}
+
+int main()
+{
+#if defined(MASA_OMIT_DOUBLEDOUBLE) || defined(MASA_OMIT_LONGDOUBLE)
+  // skipped: this build left out the doubledouble and long double instances
+  return 77;
+#else
+  masa_init<double>("ns","navierstokes_3d_compressible");
+  masa_init_param<double>();
+
+  const unsigned int n = 61;
+  vector<double> px(n),py(n),pz(n),hi,lo;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      px[i] = double(i)/n;
+      py[i] = double(i%7)/7 + 0.05;
+      pz[i] = double(i%11)/11 + 0.05;
+    }
+
+  vector<string> fields;
+  fields.push_back("exact_rho");
+  fields.push_back("q_rho");
+  fields.push_back("q_rho_u");
+  fields.push_back("q_rho_e");
+
+  const char* shadows[] = {"longdouble", "doubledouble"};
+  for(int s = 0; s < 2; s++)
+    {
+      vector<double> max_rel;
+      if(masa_audit_3d(fields,shadows[s],px,py,pz,max_rel))
+        fail("audit");
+      if(max_rel.size() != fields.size())
+        fail("size");
+
+      // the exact solution is a few roundings away from the shadow, the
+      // source terms lose more to cancellation, but double still
+      // carries most of their digits
+      if(!(max_rel[0] > 0 && max_rel[0] < 1e-14))
+        fail("discrepancy of the exact solution");
+      for(unsigned int f = 1; f < fields.size(); f++)
+        if(!(max_rel[f] > 0 && max_rel[f] < 1e-10))
+          fail("discrepancy of " + fields[f]);
+    }
+
+  // the audit against double-double is the largest relative distance
+  // of the double terms to the double-double evaluation
+  vector<double> max_rel;
+  if(masa_audit_3d(vector<string>(1,"q_rho_e"),"doubledouble",px,py,pz,max_rel))
+    fail("audit of q_rho_e");
+  if(masa_eval_3d_dd("q_rho_e",px,py,pz,hi,lo))
+    fail("double-double evaluation");
+
+  double expected = 0;
+  for(unsigned int i = 0; i < n; i++)
+    {
+      const DoubleDouble ref(hi[i],lo[i]);
+      const DoubleDouble diff = DoubleDouble(masa_eval_source_rho_e<double>(px[i],py[i],pz[i])) - ref;
+      expected = max(expected,fabs(static_cast<double>(diff / ref)));
+    }
+  if(max_rel[0] != expected)
+    fail("differs from the double-double evaluation");
+
+  // parameter changes reach the shadow instances
+  vector<double> before;
+  masa_audit_3d(fields,"longdouble",px,py,pz,before);
+  masa_set_param<double>("mu",masa_get_param<double>("mu")*1000);
+  masa_audit_3d(fields,"longdouble",px,py,pz,max_rel);
+  if(max_rel[0] != before[0] || max_rel[3] == before[3])
+    fail("parameter change");
+
+  // an unknown term is reported, the others are still measured
+  fields.push_back("no_such_term");
+  if(masa_audit_3d(fields,"longdouble",px,py,pz,max_rel) != 1)
+    fail("accepted an unknown term");
+  if(max_rel.size() != fields.size() || max_rel[4] != 0 || max_rel[0] != before[0])
+    fail("audit around an unknown term");
+
+  if(masa_audit_3d(fields,"quad",px,py,pz,max_rel) != 1)
+    fail("accepted an unknown shadow type");
+
+  return 0;
+#endif
+}
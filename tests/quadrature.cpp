@@ -0,0 +1,165 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+// $Author$
+// $Id$
+//
+// quadrature.cpp: program that tests the integrated and cell-averaged
+//                 source terms against analytical integrals
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+
+using namespace MASA;
+using namespace std;
+
+template<typename Scalar>
+Scalar unity(Scalar,Scalar,Scalar)
+{
+  return 1;
+}
+
+template<typename Scalar>
+Scalar xyz(Scalar x,Scalar y,Scalar z)
+{
+  return x*y*z;
+}
+
+// integral of cos(a*s) over [s0,s1]
+template<typename Scalar>
+Scalar int_cos(Scalar a,Scalar s0,Scalar s1)
+{
+  return (std::sin(a*s1) - std::sin(a*s0))/a;
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  Scalar threshold = 100 * numeric_limits<Scalar>::epsilon();
+  Scalar err;
+
+  masa_init<Scalar>("quadrature-test","heateq_3d_steady_const");
+  masa_init_param<Scalar>();
+
+  Scalar A_x = masa_get_param<Scalar>("A_x");
+  Scalar B_y = masa_get_param<Scalar>("B_y");
+  Scalar C_z = masa_get_param<Scalar>("C_z");
+  Scalar k_0 = masa_get_param<Scalar>("k_0");
+  Scalar amp = k_0 * (A_x*A_x + B_y*B_y + C_z*C_z);
+
+  // check the rule itself: weights sum to two, symmetric abscissae
+  std::vector<Scalar> gx,gw;
+  for(int n = 1; n <= 12; n++)
+    {
+      masa_gauss_legendre<Scalar>(n,gx,gw);
+      Scalar sum = 0;
+      for(int q = 0; q < n; q++)
+        {
+          sum += gw[q];
+          threshcheck(fabs(gx[q] + gx[n-1-q]),threshold);
+        }
+      threshcheck(fabs(sum - 2),threshold);
+    }
+
+  // box integral and average of the source term
+  Scalar x0 = 0.1, x1 = 0.6, y0 = -0.2, y1 = 0.3, z0 = 0.4, z1 = 1.1;
+  Scalar exact = amp * int_cos(A_x,x0,x1) * int_cos(B_y,y0,y1) * int_cos(C_z,z0,z1);
+  Scalar vol   = (x1-x0)*(y1-y0)*(z1-z0);
+
+  err = masa_integrate_box<Scalar>(masa_eval_source_t<Scalar>,x0,x1,y0,y1,z0,z1,10);
+  threshcheck(fabs(err - exact)/fabs(exact),threshold);
+
+  err = masa_average_box<Scalar>(masa_eval_source_t<Scalar>,x0,x1,y0,y1,z0,z1,10);
+  threshcheck(fabs(err - exact/vol)/fabs(exact/vol),threshold);
+
+  // weighted integral: a trilinear test function is integrated exactly
+  err = masa_integrate_box<Scalar>(unity<Scalar>,x0,x1,y0,y1,z0,z1,2,xyz<Scalar>);
+  exact = (x1*x1-x0*x0)*(y1*y1-y0*y0)*(z1*z1-z0*z0)/8;
+  threshcheck(fabs(err - exact)/fabs(exact),threshold);
+
+  // grid of cell averages
+  int nx = 4, ny = 3, nz = 2;
+  std::vector<Scalar> xn(nx+1),yn(ny+1),zn(nz+1),avg;
+  for(int i = 0; i <= nx; i++) xn[i] = Scalar(i)/nx;
+  for(int j = 0; j <= ny; j++) yn[j] = Scalar(j)/ny - Scalar(0.5);
+  for(int k = 0; k <= nz; k++) zn[k] = Scalar(2*k)/nz;
+
+  if(masa_average_grid<Scalar>(masa_eval_source_t<Scalar>,xn,yn,zn,8,avg) != 0 ||
+     int(avg.size()) != nx*ny*nz)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_average_grid\n";
+      exit(1);
+    }
+
+  for(int k = 0; k < nz; k++)
+    for(int j = 0; j < ny; j++)
+      for(int i = 0; i < nx; i++)
+        {
+          Scalar cell = (xn[i+1]-xn[i])*(yn[j+1]-yn[j])*(zn[k+1]-zn[k]);
+          exact = amp * int_cos(A_x,xn[i],xn[i+1]) * int_cos(B_y,yn[j],yn[j+1])
+                      * int_cos(C_z,zn[k],zn[k+1]) / cell;
+          threshcheck(fabs(avg[(k*ny+j)*nx+i] - exact)/fabs(exact),threshold);
+        }
+
+  // tetrahedra: volume, and the exact moment of xyz over the unit simplex
+  Scalar v0[3] = {0,0,0};
+  Scalar v1[3] = {1,0,0};
+  Scalar v2[3] = {0,1,0};
+  Scalar v3[3] = {0,0,1};
+
+  err = masa_integrate_tet<Scalar>(unity<Scalar>,v0,v1,v2,v3,2);
+  threshcheck(fabs(err - Scalar(1)/6)*6,threshold);
+
+  err = masa_integrate_tet<Scalar>(xyz<Scalar>,v2,v0,v3,v1,4);
+  threshcheck(fabs(err - Scalar(1)/720)*720,threshold);
+
+  err = masa_integrate_tet<Scalar>(unity<Scalar>,v0,v1,v2,v3,4,xyz<Scalar>);
+  threshcheck(fabs(err - Scalar(1)/720)*720,threshold);
+
+  // a bad order is reported, not fatal
+  if(masa_gauss_legendre<Scalar>(0,gx,gw) == 0 ||
+     masa_average_grid<Scalar>(masa_eval_source_t<Scalar>,xn,yn,zn,0,avg) == 0 ||
+     !std::isnan(masa_integrate_box<Scalar>(unity<Scalar>,x0,x1,y0,y1,z0,z1,0)) ||
+     !std::isnan(masa_integrate_tet<Scalar>(unity<Scalar>,v0,v1,v2,v3,-1)))
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: quadrature order 0 accepted\n";
+      exit(1);
+    }
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
@@ -0,0 +1,153 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// simd.cpp: program that tests the evaluation of several points per
+//           call through the lane instantiations of the solutions
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+
+using namespace MASA;
+using namespace std;
+
+const double thresh = 1.0e-13;
+
+void fail(const string& what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: simd " << what << "\n";
+  exit(1);
+}
+
+void compare(const vector<double>& lanes,const vector<double>& expect,const string& what)
+{
+  if(lanes.size() != expect.size())
+    fail(what + " size");
+  for(unsigned int i = 0; i < expect.size(); i++)
+    if(fabs(lanes[i] - expect[i]) > thresh * max(1.0,fabs(expect[i])))
+      fail(what);
+}
+
+// n is deliberately not a multiple of the lane count
+const unsigned int n = 103;
+
+void points(vector<double>& x,vector<double>& y,vector<double>& z,vector<double>& t)
+{
+  x.resize(n); y.resize(n); z.resize(n); t.resize(n);
+  for(unsigned int i = 0; i < n; i++)
+    {
+      x[i] = double(i)/n;
+      y[i] = double(i%7)/7 + 0.05;
+      z[i] = double(i%11)/11 + 0.05;
+      t[i] = double(i%5)/5;
+    }
+}
+
+void check_1d(const string& solution,const char* field,double (*func)(double))
+{
+  vector<double> x,y,z,t,expect,out;
+  points(x,y,z,t);
+  masa_init<double>(solution,solution);
+  masa_init_param<double>();
+  masa_eval_1d_batch(func,x,expect);
+  if(masa_eval_1d_lanes(field,x,out))
+    fail(solution + " " + field);
+  compare(out,expect,solution + " " + field);
+}
+
+void check_2d(const string& solution,const char* field,double (*func)(double,double))
+{
+  vector<double> x,y,z,t,expect,out;
+  points(x,y,z,t);
+  masa_init<double>(solution,solution);
+  masa_init_param<double>();
+  masa_eval_2d_batch(func,x,y,expect);
+  if(masa_eval_2d_lanes(field,x,y,out))
+    fail(solution + " " + field);
+  compare(out,expect,solution + " " + field);
+}
+
+void check_3d(const string& solution,const char* field,double (*func)(double,double,double))
+{
+  vector<double> x,y,z,t,expect,out;
+  points(x,y,z,t);
+  masa_init<double>(solution,solution);
+  masa_init_param<double>();
+  masa_eval_3d_batch(func,x,y,z,expect);
+  if(masa_eval_3d_lanes(field,x,y,z,out))
+    fail(solution + " " + field);
+  compare(out,expect,solution + " " + field);
+}
+
+void check_4d(const string& solution,const char* field,double (*func)(double,double,double,double))
+{
+  vector<double> x,y,z,t,expect,out;
+  points(x,y,z,t);
+  masa_init<double>(solution,solution);
+  masa_init_param<double>();
+  masa_eval_4d_batch(func,x,y,z,t,expect);
+  if(masa_eval_4d_lanes(field,x,y,z,t,out))
+    fail(solution + " " + field);
+  compare(out,expect,solution + " " + field);
+}
+
+int main()
+{
+  // lane instantiations
+  check_1d("euler_1d","q_rho_e",masa_eval_source_rho_e<double>);
+  check_1d("heateq_1d_steady_const","exact_t",masa_eval_exact_t<double>);
+  check_2d("navierstokes_2d_compressible","q_rho_u",masa_eval_source_rho_u<double>);
+  check_3d("burgers_equation","q_u",masa_eval_source_u<double>);
+  check_3d("euler_3d","q_rho_w",masa_eval_source_rho_w<double>);
+  check_3d("navierstokes_3d_compressible","q_rho_e",masa_eval_source_rho_e<double>);
+  check_3d("navierstokes_3d_compressible","exact_p",masa_eval_exact_p<double>);
+  check_3d("heateq_2d_unsteady_var","q_t",masa_eval_source_t<double>);
+  check_4d("navierstokes_4d_compressible_powerlaw","q_rho_e",masa_eval_source_rho_e<double>);
+  check_4d("navierstokes_3d_transient_sutherland","q_u",masa_eval_source_u<double>);
+
+  // point by point fallback
+  check_2d("sod_1d","q_rho",masa_eval_source_rho<double>);
+  check_3d("ad_cns_3d_crossterms","exact_u",masa_eval_exact_u<double>);
+
+  // parameter changes reach the lane instance
+  vector<double> x,y,z,t,expect,out;
+  points(x,y,z,t);
+  masa_init<double>("euler_3d-changed","euler_3d");
+  masa_init_param<double>();
+  masa_eval_3d_lanes("q_rho_u",x,y,z,out);
+  masa_set_param<double>("u_0",masa_get_param<double>("u_0")*3);
+  masa_eval_3d_batch(masa_eval_source_rho_u<double>,x,y,z,expect);
+  masa_eval_3d_lanes("q_rho_u",x,y,z,out);
+  compare(out,expect,"parameter change");
+
+  if(masa_eval_3d_lanes("q_no_such_term",x,y,z,out) != 1)
+    fail("accepted an unknown term");
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// stream.cpp: program that tests the out-of-core grid evaluation
+//             against in-memory grid evaluation
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+
+using namespace MASA;
+using namespace std;
+
+void fail(const char* what)
+{
+  cout << "\nMASA REGRESSION TEST FAILED: masa_stream_3d_grid " << what << "\n";
+  exit(1);
+}
+
+template<typename T>
+T get(const std::vector<char>& buf, std::size_t offset)
+{
+  T value;
+  std::memcpy(&value,&buf[offset],sizeof(T));
+  return value;
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const char* filename = sizeof(Scalar) == sizeof(double) ? "stream_double.masa" : "stream_ldouble.masa";
+
+  masa_init<Scalar>("stream-test","euler_3d");
+  masa_init_param<Scalar>();
+
+  std::vector<Scalar> x(7),y(5),z(11);
+  for(unsigned int i = 0; i < x.size(); i++) x[i] = Scalar(i)/6;
+  for(unsigned int j = 0; j < y.size(); j++) y[j] = Scalar(j)/4 + 1;
+  for(unsigned int k = 0; k < z.size(); k++) z[k] = Scalar(k)/10 - 1;
+
+  std::vector<Scalar (*)(Scalar,Scalar,Scalar)> fields;
+  std::vector<std::string> names;
+  fields.push_back(masa_eval_exact_rho<Scalar>);    names.push_back("exact_rho");
+  fields.push_back(masa_eval_source_rho_e<Scalar>); names.push_back("source_rho_e");
+
+  // 11 planes in slabs of 3: the last slab is a partial one
+  if(masa_stream_3d_grid<Scalar>(filename,fields,names,x,y,z,3) != 0)
+    fail("returned an error");
+
+  std::ifstream in(filename,std::ios::binary);
+  std::vector<char> buf((std::istreambuf_iterator<char>(in)),std::istreambuf_iterator<char>());
+  in.close();
+  remove(filename);
+
+  if(buf.size() < 56 || std::memcmp(&buf[0],"MASAGRID",8) != 0)
+    fail("wrote no header");
+
+  const std::size_t npts = x.size()*y.size()*z.size();
+  const uint64_t offset = get<uint64_t>(buf,48);
+
+  if(get<uint32_t>(buf,8)  != 1 ||
+     get<uint32_t>(buf,12) != sizeof(Scalar) ||
+     get<uint64_t>(buf,16) != x.size() ||
+     get<uint64_t>(buf,24) != y.size() ||
+     get<uint64_t>(buf,32) != z.size() ||
+     get<uint64_t>(buf,40) != fields.size() ||
+     offset % 4096 != 0 ||
+     buf.size() != offset + fields.size()*npts*sizeof(Scalar))
+    fail("wrote a bad header");
+
+  if(std::string(&buf[56]) != "exact_rho" || std::string(&buf[88]) != "source_rho_e")
+    fail("wrote bad field names");
+
+  if(get<Scalar>(buf,120 + 3*sizeof(Scalar)) != x[3] ||
+     get<Scalar>(buf,120 + (x.size()+y.size()+4)*sizeof(Scalar)) != z[4])
+    fail("wrote bad coordinates");
+
+  std::vector<Scalar> expect;
+  for(unsigned int f = 0; f < fields.size(); f++)
+    {
+      masa_eval_3d_grid<Scalar>(fields[f],x,y,z,expect);
+      for(std::size_t p = 0; p < npts; p++)
+        if(get<Scalar>(buf,offset + (f*npts + p)*sizeof(Scalar)) != expect[p])
+          fail("wrote wrong values");
+    }
+
+  // a missing field name is refused
+  names.pop_back();
+  if(masa_stream_3d_grid<Scalar>(filename,fields,names,x,y,z,3) != 1)
+    fail("accepted mismatched names");
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  err += run_regression<double>();
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}
@@ -0,0 +1,247 @@
+// -*-c++-*-
+//
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// MASA - Manufactured Analytical Solutions Abstraction Library
+//
+// Copyright (C) 2010,2011,2012,2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+//
+// $Author$
+// $Id$
+//
+// threads.cpp: program that tests the threaded batch and grid
+//              evaluations reproduce serial evaluation exactly
+//
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+
+#include <tests.h>
+#include <thread>
+#include <sched.h>
+
+using namespace MASA;
+using namespace std;
+
+// records which thread, and on which processor, evaluated each
+// (integer) point
+std::vector<std::thread::id> owner(1000);
+std::vector<int> processor(1000);
+
+template<typename Scalar>
+Scalar whoami(Scalar x)
+{
+  owner[int(x)] = std::this_thread::get_id();
+#ifdef __linux__
+  processor[int(x)] = sched_getcpu();
+#endif
+  return x;
+}
+
+template<typename Scalar>
+int compare(const char* what,const std::vector<Scalar>& batch,const std::vector<Scalar>& serial)
+{
+  if(batch.size() != serial.size())
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: " << what << " returned "
+           << batch.size() << " values, expected " << serial.size() << "\n";
+      exit(1);
+    }
+
+  // every point is evaluated by exactly the same code: demand bitwise equality
+  for(unsigned int i = 0; i != batch.size(); i++)
+    if(batch[i] != serial[i] && !(batch[i] != batch[i] && serial[i] != serial[i]))
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: " << what << " differs at point " << i << "\n";
+        exit(1);
+      }
+
+  return 0;
+}
+
+template<typename Scalar>
+int run_regression()
+{
+  const int n = 2000;
+  std::vector<Scalar> x(n),y(n),z(n),serial(n),batch;
+
+  for(int i = 0; i < n; i++)
+    {
+      x[i] = Scalar(10*i)/n - 1;
+      y[i] = Scalar(i%37 + 1)/38;
+      z[i] = Scalar(i%11)/10;
+    }
+
+  // sod_1d keeps its left/right states in members while evaluating
+  masa_init<Scalar>("sod-threads","sod_1d");
+  masa_init_param<Scalar>();
+
+  for(int i = 0; i < n; i++)
+    serial[i] = masa_eval_source_rho_u<Scalar>(x[i],y[i]);
+  masa_eval_2d_batch<Scalar>(masa_eval_source_rho_u<Scalar>,x,y,batch);
+  compare("sod_1d batch",batch,serial);
+
+  // parameter changes reach the worker copies
+  masa_set_param<Scalar>("Gamma",1.3);
+  for(int i = 0; i < n; i++)
+    serial[i] = masa_eval_source_rho<Scalar>(x[i],y[i]);
+  masa_eval_2d_batch<Scalar>(masa_eval_source_rho<Scalar>,x,y,batch);
+  compare("sod_1d batch after masa_set_param",batch,serial);
+
+  // fans_sa_steady_wall_bounded updates most of its members per point
+  masa_init<Scalar>("fans-threads","fans_sa_steady_wall_bounded");
+  for(int i = 0; i < n; i++)
+    serial[i] = masa_eval_source_rho_e<Scalar>(y[i],z[i] + Scalar(0.05));
+  std::vector<Scalar> zs(z);
+  for(int i = 0; i < n; i++)
+    zs[i] += Scalar(0.05);
+  masa_eval_2d_batch<Scalar>(masa_eval_source_rho_e<Scalar>,y,zs,batch);
+  compare("fans_sa batch",batch,serial);
+
+  // a non-MASA function goes through the pool as well
+  masa_eval_1d_batch<Scalar>(std::exp,x,batch);
+  for(int i = 0; i < n; i++)
+    serial[i] = std::exp(x[i]);
+  compare("1d batch",batch,serial);
+
+  // tensor-product grid, x fastest
+  masa_init<Scalar>("heat-threads","heateq_3d_steady_const");
+  masa_init_param<Scalar>();
+
+  std::vector<Scalar> gx(17),gy(13),gz(9);
+  for(unsigned int i = 0; i < gx.size(); i++) gx[i] = Scalar(i)/16;
+  for(unsigned int j = 0; j < gy.size(); j++) gy[j] = Scalar(j)/12;
+  for(unsigned int k = 0; k < gz.size(); k++) gz[k] = Scalar(k)/8;
+
+  serial.clear();
+  for(unsigned int k = 0; k < gz.size(); k++)
+    for(unsigned int j = 0; j < gy.size(); j++)
+      for(unsigned int i = 0; i < gx.size(); i++)
+        serial.push_back(masa_eval_source_t<Scalar>(gx[i],gy[j],gz[k]));
+  masa_eval_3d_grid<Scalar>(masa_eval_source_t<Scalar>,gx,gy,gz,batch);
+  compare("3d grid",batch,serial);
+
+  // cell averages do not depend on the thread count
+  std::vector<Scalar> avg;
+  masa_set_num_threads(1);
+  masa_average_grid<Scalar>(masa_eval_source_t<Scalar>,gx,gy,gz,4,serial);
+  masa_set_num_threads(3);
+  masa_average_grid<Scalar>(masa_eval_source_t<Scalar>,gx,gy,gz,4,avg);
+  compare("masa_average_grid",avg,serial);
+
+  // static slabs matching an OpenMP schedule(static) loop over z
+  std::vector<std::size_t> part;
+  masa_static_partition(gz.size(),gx.size()*gy.size(),4,part);
+  const std::size_t plane = gx.size()*gy.size();
+  const std::size_t expect[5] = {0,3*plane,5*plane,7*plane,9*plane};
+  for(int s = 0; s < 5; s++)
+    if(part.size() != 5 || part[s] != expect[s])
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: masa_static_partition\n";
+        exit(1);
+      }
+
+  Scalar* field = masa_alloc_field<Scalar>(part.back(),part);
+  for(std::size_t p = 0; p < part.back(); p++)
+    if(field[p] != 0)
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: masa_alloc_field not zeroed\n";
+        exit(1);
+      }
+
+  masa_eval_3d_grid<Scalar>(masa_eval_source_t<Scalar>,gx,gy,gz,field,part);
+  batch.assign(field,field+part.back());
+  masa_free_field(field);
+  masa_eval_3d_grid<Scalar>(masa_eval_source_t<Scalar>,gx,gy,gz,serial);
+  compare("partitioned 3d grid",batch,serial);
+
+  // with a static partition a slab always lands on the same thread
+  std::vector<Scalar> pts(owner.size());
+  for(unsigned int i = 0; i < pts.size(); i++)
+    pts[i] = i;
+  masa_static_partition(pts.size(),1,7,part);
+
+  masa_eval_1d_batch<Scalar>(whoami<Scalar>,pts.size(),pts.data(),batch.data(),part);
+  std::vector<std::thread::id> first(owner);
+  masa_eval_1d_batch<Scalar>(whoami<Scalar>,pts.size(),pts.data(),batch.data(),part);
+  if(first != owner)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: static slabs moved between threads\n";
+      exit(1);
+    }
+
+  // and with MASA_THREAD_AFFINITY=close (main) the pool threads stay
+  // on their processors; the calling thread is not pinned
+  std::vector<int> first_processor(processor);
+  for(int r = 0; r < 3; r++)
+    masa_eval_1d_batch<Scalar>(whoami<Scalar>,pts.size(),pts.data(),batch.data(),part);
+  for(unsigned int i = 0; i < pts.size(); i++)
+    if(owner[i] != std::this_thread::get_id() && processor[i] != first_processor[i])
+      {
+        cout << "\nMASA REGRESSION TEST FAILED: pinned pool thread moved\n";
+        exit(1);
+      }
+
+  // partitions must cover the output in order
+  part.back()--;
+  if(masa_eval_1d_batch<Scalar>(whoami<Scalar>,pts.size(),pts.data(),batch.data(),part) != 1)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: short partition accepted\n";
+      exit(1);
+    }
+
+  // mismatched coordinate arrays are rejected
+  y.pop_back();
+  if(masa_eval_2d_batch<Scalar>(masa_eval_source_t<Scalar>,x,y,batch) != 1)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: mismatched batch accepted\n";
+      exit(1);
+    }
+
+  return 0;
+}
+
+int main()
+{
+  int err=0;
+
+  // read when the pool first starts
+  setenv("MASA_THREAD_AFFINITY","close",1);
+
+  if(masa_set_num_threads(4) != 0 || masa_get_num_threads() != 4)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: masa_set_num_threads\n";
+      exit(1);
+    }
+
+  if(masa_set_num_threads(-1) != 1 || masa_get_num_threads() != 4)
+    {
+      cout << "\nMASA REGRESSION TEST FAILED: negative thread count accepted\n";
+      exit(1);
+    }
+
+  err += run_regression<double>();
+
+  masa_set_num_threads(4);
+#ifndef MASA_OMIT_LONGDOUBLE
+  err += run_regression<long double>();
+#endif
+
+  return err;
+}